@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstdlib>
+
+#include "embec/arena.hpp"
+
+#include "bench.hpp"
+
+#if EMBEC_HAS_PMR
+#include <vector>
+#endif
+
+namespace {
+
+constexpr std::size_t batch = 16;
+
+// Sizes of a typical parse: small nodes and a few larger buffers.
+constexpr std::size_t sizes[batch] = {24, 16, 40, 8, 24, 96, 16, 32,
+                                      24, 16, 200, 8, 24, 48, 16, 64};
+
+embec::static_arena<4096> request_arena;
+
+EMBEC_BENCHMARK(arena_scope_16, "arena/alloc_scope_16", 0)
+{
+    void* blocks[batch];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::arena_scope scope(request_arena);
+        for (std::size_t k = 0; k < batch; ++k) {
+            blocks[k] = request_arena.allocate(sizes[k], 8);
+        }
+        embec::bench::do_not_optimize(blocks);
+    }
+}
+
+// Reference point for the arena above.
+EMBEC_BENCHMARK(malloc_16, "arena/malloc_free_16", 0)
+{
+    void* blocks[batch];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        for (std::size_t k = 0; k < batch; ++k) {
+            blocks[k] = std::malloc(sizes[k]);
+        }
+        embec::bench::do_not_optimize(blocks);
+        for (auto* block : blocks) {
+            std::free(block);
+        }
+    }
+}
+
+#if EMBEC_HAS_PMR
+
+EMBEC_BENCHMARK(pmr_vector, "arena/pmr_vector_push_256", 0)
+{
+    embec::arena_resource resource(request_arena);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::arena_scope scope(request_arena);
+        std::pmr::vector<int> v(&resource);
+        for (int k = 0; k < 256; ++k) {
+            v.push_back(k);
+        }
+        embec::bench::do_not_optimize(v.data());
+    }
+}
+
+EMBEC_BENCHMARK(std_vector, "arena/std_vector_push_256", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        std::vector<int> v;
+        for (int k = 0; k < 256; ++k) {
+            v.push_back(k);
+        }
+        embec::bench::do_not_optimize(v.data());
+    }
+}
+
+#endif // EMBEC_HAS_PMR
+
+} // namespace
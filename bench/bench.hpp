@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file bench.hpp
+/// @brief Minimal host micro-benchmark framework for embec components.
+///
+/// A benchmark is a function that runs the measured operation a given
+/// number of times. The runner in main.cpp calibrates the iteration count,
+/// times several repetitions with the wall clock and embec::cycle_counter,
+/// measures stack usage and reports the fastest repetition. Each component
+/// has its own <component>_bench.cpp registering its benchmarks.
+
+#ifndef EMBEC_BENCH_BENCH_HPP
+#define EMBEC_BENCH_BENCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace embec {
+namespace bench {
+
+using bench_fn = void (*)(std::uint64_t iterations);
+
+struct benchmark {
+    const char* name;
+    std::size_t bytes_per_op; ///< Payload processed per iteration, 0 if none.
+    bench_fn fn;
+};
+
+inline std::vector<benchmark>& registry()
+{
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+}
+
+/// Registers a benchmark from a static initialiser.
+struct registrar {
+    registrar(const char* name, std::size_t bytes_per_op, bench_fn fn)
+    {
+        registry().push_back({name, bytes_per_op, fn});
+    }
+};
+
+/// Extra result of the running benchmark that timings do not capture,
+/// such as a compression ratio. Cleared before each benchmark, printed
+/// after its row and written to the note column.
+inline std::string& note()
+{
+    static std::string text;
+    return text;
+}
+
+/// Forces @p value to be materialised so the computation producing it is
+/// not optimised away.
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Forces pending memory writes to be considered observable.
+inline void clobber_memory()
+{
+    asm volatile("" : : : "memory");
+}
+
+/// Deterministic xorshift generator for benchmark input data.
+inline void fill_random(void* data, std::size_t length, std::uint32_t seed = 0x2545f491u)
+{
+    auto* p = static_cast<std::uint8_t*>(data);
+    for (std::size_t i = 0; i < length; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        p[i] = static_cast<std::uint8_t>(seed);
+    }
+}
+
+} // namespace bench
+} // namespace embec
+
+/// Defines and registers a benchmark function taking the iteration count.
+#define EMBEC_BENCHMARK(func, name, bytes_per_op)                              \
+    static void func(std::uint64_t);                                           \
+    static const ::embec::bench::registrar func##_registrar{name, bytes_per_op, \
+                                                           func};              \
+    static void func(std::uint64_t iterations)
+
+#endif // EMBEC_BENCH_BENCH_HPP
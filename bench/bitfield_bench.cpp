@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/bitfield.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+struct sample {
+    std::uint8_t channel;
+    std::int16_t value;
+    bool valid;
+    std::uint32_t timestamp;
+};
+
+// 8-byte sensor record: 4-bit channel, 12-bit signed value, valid flag and a
+// 31-bit big-endian timestamp.
+using sample_layout = embec::bit_layout<8,
+    embec::bit_field<&sample::channel, 0, 4>,
+    embec::bit_field<&sample::value, 4, 12>,
+    embec::bit_field<&sample::valid, 16, 1>,
+    embec::bit_field<&sample::timestamp, 33, 31>>;
+
+constexpr std::size_t record_count = 1024;
+constexpr std::size_t array_bytes = record_count * sample_layout::size;
+
+const std::uint8_t* records()
+{
+    static std::uint8_t data[array_bytes];
+    static bool ready = false;
+    if (!ready) {
+        embec::bench::fill_random(data, sizeof(data));
+        ready = true;
+    }
+    return data;
+}
+
+EMBEC_BENCHMARK(unpack_record, "bitfield/unpack_record", sample_layout::size)
+{
+    const std::uint8_t* data = records();
+    sample s{};
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        sample_layout::unpack(data + (i % record_count) * sample_layout::size, s);
+        embec::bench::do_not_optimize(s);
+    }
+}
+
+EMBEC_BENCHMARK(pack_record, "bitfield/pack_record", sample_layout::size)
+{
+    sample s{3, -42, true, 123456};
+    std::uint8_t out[sample_layout::size];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        s.timestamp = static_cast<std::uint32_t>(i);
+        sample_layout::pack(s, out);
+        embec::bench::do_not_optimize(out);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(unpack_array, "bitfield/unpack_array_value_1k", array_bytes)
+{
+    const std::uint8_t* data = records();
+    static std::int16_t values[record_count];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        sample_layout::unpack_array<&sample::value>(data, record_count, values);
+        embec::bench::do_not_optimize(values);
+        embec::bench::clobber_memory();
+    }
+}
+
+} // namespace
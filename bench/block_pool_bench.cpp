@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstdlib>
+
+#include "embec/block_pool.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t batch = 16;
+
+embec::block_pool<64, 32> pool;
+embec::atomic_block_pool<64, 32> atomic_pool;
+
+template <typename Pool>
+void allocate_release(Pool& p, std::uint64_t iterations)
+{
+    void* blocks[batch];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        for (auto& block : blocks) {
+            block = p.allocate();
+        }
+        embec::bench::do_not_optimize(blocks);
+        for (auto* block : blocks) {
+            p.release(block);
+        }
+    }
+}
+
+EMBEC_BENCHMARK(pool_pair, "block_pool/alloc_release_16", 0)
+{
+    allocate_release(pool, iterations);
+}
+
+EMBEC_BENCHMARK(atomic_pool_pair, "block_pool/atomic_alloc_release_16", 0)
+{
+    allocate_release(atomic_pool, iterations);
+}
+
+// Reference point for the pools above.
+EMBEC_BENCHMARK(malloc_pair, "block_pool/malloc_free_16", 0)
+{
+    void* blocks[batch];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        for (auto& block : blocks) {
+            block = std::malloc(64);
+        }
+        embec::bench::do_not_optimize(blocks);
+        for (auto* block : blocks) {
+            std::free(block);
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/byte_buffer.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+struct record {
+    std::uint8_t type;
+    std::uint8_t flags;
+    std::uint16_t length;
+    std::uint32_t sequence;
+    std::uint64_t timestamp;
+};
+
+constexpr std::size_t record_size = 16;
+constexpr std::size_t record_count = 256;
+constexpr std::size_t array_bytes = 4096;
+
+const std::uint8_t* input()
+{
+    static std::uint8_t data[array_bytes];
+    static bool filled = false;
+    if (!filled) {
+        embec::bench::fill_random(data, sizeof(data));
+        filled = true;
+    }
+    return data;
+}
+
+/// Hand-written cursor of the kind the reader replaces: each field is
+/// checked separately and assembled from bytes.
+struct checked_cursor {
+    const std::uint8_t* p;
+    std::size_t left;
+
+    bool u8(std::uint8_t& v)
+    {
+        if (left < 1) {
+            return false;
+        }
+        v = *p++;
+        --left;
+        return true;
+    }
+
+    template <typename T>
+    bool be(T& v)
+    {
+        if (left < sizeof(T)) {
+            return false;
+        }
+        T r = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            r = static_cast<T>((r << 8) | *p++);
+        }
+        v = r;
+        left -= sizeof(T);
+        return true;
+    }
+};
+
+EMBEC_BENCHMARK(parse_record, "byte_buffer/parse_record_be", record_size)
+{
+    const std::uint8_t* data = input();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::be_reader in(data + (i % record_count) * record_size, record_size);
+        record r;
+        r.type = in.read<std::uint8_t>();
+        r.flags = in.read<std::uint8_t>();
+        r.length = in.read<std::uint16_t>();
+        r.sequence = in.read<std::uint32_t>();
+        r.timestamp = in.read<std::uint64_t>();
+        embec::bench::do_not_optimize(r);
+        embec::bench::do_not_optimize(in.ok());
+    }
+}
+
+EMBEC_BENCHMARK(parse_record_checked, "byte_buffer/parse_record_checked_bytes", record_size)
+{
+    const std::uint8_t* data = input();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        checked_cursor in{data + (i % record_count) * record_size, record_size};
+        record r;
+        const bool ok = in.u8(r.type) && in.u8(r.flags) && in.be(r.length) &&
+                        in.be(r.sequence) && in.be(r.timestamp);
+        embec::bench::do_not_optimize(r);
+        embec::bench::do_not_optimize(ok);
+    }
+}
+
+EMBEC_BENCHMARK(parse_record_memcpy, "byte_buffer/parse_record_memcpy", record_size)
+{
+    // Lower bound: copies the record without byte order conversion.
+    const std::uint8_t* data = input();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        record r;
+        std::memcpy(&r, data + (i % record_count) * record_size, record_size);
+        embec::bench::do_not_optimize(r);
+    }
+}
+
+EMBEC_BENCHMARK(write_record, "byte_buffer/write_record_be", record_size)
+{
+    static std::uint8_t out[record_size];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::be_writer w(out);
+        w.write<std::uint8_t>(1);
+        w.write<std::uint8_t>(0);
+        w.write(static_cast<std::uint16_t>(i));
+        w.write(static_cast<std::uint32_t>(i));
+        w.write(i);
+        embec::bench::do_not_optimize(w.ok());
+        embec::bench::clobber_memory();
+    }
+}
+
+template <typename T, embec::byte_order Order>
+void read_array_run(std::uint64_t iterations)
+{
+    const std::uint8_t* data = input();
+    static T values[array_bytes / sizeof(T)];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::byte_reader<Order> in(data, array_bytes);
+        in.read_array(values, array_bytes / sizeof(T));
+        embec::bench::do_not_optimize(values);
+        embec::bench::clobber_memory();
+    }
+}
+
+void memcpy_run(std::uint64_t iterations)
+{
+    const std::uint8_t* data = input();
+    static std::uint8_t values[array_bytes];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        std::memcpy(values, data, array_bytes);
+        embec::bench::do_not_optimize(values);
+        embec::bench::clobber_memory();
+    }
+}
+
+constexpr auto big = embec::byte_order::big;
+constexpr auto little = embec::byte_order::little;
+
+const embec::bench::registrar arrays[] = {
+    {"byte_buffer/read_array_u16_be_4k", array_bytes, read_array_run<std::uint16_t, big>},
+    {"byte_buffer/read_array_u32_be_4k", array_bytes, read_array_run<std::uint32_t, big>},
+    {"byte_buffer/read_array_u64_be_4k", array_bytes, read_array_run<std::uint64_t, big>},
+    {"byte_buffer/read_array_u32_le_4k", array_bytes, read_array_run<std::uint32_t, little>},
+    {"byte_buffer/memcpy_4k", array_bytes, memcpy_run},
+};
+
+} // namespace
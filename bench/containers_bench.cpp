@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <vector>
+
+#include "embec/inline_string.hpp"
+#include "embec/static_deque.hpp"
+#include "embec/static_vector.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t count = 64;
+
+EMBEC_BENCHMARK(vector_fill, "containers/static_vector_fill_64", count * sizeof(int))
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::static_vector<int, count> v;
+        for (std::size_t k = 0; k < count; ++k) {
+            v.push_back(static_cast<int>(k));
+        }
+        embec::bench::do_not_optimize(v);
+    }
+}
+
+// Reference point: the same loop with heap allocation.
+EMBEC_BENCHMARK(std_vector_fill, "containers/std_vector_fill_64", count * sizeof(int))
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        std::vector<int> v;
+        for (std::size_t k = 0; k < count; ++k) {
+            v.push_back(static_cast<int>(k));
+        }
+        embec::bench::do_not_optimize(v.data());
+    }
+}
+
+EMBEC_BENCHMARK(vector_insert_erase, "containers/static_vector_insert_erase_front", 0)
+{
+    embec::static_vector<int, count> v(count - 8, 0);
+    const int block[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        v.insert(v.begin(), block, block + 8);
+        v.erase(v.begin(), v.begin() + 8);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(string_append, "containers/inline_string_append", 32)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::inline_string<32> s("GET /");
+        s += "status";
+        s += '?';
+        s.append("id=0123456789ab");
+        embec::bench::do_not_optimize(s);
+    }
+}
+
+EMBEC_BENCHMARK(deque_cycle, "containers/static_deque_push_pop", 0)
+{
+    embec::static_deque<int, 16> d;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        d.push_back(static_cast<int>(i));
+        d.push_front(static_cast<int>(i));
+        d.pop_back();
+        embec::bench::do_not_optimize(d.front());
+        d.pop_front();
+    }
+}
+
+} // namespace
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/crc.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+using embec::crc_engine;
+using embec::crc_strategy;
+namespace catalog = embec::crc_catalog;
+
+constexpr std::size_t frame_size = 4096;
+
+const std::uint8_t* frame()
+{
+    static std::uint8_t data[frame_size];
+    static bool filled = false;
+    if (!filled) {
+        embec::bench::fill_random(data, sizeof(data));
+        filled = true;
+    }
+    return data;
+}
+
+template <typename Spec, crc_strategy Strategy>
+void crc_run(std::uint64_t iterations)
+{
+    const std::uint8_t* data = frame();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(crc_engine<Spec, Strategy>::compute(data, frame_size));
+    }
+}
+
+#define CRC_BENCH(spec, strategy)                                                         \
+    const embec::bench::registrar spec##_##strategy{"crc/" #spec "/" #strategy, frame_size, \
+                                                    crc_run<catalog::spec, crc_strategy::strategy>}
+
+CRC_BENCH(crc8_smbus, bitwise);
+CRC_BENCH(crc8_smbus, nibble);
+CRC_BENCH(crc8_smbus, byte);
+CRC_BENCH(crc8_smbus, slice8);
+CRC_BENCH(crc16_ccitt_false, bitwise);
+CRC_BENCH(crc16_ccitt_false, nibble);
+CRC_BENCH(crc16_ccitt_false, byte);
+CRC_BENCH(crc16_ccitt_false, slice8);
+CRC_BENCH(crc32, bitwise);
+CRC_BENCH(crc32, nibble);
+CRC_BENCH(crc32, byte);
+CRC_BENCH(crc32, slice8);
+CRC_BENCH(crc64_xz, byte);
+CRC_BENCH(crc64_xz, slice8);
+
+} // namespace
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/filter.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+using embec::q15;
+
+constexpr std::size_t block = 1024;
+
+template <typename T>
+const T* samples()
+{
+    static T data[block];
+    static bool ready = false;
+    if (!ready) {
+        embec::bench::fill_random(data, sizeof(data));
+        if constexpr (std::is_floating_point<T>::value) {
+            for (T& x : data) {
+                x = x != x ? T(0) : x / (T(1) + (x < 0 ? -x : x)); // finite, in (-1, 1)
+            }
+        }
+        ready = true;
+    }
+    return data;
+}
+
+EMBEC_BENCHMARK(moving_average_i16, "filter/moving_average_i16_16_1k", block * 2)
+{
+    const std::int16_t* in = samples<std::int16_t>();
+    static std::int16_t out[block];
+    embec::moving_average<std::int16_t, 16> filter;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        filter.process(in, out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(exponential_average_q15, "filter/exponential_average_q15_1k", block * 2)
+{
+    const q15* in = samples<q15>();
+    static q15 out[block];
+    embec::exponential_average<q15> filter(0.05);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        filter.process(in, out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(biquad_q15, "filter/biquad_q15_1k", block * 2)
+{
+    const q15* in = samples<q15>();
+    static q15 out[block];
+    embec::biquad<q15> filter(embec::biquad_coefficients::lowpass(50, 1000));
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        filter.process(in, out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(biquad_float, "filter/biquad_float_1k", block * 4)
+{
+    const float* in = samples<float>();
+    static float out[block];
+    embec::biquad<float> filter(embec::biquad_coefficients::lowpass(50, 1000));
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        filter.process(in, out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(median_i16, "filter/median_i16_5_1k", block * 2)
+{
+    const std::int16_t* in = samples<std::int16_t>();
+    static std::int16_t out[block];
+    embec::median_filter<std::int16_t, 5> filter;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        filter.process(in, out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+} // namespace
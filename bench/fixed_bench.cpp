@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/fixed.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+using embec::q15;
+using embec::q31;
+using angle = embec::fixed<3, 12>;
+
+constexpr std::size_t block = 1024;
+constexpr std::size_t taps = 32;
+
+template <typename T>
+const T* samples()
+{
+    static T data[block + taps];
+    static bool ready = false;
+    if (!ready) {
+        embec::bench::fill_random(data, sizeof(data));
+        ready = true;
+    }
+    return data;
+}
+
+EMBEC_BENCHMARK(dot_q15, "fixed/dot_q15_1k", block * sizeof(q15))
+{
+    const q15* a = samples<q15>();
+    const q15* b = a + taps;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(embec::dot(a, b, block));
+    }
+}
+
+// The same sum without the vector path, for comparison.
+EMBEC_BENCHMARK(dot_q15_scalar, "fixed/dot_q15_scalar_1k", block * sizeof(q15))
+{
+    const q15* a = samples<q15>();
+    const q15* b = a + taps;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        std::int64_t sum = 0;
+        for (std::size_t k = 0; k < block; ++k) {
+            sum += std::int64_t{a[k].raw()} * b[k].raw();
+            embec::bench::do_not_optimize(sum);
+        }
+        embec::bench::do_not_optimize(q15::from_wide(sum, 30));
+    }
+}
+
+EMBEC_BENCHMARK(dot_q31, "fixed/dot_q31_1k", block * sizeof(q31))
+{
+    const q31* a = samples<q31>();
+    const q31* b = a + taps;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(embec::dot(a, b, block));
+    }
+}
+
+EMBEC_BENCHMARK(scale_q15, "fixed/scale_q15_1k", block * sizeof(q15))
+{
+    const q15* in = samples<q15>();
+    static q15 out[block];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::scale(in, q15(0.75), out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(fir_q15, "fixed/fir_q15_32tap_1k", block * sizeof(q15))
+{
+    const q15* in = samples<q15>();
+    static q15 coeffs[taps];
+    static q15 out[block];
+    for (std::size_t k = 0; k < taps; ++k) {
+        coeffs[k] = q15(1.0 / taps);
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::fir(coeffs, taps, in, out, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(sin_q3_12, "fixed/sin", 0)
+{
+    angle x = angle::lowest();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(sin(x));
+        x += angle::epsilon();
+    }
+}
+
+EMBEC_BENCHMARK(atan2_q3_12, "fixed/atan2", 0)
+{
+    angle x(0.7);
+    angle y = angle::lowest();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(atan2(y, x));
+        y += angle::epsilon();
+    }
+}
+
+EMBEC_BENCHMARK(sqrt_q3_12, "fixed/sqrt", 0)
+{
+    angle x = angle::epsilon();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(sqrt(x));
+        x += angle::epsilon();
+    }
+}
+
+EMBEC_BENCHMARK(exp_q3_12, "fixed/exp", 0)
+{
+    angle x(-4);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(exp(x));
+        x += angle::epsilon();
+    }
+}
+
+} // namespace
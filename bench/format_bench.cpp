@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "embec/fixed.hpp"
+#include "embec/format.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t value_count = 1024;
+
+template <typename T>
+const T* values()
+{
+    static T data[value_count];
+    static bool filled = false;
+    if (!filled) {
+        embec::bench::fill_random(data, sizeof(data));
+        filled = true;
+    }
+    return data;
+}
+
+const double* doubles()
+{
+    static double data[value_count];
+    static bool filled = false;
+    if (!filled) {
+        const std::int32_t* raw = values<std::int32_t>();
+        for (std::size_t i = 0; i < value_count; ++i) {
+            data[i] = raw[i] / 1024.0;
+        }
+        filled = true;
+    }
+    return data;
+}
+
+/// Decimal texts of values<std::int32_t>() and doubles(), NUL-separated.
+struct texts {
+    char data[value_count * 24];
+    std::size_t offsets[value_count + 1];
+};
+
+template <typename Format, typename T>
+const texts& make_texts(Format format, const T* source)
+{
+    static texts t;
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < value_count; ++i) {
+        t.offsets[i] = pos;
+        pos += static_cast<std::size_t>(format(t.data + pos, source[i])) + 1;
+    }
+    t.offsets[value_count] = pos;
+    return t;
+}
+
+const texts& int_texts()
+{
+    static const texts& t = make_texts(
+        [](char* out, std::int32_t v) { return std::snprintf(out, 24, "%ld", static_cast<long>(v)); },
+        values<std::int32_t>());
+    return t;
+}
+
+const texts& double_texts()
+{
+    static const texts& t = make_texts(
+        [](char* out, double v) { return std::snprintf(out, 24, "%.3f", v); }, doubles());
+    return t;
+}
+
+EMBEC_BENCHMARK(u32_to_chars, "format/u32_to_chars", 0)
+{
+    const std::uint32_t* v = values<std::uint32_t>();
+    char out[16];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto r = embec::to_chars(out, out + sizeof(out), v[i % value_count]);
+        embec::bench::do_not_optimize(r.ptr);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(u32_snprintf, "format/u32_snprintf", 0)
+{
+    const std::uint32_t* v = values<std::uint32_t>();
+    char out[16];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        int n = std::snprintf(out, sizeof(out), "%lu", static_cast<unsigned long>(v[i % value_count]));
+        embec::bench::do_not_optimize(n);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(i64_to_chars, "format/i64_to_chars", 0)
+{
+    const std::int64_t* v = values<std::int64_t>();
+    char out[24];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto r = embec::to_chars(out, out + sizeof(out), v[i % value_count]);
+        embec::bench::do_not_optimize(r.ptr);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(i64_snprintf, "format/i64_snprintf", 0)
+{
+    const std::int64_t* v = values<std::int64_t>();
+    char out[24];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        int n = std::snprintf(out, sizeof(out), "%lld", static_cast<long long>(v[i % value_count]));
+        embec::bench::do_not_optimize(n);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(double_to_chars, "format/double_f3_to_chars", 0)
+{
+    const double* v = doubles();
+    char out[48];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto r = embec::to_chars(out, out + sizeof(out), v[i % value_count], 3);
+        embec::bench::do_not_optimize(r.ptr);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(double_snprintf, "format/double_f3_snprintf", 0)
+{
+    const double* v = doubles();
+    char out[48];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        int n = std::snprintf(out, sizeof(out), "%.3f", v[i % value_count]);
+        embec::bench::do_not_optimize(n);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(fixed_to_chars, "format/fixed_q16_15_to_chars", 0)
+{
+    using q16_15 = embec::fixed<16, 15>;
+    const std::int32_t* v = values<std::int32_t>();
+    char out[40];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto r = embec::to_chars(out, out + sizeof(out), q16_15::from_raw(v[i % value_count]), 3);
+        embec::bench::do_not_optimize(r.ptr);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(line_format_to, "format/line_format_to", 0)
+{
+    const std::int32_t* v = values<std::int32_t>();
+    const double* d = doubles();
+    char out[64];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const std::size_t k = i % value_count;
+        auto r = embec::format_to(out, EMBEC_FMT("ch{:<2} {:>10.2f} V id={:08X} {}"),
+                                  static_cast<unsigned>(k & 15), d[k], v[k], "ok");
+        embec::bench::do_not_optimize(r.length);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(line_snprintf, "format/line_snprintf", 0)
+{
+    const std::int32_t* v = values<std::int32_t>();
+    const double* d = doubles();
+    char out[64];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const std::size_t k = i % value_count;
+        int n = std::snprintf(out, sizeof(out), "ch%-2u %10.2f V id=%08lX %s",
+                              static_cast<unsigned>(k & 15), d[k],
+                              static_cast<unsigned long>(static_cast<std::uint32_t>(v[k])), "ok");
+        embec::bench::do_not_optimize(n);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(i32_from_chars, "format/i32_from_chars", 0)
+{
+    const texts& t = int_texts();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const std::size_t k = i % value_count;
+        std::int32_t value = 0;
+        embec::from_chars(t.data + t.offsets[k], t.data + t.offsets[k + 1] - 1, value);
+        embec::bench::do_not_optimize(value);
+    }
+}
+
+EMBEC_BENCHMARK(i32_strtol, "format/i32_strtol", 0)
+{
+    const texts& t = int_texts();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        long value = std::strtol(t.data + t.offsets[i % value_count], nullptr, 10);
+        embec::bench::do_not_optimize(value);
+    }
+}
+
+EMBEC_BENCHMARK(double_from_chars, "format/double_from_chars", 0)
+{
+    const texts& t = double_texts();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const std::size_t k = i % value_count;
+        double value = 0;
+        embec::from_chars(t.data + t.offsets[k], t.data + t.offsets[k + 1] - 1, value);
+        embec::bench::do_not_optimize(value);
+    }
+}
+
+EMBEC_BENCHMARK(double_strtod, "format/double_strtod", 0)
+{
+    const texts& t = double_texts();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        double value = std::strtod(t.data + t.offsets[i % value_count], nullptr);
+        embec::bench::do_not_optimize(value);
+    }
+}
+
+} // namespace
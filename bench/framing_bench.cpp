@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/cobs.hpp"
+#include "embec/slip.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t frame_size = 1024;
+
+struct buffers {
+    std::uint8_t frame[frame_size];
+    std::uint8_t cobs[embec::cobs_max_encoded_size(frame_size) + 1];
+    std::size_t cobs_length;
+    std::uint8_t slip[embec::slip_max_encoded_size(frame_size)];
+    std::size_t slip_length;
+    std::uint8_t decoded[frame_size];
+};
+
+// Random payload with roughly one zero / special byte per 100, typical of
+// binary telemetry.
+buffers& data()
+{
+    static buffers b;
+    static bool ready = false;
+    if (!ready) {
+        embec::bench::fill_random(b.frame, sizeof(b.frame));
+        for (std::size_t i = 0; i < frame_size; ++i) {
+            if (b.frame[i] == 0 || b.frame[i] == embec::slip::end || b.frame[i] == embec::slip::esc) {
+                b.frame[i] = 0x55;
+            }
+        }
+        for (std::size_t i = 37; i < frame_size; i += 100) {
+            b.frame[i] = 0;
+            b.frame[i + 50 < frame_size ? i + 50 : i] = embec::slip::end;
+        }
+        b.cobs_length = embec::cobs_encode(b.frame, frame_size, b.cobs, sizeof(b.cobs)).length;
+        b.cobs[b.cobs_length++] = 0;
+        b.slip_length = embec::slip_encode(b.frame, frame_size, b.slip, sizeof(b.slip)).length;
+        ready = true;
+    }
+    return b;
+}
+
+EMBEC_BENCHMARK(cobs_encode, "framing/cobs_encode_1k", frame_size)
+{
+    buffers& b = data();
+    std::uint8_t out[sizeof(b.cobs)];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(embec::cobs_encode(b.frame, frame_size, out, sizeof(out)));
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(cobs_decode, "framing/cobs_decode_1k", frame_size)
+{
+    buffers& b = data();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::cobs_decode(b.cobs, b.cobs_length - 1, b.decoded, frame_size));
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(cobs_stream_decode, "framing/cobs_stream_decode_1k", frame_size)
+{
+    buffers& b = data();
+    embec::cobs_decoder decoder(b.decoded, frame_size);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::frame_status status;
+        decoder.push(b.cobs, b.cobs_length, status);
+        embec::bench::do_not_optimize(status);
+    }
+}
+
+EMBEC_BENCHMARK(cobs_byte_decode, "framing/cobs_bytewise_decode_1k", frame_size)
+{
+    buffers& b = data();
+    embec::cobs_decoder decoder(b.decoded, frame_size);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::frame_status status = embec::frame_status::incomplete;
+        for (std::size_t k = 0; k < b.cobs_length; ++k) {
+            status = decoder.push(b.cobs[k]);
+        }
+        embec::bench::do_not_optimize(status);
+    }
+}
+
+EMBEC_BENCHMARK(slip_encode, "framing/slip_encode_1k", frame_size)
+{
+    buffers& b = data();
+    std::uint8_t out[sizeof(b.slip)];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(embec::slip_encode(b.frame, frame_size, out, sizeof(out)));
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(slip_decode, "framing/slip_decode_1k", frame_size)
+{
+    buffers& b = data();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::slip_decode(b.slip + 1, b.slip_length - 2, b.decoded, frame_size));
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(slip_stream_decode, "framing/slip_stream_decode_1k", frame_size)
+{
+    buffers& b = data();
+    embec::slip_decoder decoder(b.decoded, frame_size);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::frame_status status;
+        decoder.push(b.slip, b.slip_length, status);
+        decoder.push(b.slip + 1, b.slip_length - 1, status);
+        embec::bench::do_not_optimize(status);
+    }
+}
+
+} // namespace
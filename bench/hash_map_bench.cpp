@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/hash_map.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// Lookups of present keys (parameter IDs) in tables of N entries, against
+// the linear search over an array that such tables usually start out as.
+
+constexpr std::uint32_t key_of(std::size_t i)
+{
+    return static_cast<std::uint32_t>(i * 2654435761u) >> 8;
+}
+
+template <std::size_t N>
+struct entries {
+    embec::map_entry<std::uint32_t, std::uint32_t> data[N];
+};
+
+template <std::size_t N>
+constexpr entries<N> make_entries()
+{
+    entries<N> e{};
+    for (std::size_t i = 0; i < N; ++i) {
+        e.data[i] = {key_of(i), static_cast<std::uint32_t>(i)};
+    }
+    return e;
+}
+
+template <std::size_t N>
+constexpr entries<N> table_entries = make_entries<N>();
+
+template <std::size_t N>
+std::uint32_t linear_find(std::uint32_t key)
+{
+    for (const auto& e : table_entries<N>.data) {
+        if (e.first == key) {
+            return e.second;
+        }
+    }
+    return 0;
+}
+
+// Visits the keys in a scrambled order so that lookups are not predictable.
+template <std::size_t N>
+std::uint32_t probe_key(std::uint64_t i)
+{
+    return key_of((i * 40503u) % N);
+}
+
+template <std::size_t N>
+void bench_linear(std::uint64_t iterations)
+{
+    std::uint32_t sum = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        sum += linear_find<N>(probe_key<N>(i));
+    }
+    embec::bench::do_not_optimize(sum);
+}
+
+template <std::size_t N>
+void bench_hash_map(std::uint64_t iterations)
+{
+    static embec::hash_map<std::uint32_t, std::uint32_t, N> map;
+    if (map.empty()) {
+        for (const auto& e : table_entries<N>.data) {
+            map.try_emplace(e.first, e.second);
+        }
+    }
+    std::uint32_t sum = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        sum += map.find(probe_key<N>(i))->second;
+    }
+    embec::bench::do_not_optimize(sum);
+}
+
+template <std::size_t N>
+void bench_perfect(std::uint64_t iterations)
+{
+    static constexpr embec::perfect_hash_map<std::uint32_t, std::uint32_t, N> map(
+        table_entries<N>.data);
+    std::uint32_t sum = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        sum += *map.find(probe_key<N>(i));
+    }
+    embec::bench::do_not_optimize(sum);
+}
+
+template <std::size_t N>
+void bench_miss(std::uint64_t iterations)
+{
+    static embec::hash_map<std::uint32_t, std::uint32_t, N> map;
+    if (map.empty()) {
+        for (const auto& e : table_entries<N>.data) {
+            map.try_emplace(e.first, e.second);
+        }
+    }
+    std::size_t hits = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        hits += map.contains(probe_key<N>(i) + 1);
+    }
+    embec::bench::do_not_optimize(hits);
+}
+
+const embec::bench::registrar registrars[] = {
+    {"hash_map/linear_find_16", 0, bench_linear<16>},
+    {"hash_map/linear_find_32", 0, bench_linear<32>},
+    {"hash_map/linear_find_128", 0, bench_linear<128>},
+    {"hash_map/linear_find_1024", 0, bench_linear<1024>},
+    {"hash_map/find_16", 0, bench_hash_map<16>},
+    {"hash_map/find_32", 0, bench_hash_map<32>},
+    {"hash_map/find_128", 0, bench_hash_map<128>},
+    {"hash_map/find_1024", 0, bench_hash_map<1024>},
+    {"hash_map/find_miss_1024", 0, bench_miss<1024>},
+    {"hash_map/perfect_find_32", 0, bench_perfect<32>},
+    {"hash_map/perfect_find_1024", 0, bench_perfect<1024>},
+};
+
+} // namespace
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/histogram.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t batch = 256;
+
+embec::histogram<> latencies;
+std::uint32_t samples[batch];
+
+const bool samples_ready = [] {
+    embec::bench::fill_random(samples, sizeof(samples));
+    for (auto& s : samples) {
+        s >>= s & 31; // spread over all magnitudes, like latencies with a tail
+    }
+    return true;
+}();
+
+EMBEC_BENCHMARK(record, "histogram/record_256", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        for (std::uint32_t s : samples) {
+            latencies.record(s);
+        }
+    }
+}
+
+EMBEC_BENCHMARK(snapshot_percentiles, "histogram/snapshot_p50_p99_p999", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const auto s = latencies.snapshot();
+        embec::bench::do_not_optimize(s.percentile(50));
+        embec::bench::do_not_optimize(s.percentile(99));
+        embec::bench::do_not_optimize(s.percentile(99.9));
+    }
+}
+
+} // namespace
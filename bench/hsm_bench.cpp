@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/hsm.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// A small protocol handler: link { idle, session { auth, data { rx, tx } } }.
+enum class st : std::uint8_t { idle, session, auth, data, rx, tx };
+enum class ev : std::uint8_t { connect, login, send, sent, byte, drop };
+
+struct handler {
+    std::uint32_t bytes = 0;
+    std::uint32_t entries = 0;
+
+    static void count_byte(handler& h) { ++h.bytes; }
+    static void entered(handler& h) { ++h.entries; }
+    static bool always(handler&) { return true; }
+};
+
+struct handler_def {
+    using context = handler;
+    using event = ev;
+    static constexpr st initial = st::idle;
+    using states = embec::hsm_states<
+        embec::hsm_state<st::idle>,
+        embec::hsm_state<st::session, embec::hsm_none, st::auth>,
+        embec::hsm_state<st::auth, st::session>,
+        embec::hsm_state<st::data, st::session, st::rx>,
+        embec::hsm_state<st::rx, st::data>,
+        embec::hsm_state<st::tx, st::data>>;
+    using rules = embec::hsm_rules<
+        embec::hsm_entry<st::session, &handler::entered>,
+        embec::hsm_entry<st::data, &handler::entered>,
+        embec::hsm_entry<st::rx, &handler::entered>,
+        embec::hsm_entry<st::tx, &handler::entered>,
+        embec::hsm_transition<st::idle, ev::connect, st::session>,
+        embec::hsm_transition<st::auth, ev::login, st::data, nullptr, &handler::always>,
+        embec::hsm_transition<st::rx, ev::send, st::tx>,
+        embec::hsm_transition<st::tx, ev::sent, st::rx>,
+        embec::hsm_internal<st::data, ev::byte, &handler::count_byte>,
+        embec::hsm_transition<st::session, ev::drop, st::idle>>;
+};
+
+EMBEC_BENCHMARK(internal, "hsm/internal_transition", 0)
+{
+    handler h;
+    embec::hsm<handler_def> machine(h);
+    machine.start();
+    machine.dispatch(ev::connect);
+    machine.dispatch(ev::login);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        machine.dispatch(ev::byte);
+    }
+    embec::bench::do_not_optimize(h.bytes);
+}
+
+EMBEC_BENCHMARK(siblings, "hsm/sibling_transition", 0)
+{
+    handler h;
+    embec::hsm<handler_def> machine(h);
+    machine.start();
+    machine.dispatch(ev::connect);
+    machine.dispatch(ev::login);
+    for (std::uint64_t i = 0; i < iterations; i += 2) {
+        machine.dispatch(ev::send);
+        machine.dispatch(ev::sent);
+    }
+    embec::bench::do_not_optimize(h.entries);
+}
+
+// drop exits three levels; connect and login enter three.
+EMBEC_BENCHMARK(nested, "hsm/nested_transition", 0)
+{
+    handler h;
+    embec::hsm<handler_def> machine(h);
+    machine.start();
+    for (std::uint64_t i = 0; i < iterations; i += 3) {
+        machine.dispatch(ev::connect);
+        machine.dispatch(ev::login);
+        machine.dispatch(ev::drop);
+    }
+    embec::bench::do_not_optimize(h.entries);
+}
+
+EMBEC_BENCHMARK(timed, "hsm/internal_transition_timed", 0)
+{
+    handler h;
+    embec::hsm<handler_def, 8, embec::hsm_timing_monitor<handler_def>> machine(h);
+    machine.start();
+    machine.dispatch(ev::connect);
+    machine.dispatch(ev::login);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        machine.dispatch(ev::byte);
+    }
+    embec::bench::do_not_optimize(machine.monitor()[8].max);
+}
+
+} // namespace
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <list>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "embec/intrusive.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// Event-path workloads on 1024 live elements, against the allocating
+// standard containers they replace. One operation removes an element and
+// inserts it again with a new key. Each benchmark has its own elements, as
+// the containers stay populated between runs.
+
+constexpr std::size_t element_count = 1024;
+
+struct event : embec::list_hook<>, embec::rb_hook<>, embec::heap_hook<> {
+    std::uint32_t key;
+    bool operator<(const event& other) const { return key < other.key; }
+};
+
+std::uint32_t next_key(std::uint64_t i)
+{
+    return static_cast<std::uint32_t>(i * 2654435761u) >> 12;
+}
+
+EMBEC_BENCHMARK(rb_tree, "intrusive/rb_tree_reinsert_1024", 0)
+{
+    static event events[element_count];
+    static embec::rb_tree<event> tree;
+    if (tree.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            events[k].key = next_key(k);
+            tree.insert(events[k]);
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        event& e = events[(i * 7) % element_count];
+        tree.erase(e);
+        e.key = next_key(i);
+        tree.insert(e);
+    }
+    embec::bench::do_not_optimize(tree.front().key);
+}
+
+EMBEC_BENCHMARK(std_multiset, "intrusive/std_multiset_reinsert_1024", 0)
+{
+    static std::multiset<std::uint32_t> set;
+    static std::vector<std::multiset<std::uint32_t>::iterator> where(element_count);
+    if (set.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            where[k] = set.insert(next_key(k));
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const std::size_t k = (i * 7) % element_count;
+        set.erase(where[k]);
+        where[k] = set.insert(next_key(i));
+    }
+    embec::bench::do_not_optimize(*set.begin());
+}
+
+// Timer-queue pattern: take the earliest element and requeue it later.
+EMBEC_BENCHMARK(pairing_heap, "intrusive/pairing_heap_pop_push_1024", 0)
+{
+    static event events[element_count];
+    static embec::pairing_heap<event> heap;
+    if (heap.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            events[k].key = next_key(k);
+            heap.push(events[k]);
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        event& e = heap.pop();
+        e.key += next_key(i) >> 8;
+        heap.push(e);
+    }
+    embec::bench::do_not_optimize(heap.top().key);
+}
+
+EMBEC_BENCHMARK(rb_tree_queue, "intrusive/rb_tree_pop_push_1024", 0)
+{
+    static event events[element_count];
+    static embec::rb_tree<event> tree;
+    if (tree.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            events[k].key = next_key(k);
+            tree.insert(events[k]);
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        event& e = tree.pop_front();
+        e.key += next_key(i) >> 8;
+        tree.insert(e);
+    }
+    embec::bench::do_not_optimize(tree.front().key);
+}
+
+// Cancelling and rearming an arbitrary timer, which a std::priority_queue
+// cannot do without lazy deletion.
+EMBEC_BENCHMARK(pairing_heap_cancel, "intrusive/pairing_heap_erase_push_1024", 0)
+{
+    static event events[element_count];
+    static embec::pairing_heap<event> heap;
+    if (heap.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            events[k].key = next_key(k);
+            heap.push(events[k]);
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        event& e = events[(i * 7) % element_count];
+        heap.erase(e);
+        e.key = next_key(i);
+        heap.push(e);
+        if ((i & 15) == 0) {
+            // Keep the root's child list from growing without bound.
+            event& top = heap.pop();
+            heap.push(top);
+        }
+    }
+    embec::bench::do_not_optimize(heap.top().key);
+}
+
+EMBEC_BENCHMARK(priority_queue, "intrusive/std_priority_queue_pop_push_1024", 0)
+{
+    static event events[element_count];
+    using entry = std::pair<std::uint32_t, event*>;
+    static std::priority_queue<entry, std::vector<entry>, std::greater<>> queue;
+    if (queue.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            events[k].key = next_key(k);
+            queue.push({events[k].key, &events[k]});
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        event* e = queue.top().second;
+        queue.pop();
+        e->key += next_key(i) >> 8;
+        queue.push({e->key, e});
+    }
+    embec::bench::do_not_optimize(queue.top().first);
+}
+
+EMBEC_BENCHMARK(list, "intrusive/list_unlink_push_1024", 0)
+{
+    static event events[element_count];
+    static embec::intrusive_list<event> list;
+    if (list.empty()) {
+        for (event& e : events) {
+            list.push_back(e);
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        event& e = events[(i * 7) % element_count];
+        e.embec::list_hook<>::unlink();
+        list.push_back(e);
+    }
+    embec::bench::do_not_optimize(list.front().key);
+}
+
+EMBEC_BENCHMARK(std_list, "intrusive/std_list_erase_push_1024", 0)
+{
+    static event events[element_count];
+    static std::list<event*> list;
+    static std::vector<std::list<event*>::iterator> where(element_count);
+    if (list.empty()) {
+        for (std::size_t k = 0; k < element_count; ++k) {
+            where[k] = list.insert(list.end(), &events[k]);
+        }
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        const std::size_t k = (i * 7) % element_count;
+        list.erase(where[k]);
+        where[k] = list.insert(list.end(), &events[k]);
+    }
+    embec::bench::do_not_optimize(list.front());
+}
+
+} // namespace
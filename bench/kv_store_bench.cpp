@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/flash_sim.hpp"
+#include "embec/kv_store.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// 64 KiB of simulated flash in 4 KiB sectors, so the figures are the CPU
+// cost of the store (index, CRC, record assembly, collection) on top of
+// memcpy-speed flash.
+using flash_type = embec::flash_sim<4096, 16, 8>;
+using store_type = embec::kv_store<flash_type, 256>;
+
+constexpr std::size_t key_count = 64;
+constexpr std::size_t value_size = 16;
+
+struct fixture {
+    flash_type flash;
+    store_type store{flash};
+
+    // @p static_keys keys of 200 bytes that are never rewritten make the
+    // collector copy about half a sector for every sector it frees.
+    explicit fixture(std::size_t static_keys)
+    {
+        flash.open();
+        store.mount();
+        std::uint8_t value[200];
+        embec::bench::fill_random(value, sizeof(value));
+        for (std::size_t k = 0; k < static_keys; ++k) {
+            store.put(static_cast<std::uint16_t>(1000 + k), value, sizeof(value));
+        }
+        for (std::size_t k = 0; k < key_count; ++k) {
+            store.put(static_cast<std::uint16_t>(k), value, value_size);
+        }
+    }
+};
+
+void bench_put(fixture& f, std::uint64_t iterations)
+{
+    std::uint8_t value[value_size];
+    embec::bench::fill_random(value, sizeof(value));
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        value[0] = static_cast<std::uint8_t>(i);
+        f.store.put(static_cast<std::uint16_t>(i % key_count), value, sizeof(value));
+    }
+}
+
+EMBEC_BENCHMARK(put, "kv_store/put_16", value_size)
+{
+    static fixture f(0);
+    bench_put(f, iterations);
+}
+
+EMBEC_BENCHMARK(put_loaded, "kv_store/put_16_half_full", value_size)
+{
+    static fixture f(100);
+    bench_put(f, iterations);
+}
+
+EMBEC_BENCHMARK(get, "kv_store/get_16", value_size)
+{
+    static fixture f(0);
+    std::uint8_t value[value_size];
+    std::size_t total = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        total += f.store.get(static_cast<std::uint16_t>((i * 37) % key_count), value,
+                             sizeof(value)).length;
+    }
+    embec::bench::do_not_optimize(total);
+}
+
+// Replaying the log: one operation mounts a store holding 164 keys.
+EMBEC_BENCHMARK(mount, "kv_store/mount_16_sectors", 0)
+{
+    static fixture f(100);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        f.store.mount();
+    }
+    embec::bench::do_not_optimize(f.store.size());
+}
+
+} // namespace
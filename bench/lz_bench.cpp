@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstdio>
+#include <cstring>
+
+#include "embec/lz.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t corpus_size = 4096;
+
+struct corpus {
+    std::uint8_t data[corpus_size];
+    std::uint8_t compressed[embec::lz_max_compressed_size(corpus_size)];
+    std::size_t compressed_length;
+};
+
+// Sensor log as CSV text: timestamp, two slowly drifting readings and a
+// status word.
+const corpus& csv_corpus()
+{
+    static corpus c;
+    static bool ready = false;
+    if (!ready) {
+        std::uint32_t noise = 0;
+        embec::bench::fill_random(&noise, sizeof(noise), 11);
+        std::size_t at = 0;
+        for (unsigned i = 0; at < corpus_size; ++i) {
+            noise = noise * 1103515245u + 12345u;
+            char line[64];
+            const int n = std::snprintf(line, sizeof(line), "%u,%d.%u,%u.%u,%s\n", 1700000000 + i,
+                                        21 + static_cast<int>(i / 90), (noise >> 16) % 10,
+                                        40 + i / 150, (noise >> 20) % 10,
+                                        i % 50 == 0 ? "WARN" : "OK");
+            const std::size_t take = corpus_size - at < static_cast<std::size_t>(n)
+                                         ? corpus_size - at
+                                         : static_cast<std::size_t>(n);
+            std::memcpy(c.data + at, line, take);
+            at += take;
+        }
+        ready = true;
+    }
+    return c;
+}
+
+// Binary 16-byte records: timestamp, three accelerometer axes with small
+// noise around a resting value, battery voltage and flags.
+const corpus& binary_corpus()
+{
+    static corpus c;
+    static bool ready = false;
+    if (!ready) {
+        std::uint8_t noise[corpus_size / 16 * 3];
+        embec::bench::fill_random(noise, sizeof(noise), 23);
+        for (std::size_t r = 0; r < corpus_size / 16; ++r) {
+            std::uint8_t* p = c.data + 16 * r;
+            const auto time = static_cast<std::uint32_t>(100 * r);
+            std::memcpy(p, &time, 4);
+            const std::int16_t axes[3] = {static_cast<std::int16_t>(12 + noise[3 * r] % 4),
+                                          static_cast<std::int16_t>(-7 + noise[3 * r + 1] % 4),
+                                          static_cast<std::int16_t>(1000 + noise[3 * r + 2] % 4)};
+            std::memcpy(p + 4, axes, 6);
+            const auto battery = static_cast<std::uint16_t>(3700 - r / 32);
+            std::memcpy(p + 10, &battery, 2);
+            p[12] = r % 64 == 0 ? 0x81 : 0x01;
+            p[13] = p[14] = p[15] = 0;
+        }
+        ready = true;
+    }
+    return c;
+}
+
+const corpus& random_corpus()
+{
+    static corpus c;
+    static bool ready = false;
+    if (!ready) {
+        embec::bench::fill_random(c.data, sizeof(c.data), 37);
+        ready = true;
+    }
+    return c;
+}
+
+template <typename Encoder>
+void compress(const corpus& c, std::uint64_t iterations)
+{
+    static Encoder encoder;
+    std::uint8_t out[embec::lz_max_compressed_size(corpus_size)];
+    std::size_t length = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        length = embec::lz_compress(encoder, c.data, corpus_size, out, sizeof(out)).length;
+        embec::bench::do_not_optimize(out[0]);
+    }
+    char text[48];
+    std::snprintf(text, sizeof(text), "ratio %.2f (%zu B)",
+                  static_cast<double>(corpus_size) / static_cast<double>(length), length);
+    embec::bench::note() = text;
+}
+
+template <typename Encoder, typename Decoder>
+void decompress(const corpus& c, std::uint64_t iterations)
+{
+    static Encoder encoder;
+    static Decoder decoder;
+    std::uint8_t packed[embec::lz_max_compressed_size(corpus_size)];
+    const std::size_t length =
+        embec::lz_compress(encoder, c.data, corpus_size, packed, sizeof(packed)).length;
+    std::uint8_t out[corpus_size];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::lz_decompress(decoder, packed, length, out, sizeof(out)).length);
+        embec::bench::clobber_memory();
+    }
+}
+
+// 256-byte window: about 2.3 KiB of encoder state, 300 bytes of decoder.
+using small_encoder = embec::lz_encoder<8, 4>;
+using small_decoder = embec::lz_decoder<8, 4>;
+// 1 KiB window: about 7 KiB of encoder state.
+using medium_encoder = embec::lz_encoder<10, 5, 10, 8>;
+// Single-candidate match finder, no chain table.
+using fast_encoder = embec::lz_encoder<8, 4, 8, 1>;
+
+EMBEC_BENCHMARK(compress_csv, "lz/compress_csv_w256", corpus_size)
+{
+    compress<small_encoder>(csv_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(compress_csv_fast, "lz/compress_csv_w256_nochain", corpus_size)
+{
+    compress<fast_encoder>(csv_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(compress_csv_medium, "lz/compress_csv_w1k", corpus_size)
+{
+    compress<medium_encoder>(csv_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(compress_binary, "lz/compress_records_w256", corpus_size)
+{
+    compress<small_encoder>(binary_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(compress_binary_medium, "lz/compress_records_w1k", corpus_size)
+{
+    compress<medium_encoder>(binary_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(compress_random, "lz/compress_random_w256", corpus_size)
+{
+    compress<small_encoder>(random_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(decompress_csv, "lz/decompress_csv_w256", corpus_size)
+{
+    decompress<small_encoder, small_decoder>(csv_corpus(), iterations);
+}
+
+EMBEC_BENCHMARK(decompress_binary, "lz/decompress_records_w256", corpus_size)
+{
+    decompress<small_encoder, small_decoder>(binary_corpus(), iterations);
+}
+
+} // namespace
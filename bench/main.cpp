@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Benchmark runner.
+//
+// Usage: embec_bench [--output FILE] [--filter TEXT] [--baseline FILE]
+//                    [--tolerance PERCENT]
+//
+// Every registered benchmark is calibrated to run for at least
+// min_run_seconds, timed over several repetitions with both the wall clock
+// and embec::cycle_counter, and run once more on a painted stack to find its
+// stack high-water mark. Results are printed to stdout and written as CSV to
+// the output file (bench_output.txt by default).
+//
+// With --baseline, ns/op of each benchmark is compared with a previous
+// output file and the runner exits with status 2 if any benchmark got slower
+// by more than the tolerance (default 10 %).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <ucontext.h>
+
+#include "embec/cycle_counter.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr double min_run_seconds = 0.05;
+constexpr int repetitions = 5;
+constexpr std::size_t probe_stack_size = 256 * 1024;
+constexpr unsigned char stack_paint = 0xa5;
+
+struct timing {
+    double seconds;
+    embec::cycles_t cycles;
+};
+
+timing time_run(embec::bench::bench_fn fn, std::uint64_t iterations)
+{
+    const auto start = clock_type::now();
+    const embec::cycles_t start_cycles = embec::cycle_counter::now();
+    fn(iterations);
+    const embec::cycles_t stop_cycles = embec::cycle_counter::now();
+    const auto stop = clock_type::now();
+    return {std::chrono::duration<double>(stop - start).count(),
+            static_cast<embec::cycles_t>(stop_cycles - start_cycles)};
+}
+
+// Stack probing: the benchmark runs once on a private stack that is filled
+// with a known pattern beforehand; the lowest overwritten byte marks the
+// deepest point reached (stacks grow downwards on all supported hosts).
+
+ucontext_t probe_caller;
+ucontext_t probe_context;
+embec::bench::bench_fn probe_fn;
+
+void probe_trampoline()
+{
+    probe_fn(1);
+}
+
+void probe_empty(std::uint64_t) {}
+
+std::size_t stack_depth(embec::bench::bench_fn fn)
+{
+    static unsigned char stack[probe_stack_size];
+    std::memset(stack, stack_paint, sizeof(stack));
+    probe_fn = fn;
+    getcontext(&probe_context);
+    probe_context.uc_stack.ss_sp = stack;
+    probe_context.uc_stack.ss_size = sizeof(stack);
+    probe_context.uc_link = &probe_caller;
+    makecontext(&probe_context, probe_trampoline, 0);
+    swapcontext(&probe_caller, &probe_context);
+
+    std::size_t untouched = 0;
+    while (untouched < sizeof(stack) && stack[untouched] == stack_paint) {
+        ++untouched;
+    }
+    return sizeof(stack) - untouched;
+}
+
+std::map<std::string, double> load_baseline(const char* path)
+{
+    std::map<std::string, double> baseline;
+    std::FILE* in = std::fopen(path, "r");
+    if (!in) {
+        std::perror(path);
+        return baseline;
+    }
+    char line[512];
+    bool header = true;
+    while (std::fgets(line, sizeof(line), in)) {
+        if (header) {
+            header = false;
+            continue;
+        }
+        char* comma = std::strchr(line, ',');
+        if (!comma) {
+            continue;
+        }
+        *comma = '\0';
+        // Columns: benchmark, iterations, ns_per_op, ...
+        char* iterations_end = std::strchr(comma + 1, ',');
+        if (iterations_end) {
+            baseline[line] = std::strtod(iterations_end + 1, nullptr);
+        }
+    }
+    std::fclose(in);
+    return baseline;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* output_path = "bench_output.txt";
+    const char* filter = nullptr;
+    const char* baseline_path = nullptr;
+    double tolerance = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--output") && has_value) {
+            output_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--filter") && has_value) {
+            filter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--baseline") && has_value) {
+            baseline_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--tolerance") && has_value) {
+            tolerance = std::strtod(argv[++i], nullptr);
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--output FILE] [--filter TEXT] [--baseline FILE] "
+                         "[--tolerance PERCENT]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    const auto baseline =
+        baseline_path ? load_baseline(baseline_path) : std::map<std::string, double>{};
+
+    auto benchmarks = embec::bench::registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+              [](const auto& a, const auto& b) { return std::strcmp(a.name, b.name) < 0; });
+
+    std::FILE* out = std::fopen(output_path, "w");
+    if (!out) {
+        std::perror(output_path);
+        return 1;
+    }
+
+    embec::cycle_counter::enable();
+    const std::size_t stack_overhead = stack_depth(probe_empty);
+
+    std::fprintf(out, "benchmark,iterations,ns_per_op,cycles_per_op,bytes_per_op,"
+                      "cycles_per_byte,mb_per_s,stack_bytes,counter,note\n");
+    std::printf("cycle counter: %s\n", embec::cycle_counter::name());
+    std::printf("%-44s %12s %12s %12s %9s %9s %7s\n", "benchmark", "iterations", "ns/op",
+                "cycles/op", "cyc/B", "MB/s", "stack");
+
+    int regressions = 0;
+    for (const auto& b : benchmarks) {
+        if (filter && !std::strstr(b.name, filter)) {
+            continue;
+        }
+        embec::bench::note().clear();
+        std::uint64_t iterations = 1;
+        while (time_run(b.fn, iterations).seconds < min_run_seconds &&
+               iterations < (1ull << 40)) {
+            iterations *= 2;
+        }
+        timing best = time_run(b.fn, iterations);
+        for (int i = 1; i < repetitions; ++i) {
+            const timing t = time_run(b.fn, iterations);
+            best.seconds = std::min(best.seconds, t.seconds);
+            best.cycles = std::min(best.cycles, t.cycles);
+        }
+        const std::size_t depth = stack_depth(b.fn);
+        const std::size_t stack_bytes = depth > stack_overhead ? depth - stack_overhead : 0;
+
+        const double n = static_cast<double>(iterations);
+        const double ns_per_op = best.seconds * 1e9 / n;
+        const double cycles_per_op = static_cast<double>(best.cycles) / n;
+        const double bytes = static_cast<double>(b.bytes_per_op);
+        const double cycles_per_byte = b.bytes_per_op ? cycles_per_op / bytes : 0.0;
+        const double mb_per_s = b.bytes_per_op ? bytes * 1e3 / ns_per_op : 0.0;
+
+        std::fprintf(out, "%s,%llu,%.3f,%.1f,%zu,%.3f,%.2f,%zu,%s,%s\n", b.name,
+                     static_cast<unsigned long long>(iterations), ns_per_op, cycles_per_op,
+                     b.bytes_per_op, cycles_per_byte, mb_per_s, stack_bytes,
+                     embec::cycle_counter::name(), embec::bench::note().c_str());
+        std::printf("%-44s %12llu %12.3f %12.1f %9.3f %9.2f %7zu", b.name,
+                    static_cast<unsigned long long>(iterations), ns_per_op, cycles_per_op,
+                    cycles_per_byte, mb_per_s, stack_bytes);
+        if (!embec::bench::note().empty()) {
+            std::printf("  %s", embec::bench::note().c_str());
+        }
+
+        const auto previous = baseline.find(b.name);
+        if (previous != baseline.end() && previous->second > 0.0) {
+            const double change = (ns_per_op / previous->second - 1.0) * 100.0;
+            std::printf("  %+6.1f%%", change);
+            if (change > tolerance) {
+                std::printf(" REGRESSION");
+                ++regressions;
+            }
+        }
+        std::printf("\n");
+    }
+
+    std::fclose(out);
+    if (regressions) {
+        std::printf("%d benchmark(s) regressed by more than %.1f%%\n", regressions, tolerance);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "embec/mpmc_queue.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// Scaling: each of T threads alternately pushes and pops, so the indices
+// and slots are contended by all of them. ns/op is per push/pop pair over
+// all threads, i.e. inverse throughput; thread start-up is amortised by the
+// iteration calibration. Results above the host's core count measure
+// oversubscription rather than scaling.
+
+embec::mpmc_queue<std::uint64_t, 1024> queue;
+
+template <typename Queue>
+void run_threads(Queue& q, unsigned threads, std::uint64_t iterations)
+{
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        const std::uint64_t share = iterations / threads + (t < iterations % threads);
+        workers.emplace_back([&q, share] {
+            std::uint64_t value = 0;
+            for (std::uint64_t i = 0; i < share; ++i) {
+                while (!q.push(i)) {
+                    std::this_thread::yield();
+                }
+                while (!q.pop(value)) {
+                    std::this_thread::yield();
+                }
+                embec::bench::do_not_optimize(value);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+EMBEC_BENCHMARK(pairs_1, "mpmc_queue/push_pop_1_thread", 0)
+{
+    run_threads(queue, 1, iterations);
+}
+
+EMBEC_BENCHMARK(pairs_2, "mpmc_queue/push_pop_2_threads", 0)
+{
+    run_threads(queue, 2, iterations);
+}
+
+EMBEC_BENCHMARK(pairs_4, "mpmc_queue/push_pop_4_threads", 0)
+{
+    run_threads(queue, 4, iterations);
+}
+
+EMBEC_BENCHMARK(pairs_8, "mpmc_queue/push_pop_8_threads", 0)
+{
+    run_threads(queue, 8, iterations);
+}
+
+EMBEC_BENCHMARK(batch_16, "mpmc_queue/batch_push_pop_16", 16 * sizeof(std::uint64_t))
+{
+    std::uint64_t buf[16] = {};
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        queue.push(buf, 16);
+        queue.pop(buf, 16);
+        embec::bench::clobber_memory();
+    }
+}
+
+// Reference point: a mutex-protected deque with the same interface.
+struct locked_queue {
+    std::mutex mutex;
+    std::deque<std::uint64_t> items;
+
+    bool push(std::uint64_t v)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(v);
+        return true;
+    }
+
+    bool pop(std::uint64_t& v)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        v = items.front();
+        items.pop_front();
+        return true;
+    }
+};
+
+locked_queue mutex_queue;
+
+EMBEC_BENCHMARK(mutex_1, "mpmc_queue/mutex_push_pop_1_thread", 0)
+{
+    run_threads(mutex_queue, 1, iterations);
+}
+
+EMBEC_BENCHMARK(mutex_4, "mpmc_queue/mutex_push_pop_4_threads", 0)
+{
+    run_threads(mutex_queue, 4, iterations);
+}
+
+} // namespace
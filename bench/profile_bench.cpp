@@ -0,0 +1,28 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/profile.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+EMBEC_PROFILE_COUNTER(bench_events);
+EMBEC_PROFILE_HISTOGRAM(bench_scope);
+
+// Cost of instrumentation left in a hot path.
+EMBEC_BENCHMARK(count, "profile/count", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        EMBEC_PROFILE_COUNT(bench_events);
+    }
+}
+
+EMBEC_BENCHMARK(scope, "profile/scope", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        EMBEC_PROFILE_SCOPE(bench_scope);
+        embec::bench::clobber_memory();
+    }
+}
+
+} // namespace
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/scheduler.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// Each benchmark owns a scheduler whose tasks run forever, so one
+// iteration is one run_once(): pick the next task, resume it, and let it
+// suspend again.
+
+std::uint32_t counter;
+
+struct pt_yielder : embec::protothread<pt_yielder> {
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        for (;;) {
+            ++counter;
+            EMBEC_PT_YIELD();
+        }
+        EMBEC_PT_END();
+    }
+};
+
+embec::scheduler pt_yield_sched;
+pt_yielder pt_yield_tasks[2];
+
+EMBEC_BENCHMARK(protothread_yield, "scheduler/protothread_yield_switch", 0)
+{
+    if (pt_yield_tasks[0].state() == embec::task::status::idle) {
+        pt_yield_sched.spawn(pt_yield_tasks[0], 4);
+        pt_yield_sched.spawn(pt_yield_tasks[1], 4);
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        pt_yield_sched.run_once();
+    }
+    embec::bench::do_not_optimize(counter);
+}
+
+// A message bounces between two tasks through two one-slot channels, so
+// every switch also blocks one task and wakes the other.
+embec::channel<std::uint32_t, 1> ping;
+embec::channel<std::uint32_t, 1> pong;
+
+struct pt_pinger : embec::protothread<pt_pinger> {
+    std::uint32_t value = 0;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        for (;;) {
+            EMBEC_PT_SEND(ping, value + 1);
+            EMBEC_PT_RECEIVE(pong, value);
+        }
+        EMBEC_PT_END();
+    }
+};
+
+struct pt_ponger : embec::protothread<pt_ponger> {
+    std::uint32_t value = 0;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        for (;;) {
+            EMBEC_PT_RECEIVE(ping, value);
+            EMBEC_PT_SEND(pong, value);
+        }
+        EMBEC_PT_END();
+    }
+};
+
+embec::scheduler pt_channel_sched;
+pt_pinger pt_ping_task;
+pt_ponger pt_pong_task;
+
+EMBEC_BENCHMARK(protothread_channel, "scheduler/protothread_channel_switch", 0)
+{
+    if (pt_ping_task.state() == embec::task::status::idle) {
+        pt_channel_sched.spawn(pt_ping_task, 4);
+        pt_channel_sched.spawn(pt_pong_task, 4);
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        pt_channel_sched.run_once();
+    }
+    embec::bench::do_not_optimize(pt_ping_task.value);
+}
+
+#if EMBEC_HAS_COROUTINES
+
+embec::coroutine co_yielder(embec::coroutine_storage&)
+{
+    for (;;) {
+        ++counter;
+        co_await embec::yield();
+    }
+}
+
+embec::scheduler co_yield_sched;
+embec::task_storage<256> co_yield_storage[2];
+
+EMBEC_BENCHMARK(coroutine_yield, "scheduler/coroutine_yield_switch", 0)
+{
+    if (!co_yield_storage[0].busy()) {
+        co_yield_sched.spawn(co_yielder(co_yield_storage[0]), 4);
+        co_yield_sched.spawn(co_yielder(co_yield_storage[1]), 4);
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        co_yield_sched.run_once();
+    }
+    embec::bench::do_not_optimize(counter);
+}
+
+embec::channel<std::uint32_t, 1> co_ping;
+embec::channel<std::uint32_t, 1> co_pong;
+
+embec::coroutine co_pinger(embec::coroutine_storage&)
+{
+    std::uint32_t value = 0;
+    for (;;) {
+        co_await co_ping.send(value + 1);
+        value = co_await co_pong.receive();
+    }
+}
+
+embec::coroutine co_ponger(embec::coroutine_storage&)
+{
+    for (;;) {
+        const std::uint32_t value = co_await co_ping.receive();
+        co_await co_pong.send(value);
+    }
+}
+
+embec::scheduler co_channel_sched;
+embec::task_storage<256> co_channel_storage[2];
+
+EMBEC_BENCHMARK(coroutine_channel, "scheduler/coroutine_channel_switch", 0)
+{
+    if (!co_channel_storage[0].busy()) {
+        co_channel_sched.spawn(co_pinger(co_channel_storage[0]), 4);
+        co_channel_sched.spawn(co_ponger(co_channel_storage[1]), 4);
+    }
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        co_channel_sched.run_once();
+    }
+}
+
+#endif // EMBEC_HAS_COROUTINES
+
+} // namespace
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "embec/snapshot.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+// A control-loop sized sensor state: 16 floats plus a timestamp.
+struct sensor_state {
+    float values[16];
+    std::uint64_t timestamp;
+};
+
+embec::seqlock<sensor_state> lock;
+embec::triple_buffer<sensor_state> buffer;
+
+// Reference point: the payload copied out under a mutex.
+struct locked_state {
+    std::mutex mutex;
+    sensor_state state{};
+
+    void store(const sensor_state& s)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        state = s;
+    }
+
+    sensor_state load()
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        return state;
+    }
+};
+
+locked_state mutex_state;
+
+// Read latency without and with a writer thread publishing continuously.
+// On a single-core host the contended numbers include the scheduler.
+template <typename Write, typename Read>
+void contended(Write write, Read read, std::uint64_t iterations)
+{
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        sensor_state s{};
+        while (!stop.load(std::memory_order_relaxed)) {
+            ++s.timestamp;
+            write(s);
+        }
+    });
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        read();
+    }
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+}
+
+EMBEC_BENCHMARK(seqlock_read, "snapshot/seqlock_read", sizeof(sensor_state))
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(lock.load().timestamp);
+    }
+}
+
+EMBEC_BENCHMARK(triple_buffer_read, "snapshot/triple_buffer_read", sizeof(sensor_state))
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(buffer.read().timestamp);
+    }
+}
+
+EMBEC_BENCHMARK(mutex_read, "snapshot/mutex_read", sizeof(sensor_state))
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(mutex_state.load().timestamp);
+    }
+}
+
+EMBEC_BENCHMARK(seqlock_write, "snapshot/seqlock_write", sizeof(sensor_state))
+{
+    sensor_state s{};
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        s.timestamp = i;
+        lock.store(s);
+    }
+}
+
+EMBEC_BENCHMARK(triple_buffer_write, "snapshot/triple_buffer_write", sizeof(sensor_state))
+{
+    sensor_state s{};
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        s.timestamp = i;
+        buffer.write(s);
+    }
+}
+
+EMBEC_BENCHMARK(seqlock_contended, "snapshot/seqlock_read_contended", sizeof(sensor_state))
+{
+    contended([](const sensor_state& s) { lock.store(s); },
+              [] { embec::bench::do_not_optimize(lock.load().timestamp); }, iterations);
+}
+
+EMBEC_BENCHMARK(triple_buffer_contended, "snapshot/triple_buffer_read_contended",
+                sizeof(sensor_state))
+{
+    contended([](const sensor_state& s) { buffer.write(s); },
+              [] { embec::bench::do_not_optimize(buffer.read().timestamp); }, iterations);
+}
+
+EMBEC_BENCHMARK(mutex_contended, "snapshot/mutex_read_contended", sizeof(sensor_state))
+{
+    contended([](const sensor_state& s) { mutex_state.store(s); },
+              [] { embec::bench::do_not_optimize(mutex_state.load().timestamp); }, iterations);
+}
+
+} // namespace
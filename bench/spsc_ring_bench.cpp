@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/spsc_ring.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t burst = 64;
+
+embec::spsc_ring<std::uint8_t, 1024> ring;
+std::uint8_t scratch[burst];
+
+EMBEC_BENCHMARK(push_pop, "spsc_ring/push_pop_64", burst)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        for (std::size_t k = 0; k < burst; ++k) {
+            ring.push(static_cast<std::uint8_t>(k));
+        }
+        std::uint8_t value = 0;
+        for (std::size_t k = 0; k < burst; ++k) {
+            ring.pop(value);
+            embec::bench::do_not_optimize(value);
+        }
+    }
+}
+
+EMBEC_BENCHMARK(write_read, "spsc_ring/write_read_64", burst)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        ring.write(scratch, burst);
+        ring.read(scratch, burst);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(claim_commit, "spsc_ring/claim_commit_64", burst)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        auto out = ring.claim_write();
+        const std::size_t n = out.size < burst ? out.size : burst;
+        for (std::size_t k = 0; k < n; ++k) {
+            out.data[k] = static_cast<std::uint8_t>(k);
+        }
+        ring.commit_write(n);
+        auto in = ring.claim_read();
+        embec::bench::do_not_optimize(in.data[0]);
+        ring.commit_read(in.size);
+    }
+}
+
+} // namespace
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/stats.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t block = 1024;
+
+template <typename T>
+const T* samples()
+{
+    static T data[block];
+    static bool ready = false;
+    if (!ready) {
+        embec::bench::fill_random(data, sizeof(data));
+        if constexpr (std::is_floating_point<T>::value) {
+            for (T& x : data) {
+                x = x != x ? T(0) : x / (T(1) + (x < 0 ? -x : x)); // finite, in (-1, 1)
+            }
+        }
+        ready = true;
+    }
+    return data;
+}
+
+EMBEC_BENCHMARK(running_stats_i16, "stats/running_stats_i16_block_1k", block * 2)
+{
+    const std::int16_t* x = samples<std::int16_t>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::running_stats<std::int16_t> s;
+        s.add(x, block);
+        embec::bench::do_not_optimize(s);
+    }
+}
+
+// The same samples through the per-sample Welford update, for comparison.
+EMBEC_BENCHMARK(running_stats_i16_scalar, "stats/running_stats_i16_scalar_1k", block * 2)
+{
+    const std::int16_t* x = samples<std::int16_t>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::running_stats<std::int16_t> s;
+        for (std::size_t k = 0; k < block; ++k) {
+            s.add(x[k]);
+        }
+        embec::bench::do_not_optimize(s);
+    }
+}
+
+EMBEC_BENCHMARK(running_stats_float, "stats/running_stats_float_block_1k", block * 4)
+{
+    const float* x = samples<float>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::running_stats<float> s;
+        s.add(x, block);
+        embec::bench::do_not_optimize(s);
+    }
+}
+
+EMBEC_BENCHMARK(running_stats_float_scalar, "stats/running_stats_float_scalar_1k", block * 4)
+{
+    const float* x = samples<float>();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::running_stats<float> s;
+        for (std::size_t k = 0; k < block; ++k) {
+            s.add(x[k]);
+        }
+        embec::bench::do_not_optimize(s);
+    }
+}
+
+EMBEC_BENCHMARK(sliding_min_max, "stats/sliding_min_max_64_1k", block * 2)
+{
+    const std::int16_t* x = samples<std::int16_t>();
+    static std::int16_t lo[block];
+    static std::int16_t hi[block];
+    embec::sliding_min_max<std::int16_t, 64> window;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        window.process(x, lo, hi, block);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(p2_quantile, "stats/p2_quantile_float_1k", block * 4)
+{
+    const float* x = samples<float>();
+    embec::p2_quantile<float> q(0.95f);
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        q.add(x, block);
+        embec::bench::do_not_optimize(q);
+    }
+}
+
+} // namespace
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/timer_wheel.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t timer_count = 1024;
+
+embec::timer_wheel<> wheel;
+embec::timer timers[timer_count];
+
+void noop(embec::timer&) {}
+
+EMBEC_BENCHMARK(start_stop, "timer_wheel/start_stop", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::timer& t = timers[i % timer_count];
+        wheel.start(t, static_cast<embec::tick_t>(1 + (i * 7919) % 100000));
+        wheel.stop(t);
+    }
+}
+
+// Steady state of 1024 periodic timers with periods spread over three
+// levels; one operation is one tick including the callbacks that fire.
+EMBEC_BENCHMARK(tick_loaded, "timer_wheel/tick_1024_periodic", 0)
+{
+    static bool armed = false;
+    if (!armed) {
+        for (std::size_t k = 0; k < timer_count; ++k) {
+            timers[k].set_callback(noop);
+            const auto period = static_cast<embec::tick_t>(10 + (k * 7919) % 20000);
+            wheel.start(timers[k], period, period);
+        }
+        armed = true;
+    }
+    std::size_t fired = 0;
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        fired += wheel.tick();
+    }
+    embec::bench::do_not_optimize(fired);
+}
+
+} // namespace
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embec/trace.hpp"
+
+#include <cstdio>
+
+#include "bench.hpp"
+
+namespace {
+
+embec::trace_buffer<4096> trace;
+std::uint8_t drained[4096 * 4];
+char line[96];
+
+// Keeps the buffer from filling up so every call takes the full path.
+void make_room(std::uint64_t i)
+{
+    if ((i & 255) == 255) {
+        embec::bench::do_not_optimize(trace.drain(drained, sizeof(drained)));
+    }
+}
+
+EMBEC_BENCHMARK(log0, "trace/log_no_args", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        EMBEC_TRACE(trace, "tick");
+        make_room(i);
+    }
+}
+
+EMBEC_BENCHMARK(log3, "trace/log_3_args", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        EMBEC_TRACE(trace, "adc ch%u = %d mV (%f)", static_cast<unsigned>(i & 7),
+                    static_cast<int>(i), 0.5f);
+        make_room(i);
+    }
+}
+
+EMBEC_BENCHMARK(snprintf3, "trace/snprintf_3_args", 0)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        std::snprintf(line, sizeof(line), "adc ch%u = %d mV (%f)", static_cast<unsigned>(i & 7),
+                      static_cast<int>(i), 0.5);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(drain, "trace/drain_4_words", 16)
+{
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        EMBEC_TRACE(trace, "value %d", static_cast<int>(i));
+        embec::bench::do_not_optimize(trace.drain(drained, 16));
+    }
+}
+
+} // namespace
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstdio>
+
+#include "embec/varint.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr std::size_t value_count = 1024;
+constexpr std::size_t value_bytes = value_count * sizeof(std::uint32_t);
+
+struct corpus {
+    std::uint32_t values[value_count];
+    std::uint8_t encoded[value_count * embec::varint_max_size<std::uint32_t>];
+    std::size_t length;
+};
+
+enum class mix {
+    small, ///< Counters and flags below 128: one byte each.
+    mixed, ///< Telemetry fields: mostly one or two bytes, some three.
+    large, ///< Uniform 32-bit values: mostly five bytes.
+};
+
+template <mix Mix>
+const corpus& data()
+{
+    static corpus c;
+    static bool ready = false;
+    if (!ready) {
+        std::uint32_t random[value_count];
+        embec::bench::fill_random(random, sizeof(random), 41);
+        for (std::size_t i = 0; i < value_count; ++i) {
+            const std::uint32_t r = random[i];
+            switch (Mix) {
+            case mix::small:
+                c.values[i] = r & 0x7f;
+                break;
+            case mix::mixed:
+                c.values[i] = r % 8 < 5 ? r >> 25 : r % 8 < 7 ? r >> 18 : r >> 11;
+                break;
+            case mix::large:
+                c.values[i] = r;
+                break;
+            }
+        }
+        c.length =
+            embec::varint_encode_array(c.values, value_count, c.encoded, sizeof(c.encoded)).length;
+        ready = true;
+    }
+    return c;
+}
+
+template <mix Mix>
+void note_size()
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2f B/value",
+                  static_cast<double>(data<Mix>().length) / value_count);
+    embec::bench::note() = text;
+}
+
+// The loop a hand-written parser has: one value at a time, one byte at a
+// time.
+template <mix Mix>
+void decode_single(std::uint64_t iterations)
+{
+    const corpus& c = data<Mix>();
+    std::uint32_t out[value_count];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        std::size_t at = 0;
+        for (std::size_t k = 0; k < value_count; ++k) {
+            at += embec::varint_decode(c.encoded + at, c.length - at, out[k]);
+        }
+        embec::bench::do_not_optimize(at);
+        embec::bench::clobber_memory();
+    }
+    note_size<Mix>();
+}
+
+template <mix Mix>
+void decode_bulk(std::uint64_t iterations)
+{
+    const corpus& c = data<Mix>();
+    std::uint32_t out[value_count];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::varint_decode_array(c.encoded, c.length, out, value_count).length);
+        embec::bench::clobber_memory();
+    }
+    note_size<Mix>();
+}
+
+template <mix Mix>
+void encode(std::uint64_t iterations)
+{
+    const corpus& c = data<Mix>();
+    std::uint8_t out[sizeof(c.encoded)];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::varint_encode_array(c.values, value_count, out, sizeof(out)).length);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(decode_small_single, "varint/decode_small_single", value_bytes)
+{
+    decode_single<mix::small>(iterations);
+}
+
+EMBEC_BENCHMARK(decode_small_bulk, "varint/decode_small_bulk", value_bytes)
+{
+    decode_bulk<mix::small>(iterations);
+}
+
+EMBEC_BENCHMARK(decode_mixed_single, "varint/decode_mixed_single", value_bytes)
+{
+    decode_single<mix::mixed>(iterations);
+}
+
+EMBEC_BENCHMARK(decode_mixed_bulk, "varint/decode_mixed_bulk", value_bytes)
+{
+    decode_bulk<mix::mixed>(iterations);
+}
+
+EMBEC_BENCHMARK(decode_large_single, "varint/decode_large_single", value_bytes)
+{
+    decode_single<mix::large>(iterations);
+}
+
+EMBEC_BENCHMARK(decode_large_bulk, "varint/decode_large_bulk", value_bytes)
+{
+    decode_bulk<mix::large>(iterations);
+}
+
+EMBEC_BENCHMARK(encode_mixed, "varint/encode_mixed", value_bytes)
+{
+    encode<mix::mixed>(iterations);
+}
+
+// Millisecond timestamps with a 10 ms period and a little jitter.
+struct timestamps {
+    std::uint32_t values[value_count];
+    std::uint8_t encoded[value_count * embec::varint_max_size<std::uint32_t>];
+    std::size_t length;
+};
+
+const timestamps& stamps()
+{
+    static timestamps t;
+    static bool ready = false;
+    if (!ready) {
+        std::uint8_t jitter[value_count];
+        embec::bench::fill_random(jitter, sizeof(jitter), 43);
+        std::uint32_t now = 1700000000u;
+        for (std::size_t i = 0; i < value_count; ++i) {
+            now += 10 + (jitter[i] % 3) - 1;
+            t.values[i] = now;
+        }
+        t.length = embec::varint_delta_encode<2>(t.values, value_count, t.encoded,
+                                                 sizeof(t.encoded))
+                       .length;
+        ready = true;
+    }
+    return t;
+}
+
+EMBEC_BENCHMARK(delta2_encode, "varint/delta2_encode_timestamps", value_bytes)
+{
+    const timestamps& t = stamps();
+    std::uint8_t out[sizeof(t.encoded)];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::varint_delta_encode<2>(t.values, value_count, out, sizeof(out)).length);
+        embec::bench::clobber_memory();
+    }
+}
+
+EMBEC_BENCHMARK(delta2_decode, "varint/delta2_decode_timestamps", value_bytes)
+{
+    const timestamps& t = stamps();
+    std::uint32_t out[value_count];
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        embec::bench::do_not_optimize(
+            embec::varint_delta_decode<2>(t.encoded, t.length, out, value_count).length);
+        embec::bench::clobber_memory();
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2f B/value", static_cast<double>(t.length) / value_count);
+    embec::bench::note() = text;
+}
+
+} // namespace
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file arena.hpp
+/// @brief Monotonic (bump-pointer) arena allocator with checkpoints,
+///        overflow chaining and a std::pmr adapter.
+///
+/// An arena hands out memory from one buffer by advancing an offset, so an
+/// allocation is a few instructions and has no per-allocation overhead
+/// beyond alignment padding. Memory is not freed piecemeal: mark() takes a
+/// checkpoint and rewind() frees everything allocated since in O(1), which
+/// suits per-request or per-frame work. arena_scope does this on scope
+/// exit.
+///
+/// @code
+/// static unsigned char request_memory[4096];
+/// embec::arena request_arena(request_memory);
+///
+/// void handle(const packet& p)
+/// {
+///     embec::arena_scope scope(request_arena); // freed on return
+///     auto* fields = request_arena.allocate_array<field>(p.field_count());
+///     ...
+/// }
+/// @endcode
+///
+/// An arena may name a fallback arena that serves the allocations it has
+/// no room for (for example a larger, slower RAM region), and that one a
+/// fallback of its own, up to arena_max_chain arenas in all. Checkpoints
+/// cover the whole chain, so a rewind also frees what overflowed. Rewinds
+/// must happen in LIFO order across everything sharing a chain.
+///
+/// Destructors are never run: create() accepts trivially destructible
+/// types only. stats() reports the peak usage for sizing the buffers.
+///
+/// On hosted builds with <memory_resource>, arena_resource adapts an arena
+/// to std::pmr::memory_resource so that standard containers can use it.
+/// Allocations that do not fit go to an upstream resource (by default
+/// std::pmr::null_memory_resource(), which throws std::bad_alloc).
+///
+/// An arena is a single-context object; synchronise concurrent use.
+
+#ifndef EMBEC_ARENA_HPP
+#define EMBEC_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "embec/config.hpp"
+
+/// Defined to 1 when arena_resource (std::pmr) is available. Define
+/// EMBEC_NO_PMR to leave it out.
+#if !defined(EMBEC_NO_PMR) && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#if defined(__cpp_lib_memory_resource)
+#define EMBEC_HAS_PMR 1
+#endif
+#endif
+#endif
+
+namespace embec {
+
+/// Longest chain of an arena and its fallbacks.
+inline constexpr std::size_t arena_max_chain = 4;
+
+/// Usage counters of an arena.
+struct arena_stats {
+    std::size_t capacity;   ///< Bytes in the buffer.
+    std::size_t used;       ///< Bytes allocated, including alignment padding.
+    std::size_t high_water; ///< Largest used value seen since reset.
+    std::size_t overflows;  ///< Allocations passed on to the fallback.
+    std::size_t failures;   ///< Allocations that found no room in the chain.
+};
+
+/// Bump-pointer arena over a caller-provided buffer.
+class arena {
+public:
+    /// Offsets of every arena in a chain.
+    struct checkpoint {
+        std::size_t offsets[arena_max_chain];
+    };
+
+    /// An empty arena; every allocation goes to @p fallback. A fallback
+    /// whose chain is already arena_max_chain long is not used, so that
+    /// checkpoints always cover the whole chain.
+    explicit arena(arena* fallback = nullptr) noexcept
+        : fallback_(fallback != nullptr && fallback->depth_ < arena_max_chain ? fallback : nullptr),
+          depth_(fallback_ != nullptr ? fallback_->depth_ + 1 : 1)
+    {
+        EMBEC_ASSERT(fallback_ == fallback); // chain longer than arena_max_chain
+    }
+
+    arena(void* buffer, std::size_t size, arena* fallback = nullptr) noexcept : arena(fallback)
+    {
+        buffer_ = static_cast<unsigned char*>(buffer);
+        capacity_ = size;
+    }
+
+    template <std::size_t N>
+    explicit arena(unsigned char (&buffer)[N], arena* fallback = nullptr) noexcept
+        : arena(buffer, N, fallback)
+    {
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    /// Returns @p size bytes aligned to @p align (a power of two), from
+    /// this arena or its fallbacks, or nullptr if none has room.
+    void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t)) noexcept
+    {
+        EMBEC_ASSERT(align != 0 && (align & (align - 1)) == 0);
+        const auto base = reinterpret_cast<std::uintptr_t>(buffer_);
+        const std::size_t begin =
+            static_cast<std::size_t>(((base + offset_ + align - 1) & ~(align - 1)) - base);
+        if (EMBEC_LIKELY(begin <= capacity_ && size <= capacity_ - begin)) {
+            offset_ = begin + size;
+            high_water_ = offset_ > high_water_ ? offset_ : high_water_;
+            return buffer_ + begin;
+        }
+        if (fallback_ != nullptr) {
+            if (void* p = fallback_->allocate(size, align)) {
+                ++overflows_;
+                return p;
+            }
+        }
+        ++failures_;
+        return nullptr;
+    }
+
+    /// Uninitialised storage for @p count objects of type T, or nullptr.
+    template <typename T>
+    T* allocate_array(std::size_t count) noexcept
+    {
+        if (count > static_cast<std::size_t>(-1) / sizeof(T)) {
+            ++failures_;
+            return nullptr;
+        }
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// Allocates and constructs a T, or returns nullptr. The destructor
+    /// will never run, so T must be trivially destructible.
+    template <typename T, typename... Args>
+    T* create(Args&&... args) noexcept(noexcept(T(std::forward<Args>(args)...)))
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena objects are never destroyed");
+        void* p = allocate(sizeof(T), alignof(T));
+        return p != nullptr ? ::new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    /// Current position of this arena and its fallbacks.
+    checkpoint mark() const noexcept
+    {
+        checkpoint cp{};
+        std::size_t i = 0;
+        for (const arena* a = this; a != nullptr; a = a->fallback_) {
+            cp.offsets[i++] = a->offset_;
+        }
+        return cp;
+    }
+
+    /// Frees everything allocated in the chain since @p cp was taken.
+    void rewind(const checkpoint& cp) noexcept
+    {
+        std::size_t i = 0;
+        for (arena* a = this; a != nullptr; a = a->fallback_) {
+            EMBEC_ASSERT(cp.offsets[i] <= a->offset_); // rewinds must nest
+            a->offset_ = cp.offsets[i++];
+        }
+    }
+
+    /// Frees everything in the chain.
+    void reset() noexcept
+    {
+        for (arena* a = this; a != nullptr; a = a->fallback_) {
+            a->offset_ = 0;
+        }
+    }
+
+    /// True if @p p points into this arena's buffer (not its fallbacks').
+    bool owns(const void* p) const noexcept
+    {
+        const auto* byte = static_cast<const unsigned char*>(p);
+        return byte >= buffer_ && byte < buffer_ + capacity_;
+    }
+
+    /// True if @p p points into the buffer of any arena in the chain.
+    bool chain_owns(const void* p) const noexcept
+    {
+        for (const arena* a = this; a != nullptr; a = a->fallback_) {
+            if (a->owns(p)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t used() const noexcept { return offset_; }
+    std::size_t remaining() const noexcept { return capacity_ - offset_; }
+    arena* fallback() const noexcept { return fallback_; }
+
+    arena_stats stats() const noexcept
+    {
+        return {capacity_, offset_, high_water_, overflows_, failures_};
+    }
+
+    /// Restarts high-water tracking from the current usage and clears the
+    /// overflow and failure counters.
+    void reset_stats() noexcept
+    {
+        high_water_ = offset_;
+        overflows_ = 0;
+        failures_ = 0;
+    }
+
+private:
+    unsigned char* buffer_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t offset_ = 0;
+    arena* fallback_;
+    std::size_t depth_; ///< Arenas in the chain starting here.
+    std::size_t high_water_ = 0;
+    std::size_t overflows_ = 0;
+    std::size_t failures_ = 0;
+};
+
+/// Arena with a buffer of @p Size bytes inside the object.
+template <std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+class static_arena : public arena {
+    static_assert(Size > 0, "arena must not be empty");
+    static_assert((Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+public:
+    explicit static_arena(arena* fallback = nullptr) noexcept : arena(storage_, Size, fallback) {}
+
+private:
+    alignas(Align) unsigned char storage_[Size];
+};
+
+/// Rewinds an arena (and its fallbacks) to where it was on construction.
+class arena_scope {
+public:
+    explicit arena_scope(arena& a) noexcept : arena_(a), mark_(a.mark()) {}
+    ~arena_scope() { arena_.rewind(mark_); }
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+private:
+    arena& arena_;
+    arena::checkpoint mark_;
+};
+
+#if EMBEC_HAS_PMR
+
+/// std::pmr::memory_resource on an arena. Deallocation is a no-op for
+/// arena memory (it is freed by rewinding the arena) and is passed on for
+/// memory that came from @p upstream.
+class arena_resource : public std::pmr::memory_resource {
+public:
+    explicit arena_resource(
+        arena& a, std::pmr::memory_resource* upstream = std::pmr::null_memory_resource()) noexcept
+        : arena_(a), upstream_(upstream)
+    {
+    }
+
+    arena& get_arena() const noexcept { return arena_; }
+    std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* p = arena_.allocate(bytes, alignment);
+        return p != nullptr ? p : upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        if (!arena_.chain_owns(p)) {
+            upstream_->deallocate(p, bytes, alignment);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    arena& arena_;
+    std::pmr::memory_resource* upstream_;
+};
+
+#endif // EMBEC_HAS_PMR
+
+} // namespace embec
+
+#endif // EMBEC_ARENA_HPP
@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file block_pool.hpp
+/// @brief Fixed-block memory pools with O(1) allocate/release.
+///
+/// Two pools are provided:
+///  - block_pool: single-context pool. The caller serialises access (for
+///    example by using it from one thread, or with interrupts masked).
+///  - atomic_block_pool: lock-free pool usable concurrently from several
+///    cores, threads or interrupt priorities. Requires native atomic
+///    read-modify-write instructions (e.g. LDREX/STREX), so not Cortex-M0.
+///
+/// Both pools are backed by storage inside the object, need no run-time
+/// initialisation (blocks are handed out from an untouched region before
+/// the free list is consulted) and record usage telemetry.
+
+#ifndef EMBEC_BLOCK_POOL_HPP
+#define EMBEC_BLOCK_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+/// Usage counters of a pool.
+struct pool_stats {
+    std::size_t capacity;   ///< Total number of blocks.
+    std::size_t in_use;     ///< Blocks currently allocated.
+    std::size_t high_water; ///< Largest in_use value seen since reset.
+    std::size_t failures;   ///< Allocations that found the pool exhausted.
+};
+
+namespace detail {
+
+constexpr std::size_t round_up(std::size_t value, std::size_t align) noexcept
+{
+    return (value + align - 1) / align * align;
+}
+
+/// Typed create/destroy helpers shared by both pools.
+template <typename Pool>
+class pool_object_api {
+public:
+    /// Allocates a block and constructs a T in it. Returns nullptr when the
+    /// pool is exhausted.
+    template <typename T, typename... Args>
+    T* create(Args&&... args) noexcept(noexcept(T(std::forward<Args>(args)...)))
+    {
+        static_assert(sizeof(T) <= Pool::block_size(), "object does not fit in a block");
+        static_assert(Pool::block_align() % alignof(T) == 0, "object is over-aligned for the pool");
+        void* block = static_cast<Pool*>(this)->allocate();
+        return block ? ::new (block) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    /// Destroys an object returned by create() and releases its block.
+    template <typename T>
+    void destroy(T* object) noexcept
+    {
+        if (object) {
+            object->~T();
+            static_cast<Pool*>(this)->release(object);
+        }
+    }
+};
+
+} // namespace detail
+
+/// Single-context pool of @p Count blocks of @p Size bytes.
+///
+/// Free blocks are linked through their own first bytes, so the pool has no
+/// per-block overhead beyond rounding the block size up to hold a pointer
+/// and to satisfy @p Align.
+template <std::size_t Size, std::size_t Count,
+          std::size_t Align = alignof(std::max_align_t)>
+class block_pool : public detail::pool_object_api<block_pool<Size, Count, Align>> {
+    static_assert(Size > 0 && Count > 0, "pool must not be empty");
+    static_assert((Align & (Align - 1)) == 0 && Align >= alignof(void*),
+                  "alignment must be a power of two of at least pointer alignment");
+
+public:
+    constexpr block_pool() noexcept = default;
+    block_pool(const block_pool&) = delete;
+    block_pool& operator=(const block_pool&) = delete;
+
+    static constexpr std::size_t block_size() noexcept { return stride; }
+    static constexpr std::size_t block_align() noexcept { return Align; }
+    static constexpr std::size_t capacity() noexcept { return Count; }
+
+    /// Returns a free block, or nullptr when the pool is exhausted.
+    void* allocate() noexcept
+    {
+        void* block;
+        if (free_) {
+            block = free_;
+            free_ = free_->next;
+        } else if (fresh_ < Count) {
+            block = &storage_[fresh_++ * stride];
+        } else {
+            ++failures_;
+            return nullptr;
+        }
+        if (++in_use_ > high_water_) {
+            high_water_ = in_use_;
+        }
+        return block;
+    }
+
+    /// Returns @p block to the pool. nullptr is ignored.
+    void release(void* block) noexcept
+    {
+        if (!block) {
+            return;
+        }
+        EMBEC_ASSERT(owns(block));
+        node* n = static_cast<node*>(block);
+        n->next = free_;
+        free_ = n;
+        --in_use_;
+    }
+
+    /// True if @p p is the start of a block of this pool.
+    bool owns(const void* p) const noexcept
+    {
+        const auto* byte = static_cast<const unsigned char*>(p);
+        return byte >= storage_ && byte < storage_ + sizeof(storage_) &&
+               static_cast<std::size_t>(byte - storage_) % stride == 0;
+    }
+
+    std::size_t available() const noexcept { return Count - in_use_; }
+
+    pool_stats stats() const noexcept
+    {
+        return {Count, in_use_, high_water_, failures_};
+    }
+
+    /// Restarts high-water tracking from the current usage and clears the
+    /// failure counter.
+    void reset_stats() noexcept
+    {
+        high_water_ = in_use_;
+        failures_ = 0;
+    }
+
+private:
+    struct node {
+        node* next;
+    };
+
+    static constexpr std::size_t stride =
+        detail::round_up(Size < sizeof(node) ? sizeof(node) : Size, Align);
+
+    alignas(Align) unsigned char storage_[stride * Count]{};
+    node* free_ = nullptr;
+    std::size_t fresh_ = 0;
+    std::size_t in_use_ = 0;
+    std::size_t high_water_ = 0;
+    std::size_t failures_ = 0;
+};
+
+/// Lock-free pool of @p Count blocks of @p Size bytes.
+///
+/// The free list is a Treiber stack whose head packs a 16-bit block index
+/// with a 16-bit modification tag into one 32-bit word, which prevents ABA
+/// while needing only 32-bit compare-and-swap. The link words live in a
+/// side table (two bytes per block) rather than inside the blocks so that a
+/// stale read of a link never races with the owner writing block contents.
+template <std::size_t Size, std::size_t Count,
+          std::size_t Align = alignof(std::max_align_t)>
+class atomic_block_pool
+    : public detail::pool_object_api<atomic_block_pool<Size, Count, Align>> {
+    static_assert(Size > 0 && Count > 0, "pool must not be empty");
+    static_assert(Count < 0xffff, "atomic_block_pool supports at most 65534 blocks");
+    static_assert((Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+public:
+    constexpr atomic_block_pool() noexcept = default;
+    atomic_block_pool(const atomic_block_pool&) = delete;
+    atomic_block_pool& operator=(const atomic_block_pool&) = delete;
+
+    static constexpr std::size_t block_size() noexcept { return stride; }
+    static constexpr std::size_t block_align() noexcept { return Align; }
+    static constexpr std::size_t capacity() noexcept { return Count; }
+
+    /// Returns a free block, or nullptr when the pool is exhausted.
+    void* allocate() noexcept
+    {
+        std::uint32_t head = head_.load(std::memory_order_acquire);
+        while (index_of(head) != none) {
+            const std::uint16_t index = index_of(head);
+            const std::uint32_t next =
+                pack(links_[index].load(std::memory_order_relaxed), tag_of(head) + 1);
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+                return account(&storage_[index * stride]);
+            }
+        }
+        std::size_t fresh = fresh_.load(std::memory_order_relaxed);
+        while (fresh < Count) {
+            if (fresh_.compare_exchange_weak(fresh, fresh + 1, std::memory_order_relaxed)) {
+                return account(&storage_[fresh * stride]);
+            }
+        }
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    /// Returns @p block to the pool. nullptr is ignored.
+    void release(void* block) noexcept
+    {
+        if (!block) {
+            return;
+        }
+        EMBEC_ASSERT(owns(block));
+        const auto index = static_cast<std::uint16_t>(
+            (static_cast<unsigned char*>(block) - storage_) / stride);
+        in_use_.fetch_sub(1, std::memory_order_relaxed);
+        std::uint32_t head = head_.load(std::memory_order_relaxed);
+        do {
+            links_[index].store(index_of(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, pack(index, tag_of(head) + 1),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    /// True if @p p is the start of a block of this pool.
+    bool owns(const void* p) const noexcept
+    {
+        const auto* byte = static_cast<const unsigned char*>(p);
+        return byte >= storage_ && byte < storage_ + sizeof(storage_) &&
+               static_cast<std::size_t>(byte - storage_) % stride == 0;
+    }
+
+    std::size_t available() const noexcept
+    {
+        return Count - in_use_.load(std::memory_order_relaxed);
+    }
+
+    /// Snapshot of the counters. Individual fields are read separately and
+    /// may be mutually inconsistent while other contexts are active.
+    pool_stats stats() const noexcept
+    {
+        return {Count, in_use_.load(std::memory_order_relaxed),
+                high_water_.load(std::memory_order_relaxed),
+                failures_.load(std::memory_order_relaxed)};
+    }
+
+    /// Restarts high-water tracking from the current usage and clears the
+    /// failure counter.
+    void reset_stats() noexcept
+    {
+        high_water_.store(in_use_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        failures_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::uint16_t none = 0xffff;
+    static constexpr std::size_t stride = detail::round_up(Size, Align);
+
+    static constexpr std::uint16_t index_of(std::uint32_t word) noexcept
+    {
+        return static_cast<std::uint16_t>(word);
+    }
+    static constexpr std::uint16_t tag_of(std::uint32_t word) noexcept
+    {
+        return static_cast<std::uint16_t>(word >> 16);
+    }
+    static constexpr std::uint32_t pack(std::uint16_t index, unsigned tag) noexcept
+    {
+        return static_cast<std::uint32_t>((tag & 0xffffu) << 16) | index;
+    }
+
+    void* account(void* block) noexcept
+    {
+        const std::size_t used = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::size_t peak = high_water_.load(std::memory_order_relaxed);
+        while (used > peak &&
+               !high_water_.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+        }
+        return block;
+    }
+
+    alignas(Align) unsigned char storage_[stride * Count]{};
+    std::atomic<std::uint16_t> links_[Count]{};
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<std::uint32_t> head_{pack(none, 0)};
+    std::atomic<std::size_t> fresh_{0};
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<std::size_t> in_use_{0};
+    std::atomic<std::size_t> high_water_{0};
+    std::atomic<std::size_t> failures_{0};
+};
+
+} // namespace embec
+
+#endif // EMBEC_BLOCK_POOL_HPP
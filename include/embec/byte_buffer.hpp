@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file byte_buffer.hpp
+/// @brief Byte-order-aware reader and writer cursors over byte buffers.
+///
+/// byte_reader and byte_writer walk a caller-owned buffer and convert values
+/// from or to a byte order fixed at compile time. Loads and stores are
+/// alignment-safe and compile to a single load or store (plus a byte swap
+/// instruction for the foreign byte order), so there is no need to cast
+/// buffer pointers to packed structs:
+///
+/// @code
+/// embec::be_reader in(frame, frame_length);
+/// const auto type = in.read<std::uint8_t>();
+/// const auto length = in.read<std::uint16_t>();
+/// const std::uint8_t* payload = in.bytes(length);
+/// const auto crc = in.read<std::uint32_t>();
+/// if (!in.ok()) {
+///     return false;
+/// }
+/// @endcode
+///
+/// Errors are sticky: an access past the end returns zero (or null for
+/// bytes()), marks the cursor as failed and makes every later access fail
+/// as well, so a whole record can be parsed or built before checking ok()
+/// once. Bulk array accesses copy with memcpy when the byte order is the
+/// host's and swap 16 bytes at a time with SSE2 on host builds otherwise.
+
+#ifndef EMBEC_BYTE_BUFFER_HPP
+#define EMBEC_BYTE_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/endian.hpp"
+
+#if defined(EMBEC_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace embec {
+namespace detail {
+
+#if defined(EMBEC_SIMD_SSE2)
+template <std::size_t Size>
+inline __m128i byteswap_lanes(__m128i v) noexcept
+{
+    if constexpr (Size == 4) {
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+    } else if constexpr (Size == 8) {
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1b), 0x1b);
+    }
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+#endif
+
+/// Copies @p count values of @p Size bytes from @p src to @p dst, reversing
+/// the bytes of each.
+template <std::size_t Size>
+inline void byteswap_copy(void* dst, const void* src, std::size_t count) noexcept
+{
+    using raw_type = typename unsigned_of_size<Size>::type;
+    auto* d = static_cast<std::uint8_t*>(dst);
+    const auto* s = static_cast<const std::uint8_t*>(src);
+#if defined(EMBEC_SIMD_SSE2)
+    // Whole vectors first, then advance past them: the tail count is then
+    // visibly below one vector, so the scalar loop is not vectorized again.
+    constexpr std::size_t per_vector = 16 / Size;
+    const std::size_t vector_end = count - count % per_vector;
+    for (std::size_t i = 0; i < vector_end; i += per_vector) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i * Size));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i * Size), byteswap_lanes<Size>(v));
+    }
+    d += vector_end * Size;
+    s += vector_end * Size;
+    count %= per_vector;
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        raw_type raw;
+        std::memcpy(&raw, s + i * Size, Size);
+        raw = byteswap(raw);
+        std::memcpy(d + i * Size, &raw, Size);
+    }
+}
+
+/// Copies @p count values of type T between buffer and host order.
+template <byte_order Order, typename T>
+inline void convert_copy(void* dst, const void* src, std::size_t count) noexcept
+{
+    static_assert(is_endian_value<T> && !std::is_same<T, bool>::value, "unsupported type");
+    if constexpr (Order == native_byte_order || sizeof(T) == 1) {
+        if (count != 0) {
+            std::memcpy(dst, src, count * sizeof(T));
+        }
+    } else {
+        byteswap_copy<sizeof(T)>(dst, src, count);
+    }
+}
+
+} // namespace detail
+
+/// Reads values in byte order @p Order from a buffer; see the file
+/// documentation.
+template <byte_order Order>
+class byte_reader {
+public:
+    static constexpr byte_order order = Order;
+
+    /// An empty reader; every read fails.
+    constexpr byte_reader() noexcept = default;
+
+    byte_reader(const void* data, std::size_t size) noexcept
+        : begin_(static_cast<const std::uint8_t*>(data)), pos_(begin_), end_(begin_ + size)
+    {
+        EMBEC_ASSERT(data != nullptr || size == 0);
+    }
+
+    template <std::size_t N>
+    explicit byte_reader(const std::uint8_t (&data)[N]) noexcept : byte_reader(data, N)
+    {
+    }
+
+    /// Reads an integer, bool, enumeration, float or double.
+    template <typename T>
+    T read() noexcept
+    {
+        if (EMBEC_UNLIKELY(!take(sizeof(T)))) {
+            return T{};
+        }
+        const T value = detail::load<T, Order>(pos_);
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    /// Reads into @p value, leaving it unchanged on failure.
+    template <typename T>
+    bool read(T& value) noexcept
+    {
+        if (EMBEC_UNLIKELY(!take(sizeof(T)))) {
+            return false;
+        }
+        value = detail::load<T, Order>(pos_);
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    /// Reads the value at @p offset from the current position without
+    /// advancing.
+    template <typename T>
+    T peek(std::size_t offset = 0) const noexcept
+    {
+        if (offset > remaining() || sizeof(T) > remaining() - offset) {
+            return T{};
+        }
+        return detail::load<T, Order>(pos_ + offset);
+    }
+
+    /// Reads @p count values into @p out.
+    template <typename T>
+    bool read_array(T* out, std::size_t count) noexcept
+    {
+        if (EMBEC_UNLIKELY(count > remaining() / sizeof(T))) {
+            fail();
+            return false;
+        }
+        detail::convert_copy<Order, T>(out, pos_, count);
+        pos_ += count * sizeof(T);
+        return true;
+    }
+
+    /// Copies @p length raw bytes to @p out.
+    bool read_bytes(void* out, std::size_t length) noexcept
+    {
+        const std::uint8_t* p = bytes(length);
+        if (p != nullptr && length != 0) {
+            std::memcpy(out, p, length);
+        }
+        return p != nullptr;
+    }
+
+    /// Returns the next @p length bytes in place and skips them, or null.
+    const std::uint8_t* bytes(std::size_t length) noexcept
+    {
+        if (EMBEC_UNLIKELY(!take(length))) {
+            return nullptr;
+        }
+        const std::uint8_t* p = pos_;
+        pos_ += length;
+        return p;
+    }
+
+    bool skip(std::size_t length) noexcept { return bytes(length) != nullptr; }
+
+    /// Splits off a reader over the next @p length bytes, e.g. a nested
+    /// length-prefixed record, and skips them. A failed split returns a
+    /// failed reader.
+    byte_reader sub(std::size_t length) noexcept
+    {
+        const std::uint8_t* p = bytes(length);
+        if (p == nullptr) {
+            byte_reader r;
+            r.failed_ = true;
+            return r;
+        }
+        return byte_reader(p, length);
+    }
+
+    /// True if no access has failed.
+    bool ok() const noexcept { return !failed_; }
+    bool empty() const noexcept { return pos_ == end_; }
+    std::size_t remaining() const noexcept { return static_cast<std::size_t>(end_ - pos_); }
+    std::size_t position() const noexcept { return static_cast<std::size_t>(pos_ - begin_); }
+    const std::uint8_t* data() const noexcept { return begin_; }
+    const std::uint8_t* current() const noexcept { return pos_; }
+
+private:
+    bool take(std::size_t length) noexcept
+    {
+        if (EMBEC_LIKELY(length <= remaining())) {
+            return true;
+        }
+        fail();
+        return false;
+    }
+
+    /// Cuts the buffer at the current position so later accesses fail too.
+    void fail() noexcept
+    {
+        end_ = pos_;
+        failed_ = true;
+    }
+
+    const std::uint8_t* begin_ = nullptr;
+    const std::uint8_t* pos_ = nullptr;
+    const std::uint8_t* end_ = nullptr;
+    bool failed_ = false;
+};
+
+/// Writes values in byte order @p Order into a buffer; see the file
+/// documentation.
+template <byte_order Order>
+class byte_writer {
+public:
+    static constexpr byte_order order = Order;
+
+    /// An empty writer; every write fails.
+    constexpr byte_writer() noexcept = default;
+
+    byte_writer(void* data, std::size_t size) noexcept
+        : begin_(static_cast<std::uint8_t*>(data)), pos_(begin_), end_(begin_ + size)
+    {
+        EMBEC_ASSERT(data != nullptr || size == 0);
+    }
+
+    template <std::size_t N>
+    explicit byte_writer(std::uint8_t (&data)[N]) noexcept : byte_writer(data, N)
+    {
+    }
+
+    /// Writes an integer, bool, enumeration, float or double.
+    template <typename T>
+    bool write(T value) noexcept
+    {
+        if (EMBEC_UNLIKELY(!take(sizeof(T)))) {
+            return false;
+        }
+        detail::store<Order>(pos_, value);
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    /// Overwrites the value at @p offset from the start of the buffer,
+    /// which must lie in the part already written; used to fill in length
+    /// or checksum fields after the data that follows them.
+    template <typename T>
+    bool patch(std::size_t offset, T value) noexcept
+    {
+        if (EMBEC_UNLIKELY(offset > position() || sizeof(T) > position() - offset)) {
+            fail();
+            return false;
+        }
+        detail::store<Order>(begin_ + offset, value);
+        return true;
+    }
+
+    /// Writes @p count values from @p in.
+    template <typename T>
+    bool write_array(const T* in, std::size_t count) noexcept
+    {
+        if (EMBEC_UNLIKELY(count > remaining() / sizeof(T))) {
+            fail();
+            return false;
+        }
+        detail::convert_copy<Order, T>(pos_, in, count);
+        pos_ += count * sizeof(T);
+        return true;
+    }
+
+    /// Copies @p length raw bytes from @p in.
+    bool write_bytes(const void* in, std::size_t length) noexcept
+    {
+        std::uint8_t* p = reserve(length);
+        if (p != nullptr && length != 0) {
+            std::memcpy(p, in, length);
+        }
+        return p != nullptr;
+    }
+
+    /// Writes @p length copies of @p value.
+    bool fill(std::uint8_t value, std::size_t length) noexcept
+    {
+        std::uint8_t* p = reserve(length);
+        if (p != nullptr && length != 0) {
+            std::memset(p, value, length);
+        }
+        return p != nullptr;
+    }
+
+    /// Returns the next @p length bytes for the caller to fill in place and
+    /// skips them, or null.
+    std::uint8_t* reserve(std::size_t length) noexcept
+    {
+        if (EMBEC_UNLIKELY(!take(length))) {
+            return nullptr;
+        }
+        std::uint8_t* p = pos_;
+        pos_ += length;
+        return p;
+    }
+
+    /// True if no access has failed.
+    bool ok() const noexcept { return !failed_; }
+    std::size_t remaining() const noexcept { return static_cast<std::size_t>(end_ - pos_); }
+    /// Bytes written so far.
+    std::size_t position() const noexcept { return static_cast<std::size_t>(pos_ - begin_); }
+    std::uint8_t* data() const noexcept { return begin_; }
+    std::uint8_t* current() const noexcept { return pos_; }
+
+private:
+    bool take(std::size_t length) noexcept
+    {
+        if (EMBEC_LIKELY(length <= remaining())) {
+            return true;
+        }
+        fail();
+        return false;
+    }
+
+    void fail() noexcept
+    {
+        end_ = pos_;
+        failed_ = true;
+    }
+
+    std::uint8_t* begin_ = nullptr;
+    std::uint8_t* pos_ = nullptr;
+    std::uint8_t* end_ = nullptr;
+    bool failed_ = false;
+};
+
+using be_reader = byte_reader<byte_order::big>;
+using le_reader = byte_reader<byte_order::little>;
+using be_writer = byte_writer<byte_order::big>;
+using le_writer = byte_writer<byte_order::little>;
+
+} // namespace embec
+
+#endif // EMBEC_BYTE_BUFFER_HPP
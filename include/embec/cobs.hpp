@@ -0,0 +1,382 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file cobs.hpp
+/// @brief Consistent Overhead Byte Stuffing (COBS) framing.
+///
+/// COBS removes all zero bytes from a frame at a cost of at most one byte
+/// per 254, so a zero byte can delimit frames on the wire. This header
+/// provides:
+///  - cobs_encode()/cobs_decode(): one-shot conversion between buffers.
+///    Decoding may be done in place (dst == src).
+///  - cobs_encoder: produces the encoded frame one byte at a time, for a
+///    transmit ISR that feeds a UART data register with no buffer.
+///  - cobs_decoder: reassembles frames from bytes, blocks or an spsc_ring,
+///    writing the decoded payload straight into the caller's buffer.
+///  - cobs_write(): encodes a frame directly into an spsc_ring.
+///
+/// Runs of non-zero bytes are located with a word-at-a-time scan and moved
+/// with memcpy, so throughput approaches memcpy speed on 32/64-bit cores.
+
+#ifndef EMBEC_COBS_HPP
+#define EMBEC_COBS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "embec/framing.hpp"
+
+namespace embec {
+
+/// Worst-case encoded size of a @p length byte frame, excluding the
+/// delimiter.
+constexpr std::size_t cobs_max_encoded_size(std::size_t length) noexcept
+{
+    return length + length / 254 + 1;
+}
+
+/// Encodes @p length bytes at @p src into @p dst. No delimiter is appended.
+/// @p dst must not overlap @p src.
+inline frame_result cobs_encode(const std::uint8_t* src, std::size_t length, std::uint8_t* dst,
+                                std::size_t capacity) noexcept
+{
+    std::size_t out = 0;
+    std::size_t in = 0;
+    for (;;) {
+        const std::size_t limit = length - in < 254 ? length - in : 254;
+        const std::size_t run = detail::find_zero(src + in, limit);
+        if (out + 1 + run > capacity) {
+            return {0, frame_status::overflow};
+        }
+        dst[out] = static_cast<std::uint8_t>(run + 1);
+        if (run) {
+            std::memcpy(dst + out + 1, src + in, run);
+        }
+        out += 1 + run;
+        in += run;
+        if (in == length) {
+            // A full block at the very end needs no terminating empty block.
+            break;
+        }
+        if (run < 254) {
+            ++in; // skip the zero that ended the block
+            if (in == length) {
+                // Trailing zero: one more (empty) block encodes it.
+                if (out + 1 > capacity) {
+                    return {0, frame_status::overflow};
+                }
+                dst[out++] = 1;
+                break;
+            }
+        }
+    }
+    return {out, frame_status::ok};
+}
+
+/// Decodes the @p length encoded bytes at @p src (without delimiter) into
+/// @p dst. @p dst may equal @p src for in-place decoding.
+inline frame_result cobs_decode(const std::uint8_t* src, std::size_t length, std::uint8_t* dst,
+                                std::size_t capacity) noexcept
+{
+    std::size_t out = 0;
+    std::size_t in = 0;
+    while (in < length) {
+        const std::size_t code = src[in++];
+        const std::size_t run = code - 1;
+        if (code == 0 || run > length - in ||
+            detail::find_zero(src + in, run) != run) {
+            return {0, frame_status::invalid};
+        }
+        if (out + run > capacity) {
+            return {0, frame_status::overflow};
+        }
+        if (run) {
+            std::memmove(dst + out, src + in, run);
+        }
+        out += run;
+        in += run;
+        if (code != 0xff && in < length) {
+            if (out == capacity) {
+                return {0, frame_status::overflow};
+            }
+            dst[out++] = 0;
+        }
+    }
+    return {out, frame_status::ok};
+}
+
+/// Byte-at-a-time COBS encoder. Emits the encoded frame followed by the
+/// zero delimiter.
+///
+/// @code
+/// encoder.begin(frame, length);          // main loop
+/// ...
+/// uint8_t byte;                          // TX-empty ISR
+/// if (encoder.next(byte)) UART->DR = byte; else disable_tx_irq();
+/// @endcode
+class cobs_encoder {
+public:
+    constexpr cobs_encoder() noexcept = default;
+
+    /// Starts encoding @p length bytes at @p frame. The frame must stay
+    /// valid until next() returns false.
+    void begin(const std::uint8_t* frame, std::size_t length) noexcept
+    {
+        src_ = frame;
+        remaining_ = length;
+        run_ = 0;
+        state_ = state::code;
+    }
+
+    /// True while bytes remain to be emitted.
+    bool busy() const noexcept { return state_ != state::idle; }
+
+    /// Produces the next encoded byte. Returns false when the frame,
+    /// including its delimiter, has been emitted.
+    bool next(std::uint8_t& out) noexcept
+    {
+        switch (state_) {
+        case state::code: {
+            const std::size_t limit = remaining_ < 254 ? remaining_ : 254;
+            run_ = detail::find_zero(src_, limit);
+            // The block ends in a zero (to be skipped) unless it is full or
+            // reaches the end of the frame.
+            skip_zero_ = run_ < 254 && run_ < remaining_;
+            out = static_cast<std::uint8_t>(run_ + 1);
+            state_ = run_ ? state::data : after_block();
+            return true;
+        }
+        case state::data:
+            out = *src_++;
+            --remaining_;
+            if (--run_ == 0) {
+                state_ = after_block();
+            }
+            return true;
+        case state::delimiter:
+            out = 0;
+            state_ = state::idle;
+            return true;
+        case state::idle:
+            break;
+        }
+        return false;
+    }
+
+private:
+    enum class state : std::uint8_t { idle, code, data, delimiter };
+
+    state after_block() noexcept
+    {
+        if (skip_zero_) {
+            ++src_;
+            --remaining_;
+            // A zero as the last byte still needs an empty block after it.
+            return state::code;
+        }
+        return remaining_ ? state::code : state::delimiter;
+    }
+
+    const std::uint8_t* src_ = nullptr;
+    std::size_t remaining_ = 0;
+    std::size_t run_ = 0;
+    bool skip_zero_ = false;
+    state state_ = state::idle;
+};
+
+/// Streaming COBS decoder writing into a caller-provided frame buffer.
+///
+/// Bytes may arrive one at a time (from a receive ISR), in blocks, or from
+/// an spsc_ring. A zero byte ends a frame. Empty frames are ignored, so
+/// senders may also put a delimiter in front of each frame. After an
+/// overflow or invalid frame the decoder discards input up to the next
+/// delimiter and then resumes.
+class cobs_decoder {
+public:
+    constexpr cobs_decoder(std::uint8_t* buffer, std::size_t capacity) noexcept
+        : buffer_(buffer), capacity_(capacity)
+    {
+    }
+
+    /// Decoded frame, valid after a push returned frame_status::ok and until
+    /// the next push.
+    const std::uint8_t* data() const noexcept { return buffer_; }
+    std::size_t size() const noexcept { return size_; }
+
+    /// Drops any partially received frame.
+    void reset() noexcept
+    {
+        size_ = 0;
+        remaining_ = 0;
+        pending_zero_ = false;
+        discard_ = false;
+        complete_ = false;
+    }
+
+    /// Processes one received byte.
+    frame_status push(std::uint8_t byte) noexcept
+    {
+        begin_push();
+        if (byte == 0) {
+            return end_frame();
+        }
+        if (discard_) {
+            return frame_status::incomplete;
+        }
+        if (remaining_ == 0) {
+            return start_block(byte);
+        }
+        if (size_ == capacity_) {
+            return fail(frame_status::overflow);
+        }
+        buffer_[size_++] = byte;
+        --remaining_;
+        return frame_status::incomplete;
+    }
+
+    /// Processes up to @p length bytes, stopping right after a frame ends.
+    /// Returns the number of bytes consumed; @p status receives the outcome.
+    std::size_t push(const std::uint8_t* data, std::size_t length, frame_status& status) noexcept
+    {
+        std::size_t i = 0;
+        status = frame_status::incomplete;
+        while (i < length) {
+            if (remaining_ && !discard_ && !complete_) {
+                // Copy the data bytes of the current block in one go.
+                std::size_t chunk = length - i < remaining_ ? length - i : remaining_;
+                chunk = detail::find_zero(data + i, chunk);
+                if (chunk > capacity_ - size_) {
+                    chunk = capacity_ - size_;
+                }
+                if (chunk) {
+                    std::memcpy(buffer_ + size_, data + i, chunk);
+                    size_ += chunk;
+                    remaining_ -= chunk;
+                    i += chunk;
+                    continue;
+                }
+            } else if (discard_ && !complete_) {
+                const std::size_t skip = detail::find_zero(data + i, length - i);
+                i += skip;
+                if (i == length) {
+                    break;
+                }
+            }
+            status = push(data[i++]);
+            if (status != frame_status::incomplete) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    /// Consumes bytes from @p ring without copying them elsewhere until a
+    /// frame ends (or fails) or the ring is empty.
+    template <typename Ring>
+    frame_status push(Ring& ring) noexcept
+    {
+        for (;;) {
+            const auto region = ring.claim_read();
+            if (region.empty()) {
+                return frame_status::incomplete;
+            }
+            frame_status status;
+            ring.commit_read(push(region.data, region.size, status));
+            if (status != frame_status::incomplete) {
+                return status;
+            }
+        }
+    }
+
+private:
+    void begin_push() noexcept
+    {
+        if (complete_) {
+            size_ = 0;
+            complete_ = false;
+        }
+    }
+
+    frame_status start_block(std::uint8_t code) noexcept
+    {
+        if (pending_zero_) {
+            if (size_ == capacity_) {
+                return fail(frame_status::overflow);
+            }
+            buffer_[size_++] = 0;
+        }
+        remaining_ = static_cast<std::size_t>(code) - 1;
+        pending_zero_ = code != 0xff;
+        return frame_status::incomplete;
+    }
+
+    frame_status end_frame() noexcept
+    {
+        const bool empty = size_ == 0 && !pending_zero_ && remaining_ == 0;
+        const bool truncated = remaining_ != 0;
+        const bool discarded = discard_;
+        const std::size_t size = size_;
+        reset();
+        if (discarded || empty) {
+            return frame_status::incomplete;
+        }
+        if (truncated) {
+            return frame_status::invalid;
+        }
+        size_ = size;
+        complete_ = true;
+        return frame_status::ok;
+    }
+
+    frame_status fail(frame_status status) noexcept
+    {
+        discard_ = true;
+        return status;
+    }
+
+    std::uint8_t* buffer_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+    std::size_t remaining_ = 0; // data bytes left in the current block
+    bool pending_zero_ = false; // previous block ended with an implicit zero
+    bool discard_ = false;
+    bool complete_ = false;
+};
+
+/// Encodes @p length bytes at @p src followed by a zero delimiter directly
+/// into the byte ring @p ring. Nothing is written unless the worst-case
+/// encoded frame fits in the free space. Must be called from the ring's
+/// producer context.
+template <typename Ring>
+bool cobs_write(Ring& ring, const std::uint8_t* src, std::size_t length) noexcept
+{
+    if (Ring::capacity() - ring.size() < cobs_max_encoded_size(length) + 1) {
+        return false;
+    }
+    std::size_t in = 0;
+    for (;;) {
+        const std::size_t limit = length - in < 254 ? length - in : 254;
+        const std::size_t run = detail::find_zero(src + in, limit);
+        const auto code = static_cast<std::uint8_t>(run + 1);
+        ring.write(&code, 1);
+        ring.write(src + in, run);
+        in += run;
+        if (in == length) {
+            break;
+        }
+        if (run < 254) {
+            ++in;
+            if (in == length) {
+                const std::uint8_t empty_block = 1;
+                ring.write(&empty_block, 1);
+                break;
+            }
+        }
+    }
+    const std::uint8_t delimiter = 0;
+    ring.write(&delimiter, 1);
+    return true;
+}
+
+} // namespace embec
+
+#endif // EMBEC_COBS_HPP
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file config.hpp
+/// @brief Build-time configuration shared by all embec components.
+///
+/// Every macro here may be predefined by the application (for example on the
+/// compiler command line) to adapt the library to a particular target.
+
+#ifndef EMBEC_CONFIG_HPP
+#define EMBEC_CONFIG_HPP
+
+/// Assertion hook used for precondition checks. Defaults to assert(), which
+/// compiles to nothing when NDEBUG is defined.
+#ifndef EMBEC_ASSERT
+#include <cassert>
+#define EMBEC_ASSERT(expr) assert(expr)
+#endif
+
+/// Size of the destructive interference region used to keep data written by
+/// different execution contexts apart. Cache-less MCUs only need word
+/// alignment, so padding is kept small there.
+#ifndef EMBEC_CACHE_LINE_SIZE
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86) || defined(__aarch64__) || defined(_M_ARM64)
+#define EMBEC_CACHE_LINE_SIZE 64
+#else
+#define EMBEC_CACHE_LINE_SIZE 8
+#endif
+#endif
+
+/// Defined to 1 when host-side vector paths may use SSE2 intrinsics. Define
+/// EMBEC_NO_SIMD to build only the portable implementations.
+#if !defined(EMBEC_NO_SIMD) && !defined(EMBEC_SIMD_SSE2) && \
+    (defined(__SSE2__) || defined(_M_X64))
+#define EMBEC_SIMD_SSE2 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define EMBEC_LIKELY(x) __builtin_expect(!!(x), 1)
+#define EMBEC_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define EMBEC_LIKELY(x) (x)
+#define EMBEC_UNLIKELY(x) (x)
+#endif
+
+#endif // EMBEC_CONFIG_HPP
@@ -0,0 +1,380 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file crc.hpp
+/// @brief Generic CRC engine with compile-time generated lookup tables.
+///
+/// A CRC is described by a crc_spec (width, polynomial, initial value, input
+/// and output reflection, final XOR; the usual Rocksoft/"CRC catalogue"
+/// model) and computed by crc_engine using one of several strategies that
+/// trade ROM for speed:
+///
+/// | Strategy | Table size                  | Work per byte          |
+/// | -------- | --------------------------- | ---------------------- |
+/// | bitwise  | none                        | 8 shift/xor steps      |
+/// | nibble   | 16 entries                  | 2 lookups              |
+/// | byte     | 256 entries                 | 1 lookup               |
+/// | slice8   | 8 x 256 entries             | 1 lookup, 8 bytes/step |
+///
+/// Tables are constexpr, so they are generated by the compiler and placed in
+/// read-only memory; only the tables of the strategies actually used are
+/// emitted. All computations are constexpr as well.
+
+#ifndef EMBEC_CRC_HPP
+#define EMBEC_CRC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace embec {
+
+enum class crc_strategy {
+    bitwise,
+    nibble,
+    byte,
+    slice8,
+};
+
+namespace detail {
+
+template <unsigned Width>
+using crc_uint = std::conditional_t<
+    (Width <= 8), std::uint8_t,
+    std::conditional_t<(Width <= 16), std::uint16_t,
+                       std::conditional_t<(Width <= 32), std::uint32_t, std::uint64_t>>>;
+
+template <typename T>
+constexpr T reflect(T value, unsigned bits) noexcept
+{
+    T result = 0;
+    for (unsigned i = 0; i < bits; ++i) {
+        result = static_cast<T>((result << 1) | (value & 1u));
+        value = static_cast<T>(value >> 1);
+    }
+    return result;
+}
+
+} // namespace detail
+
+/// Parameter set of a CRC algorithm.
+template <unsigned Width, std::uint64_t Poly, std::uint64_t Init, bool RefIn,
+          bool RefOut, std::uint64_t XorOut>
+struct crc_spec {
+    static_assert(Width >= 1 && Width <= 64, "CRC width must be 1..64 bits");
+
+    using value_type = detail::crc_uint<Width>;
+
+    static constexpr unsigned width = Width;
+    static constexpr value_type poly = static_cast<value_type>(Poly);
+    static constexpr value_type init = static_cast<value_type>(Init);
+    static constexpr bool refin = RefIn;
+    static constexpr bool refout = RefOut;
+    static constexpr value_type xorout = static_cast<value_type>(XorOut);
+};
+
+/// Commonly used CRC algorithms. Names follow the CRC RevEng catalogue.
+namespace crc_catalog {
+using crc8_smbus = crc_spec<8, 0x07, 0x00, false, false, 0x00>;
+using crc8_maxim = crc_spec<8, 0x31, 0x00, true, true, 0x00>;
+using crc7_mmc = crc_spec<7, 0x09, 0x00, false, false, 0x00>;
+using crc16_ccitt_false = crc_spec<16, 0x1021, 0xffff, false, false, 0x0000>;
+using crc16_xmodem = crc_spec<16, 0x1021, 0x0000, false, false, 0x0000>;
+using crc16_kermit = crc_spec<16, 0x1021, 0x0000, true, true, 0x0000>;
+using crc16_modbus = crc_spec<16, 0x8005, 0xffff, true, true, 0x0000>;
+using crc32 = crc_spec<32, 0x04c11db7, 0xffffffff, true, true, 0xffffffff>;
+using crc32c = crc_spec<32, 0x1edc6f41, 0xffffffff, true, true, 0xffffffff>;
+using crc32_mpeg2 = crc_spec<32, 0x04c11db7, 0xffffffff, false, false, 0x00000000>;
+using crc64_xz = crc_spec<64, 0x42f0e1eba9ea3693, 0xffffffffffffffff, true, true,
+                          0xffffffffffffffff>;
+} // namespace crc_catalog
+
+namespace detail {
+
+/// Register layout shared by all strategies of one spec.
+///
+/// Reflected CRCs keep the register right-aligned and shift right.
+/// Non-reflected CRCs keep it left-aligned in a register of at least eight
+/// bits and shift left, which handles widths below eight uniformly.
+template <typename Spec>
+struct crc_model {
+    using reg_t = typename Spec::value_type;
+
+    static constexpr unsigned reg_bits = sizeof(reg_t) * 8;
+    static constexpr unsigned shift = Spec::refin ? 0 : reg_bits - Spec::width;
+    static constexpr reg_t top_bit = static_cast<reg_t>(reg_t{1} << (reg_bits - 1));
+    static constexpr reg_t width_mask = static_cast<reg_t>(
+        Spec::width == reg_bits ? ~reg_t{0} : ((reg_t{1} << Spec::width) - 1));
+
+    static constexpr reg_t poly = Spec::refin
+        ? reflect(Spec::poly, Spec::width)
+        : static_cast<reg_t>(Spec::poly << shift);
+
+    static constexpr reg_t initial = Spec::refin
+        ? reflect(static_cast<reg_t>(Spec::init & width_mask), Spec::width)
+        : static_cast<reg_t>((Spec::init & width_mask) << shift);
+
+    /// Feeds the low @p bits bits of @p data (MSB first for non-reflected,
+    /// LSB first for reflected specs) one bit at a time.
+    static constexpr reg_t feed_bits(reg_t reg, unsigned data, unsigned bits) noexcept
+    {
+        if (Spec::refin) {
+            reg = static_cast<reg_t>(reg ^ data);
+            for (unsigned i = 0; i < bits; ++i) {
+                reg = static_cast<reg_t>((reg & 1u) ? (reg >> 1) ^ poly : reg >> 1);
+            }
+        } else {
+            reg = static_cast<reg_t>(reg ^ (static_cast<reg_t>(data) << (reg_bits - bits)));
+            for (unsigned i = 0; i < bits; ++i) {
+                reg = static_cast<reg_t>((reg & top_bit) ? (reg << 1) ^ poly : reg << 1);
+            }
+        }
+        return reg;
+    }
+
+    static constexpr reg_t finish(reg_t reg) noexcept
+    {
+        reg = static_cast<reg_t>(reg >> shift);
+        if (Spec::refin != Spec::refout) {
+            reg = reflect(reg, Spec::width);
+        }
+        return static_cast<reg_t>((reg ^ Spec::xorout) & width_mask);
+    }
+};
+
+template <typename Spec>
+struct crc_nibble_table {
+    using model = crc_model<Spec>;
+
+    static constexpr std::array<typename model::reg_t, 16> make() noexcept
+    {
+        std::array<typename model::reg_t, 16> table{};
+        for (unsigned i = 0; i < 16; ++i) {
+            table[i] = model::feed_bits(0, i, 4);
+        }
+        return table;
+    }
+
+    static constexpr std::array<typename model::reg_t, 16> value = make();
+};
+
+template <typename Spec>
+struct crc_byte_table {
+    using model = crc_model<Spec>;
+
+    static constexpr std::array<typename model::reg_t, 256> make() noexcept
+    {
+        std::array<typename model::reg_t, 256> table{};
+        for (unsigned i = 0; i < 256; ++i) {
+            table[i] = model::feed_bits(0, i, 8);
+        }
+        return table;
+    }
+
+    static constexpr std::array<typename model::reg_t, 256> value = make();
+};
+
+/// Tables for slice-by-8: entry [k][b] is the register after feeding byte b
+/// followed by k zero bytes into a zero register.
+template <typename Spec>
+struct crc_slice8_table {
+    using model = crc_model<Spec>;
+    using reg_t = typename model::reg_t;
+    using table_t = std::array<std::array<reg_t, 256>, 8>;
+
+    static constexpr table_t make() noexcept
+    {
+        table_t table{};
+        for (unsigned i = 0; i < 256; ++i) {
+            table[0][i] = model::feed_bits(0, i, 8);
+        }
+        for (unsigned k = 1; k < 8; ++k) {
+            for (unsigned i = 0; i < 256; ++i) {
+                const reg_t prev = table[k - 1][i];
+                if (Spec::refin) {
+                    table[k][i] = static_cast<reg_t>(
+                        (model::reg_bits > 8 ? prev >> 8 : 0) ^ table[0][prev & 0xffu]);
+                } else {
+                    table[k][i] = static_cast<reg_t>(
+                        (model::reg_bits > 8 ? prev << 8 : 0) ^
+                        table[0][(prev >> (model::reg_bits - 8)) & 0xffu]);
+                }
+            }
+        }
+        return table;
+    }
+
+    static constexpr table_t value = make();
+};
+
+} // namespace detail
+
+/// CRC calculator for @p Spec using @p Strategy.
+///
+/// Use compute() for one-shot checksums or an instance for incremental
+/// computation over data arriving in pieces:
+/// @code
+/// embec::crc_engine<embec::crc_catalog::crc32> crc;
+/// crc.update(header, header_len).update(payload, payload_len);
+/// uint32_t sum = crc.value();
+/// @endcode
+template <typename Spec, crc_strategy Strategy = crc_strategy::byte>
+class crc_engine {
+    using model = detail::crc_model<Spec>;
+    using reg_t = typename model::reg_t;
+
+public:
+    using spec = Spec;
+    using value_type = typename Spec::value_type;
+
+    static constexpr crc_strategy strategy = Strategy;
+
+    constexpr crc_engine() noexcept = default;
+
+    /// Restarts the computation.
+    constexpr void reset() noexcept { reg_ = model::initial; }
+
+    /// Processes @p length bytes at @p data.
+    constexpr crc_engine& update(const std::uint8_t* data, std::size_t length) noexcept
+    {
+        reg_ = process(reg_, data, length);
+        return *this;
+    }
+
+    crc_engine& update(const void* data, std::size_t length) noexcept
+    {
+        return update(static_cast<const std::uint8_t*>(data), length);
+    }
+
+    /// CRC of all data processed since construction or reset(). The engine
+    /// state is not modified, so more data may follow.
+    constexpr value_type value() const noexcept { return model::finish(reg_); }
+
+    static constexpr value_type compute(const std::uint8_t* data, std::size_t length) noexcept
+    {
+        return model::finish(process(model::initial, data, length));
+    }
+
+    static value_type compute(const void* data, std::size_t length) noexcept
+    {
+        return compute(static_cast<const std::uint8_t*>(data), length);
+    }
+
+private:
+    static constexpr reg_t process(reg_t reg, const std::uint8_t* p, std::size_t n) noexcept
+    {
+        switch (Strategy) {
+        case crc_strategy::bitwise:
+            return process_bitwise(reg, p, n);
+        case crc_strategy::nibble:
+            return process_nibble(reg, p, n);
+        case crc_strategy::byte:
+            return process_byte(reg, p, n);
+        case crc_strategy::slice8:
+            return process_slice8(reg, p, n);
+        }
+        return reg;
+    }
+
+    static constexpr reg_t process_bitwise(reg_t reg, const std::uint8_t* p, std::size_t n) noexcept
+    {
+        while (n--) {
+            reg = model::feed_bits(reg, *p++, 8);
+        }
+        return reg;
+    }
+
+    static constexpr reg_t process_nibble(reg_t reg, const std::uint8_t* p, std::size_t n) noexcept
+    {
+        const auto& table = detail::crc_nibble_table<Spec>::value;
+        constexpr unsigned top = model::reg_bits - 4;
+        while (n--) {
+            if (Spec::refin) {
+                reg = static_cast<reg_t>(reg ^ *p++);
+                reg = static_cast<reg_t>(shr(reg, 4) ^ table[reg & 0x0fu]);
+                reg = static_cast<reg_t>(shr(reg, 4) ^ table[reg & 0x0fu]);
+            } else {
+                reg = static_cast<reg_t>(reg ^ (static_cast<reg_t>(*p++) << (model::reg_bits - 8)));
+                reg = static_cast<reg_t>(shl(reg, 4) ^ table[(reg >> top) & 0x0fu]);
+                reg = static_cast<reg_t>(shl(reg, 4) ^ table[(reg >> top) & 0x0fu]);
+            }
+        }
+        return reg;
+    }
+
+    static constexpr reg_t byte_step(reg_t reg, std::uint8_t byte) noexcept
+    {
+        const auto& table = detail::crc_byte_table<Spec>::value;
+        if (Spec::refin) {
+            return static_cast<reg_t>(shr(reg, 8) ^ table[(reg ^ byte) & 0xffu]);
+        }
+        return static_cast<reg_t>(
+            shl(reg, 8) ^ table[((reg >> (model::reg_bits - 8)) ^ byte) & 0xffu]);
+    }
+
+    static constexpr reg_t process_byte(reg_t reg, const std::uint8_t* p, std::size_t n) noexcept
+    {
+        while (n--) {
+            reg = byte_step(reg, *p++);
+        }
+        return reg;
+    }
+
+    static constexpr reg_t process_slice8(reg_t reg, const std::uint8_t* p, std::size_t n) noexcept
+    {
+        const auto& t = detail::crc_slice8_table<Spec>::value;
+        while (n >= 8) {
+            // Byte-wise assembly keeps this constexpr and alignment-agnostic;
+            // compilers fold it into a single load (plus bswap if needed).
+            if (Spec::refin) {
+                const std::uint64_t word = load_le64(p) ^ static_cast<std::uint64_t>(reg);
+                reg = static_cast<reg_t>(
+                    t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^
+                    t[5][(word >> 16) & 0xff] ^ t[4][(word >> 24) & 0xff] ^
+                    t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^
+                    t[1][(word >> 48) & 0xff] ^ t[0][word >> 56]);
+            } else {
+                const std::uint64_t word =
+                    load_be64(p) ^ (static_cast<std::uint64_t>(reg) << (64 - model::reg_bits));
+                reg = static_cast<reg_t>(
+                    t[7][word >> 56] ^ t[6][(word >> 48) & 0xff] ^
+                    t[5][(word >> 40) & 0xff] ^ t[4][(word >> 32) & 0xff] ^
+                    t[3][(word >> 24) & 0xff] ^ t[2][(word >> 16) & 0xff] ^
+                    t[1][(word >> 8) & 0xff] ^ t[0][word & 0xff]);
+            }
+            p += 8;
+            n -= 8;
+        }
+        return process_byte(reg, p, n);
+    }
+
+    // Shifts that yield zero instead of being undefined for 8-bit registers.
+    static constexpr reg_t shr(reg_t reg, unsigned bits) noexcept
+    {
+        return model::reg_bits > bits ? static_cast<reg_t>(reg >> bits) : reg_t{0};
+    }
+    static constexpr reg_t shl(reg_t reg, unsigned bits) noexcept
+    {
+        return model::reg_bits > bits ? static_cast<reg_t>(reg << bits) : reg_t{0};
+    }
+
+    static constexpr std::uint64_t load_le64(const std::uint8_t* p) noexcept
+    {
+        return std::uint64_t{p[0]} | std::uint64_t{p[1]} << 8 | std::uint64_t{p[2]} << 16 |
+               std::uint64_t{p[3]} << 24 | std::uint64_t{p[4]} << 32 |
+               std::uint64_t{p[5]} << 40 | std::uint64_t{p[6]} << 48 |
+               std::uint64_t{p[7]} << 56;
+    }
+    static constexpr std::uint64_t load_be64(const std::uint8_t* p) noexcept
+    {
+        return std::uint64_t{p[0]} << 56 | std::uint64_t{p[1]} << 48 |
+               std::uint64_t{p[2]} << 40 | std::uint64_t{p[3]} << 32 |
+               std::uint64_t{p[4]} << 24 | std::uint64_t{p[5]} << 16 |
+               std::uint64_t{p[6]} << 8 | std::uint64_t{p[7]};
+    }
+
+    reg_t reg_ = model::initial;
+};
+
+} // namespace embec
+
+#endif // EMBEC_CRC_HPP
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file cycle_counter.hpp
+/// @brief Free-running cycle counter with per-target backends.
+///
+/// The backend is chosen at compile time:
+///  - EMBEC_CYCLE_COUNTER_CUSTOM: the application provides
+///    `extern "C" embec_cycles_t embec_cycle_counter_read(void)` (and sets
+///    EMBEC_CYCLE_COUNTER_TYPE if it is not uint32_t).
+///  - Armv7-M/Armv8-M Mainline, or EMBEC_CYCLE_COUNTER_DWT: the DWT CYCCNT
+///    register. Call cycle_counter::enable() once at start-up.
+///  - x86: the time-stamp counter (RDTSC). On modern CPUs this ticks at a
+///    constant reference rate, not the current core clock.
+///  - AArch64: the generic timer virtual count (CNTVCT_EL0).
+///  - Anything else: a monotonic nanosecond clock.
+///
+/// Differences of two readings are always correct across one wrap of the
+/// counter because the arithmetic is unsigned.
+
+#ifndef EMBEC_CYCLE_COUNTER_HPP
+#define EMBEC_CYCLE_COUNTER_HPP
+
+#include <cstdint>
+
+#if defined(EMBEC_CYCLE_COUNTER_CUSTOM)
+#ifndef EMBEC_CYCLE_COUNTER_TYPE
+#define EMBEC_CYCLE_COUNTER_TYPE std::uint32_t
+#endif
+#elif defined(EMBEC_CYCLE_COUNTER_DWT) || defined(__ARM_ARCH_7M__) || \
+    defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__) ||   \
+    defined(__ARM_ARCH_8_1M_MAIN__)
+#ifndef EMBEC_CYCLE_COUNTER_DWT
+#define EMBEC_CYCLE_COUNTER_DWT
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+#define EMBEC_CYCLE_COUNTER_TSC
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#define EMBEC_CYCLE_COUNTER_TSC
+#include <intrin.h>
+#elif defined(__aarch64__)
+#define EMBEC_CYCLE_COUNTER_CNTVCT
+#else
+#define EMBEC_CYCLE_COUNTER_CLOCK
+#include <chrono>
+#endif
+
+namespace embec {
+
+#if defined(EMBEC_CYCLE_COUNTER_CUSTOM)
+using cycles_t = EMBEC_CYCLE_COUNTER_TYPE;
+#elif defined(EMBEC_CYCLE_COUNTER_DWT)
+using cycles_t = std::uint32_t;
+#else
+using cycles_t = std::uint64_t;
+#endif
+
+} // namespace embec
+
+#if defined(EMBEC_CYCLE_COUNTER_CUSTOM)
+extern "C" embec::cycles_t embec_cycle_counter_read(void);
+#endif
+
+namespace embec {
+
+struct cycle_counter {
+    /// Short description of the active backend, for reports.
+    static constexpr const char* name() noexcept
+    {
+#if defined(EMBEC_CYCLE_COUNTER_CUSTOM)
+        return "custom";
+#elif defined(EMBEC_CYCLE_COUNTER_DWT)
+        return "dwt";
+#elif defined(EMBEC_CYCLE_COUNTER_TSC)
+        return "tsc";
+#elif defined(EMBEC_CYCLE_COUNTER_CNTVCT)
+        return "cntvct";
+#else
+        return "clock_ns";
+#endif
+    }
+
+    /// Starts the counter if the backend needs it. Harmless to call twice.
+    static void enable() noexcept
+    {
+#if defined(EMBEC_CYCLE_COUNTER_DWT)
+        *demcr |= demcr_trcena;
+        *dwt_ctrl |= dwt_ctrl_cyccntena;
+#endif
+    }
+
+    static inline cycles_t now() noexcept
+    {
+#if defined(EMBEC_CYCLE_COUNTER_CUSTOM)
+        return embec_cycle_counter_read();
+#elif defined(EMBEC_CYCLE_COUNTER_DWT)
+        return *dwt_cyccnt;
+#elif defined(EMBEC_CYCLE_COUNTER_TSC)
+        return __rdtsc();
+#elif defined(EMBEC_CYCLE_COUNTER_CNTVCT)
+        std::uint64_t value;
+        asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(value) : : "memory");
+        return value;
+#else
+        return static_cast<cycles_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+private:
+#if defined(EMBEC_CYCLE_COUNTER_DWT)
+    static constexpr std::uint32_t demcr_trcena = 1u << 24;
+    static constexpr std::uint32_t dwt_ctrl_cyccntena = 1u << 0;
+    static inline volatile std::uint32_t* const demcr =
+        reinterpret_cast<volatile std::uint32_t*>(0xe000edfcu);
+    static inline volatile std::uint32_t* const dwt_ctrl =
+        reinterpret_cast<volatile std::uint32_t*>(0xe0001000u);
+    static inline volatile std::uint32_t* const dwt_cyccnt =
+        reinterpret_cast<volatile std::uint32_t*>(0xe0001004u);
+#endif
+};
+
+} // namespace embec
+
+#endif // EMBEC_CYCLE_COUNTER_HPP
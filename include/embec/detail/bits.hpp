@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file bits.hpp
+/// @brief Portable bit scanning helpers.
+
+#ifndef EMBEC_DETAIL_BITS_HPP
+#define EMBEC_DETAIL_BITS_HPP
+
+#include <cstdint>
+
+namespace embec {
+namespace detail {
+
+/// Index of the lowest set bit. @p value must be non-zero.
+constexpr unsigned count_trailing_zeros(std::uint64_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+    unsigned n = 0;
+    while (!(value & 1u)) {
+        value >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/// Index of the highest set bit. @p value must be non-zero.
+constexpr unsigned highest_bit(std::uint64_t value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned n = 0;
+    while (value >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/// Rotates the low @p width bits of @p value right by @p shift (< width).
+constexpr std::uint64_t rotate_right(std::uint64_t value, unsigned shift, unsigned width) noexcept
+{
+    const std::uint64_t mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    return shift == 0 ? value : ((value >> shift) | (value << (width - shift))) & mask;
+}
+
+} // namespace detail
+} // namespace embec
+
+#endif // EMBEC_DETAIL_BITS_HPP
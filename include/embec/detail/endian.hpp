@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file endian.hpp
+/// @brief Byte order selection and unaligned, byte-order-converting loads
+///        and stores.
+///
+/// Loads and stores go through std::memcpy on a value of the same size, which
+/// is well defined for any alignment and which compilers turn into a single
+/// (possibly unaligned) load or store, followed by a byte swap instruction
+/// when the byte order differs from the host's.
+
+#ifndef EMBEC_DETAIL_ENDIAN_HPP
+#define EMBEC_DETAIL_ENDIAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace embec {
+
+enum class byte_order {
+    big,
+    little,
+};
+
+/// Byte order of the target.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr byte_order native_byte_order = byte_order::big;
+#else
+inline constexpr byte_order native_byte_order = byte_order::little;
+#endif
+
+namespace detail {
+
+constexpr std::uint8_t byteswap(std::uint8_t v) noexcept { return v; }
+
+constexpr std::uint16_t byteswap(std::uint16_t v) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap16(v);
+#else
+    return static_cast<std::uint16_t>((v << 8) | (v >> 8));
+#endif
+}
+
+constexpr std::uint32_t byteswap(std::uint32_t v) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(v);
+#else
+    v = ((v & 0x00ff00ffu) << 8) | ((v >> 8) & 0x00ff00ffu);
+    return (v << 16) | (v >> 16);
+#endif
+}
+
+constexpr std::uint64_t byteswap(std::uint64_t v) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(v);
+#else
+    return (std::uint64_t{byteswap(static_cast<std::uint32_t>(v))} << 32) |
+           byteswap(static_cast<std::uint32_t>(v >> 32));
+#endif
+}
+
+template <std::size_t Size>
+struct unsigned_of_size;
+template <>
+struct unsigned_of_size<1> { using type = std::uint8_t; };
+template <>
+struct unsigned_of_size<2> { using type = std::uint16_t; };
+template <>
+struct unsigned_of_size<4> { using type = std::uint32_t; };
+template <>
+struct unsigned_of_size<8> { using type = std::uint64_t; };
+
+/// Types that can be loaded and stored with a byte order: integers, bool,
+/// enumerations and IEEE 754 float and double.
+template <typename T>
+constexpr bool is_endian_value = (std::is_integral<T>::value || std::is_enum<T>::value ||
+                                  std::is_floating_point<T>::value) &&
+                                 (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                                  sizeof(T) == 8);
+
+/// Reads a T stored in @p Order at @p p, which need not be aligned.
+template <typename T, byte_order Order>
+inline T load(const void* p) noexcept
+{
+    static_assert(is_endian_value<T>, "unsupported type");
+    using raw_type = typename unsigned_of_size<sizeof(T)>::type;
+    raw_type raw;
+    std::memcpy(&raw, p, sizeof(raw));
+    if constexpr (Order != native_byte_order) {
+        raw = byteswap(raw);
+    }
+    if constexpr (std::is_same<T, bool>::value) {
+        return raw != 0;
+    } else {
+        T value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return value;
+    }
+}
+
+/// Writes @p value in @p Order at @p p, which need not be aligned.
+template <byte_order Order, typename T>
+inline void store(void* p, T value) noexcept
+{
+    static_assert(is_endian_value<T>, "unsupported type");
+    using raw_type = typename unsigned_of_size<sizeof(T)>::type;
+    raw_type raw;
+    if constexpr (std::is_same<T, bool>::value) {
+        raw = value ? 1 : 0;
+    } else {
+        std::memcpy(&raw, &value, sizeof(raw));
+    }
+    if constexpr (Order != native_byte_order) {
+        raw = byteswap(raw);
+    }
+    std::memcpy(p, &raw, sizeof(raw));
+}
+
+} // namespace detail
+} // namespace embec
+
+#endif // EMBEC_DETAIL_ENDIAN_HPP
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file inline_storage.hpp
+/// @brief Element storage and bulk element operations for fixed-capacity
+///        containers.
+///
+/// Trivial element types are kept in a plain array so that containers of
+/// them stay literal types (usable in constant expressions) and bulk
+/// operations reduce to memcpy/memmove. Other types live in raw aligned
+/// bytes and are constructed and destroyed explicitly.
+
+#ifndef EMBEC_DETAIL_INLINE_STORAGE_HPP
+#define EMBEC_DETAIL_INLINE_STORAGE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace embec {
+namespace detail {
+
+/// Creates a T from @p args, falling back to aggregate initialisation.
+template <typename T, typename... Args>
+constexpr T make_value(Args&&... args)
+{
+    if constexpr (std::is_constructible<T, Args&&...>::value) {
+        return T(std::forward<Args>(args)...);
+    } else {
+        return T{std::forward<Args>(args)...};
+    }
+}
+
+template <typename T, std::size_t N, bool Trivial = std::is_trivial<T>::value>
+struct inline_storage {
+    constexpr T* data() noexcept { return elems; }
+    constexpr const T* data() const noexcept { return elems; }
+
+    template <typename... Args>
+    constexpr void construct(std::size_t index, Args&&... args)
+    {
+        elems[index] = make_value<T>(std::forward<Args>(args)...);
+    }
+
+    constexpr void destroy(std::size_t) noexcept {}
+
+    // Value-initialised because constexpr objects must be fully initialised.
+    T elems[N]{};
+};
+
+template <typename T, std::size_t N>
+struct inline_storage<T, N, false> {
+    T* data() noexcept { return std::launder(reinterpret_cast<T*>(bytes)); }
+    const T* data() const noexcept
+    {
+        return std::launder(reinterpret_cast<const T*>(bytes));
+    }
+
+    template <typename... Args>
+    void construct(std::size_t index, Args&&... args)
+    {
+        if constexpr (std::is_constructible<T, Args&&...>::value) {
+            ::new (static_cast<void*>(bytes + index * sizeof(T))) T(std::forward<Args>(args)...);
+        } else {
+            ::new (static_cast<void*>(bytes + index * sizeof(T))) T{std::forward<Args>(args)...};
+        }
+    }
+
+    void destroy(std::size_t index) noexcept { data()[index].~T(); }
+
+    alignas(T) unsigned char bytes[sizeof(T) * N];
+};
+
+template <typename It>
+using require_input_iterator = std::enable_if_t<std::is_convertible<
+    typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>::value>;
+
+/// True if @p It is a pointer to (possibly const) T, so that a range of it
+/// can be copied with uninitialized_copy_n().
+template <typename It, typename T>
+constexpr bool is_pointer_to = std::is_pointer<It>::value &&
+                               std::is_same<std::remove_cv_t<std::remove_pointer_t<It>>, T>::value;
+
+/// Constructs @p count copies of @p src into uninitialised @p dst.
+template <typename T>
+void uninitialized_copy_n(const T* src, std::size_t count, T* dst)
+{
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        if (count) {
+            std::memcpy(static_cast<void*>(dst), src, count * sizeof(T));
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(dst + i)) T(src[i]);
+        }
+    }
+}
+
+/// Move-constructs @p count elements from @p src into uninitialised @p dst.
+template <typename T>
+void uninitialized_move_n(T* src, std::size_t count, T* dst)
+{
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        if (count) {
+            std::memcpy(static_cast<void*>(dst), src, count * sizeof(T));
+        }
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(dst + i)) T(std::move(src[i]));
+        }
+    }
+}
+
+/// Destroys @p count elements at @p first.
+template <typename T>
+void destroy_n(T* first, std::size_t count) noexcept
+{
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+        for (std::size_t i = 0; i < count; ++i) {
+            first[i].~T();
+        }
+    }
+}
+
+/// Removes the @p count elements at @p pos from the @p size live elements at
+/// @p data by moving the tail down and destroying the vacated slots.
+template <typename T>
+void erase_gap(T* data, std::size_t size, std::size_t pos, std::size_t count) noexcept
+{
+    if (count == 0) {
+        return; // std::move would self-move-assign the tail
+    }
+    const std::size_t tail = size - pos - count;
+    if constexpr (std::is_trivially_copyable<T>::value) {
+        if (tail) {
+            std::memmove(static_cast<void*>(data + pos), data + pos + count, tail * sizeof(T));
+        }
+    } else {
+        std::move(data + pos + count, data + size, data + pos);
+        destroy_n(data + size - count, count);
+    }
+}
+
+} // namespace detail
+} // namespace embec
+
+#endif // EMBEC_DETAIL_INLINE_STORAGE_HPP
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file sample_traits.hpp
+/// @brief How the statistics and filters see their sample types.
+///
+/// Floating-point samples are used as they are. Integer and fixed-point
+/// samples are handled as raw integers with fraction_bits fraction bits, so
+/// that sums and products can be formed exactly in 64 bits and rounded
+/// once, with the sample type's own rounding and overflow policies (integers
+/// round to nearest and saturate).
+
+#ifndef EMBEC_DETAIL_SAMPLE_TRAITS_HPP
+#define EMBEC_DETAIL_SAMPLE_TRAITS_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "embec/fixed.hpp"
+
+namespace embec {
+namespace detail {
+
+template <typename T, typename = void>
+struct sample_traits;
+
+template <typename T>
+struct sample_traits<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+    static constexpr bool is_floating = true;
+    static constexpr bool is_signed = true;
+    static constexpr int fraction_bits = 0;
+    static constexpr int raw_bits = 8 * sizeof(T);
+
+    template <typename Real>
+    static constexpr Real to_real(T x) noexcept
+    {
+        return static_cast<Real>(x);
+    }
+    template <typename Real>
+    static constexpr T from_real(Real x) noexcept
+    {
+        return static_cast<T>(x);
+    }
+};
+
+template <typename T>
+struct sample_traits<
+    T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>> {
+    static_assert(sizeof(T) <= 4, "integer samples are limited to 32 bits");
+
+    static constexpr bool is_floating = false;
+    static constexpr bool is_signed = std::is_signed<T>::value;
+    static constexpr int fraction_bits = 0;
+    static constexpr int raw_bits = 8 * sizeof(T);
+
+    static constexpr std::int64_t raw(T x) noexcept { return static_cast<std::int64_t>(x); }
+
+    /// Rounds a value with @p frac fraction bits to nearest and saturates.
+    static constexpr T from_wide(std::int64_t value, int frac) noexcept
+    {
+        value = rescale(value, frac, 0, rounding::nearest);
+        constexpr auto lo = static_cast<std::int64_t>(std::numeric_limits<T>::min());
+        constexpr auto hi = static_cast<std::int64_t>(std::numeric_limits<T>::max());
+        return static_cast<T>(value < lo ? lo : value > hi ? hi : value);
+    }
+
+    template <typename Real>
+    static constexpr Real to_real(T x) noexcept
+    {
+        return static_cast<Real>(x);
+    }
+};
+
+template <int I, int F, rounding R, overflow O>
+struct sample_traits<fixed<I, F, R, O>> {
+    using type = fixed<I, F, R, O>;
+
+    static constexpr bool is_floating = false;
+    static constexpr bool is_signed = true;
+    static constexpr int fraction_bits = F;
+    static constexpr int raw_bits = 8 * sizeof(typename type::raw_type);
+
+    static constexpr std::int64_t raw(type x) noexcept { return x.raw(); }
+
+    static constexpr type from_wide(std::int64_t value, int frac) noexcept
+    {
+        return type::from_wide(value, frac);
+    }
+
+    template <typename Real>
+    static constexpr Real to_real(type x) noexcept
+    {
+        return static_cast<Real>(x.raw()) / static_cast<Real>(std::int64_t{1} << F);
+    }
+};
+
+/// Default type for means and variances: the sample type itself for
+/// floating-point samples, float (single precision, as on Cortex-M4F)
+/// otherwise.
+template <typename T>
+using default_real_t = std::conditional_t<std::is_floating_point<T>::value, T, float>;
+
+/// @p num / @p den (@p den > 0) rounded to nearest, halves away from zero.
+constexpr std::int64_t div_round(std::int64_t num, std::int64_t den) noexcept
+{
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+} // namespace detail
+} // namespace embec
+
+#endif // EMBEC_DETAIL_SAMPLE_TRAITS_HPP
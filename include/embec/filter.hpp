@@ -0,0 +1,449 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file filter.hpp
+/// @brief Signal filters for sensor pipelines: moving average, exponential
+///        average, biquad IIR, median and a debouncer.
+///
+/// Every filter processes one sample at a time with process(x), or a block
+/// with process(in, out, n) (@p out may equal @p in), and keeps a constant
+/// amount of state:
+///  - moving_average averages the last @p Window samples with a running
+///    sum, O(1) per sample;
+///  - exponential_average is the one-pole low-pass y += alpha * (x - y);
+///  - biquad is a second-order IIR section; chain several for higher
+///    orders;
+///  - median_filter takes the median of the last @p Window samples, which
+///    removes impulse noise that averaging would smear; it keeps the window
+///    sorted, O(Window) per sample, which is cheapest for the short windows
+///    (3 to 15) it is used with;
+///  - debouncer passes a change of a binary input once it has held for a
+///    number of samples.
+///
+/// @code
+/// embec::median_filter<std::int16_t, 5> despike;
+/// embec::biquad<embec::q15> lowpass(embec::biquad_coefficients::lowpass(50, 1000));
+/// despike.process(samples, samples, n);
+/// lowpass.process(samples, samples, n);
+/// @endcode
+///
+/// Samples may be integers, fixed-point numbers or floating point (see
+/// detail/sample_traits.hpp). Integer and fixed-point filters compute in
+/// integer arithmetic only: sums and products are exact in 64 bits and
+/// rounded once per output with the sample type's policies (integers round
+/// to nearest and saturate; biquad is the exception, see there). Recursive
+/// filters depend on their previous output, so their block forms are plain
+/// loops over the sample path.
+
+#ifndef EMBEC_FILTER_HPP
+#define EMBEC_FILTER_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/sample_traits.hpp"
+
+namespace embec {
+
+/// Mean of the last @p Window samples; of all samples until @p Window have
+/// been seen.
+template <typename T, std::size_t Window>
+class moving_average {
+    static_assert(Window > 0, "Window must be non-zero");
+    using traits = detail::sample_traits<T>;
+    using sum_type = std::conditional_t<traits::is_floating, T, std::int64_t>;
+
+public:
+    using sample_type = T;
+
+    T process(T x) noexcept
+    {
+        if (size_ == Window) {
+            sum_ -= widen(history_[pos_]);
+        } else {
+            ++size_;
+        }
+        history_[pos_] = x;
+        sum_ += widen(x);
+        if (++pos_ == Window) {
+            pos_ = 0;
+            if constexpr (traits::is_floating) {
+                // Recompute the floating-point sum once per window so that
+                // rounding errors cannot accumulate.
+                sum_type sum = 0;
+                for (std::size_t i = 0; i < Window; ++i) {
+                    sum += history_[i];
+                }
+                sum_ = sum;
+            }
+        }
+        return value();
+    }
+
+    void process(const T* in, T* out, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    /// Current average; zero before the first sample.
+    T value() const noexcept
+    {
+        if (size_ == 0) {
+            return T{};
+        }
+        if constexpr (traits::is_floating) {
+            return sum_ / static_cast<T>(size_);
+        } else {
+            // A constant divisor for the usual full window compiles to a
+            // multiplication (or a shift for powers of two).
+            const std::int64_t mean =
+                EMBEC_LIKELY(size_ == Window)
+                    ? detail::div_round(sum_, static_cast<std::int64_t>(Window))
+                    : detail::div_round(sum_, static_cast<std::int64_t>(size_));
+            return traits::from_wide(mean, traits::fraction_bits);
+        }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+
+    void reset() noexcept
+    {
+        sum_ = 0;
+        pos_ = 0;
+        size_ = 0;
+    }
+
+private:
+    static constexpr sum_type widen(T x) noexcept
+    {
+        if constexpr (traits::is_floating) {
+            return x;
+        } else {
+            return traits::raw(x);
+        }
+    }
+
+    T history_[Window]{};
+    sum_type sum_ = 0;
+    std::size_t pos_ = 0;
+    std::size_t size_ = 0;
+};
+
+/// One-pole low-pass filter y += alpha * (x - y), starting from the first
+/// sample.
+///
+/// For integer and fixed-point samples, alpha is held in Q16 and the state
+/// keeps 16 guard bits below the sample's LSB (13 for 32-bit samples), so
+/// the output settles on the input instead of stopping a step short.
+template <typename T>
+class exponential_average {
+    using traits = detail::sample_traits<T>;
+    static constexpr int guard_bits = traits::raw_bits <= 16 ? 16 : 13;
+    static constexpr int alpha_bits = 16;
+    using state_type = std::conditional_t<traits::is_floating, T, std::int64_t>;
+
+public:
+    using sample_type = T;
+
+    /// @p alpha in (0, 1]; the time constant is about 1 / alpha samples.
+    constexpr explicit exponential_average(double alpha) noexcept : alpha_(to_alpha(alpha)) {}
+
+    T process(T x) noexcept
+    {
+        if constexpr (traits::is_floating) {
+            state_ = primed_ ? state_ + alpha_ * (x - state_) : x;
+        } else {
+            const std::int64_t target = traits::raw(x) * (std::int64_t{1} << guard_bits);
+            state_ = primed_ ? state_ + detail::round_shift(alpha_ * (target - state_),
+                                                            alpha_bits, rounding::nearest)
+                             : target;
+        }
+        primed_ = true;
+        return value();
+    }
+
+    void process(const T* in, T* out, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    /// Current output; zero before the first sample.
+    T value() const noexcept
+    {
+        if constexpr (traits::is_floating) {
+            return state_;
+        } else {
+            return traits::from_wide(state_, traits::fraction_bits + guard_bits);
+        }
+    }
+
+    void reset() noexcept
+    {
+        state_ = 0;
+        primed_ = false;
+    }
+
+private:
+    static constexpr state_type to_alpha(double alpha) noexcept
+    {
+        EMBEC_ASSERT(alpha > 0 && alpha <= 1);
+        if constexpr (traits::is_floating) {
+            return static_cast<T>(alpha);
+        } else {
+            const auto q = static_cast<std::int64_t>(alpha * (1 << alpha_bits) + 0.5);
+            return q < 1 ? 1 : q;
+        }
+    }
+
+    state_type alpha_;
+    state_type state_ = 0;
+    bool primed_ = false;
+};
+
+/// Biquad coefficients normalised to a0 = 1:
+/// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2].
+struct biquad_coefficients {
+    double b0;
+    double b1;
+    double b2;
+    double a1;
+    double a2;
+
+    /// Second-order low-pass at @p frequency (same unit as @p sample_rate)
+    /// with quality factor @p q, from the Audio EQ Cookbook.
+    static biquad_coefficients lowpass(double frequency, double sample_rate,
+                                       double q = 0.70710678118654752) noexcept
+    {
+        const double w = 6.28318530717958648 * frequency / sample_rate;
+        const double alpha = std::sin(w) / (2 * q);
+        const double c = std::cos(w);
+        const double a0 = 1 + alpha;
+        return {(1 - c) / 2 / a0, (1 - c) / a0, (1 - c) / 2 / a0, -2 * c / a0, (1 - alpha) / a0};
+    }
+
+    /// Second-order high-pass, as lowpass().
+    static biquad_coefficients highpass(double frequency, double sample_rate,
+                                        double q = 0.70710678118654752) noexcept
+    {
+        const double w = 6.28318530717958648 * frequency / sample_rate;
+        const double alpha = std::sin(w) / (2 * q);
+        const double c = std::cos(w);
+        const double a0 = 1 + alpha;
+        return {(1 + c) / 2 / a0, -(1 + c) / a0, (1 + c) / 2 / a0, -2 * c / a0, (1 - alpha) / a0};
+    }
+};
+
+/// Second-order IIR section.
+///
+/// Floating-point samples use the transposed direct form II. Integer and
+/// fixed-point samples use direct form I with coefficients in Q1.30 (so
+/// each must lie in [-2, 2), which covers stable sections) and a 64-bit
+/// accumulator; products of 32-bit samples drop 4 of their 30 extra
+/// fraction bits to leave headroom for the sum. Outputs are truncated with
+/// error feedback, so a constant input comes out without the offset that
+/// rounding in the feedback path would cause; the sample type's rounding
+/// policy does not apply, its overflow policy does.
+template <typename T>
+class biquad {
+    using traits = detail::sample_traits<T>;
+    static constexpr int coeff_bits = 30;
+    static constexpr int drop = traits::raw_bits > 16 ? 4 : 0;
+    using coeff_type = std::conditional_t<traits::is_floating, T, std::int64_t>;
+
+public:
+    using sample_type = T;
+
+    explicit biquad(const biquad_coefficients& c) noexcept
+        : b0_(to_coeff(c.b0)), b1_(to_coeff(c.b1)), b2_(to_coeff(c.b2)), a1_(to_coeff(c.a1)),
+          a2_(to_coeff(c.a2))
+    {
+    }
+
+    T process(T x) noexcept
+    {
+        if constexpr (traits::is_floating) {
+            const T y = b0_ * x + s1_;
+            s1_ = b1_ * x - a1_ * y + s2_;
+            s2_ = b2_ * x - a2_ * y;
+            return y;
+        } else {
+            // Truncating with the remainder fed into the next sum (error
+            // feedback) keeps the rounding error from recirculating through
+            // the poles as a DC offset.
+            const std::int64_t acc = ((b0_ * traits::raw(x)) >> drop) +
+                                     ((b1_ * traits::raw(x1_)) >> drop) +
+                                     ((b2_ * traits::raw(x2_)) >> drop) -
+                                     ((a1_ * traits::raw(y1_)) >> drop) -
+                                     ((a2_ * traits::raw(y2_)) >> drop) + error_;
+            const std::int64_t whole = acc >> (coeff_bits - drop);
+            const T y = traits::from_wide(whole, traits::fraction_bits);
+            const std::int64_t unit = std::int64_t{1} << (coeff_bits - drop);
+            error_ = traits::raw(y) == whole ? acc - whole * unit : 0; // 0 if saturated
+            x2_ = x1_;
+            x1_ = x;
+            y2_ = y1_;
+            y1_ = y;
+            return y;
+        }
+    }
+
+    void process(const T* in, T* out, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    /// Clears the filter state, as if it had only seen zeros.
+    void reset() noexcept
+    {
+        s1_ = s2_ = 0;
+        error_ = 0;
+        x1_ = x2_ = y1_ = y2_ = T{};
+    }
+
+private:
+    static coeff_type to_coeff(double c) noexcept
+    {
+        if constexpr (traits::is_floating) {
+            return static_cast<T>(c);
+        } else {
+            EMBEC_ASSERT(c >= -2 && c < 2);
+            const double scaled = c * (std::int64_t{1} << coeff_bits);
+            return static_cast<std::int64_t>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+        }
+    }
+
+    coeff_type b0_, b1_, b2_, a1_, a2_;
+    coeff_type s1_ = 0; ///< Transposed direct form II state.
+    coeff_type s2_ = 0;
+    std::int64_t error_ = 0; ///< Truncation remainder of the last output.
+    T x1_{}; ///< Direct form I history.
+    T x2_{};
+    T y1_{};
+    T y2_{};
+};
+
+/// Median of the last @p Window samples (an odd number); the lower median
+/// of all samples until @p Window have been seen.
+template <typename T, std::size_t Window>
+class median_filter {
+    static_assert(Window % 2 == 1, "Window must be odd");
+
+public:
+    using sample_type = T;
+
+    T process(T x) noexcept
+    {
+        if constexpr (Window == 1) {
+            // Nothing to sort; this also keeps the loops below in bounds.
+            history_[0] = x;
+            sorted_[0] = x;
+            size_ = 1;
+            return x;
+        }
+        std::size_t i;
+        if (size_ < Window) {
+            i = size_++;
+        } else {
+            // Take out the oldest sample, leaving a hole at i.
+            const T oldest = history_[pos_];
+            i = 0;
+            while (sorted_[i] < oldest) {
+                ++i;
+            }
+        }
+        history_[pos_] = x;
+        pos_ = pos_ + 1 == Window ? 0 : pos_ + 1;
+
+        // Move the hole to where x belongs.
+        for (; i > 0 && x < sorted_[i - 1]; --i) {
+            sorted_[i] = sorted_[i - 1];
+        }
+        for (; i + 1 < size_ && sorted_[i + 1] < x; ++i) {
+            sorted_[i] = sorted_[i + 1];
+        }
+        sorted_[i] = x;
+        return value();
+    }
+
+    void process(const T* in, T* out, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+
+    /// Current median; zero before the first sample.
+    T value() const noexcept { return size_ != 0 ? sorted_[(size_ - 1) / 2] : T{}; }
+
+    std::size_t size() const noexcept { return size_; }
+
+    void reset() noexcept
+    {
+        pos_ = 0;
+        size_ = 0;
+    }
+
+private:
+    T history_[Window]{}; ///< Samples in arrival order (a ring).
+    T sorted_[Window]{};  ///< The same samples, sorted.
+    std::size_t pos_ = 0;
+    std::size_t size_ = 0;
+};
+
+/// Integrating debouncer for a binary input.
+///
+/// A counter moves one step towards the input level per sample, between 0
+/// and @p Samples. The output changes when the counter reaches the other
+/// end, so a new level passes after @p Samples consistent samples, and
+/// bounces shorter than that are absorbed.
+template <unsigned Samples>
+class debouncer {
+    static_assert(Samples >= 1 && Samples <= 0xffff, "Samples must be in 1..65535");
+
+public:
+    constexpr explicit debouncer(bool initial = false) noexcept { reset(initial); }
+
+    /// Feeds one input sample and returns the debounced state.
+    bool update(bool input) noexcept
+    {
+        const bool before = state_;
+        if (input) {
+            count_ += count_ < Samples;
+            state_ = state_ || count_ == Samples;
+        } else {
+            count_ -= count_ > 0;
+            state_ = state_ && count_ != 0;
+        }
+        changed_ = state_ != before;
+        return state_;
+    }
+
+    bool state() const noexcept { return state_; }
+    /// True if the last update() changed the state.
+    bool changed() const noexcept { return changed_; }
+    bool rose() const noexcept { return changed_ && state_; }
+    bool fell() const noexcept { return changed_ && !state_; }
+
+    constexpr void reset(bool state) noexcept
+    {
+        count_ = state ? Samples : 0;
+        state_ = state;
+        changed_ = false;
+    }
+
+private:
+    std::uint16_t count_ = 0;
+    bool state_ = false;
+    bool changed_ = false;
+};
+
+} // namespace embec
+
+#endif // EMBEC_FILTER_HPP
@@ -0,0 +1,656 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file fixed.hpp
+/// @brief Q-format fixed-point arithmetic for targets without an FPU.
+///
+/// fixed<IntBits, FracBits> holds a signed value with @p IntBits integer
+/// bits and @p FracBits fraction bits plus a sign bit (ARM "Qm.n"
+/// notation, so q15 is fixed<0, 15>). Two policies select how results that
+/// do not fit are handled:
+///  - rounding::nearest rounds half up, rounding::truncate rounds towards
+///    minus infinity (a plain arithmetic shift);
+///  - overflow::saturate clamps to the representable range,
+///    overflow::wrap keeps the low bits like integer arithmetic.
+///
+/// Intermediate results are computed in 64 bits, so a product or quotient
+/// is rounded and range-checked exactly once.
+///
+/// The math functions (sin, cos, atan2, sqrt, exp) use integer arithmetic
+/// only. sin/cos interpolate a 257-entry quarter-wave table, atan2 runs a
+/// CORDIC in binary-angle units, sqrt is an exact integer square root and
+/// exp combines a 2^(j/32) table with a short polynomial. The tables are
+/// generated at compile time. Absolute error is below 2^-17 for sin/cos and
+/// 2^-24 rad for atan2 before the final rounding to the result format.
+///
+/// dot(), scale() and fir() operate on arrays. For 16-bit formats they have
+/// SSE2 paths on host builds (see EMBEC_SIMD_SSE2) that return the same
+/// results as the portable code.
+
+#ifndef EMBEC_FIXED_HPP
+#define EMBEC_FIXED_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/bits.hpp"
+
+#if defined(EMBEC_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace embec {
+
+enum class rounding {
+    truncate, ///< Towards minus infinity.
+    nearest,  ///< To nearest, halves rounded up.
+};
+
+enum class overflow {
+    wrap,
+    saturate,
+};
+
+namespace detail {
+
+template <int Bits>
+using fixed_storage_t = std::conditional_t<
+    (Bits <= 8), std::int8_t,
+    std::conditional_t<(Bits <= 16), std::int16_t, std::int32_t>>;
+
+/// Divides @p value by 2^@p shift (shift >= 0) with rounding @p r.
+constexpr std::int64_t round_shift(std::int64_t value, int shift, rounding r) noexcept
+{
+    if (shift <= 0) {
+        return value;
+    }
+    if (r == rounding::nearest) {
+        value += std::int64_t{1} << (shift - 1);
+    }
+    return value >> shift;
+}
+
+/// Converts @p value from @p from fraction bits to @p to fraction bits.
+constexpr std::int64_t rescale(std::int64_t value, int from, int to, rounding r) noexcept
+{
+    return to >= from ? static_cast<std::int64_t>(static_cast<std::uint64_t>(value) << (to - from))
+                      : round_shift(value, from - to, r);
+}
+
+} // namespace detail
+
+/// Signed fixed-point number with @p IntBits integer and @p FracBits
+/// fraction bits.
+template <int IntBits, int FracBits, rounding Round = rounding::nearest,
+          overflow Overflow = overflow::saturate>
+class fixed {
+    static_assert(IntBits >= 0 && FracBits >= 0 && IntBits + FracBits >= 1 &&
+                      IntBits + FracBits <= 31,
+                  "fixed supports 2..32 bit formats");
+
+public:
+    using raw_type = detail::fixed_storage_t<IntBits + FracBits + 1>;
+
+    static constexpr int integer_bits = IntBits;
+    static constexpr int fraction_bits = FracBits;
+    static constexpr int total_bits = IntBits + FracBits + 1;
+    static constexpr rounding rounding_policy = Round;
+    static constexpr overflow overflow_policy = Overflow;
+
+    static constexpr std::int64_t raw_max = (std::int64_t{1} << (total_bits - 1)) - 1;
+    static constexpr std::int64_t raw_min = -raw_max - 1;
+
+    constexpr fixed() noexcept = default;
+
+    template <typename Int, std::enable_if_t<std::is_integral<Int>::value, int> = 0>
+    constexpr explicit fixed(Int value) noexcept : raw_(from_integer(value))
+    {
+    }
+
+    /// Conversion from floating point always saturates; NaN becomes zero.
+    constexpr explicit fixed(double value) noexcept : raw_(from_double(value)) {}
+
+    /// Conversion from another format using this format's policies.
+    template <int I, int F, rounding R, overflow O>
+    constexpr explicit fixed(fixed<I, F, R, O> other) noexcept
+        : raw_(narrow(detail::rescale(other.raw(), F, FracBits, Round)))
+    {
+    }
+
+    static constexpr fixed from_raw(raw_type raw) noexcept
+    {
+        fixed f;
+        f.raw_ = raw;
+        return f;
+    }
+
+    /// Rounds and range-checks a value with @p frac fraction bits.
+    static constexpr fixed from_wide(std::int64_t value, int frac = FracBits) noexcept
+    {
+        return from_raw(narrow(detail::rescale(value, frac, FracBits, Round)));
+    }
+
+    static constexpr fixed max() noexcept { return from_raw(static_cast<raw_type>(raw_max)); }
+    static constexpr fixed lowest() noexcept { return from_raw(static_cast<raw_type>(raw_min)); }
+    static constexpr fixed epsilon() noexcept { return from_raw(1); }
+
+    constexpr raw_type raw() const noexcept { return raw_; }
+
+    constexpr double to_double() const noexcept
+    {
+        return static_cast<double>(raw_) / static_cast<double>(std::int64_t{1} << FracBits);
+    }
+    constexpr float to_float() const noexcept { return static_cast<float>(to_double()); }
+
+    /// Integer part, rounded according to the rounding policy.
+    constexpr std::int32_t to_int() const noexcept
+    {
+        return static_cast<std::int32_t>(detail::round_shift(raw_, FracBits, Round));
+    }
+
+    constexpr fixed operator+() const noexcept { return *this; }
+    constexpr fixed operator-() const noexcept { return from_raw(narrow(-std::int64_t{raw_})); }
+
+    constexpr fixed& operator+=(fixed rhs) noexcept
+    {
+        raw_ = narrow(std::int64_t{raw_} + rhs.raw_);
+        return *this;
+    }
+    constexpr fixed& operator-=(fixed rhs) noexcept
+    {
+        raw_ = narrow(std::int64_t{raw_} - rhs.raw_);
+        return *this;
+    }
+    constexpr fixed& operator*=(fixed rhs) noexcept
+    {
+        raw_ = narrow(detail::round_shift(std::int64_t{raw_} * rhs.raw_, FracBits, Round));
+        return *this;
+    }
+    /// @p rhs must not be zero.
+    constexpr fixed& operator/=(fixed rhs) noexcept
+    {
+        EMBEC_ASSERT(rhs.raw_ != 0);
+        const std::int64_t num = static_cast<std::int64_t>(std::uint64_t(std::int64_t{raw_})
+                                                           << FracBits);
+        const std::int64_t den = rhs.raw_;
+        std::int64_t q = num / den;
+        const std::int64_t r = num % den;
+        if (r != 0) {
+            // C++ division truncates towards zero; fix up to the policy.
+            const bool negative = (r < 0) != (den < 0);
+            if (Round == rounding::truncate) {
+                q -= negative;
+            } else {
+                const std::int64_t twice = 2 * (r < 0 ? -r : r);
+                const std::int64_t abs_den = den < 0 ? -den : den;
+                if (negative ? twice > abs_den : twice >= abs_den) {
+                    q += negative ? -1 : 1;
+                }
+            }
+        }
+        raw_ = narrow(q);
+        return *this;
+    }
+
+    friend constexpr fixed operator+(fixed a, fixed b) noexcept { return a += b; }
+    friend constexpr fixed operator-(fixed a, fixed b) noexcept { return a -= b; }
+    friend constexpr fixed operator*(fixed a, fixed b) noexcept { return a *= b; }
+    friend constexpr fixed operator/(fixed a, fixed b) noexcept { return a /= b; }
+
+    friend constexpr bool operator==(fixed a, fixed b) noexcept { return a.raw_ == b.raw_; }
+    friend constexpr bool operator!=(fixed a, fixed b) noexcept { return a.raw_ != b.raw_; }
+    friend constexpr bool operator<(fixed a, fixed b) noexcept { return a.raw_ < b.raw_; }
+    friend constexpr bool operator<=(fixed a, fixed b) noexcept { return a.raw_ <= b.raw_; }
+    friend constexpr bool operator>(fixed a, fixed b) noexcept { return a.raw_ > b.raw_; }
+    friend constexpr bool operator>=(fixed a, fixed b) noexcept { return a.raw_ >= b.raw_; }
+
+    /// Applies the overflow policy to a raw value held in 64 bits.
+    static constexpr raw_type narrow(std::int64_t value) noexcept
+    {
+        if (Overflow == overflow::saturate) {
+            return static_cast<raw_type>(value > raw_max ? raw_max
+                                                         : value < raw_min ? raw_min : value);
+        }
+        // Sign-extend from total_bits.
+        const std::uint64_t sign = std::uint64_t{1} << (total_bits - 1);
+        const std::uint64_t low = static_cast<std::uint64_t>(value) & ((sign << 1) - 1);
+        return static_cast<raw_type>(static_cast<std::int64_t>(low ^ sign) -
+                                     static_cast<std::int64_t>(sign));
+    }
+
+private:
+    template <typename Int>
+    static constexpr raw_type from_integer(Int value) noexcept
+    {
+        if (Overflow == overflow::saturate) {
+            constexpr std::int64_t limit = std::int64_t{1} << IntBits;
+            if constexpr (std::is_signed<Int>::value) {
+                if (value < -limit) {
+                    return static_cast<raw_type>(raw_min);
+                }
+                if (value >= limit) {
+                    return static_cast<raw_type>(raw_max);
+                }
+            } else {
+                if (value >= static_cast<std::uint64_t>(limit)) {
+                    return static_cast<raw_type>(raw_max);
+                }
+            }
+        }
+        return narrow(static_cast<std::int64_t>(static_cast<std::uint64_t>(value) << FracBits));
+    }
+
+    static constexpr raw_type from_double(double value) noexcept
+    {
+        if (!(value == value)) {
+            return 0;
+        }
+        double scaled = value * static_cast<double>(std::int64_t{1} << FracBits);
+        if (Round == rounding::nearest) {
+            scaled += 0.5;
+        }
+        if (scaled >= static_cast<double>(raw_max)) {
+            return static_cast<raw_type>(raw_max);
+        }
+        if (scaled <= static_cast<double>(raw_min)) {
+            return static_cast<raw_type>(raw_min);
+        }
+        auto whole = static_cast<std::int64_t>(scaled);
+        whole -= static_cast<double>(whole) > scaled; // floor
+        return static_cast<raw_type>(whole);
+    }
+
+    raw_type raw_ = 0;
+};
+
+using q7 = fixed<0, 7>;
+using q15 = fixed<0, 15>;
+using q31 = fixed<0, 31>;
+using q15_16 = fixed<15, 16>;
+
+template <int I, int F, rounding R, overflow O>
+constexpr fixed<I, F, R, O> abs(fixed<I, F, R, O> x) noexcept
+{
+    return x.raw() < 0 ? -x : x;
+}
+
+namespace detail {
+
+// Compile-time floating point helpers used only to generate tables.
+
+constexpr double fixed_pi = 3.14159265358979323846;
+
+constexpr double constexpr_sin(double x) noexcept // |x| <= pi/2
+{
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 16; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constexpr_atan(double x) noexcept // |x| <= 1/2
+{
+    double power = x;
+    double sum = x;
+    for (int n = 1; n < 40; ++n) {
+        power *= -x * x;
+        sum += power / (2 * n + 1);
+    }
+    return sum;
+}
+
+constexpr double constexpr_exp(double x) noexcept // |x| <= 1
+{
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 24; ++n) {
+        term *= x / n;
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr std::int64_t constexpr_round(double x) noexcept
+{
+    return static_cast<std::int64_t>(x < 0 ? x - 0.5 : x + 0.5);
+}
+
+constexpr int q30 = 30;
+constexpr std::int64_t q30_one = std::int64_t{1} << q30;
+
+/// sin over the first quadrant in Q30, 256 segments.
+constexpr std::array<std::int32_t, 257> make_fixed_sin_table() noexcept
+{
+    std::array<std::int32_t, 257> table{};
+    for (int i = 0; i <= 256; ++i) {
+        table[i] = static_cast<std::int32_t>(
+            constexpr_round(constexpr_sin(fixed_pi / 2 * i / 256) * q30_one));
+    }
+    return table;
+}
+
+inline constexpr std::array<std::int32_t, 257> fixed_sin_table = make_fixed_sin_table();
+
+/// atan(2^-i) in binary-angle units (2^32 per turn).
+constexpr std::array<std::uint32_t, 31> make_fixed_atan_table() noexcept
+{
+    std::array<std::uint32_t, 31> table{};
+    for (int i = 0; i < 31; ++i) {
+        const double angle =
+            i == 0 ? fixed_pi / 4 : constexpr_atan(1.0 / static_cast<double>(1ull << i));
+        table[i] = static_cast<std::uint32_t>(
+            constexpr_round(angle / (2 * fixed_pi) * 4294967296.0));
+    }
+    return table;
+}
+
+inline constexpr std::array<std::uint32_t, 31> fixed_atan_table = make_fixed_atan_table();
+
+/// 2^(j/32) in Q30 for j = 0..32.
+constexpr std::array<std::int64_t, 33> make_fixed_exp2_table() noexcept
+{
+    std::array<std::int64_t, 33> table{};
+    for (int j = 0; j <= 32; ++j) {
+        table[j] = constexpr_round(constexpr_exp(0.69314718055994530942 * j / 32) * q30_one);
+    }
+    return table;
+}
+
+inline constexpr std::array<std::int64_t, 33> fixed_exp2_table = make_fixed_exp2_table();
+
+/// sin of a binary angle (2^32 per turn) in Q30.
+constexpr std::int64_t sin_phase(std::uint32_t phase) noexcept
+{
+    const auto& table = fixed_sin_table;
+    const std::uint32_t quadrant = phase >> 30;
+    std::uint32_t pos = phase & 0x3fffffffu;
+    if (quadrant & 1u) {
+        pos = 0x40000000u - pos;
+    }
+    const std::uint32_t index = pos >> 22;
+    const std::int64_t frac = pos & 0x3fffffu;
+    std::int64_t value = table[index];
+    if (index < 256) {
+        value += ((table[index + 1] - value) * frac) >> 22;
+    }
+    return quadrant & 2u ? -value : value;
+}
+
+/// Converts radians with @p frac fraction bits to a binary angle.
+constexpr std::uint32_t radians_to_phase(std::int64_t raw, int frac) noexcept
+{
+    // 2^34 / (2 pi): two extra bits of precision, still below 2^32.
+    constexpr std::int64_t scale = constexpr_round(17179869184.0 / (2 * fixed_pi));
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>((raw * scale) >> (frac + 2)));
+}
+
+/// Integer square root, rounded down, with the remainder.
+constexpr std::uint64_t isqrt(std::uint64_t n, std::uint64_t& remainder) noexcept
+{
+    std::uint64_t root = 0;
+    std::uint64_t bit = n ? std::uint64_t{1} << (highest_bit(n) & ~1u) : 0;
+    while (bit) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    remainder = n;
+    return root;
+}
+
+} // namespace detail
+
+/// Sine of @p x radians.
+template <int I, int F, rounding R, overflow O>
+constexpr fixed<I, F, R, O> sin(fixed<I, F, R, O> x) noexcept
+{
+    using T = fixed<I, F, R, O>;
+    return T::from_wide(detail::sin_phase(detail::radians_to_phase(x.raw(), F)), detail::q30);
+}
+
+/// Cosine of @p x radians.
+template <int I, int F, rounding R, overflow O>
+constexpr fixed<I, F, R, O> cos(fixed<I, F, R, O> x) noexcept
+{
+    using T = fixed<I, F, R, O>;
+    return T::from_wide(
+        detail::sin_phase(detail::radians_to_phase(x.raw(), F) + 0x40000000u), detail::q30);
+}
+
+/// Angle of the vector (@p x, @p y) in radians, in [-pi, pi]. Formats with
+/// fewer than two integer bits saturate near +-pi. atan2(0, 0) is 0.
+template <int I, int F, rounding R, overflow O>
+constexpr fixed<I, F, R, O> atan2(fixed<I, F, R, O> y, fixed<I, F, R, O> x) noexcept
+{
+    using T = fixed<I, F, R, O>;
+    std::int64_t vx = x.raw();
+    std::int64_t vy = y.raw();
+    if (vx == 0 && vy == 0) {
+        return T{};
+    }
+    std::uint32_t angle = 0;
+    if (vx < 0) {
+        // Rotate by pi into the right half plane.
+        vx = -vx;
+        vy = -vy;
+        angle = 0x80000000u;
+    }
+    // Normalize so the CORDIC keeps 30 significant bits. Negating a raw
+    // lowest() gives 2^31, which needs 31 bits and is shifted down.
+    const std::uint64_t magnitude = static_cast<std::uint64_t>(vx | (vy < 0 ? -vy : vy));
+    const int shift = 30 - static_cast<int>(detail::highest_bit(magnitude));
+    if (shift >= 0) {
+        vx = static_cast<std::int64_t>(static_cast<std::uint64_t>(vx) << shift);
+        vy = static_cast<std::int64_t>(static_cast<std::uint64_t>(vy) << shift);
+    } else {
+        vx >>= -shift;
+        vy >>= -shift;
+    }
+    const auto& table = detail::fixed_atan_table;
+    for (int i = 0; i < 31; ++i) {
+        const std::int64_t dx = vy >> i;
+        const std::int64_t dy = vx >> i;
+        if (vy > 0) {
+            vx += dx;
+            vy -= dy;
+            angle += table[i];
+        } else {
+            vx -= dx;
+            vy += dy;
+            angle -= table[i];
+        }
+    }
+    // Binary angle to radians: 2 pi * 2^29 fits in 32 bits.
+    constexpr std::int64_t scale = detail::constexpr_round(2 * detail::fixed_pi * (1 << 29));
+    auto signed_angle = static_cast<std::int64_t>(static_cast<std::int32_t>(angle));
+    // Near +-pi the angle may land on either side of the branch cut; the
+    // sign of y decides.
+    if (y.raw() >= 0 && signed_angle < 0) {
+        signed_angle += std::int64_t{1} << 32;
+    } else if (y.raw() < 0 && signed_angle > 0) {
+        signed_angle -= std::int64_t{1} << 32;
+    }
+    // Keep within +-pi so that the product fits in 64 bits.
+    constexpr std::int64_t half_turn = std::int64_t{1} << 31;
+    signed_angle = signed_angle > half_turn ? half_turn
+                   : signed_angle < -half_turn ? -half_turn
+                                               : signed_angle;
+    return T::from_wide(signed_angle * scale, 61);
+}
+
+/// Square root; negative arguments give zero.
+template <int I, int F, rounding R, overflow O>
+constexpr fixed<I, F, R, O> sqrt(fixed<I, F, R, O> x) noexcept
+{
+    using T = fixed<I, F, R, O>;
+    if (x.raw() <= 0) {
+        return T{};
+    }
+    // sqrt(raw * 2^F) has F fraction bits.
+    std::uint64_t remainder = 0;
+    std::uint64_t root =
+        detail::isqrt(static_cast<std::uint64_t>(x.raw()) << F, remainder);
+    if (R == rounding::nearest && remainder > root) {
+        ++root;
+    }
+    return T::from_raw(T::narrow(static_cast<std::int64_t>(root)));
+}
+
+/// e^@p x, saturating for large arguments.
+template <int I, int F, rounding R, overflow O>
+constexpr fixed<I, F, R, O> exp(fixed<I, F, R, O> x) noexcept
+{
+    using T = fixed<I, F, R, O>;
+    // e^x = 2^(x log2 e) = 2^k * 2^(j/32) * e^u.
+    constexpr std::int64_t log2e = detail::constexpr_round(1.44269504088896340736 * detail::q30_one);
+    constexpr std::int64_t ln2 = detail::constexpr_round(0.69314718055994530942 * detail::q30_one);
+    const std::int64_t t = std::int64_t{x.raw()} * log2e; // Q(F + 30)
+    const int frac_bits = F + detail::q30;
+    const std::int64_t k = t >> frac_bits;
+    const std::int64_t f = static_cast<std::int64_t>(
+        (static_cast<std::uint64_t>(t) & ((std::uint64_t{1} << frac_bits) - 1)) >> F); // Q30
+    const std::int64_t j = f >> (detail::q30 - 5);
+    const std::int64_t r = f & ((std::int64_t{1} << (detail::q30 - 5)) - 1);
+    const std::int64_t u = (r * ln2) >> detail::q30; // < ln2 / 32
+    // e^u ~ 1 + u + u^2/2 + u^3/6, error below 2^-28 for u < 0.022.
+    const std::int64_t u2 = (u * u) >> detail::q30;
+    const std::int64_t u3 = (u2 * u) >> detail::q30;
+    const std::int64_t eu = detail::q30_one + u + u2 / 2 + u3 / 6;
+    const std::int64_t mantissa = (detail::fixed_exp2_table[j] * eu) >> detail::q30;
+    // result raw = mantissa * 2^shift
+    if (k > 64) {
+        return T::max();
+    }
+    if (k < -128) {
+        return T{};
+    }
+    const int shift = F - detail::q30 + static_cast<int>(k);
+    if (shift >= 0) {
+        if (shift >= 32 || mantissa > (T::raw_max >> shift)) {
+            return T::max();
+        }
+        return T::from_raw(static_cast<typename T::raw_type>(mantissa << shift));
+    }
+    if (shift < -62) {
+        return T{};
+    }
+    return T::from_raw(T::narrow(detail::round_shift(mantissa, -shift, R)));
+}
+
+namespace detail {
+
+template <int I, int F, rounding R, overflow O>
+constexpr bool fixed_is_16bit = sizeof(typename fixed<I, F, R, O>::raw_type) == 2;
+
+/// Fraction bits dropped from each product before accumulation: none for
+/// 16-bit formats, otherwise all but 16 guard bits below the result's LSB.
+template <int I, int F, rounding R, overflow O>
+constexpr int fixed_dot_drop = fixed_is_16bit<I, F, R, O> || F <= 16 ? 0 : F - 16;
+
+/// Sum of a[i] * b[i] with 2F - fixed_dot_drop fraction bits.
+template <int I, int F, rounding R, overflow O>
+std::int64_t fixed_dot_raw(const fixed<I, F, R, O>* a, const fixed<I, F, R, O>* b,
+                           std::size_t n) noexcept
+{
+    constexpr int drop = fixed_dot_drop<I, F, R, O>;
+    std::int64_t sum = 0;
+    std::size_t i = 0;
+#if defined(EMBEC_SIMD_SSE2)
+    if constexpr (fixed_is_16bit<I, F, R, O>) {
+        // pmaddwd forms pairwise sums of 16x16-bit products. A pair sum only
+        // reaches 2^31 for (-32768)^2 * 2, which wraps to INT32_MIN; no
+        // other sum produces INT32_MIN, so it is mapped back to +2^31 when
+        // widening to 64 bits.
+        const __m128i int_min = _mm_set1_epi32(INT32_MIN);
+        __m128i acc = _mm_setzero_si128();
+        const std::size_t vector_end = n & ~std::size_t{7};
+        for (; i < vector_end; i += 8) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            const __m128i pairs = _mm_madd_epi16(va, vb);
+            const __m128i high =
+                _mm_andnot_si128(_mm_cmpeq_epi32(pairs, int_min), _mm_srai_epi32(pairs, 31));
+            acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, high));
+            acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, high));
+        }
+        std::int64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        sum = lanes[0] + lanes[1];
+    }
+#endif
+    for (; i < n; ++i) {
+        sum += (std::int64_t{a[i].raw()} * b[i].raw()) >> drop;
+    }
+    return sum;
+}
+
+} // namespace detail
+
+/// Dot product of @p n elements, rounded once at the end.
+///
+/// 16-bit formats accumulate exactly. Wider formats keep 16 guard bits
+/// below the result's LSB (as CMSIS-DSP does for q31), which leaves room
+/// for 2^15 full-scale q31 products.
+template <int I, int F, rounding R, overflow O>
+fixed<I, F, R, O> dot(const fixed<I, F, R, O>* a, const fixed<I, F, R, O>* b,
+                      std::size_t n) noexcept
+{
+    return fixed<I, F, R, O>::from_wide(detail::fixed_dot_raw(a, b, n),
+                                        2 * F - detail::fixed_dot_drop<I, F, R, O>);
+}
+
+/// FIR filter: out[i] = sum of coeffs[k] * in[i + k] for k < @p taps.
+///
+/// As in CMSIS-DSP, @p coeffs are stored in time-reversed order, and @p in
+/// holds @p taps - 1 samples of history followed by the @p n new samples.
+template <int I, int F, rounding R, overflow O>
+void fir(const fixed<I, F, R, O>* coeffs, std::size_t taps, const fixed<I, F, R, O>* in,
+         fixed<I, F, R, O>* out, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = dot(coeffs, in + i, taps);
+    }
+}
+
+/// out[i] = in[i] * @p factor. @p out may equal @p in.
+template <int I, int F, rounding R, overflow O>
+void scale(const fixed<I, F, R, O>* in, fixed<I, F, R, O> factor, fixed<I, F, R, O>* out,
+           std::size_t n) noexcept
+{
+    std::size_t i = 0;
+#if defined(EMBEC_SIMD_SSE2)
+    if constexpr (detail::fixed_is_16bit<I, F, R, O> && I + F == 15) {
+        const __m128i f = _mm_set1_epi16(factor.raw());
+        const __m128i half = _mm_set1_epi32(R == rounding::nearest && F > 0 ? 1 << (F - 1) : 0);
+        const std::size_t vector_end = n & ~std::size_t{7};
+        for (; i < vector_end; i += 8) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i lo = _mm_mullo_epi16(v, f);
+            const __m128i hi = _mm_mulhi_epi16(v, f);
+            __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), half), F);
+            __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), half), F);
+            if (O == overflow::wrap) {
+                // Keep the low 16 bits so the saturating pack is exact.
+                p0 = _mm_srai_epi32(_mm_slli_epi32(p0, 16), 16);
+                p1 = _mm_srai_epi32(_mm_slli_epi32(p1, 16), 16);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(p0, p1));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = in[i] * factor;
+    }
+}
+
+} // namespace embec
+
+#endif // EMBEC_FIXED_HPP
@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file flash_sim.hpp
+/// @brief NOR flash simulator for host tests and benchmarks (POSIX only).
+///
+/// flash_sim models a NOR flash of @p SectorCount sectors of @p SectorSize
+/// bytes, programmed in units of @p ProgramSize bytes, in a memory mapping
+/// that is either anonymous or backed by a file, so that contents persist
+/// between runs and can be inspected with ordinary tools. Erasing sets a
+/// sector to 0xff and programming can only clear bits, as on the real part.
+/// It satisfies the Flash requirements of kv_store:
+///
+/// @code
+/// embec::flash_sim<4096, 16> flash;
+/// flash.open("flash.bin");
+/// embec::kv_store<decltype(flash), 64> store(flash);
+/// store.mount();
+/// @endcode
+///
+/// Power cuts are simulated with cut_power_after(): the program or erase
+/// operation at which the power fails changes only a pseudo-random part of
+/// its bits, and every operation fails until power_on() is called, after
+/// which the store is mounted again as after a reset.
+
+#ifndef EMBEC_FLASH_SIM_HPP
+#define EMBEC_FLASH_SIM_HPP
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "flash_sim.hpp needs a POSIX host"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+/// Simulated NOR flash; see the file documentation.
+template <std::size_t SectorSize, std::size_t SectorCount, std::size_t ProgramSize = 4>
+class flash_sim {
+    static_assert(ProgramSize > 0 && (ProgramSize & (ProgramSize - 1)) == 0,
+                  "ProgramSize must be a power of two");
+    static_assert(SectorSize % ProgramSize == 0, "SectorSize must be a multiple of ProgramSize");
+
+public:
+    static constexpr std::size_t sector_size = SectorSize;
+    static constexpr std::size_t sector_count = SectorCount;
+    static constexpr std::size_t program_size = ProgramSize;
+    static constexpr std::size_t size = SectorSize * SectorCount;
+
+    /// Operation counts since open().
+    struct statistics {
+        std::uint64_t reads;
+        std::uint64_t programs;
+        std::uint64_t erases;
+        std::uint64_t bytes_read;
+        std::uint64_t bytes_programmed;
+        std::uint64_t overwrites; ///< Programs that tried to set a cleared bit.
+    };
+
+    flash_sim() noexcept = default;
+    flash_sim(const flash_sim&) = delete;
+    flash_sim& operator=(const flash_sim&) = delete;
+    ~flash_sim() { close(); }
+
+    /// Maps the flash contents from the file at @p path, which is created
+    /// (erased) if it does not exist with the right size, or into anonymous
+    /// erased memory if @p path is null.
+    bool open(const char* path = nullptr) noexcept
+    {
+        close();
+        void* map;
+        if (path == nullptr) {
+            map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (map == MAP_FAILED) {
+                return false;
+            }
+            std::memset(map, 0xff, size);
+        } else {
+            const int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat st;
+            bool fresh = ::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != size;
+            if (fresh && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                ::close(fd);
+                return false;
+            }
+            map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (map == MAP_FAILED) {
+                return false;
+            }
+            if (fresh) {
+                std::memset(map, 0xff, size);
+            }
+        }
+        data_ = static_cast<std::uint8_t*>(map);
+        stats_ = {};
+        std::memset(erase_counts_, 0, sizeof(erase_counts_));
+        powered_ = true;
+        countdown_ = -1;
+        return true;
+    }
+
+    /// Unmaps the flash; file-backed contents are written back.
+    void close() noexcept
+    {
+        if (data_ != nullptr) {
+            ::munmap(data_, size);
+            data_ = nullptr;
+        }
+    }
+
+    bool is_open() const noexcept { return data_ != nullptr; }
+
+    bool read(std::size_t address, void* data, std::size_t length) noexcept
+    {
+        EMBEC_ASSERT(address <= size && length <= size - address);
+        if (!powered_ || data_ == nullptr) {
+            return false;
+        }
+        std::memcpy(data, data_ + address, length);
+        ++stats_.reads;
+        stats_.bytes_read += length;
+        return true;
+    }
+
+    bool program(std::size_t address, const void* data, std::size_t length) noexcept
+    {
+        EMBEC_ASSERT(address <= size && length <= size - address);
+        EMBEC_ASSERT(address % ProgramSize == 0 && length % ProgramSize == 0);
+        if (!powered_ || data_ == nullptr) {
+            return false;
+        }
+        const auto* src = static_cast<const std::uint8_t*>(data);
+        std::uint8_t* dst = data_ + address;
+        const bool cut = power_fails();
+        bool overwrite = false;
+        for (std::size_t i = 0; i < length; ++i) {
+            overwrite = overwrite || (src[i] & ~dst[i]) != 0;
+            std::uint8_t spared = 0;
+            if (cut) {
+                // Each byte is left unprogrammed, partly or fully programmed.
+                const std::uint32_t r = random();
+                spared = (r & 3) == 0 ? 0xff : (r & 3) == 1 ? (r >> 8) & 0xff : 0;
+            }
+            dst[i] &= src[i] | spared;
+        }
+        ++stats_.programs;
+        stats_.bytes_programmed += length;
+        stats_.overwrites += overwrite;
+        return !cut;
+    }
+
+    bool erase(std::size_t sector) noexcept
+    {
+        EMBEC_ASSERT(sector < SectorCount);
+        if (!powered_ || data_ == nullptr) {
+            return false;
+        }
+        std::uint8_t* dst = data_ + sector * SectorSize;
+        if (power_fails()) {
+            for (std::size_t i = 0; i < SectorSize; ++i) {
+                const std::uint32_t r = random();
+                dst[i] |= (r & 3) == 0 ? 0 : (r & 3) == 1 ? (r >> 8) & 0xff : 0xff;
+            }
+            return false;
+        }
+        std::memset(dst, 0xff, SectorSize);
+        ++stats_.erases;
+        ++erase_counts_[sector];
+        return true;
+    }
+
+    /// Lets @p operations more program or erase operations succeed; the one
+    /// after that is interrupted by a power cut. @p seed selects which bits
+    /// the interrupted operation changes.
+    void cut_power_after(std::uint64_t operations, std::uint32_t seed = 1) noexcept
+    {
+        countdown_ = static_cast<std::int64_t>(operations);
+        seed_ = seed != 0 ? seed : 1;
+    }
+
+    /// Cancels a pending cut_power_after().
+    void cancel_power_cut() noexcept { countdown_ = -1; }
+
+    /// False from a power cut until power_on().
+    bool powered() const noexcept { return powered_; }
+
+    void power_on() noexcept { powered_ = true; }
+
+    /// Completed erases of @p sector since open().
+    std::uint32_t erase_count(std::size_t sector) const noexcept
+    {
+        EMBEC_ASSERT(sector < SectorCount);
+        return erase_counts_[sector];
+    }
+
+    const statistics& stats() const noexcept { return stats_; }
+
+    /// Direct access to the contents, e.g. to inject bit errors.
+    std::uint8_t* data() noexcept { return data_; }
+    const std::uint8_t* data() const noexcept { return data_; }
+
+private:
+    bool power_fails() noexcept
+    {
+        if (countdown_ < 0) {
+            return false;
+        }
+        if (countdown_-- > 0) {
+            return false;
+        }
+        powered_ = false;
+        return true;
+    }
+
+    std::uint32_t random() noexcept
+    {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        return seed_;
+    }
+
+    std::uint8_t* data_ = nullptr;
+    statistics stats_{};
+    std::uint32_t erase_counts_[SectorCount] = {};
+    std::int64_t countdown_ = -1;
+    std::uint32_t seed_ = 1;
+    bool powered_ = true;
+};
+
+} // namespace embec
+
+#endif // EMBEC_FLASH_SIM_HPP
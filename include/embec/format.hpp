@@ -0,0 +1,1128 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file format.hpp
+/// @brief Non-allocating text formatting and number conversion.
+///
+/// format_to() writes into a caller-provided buffer, always NUL-terminated,
+/// with a subset of the std::format syntax. The format string is wrapped in
+/// EMBEC_FMT so that it is parsed at compile time: malformed strings, a
+/// field count that does not match the arguments and conversions that do
+/// not suit an argument's type are compile errors, and at run time only the
+/// pre-parsed literal text and fields are processed:
+///
+/// @code
+/// char line[64];
+/// auto r = embec::format_to(line, EMBEC_FMT("ch{} {:>8.2f} V  id={:08X}"), ch, volts, id);
+/// uart_write(line, r.length);
+/// @endcode
+///
+/// A replacement field is `{}` or `{:spec}`, with spec
+/// `[[fill]align][+][0][width][.precision][type]`: align is `<`, `>` or `^`;
+/// `0` pads numbers with zeros after the sign; precision is the number of
+/// fraction digits for floating and fixed point and the maximum length for
+/// strings. `{{` and `}}` produce literal braces. Types:
+///
+/// | Argument | Types | Default |
+/// | --- | --- | --- |
+/// | integers, enumerations | `d x X b o c` | `d` |
+/// | char | `c d x X` | `c` |
+/// | bool | `s` | `true` / `false` |
+/// | float, double | `f e` | `f`, six digits, trailing zeros removed |
+/// | embec::fixed | `f` | exact digits of the fraction bits, trailing zeros removed |
+/// | strings (`const char*`, anything convertible to `std::string_view`) | `s` | |
+/// | pointers | `p` | `0x` and hex digits |
+///
+/// The conversions are also available on their own: to_chars() and
+/// from_chars() behave like their std:: counterparts (no locale, no
+/// leading whitespace or `+`, no base prefixes) but report a chars_status
+/// and cover embec::fixed. Decimal integer output uses a two-digits-per-
+/// division table, and 32-bit values never use 64-bit division, which is a
+/// library call on 32-bit cores.
+///
+/// Floating point conversion is deliberately small rather than exact: it
+/// scales by powers of ten in double arithmetic, so output is correctly
+/// rounded only while the scaled value is exact (up to about 15 significant
+/// digits) and may differ from printf in the last digit beyond that.
+/// from_chars() is correctly rounded for up to 15 significant digits and
+/// decimal exponents up to 22, within one ulp for longer inputs and within
+/// a few ulp for larger exponents. Values of 2^64 and above are printed in
+/// exponent notation.
+
+#ifndef EMBEC_FORMAT_HPP
+#define EMBEC_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/bits.hpp"
+
+namespace embec {
+
+enum class chars_status {
+    ok,
+    no_space,     ///< The output does not fit.
+    invalid,      ///< No number at the start of the input.
+    out_of_range, ///< The number does not fit the destination type.
+};
+
+struct to_chars_result {
+    char* ptr; ///< One past the last character written.
+    chars_status status;
+
+    explicit operator bool() const noexcept { return status == chars_status::ok; }
+};
+
+struct from_chars_result {
+    const char* ptr; ///< One past the last character of the number.
+    chars_status status;
+
+    explicit operator bool() const noexcept { return status == chars_status::ok; }
+};
+
+/// Result of format_to(): @p length characters were written (excluding the
+/// terminating NUL); status is no_space if the output was truncated.
+struct format_result {
+    std::size_t length;
+    chars_status status;
+
+    explicit operator bool() const noexcept { return status == chars_status::ok; }
+};
+
+namespace detail {
+
+inline constexpr char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline constexpr char digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+inline constexpr std::uint64_t pow10_u64[20] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+/// Powers of ten that are exact in a double.
+inline constexpr double pow10_exact[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                           1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                           1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// Multiplies @p value by 10^@p exponent in binary steps.
+inline double scale_pow10(double value, int exponent) noexcept
+{
+    constexpr double steps[] = {1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256};
+    const bool down = exponent < 0;
+    unsigned e = static_cast<unsigned>(down ? -exponent : exponent);
+    for (unsigned i = 0; e != 0 && i < 9; ++i, e >>= 1) {
+        if (e & 1u) {
+            value = down ? value / steps[i] : value * steps[i];
+        }
+    }
+    // Exponents beyond 511 only arise from denormal inputs or garbage.
+    for (; e != 0; --e) {
+        value = down ? value / 1e256 / 1e256 : value * 1e256 * 1e256;
+    }
+    return value;
+}
+
+/// Number of decimal digits of @p value.
+inline unsigned decimal_digits(std::uint64_t value) noexcept
+{
+    const std::uint64_t v = value | 1;
+    const unsigned t = ((highest_bit(v) + 1) * 1233) >> 12;
+    return t + 1 - (v < pow10_u64[t]);
+}
+
+/// Writes the decimal digits of @p value so that they end at @p end.
+template <typename UInt>
+inline void write_decimal(char* end, UInt value) noexcept
+{
+    while (value >= 100) {
+        const unsigned pair = static_cast<unsigned>(value % 100) * 2;
+        value /= 100;
+        end -= 2;
+        end[0] = digit_pairs[pair];
+        end[1] = digit_pairs[pair + 1];
+    }
+    if (value >= 10) {
+        const unsigned pair = static_cast<unsigned>(value) * 2;
+        end[-2] = digit_pairs[pair];
+        end[-1] = digit_pairs[pair + 1];
+    } else {
+        end[-1] = static_cast<char>('0' + value);
+    }
+}
+
+/// Writes @p value with exactly @p digits digits (zero padded) at @p p.
+inline char* write_decimal_padded(char* p, std::uint64_t value, unsigned digits) noexcept
+{
+    for (unsigned i = digits; i > 0; --i) {
+        p[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return p + digits;
+}
+
+template <typename UInt>
+inline to_chars_result unsigned_to_chars(char* first, char* last, UInt value, int base) noexcept
+{
+    const std::size_t room = static_cast<std::size_t>(last - first);
+    if (base == 10) {
+        const unsigned n = decimal_digits(value);
+        if (n > room) {
+            return {last, chars_status::no_space};
+        }
+        // 64-bit division is a library call on 32-bit cores.
+        if (sizeof(UInt) <= 4 || value <= 0xffffffffu) {
+            write_decimal(first + n, static_cast<std::uint32_t>(value));
+        } else {
+            write_decimal(first + n, static_cast<std::uint64_t>(value));
+        }
+        return {first + n, chars_status::ok};
+    }
+    unsigned n = 1;
+    for (UInt v = value; v >= static_cast<UInt>(base); v = static_cast<UInt>(v / base)) {
+        ++n;
+    }
+    if (n > room) {
+        return {last, chars_status::no_space};
+    }
+    char* p = first + n;
+    do {
+        *--p = digit_chars[value % static_cast<UInt>(base)];
+        value = static_cast<UInt>(value / base);
+    } while (value != 0);
+    return {first + n, chars_status::ok};
+}
+
+/// Detects embec::fixed (or any type with the same raw interface) without
+/// depending on fixed.hpp.
+template <typename T, typename = void>
+struct is_fixed_point : std::false_type {};
+template <typename T>
+struct is_fixed_point<T, std::void_t<decltype(T::fraction_bits), decltype(T::raw_max),
+                                     decltype(T::from_raw(std::declval<T>().raw()))>>
+    : std::true_type {};
+
+/// Rounds @p fraction (in [0, 1)) to @p precision decimal digits, halves
+/// to even; @p odd is the parity of the digit before the fraction. Returns
+/// the carry into that digit.
+inline bool double_fraction(double fraction, int precision, bool odd,
+                            std::uint64_t& digits) noexcept
+{
+    const double scaled = fraction * pow10_exact[precision];
+    digits = static_cast<std::uint64_t>(scaled);
+    const double rest = scaled - static_cast<double>(digits);
+    if (rest > 0.5 || (rest == 0.5 && (precision > 0 ? (digits & 1) != 0 : odd))) {
+        ++digits;
+    }
+    if (digits >= pow10_u64[precision]) {
+        digits = 0;
+        return true;
+    }
+    return false;
+}
+
+/// Removes trailing fraction zeros and a trailing decimal point.
+inline char* trim_fraction(char* begin, char* end) noexcept
+{
+    const void* point = std::memchr(begin, '.', static_cast<std::size_t>(end - begin));
+    if (point == nullptr) {
+        return end;
+    }
+    while (end[-1] == '0') {
+        --end;
+    }
+    return end[-1] == '.' ? end - 1 : end;
+}
+
+} // namespace detail
+
+// -------------------------------------------------------------------- to_chars
+
+/// Writes @p value in @p base (2 to 36, lower-case digits).
+template <typename Int,
+          std::enable_if_t<std::is_integral<Int>::value && !std::is_same<Int, bool>::value, int> = 0>
+to_chars_result to_chars(char* first, char* last, Int value, int base = 10) noexcept
+{
+    EMBEC_ASSERT(base >= 2 && base <= 36);
+    using UInt = std::make_unsigned_t<Int>;
+    UInt magnitude = static_cast<UInt>(value);
+    if constexpr (std::is_signed<Int>::value) {
+        if (value < 0) {
+            if (first == last) {
+                return {last, chars_status::no_space};
+            }
+            *first++ = '-';
+            magnitude = static_cast<UInt>(UInt{0} - magnitude);
+        }
+    }
+    return detail::unsigned_to_chars(first, last, magnitude, base);
+}
+
+/// Writes @p value in fixed notation with @p precision (0 to 17) fraction
+/// digits, or in exponent notation ("1.5e+20") if it is 2^64 or more.
+/// NaN and infinities are written as "nan", "inf" and "-inf".
+inline to_chars_result to_chars(char* first, char* last, double value, int precision) noexcept
+{
+    EMBEC_ASSERT(precision >= 0 && precision <= 17);
+    char buffer[48];
+    char* p = buffer;
+    if (value != value) {
+        std::memcpy(p, "nan", 3);
+        p += 3;
+    } else {
+        if (value < 0 || (value == 0 && 1 / value < 0)) {
+            *p++ = '-';
+            value = -value;
+        }
+        if (value == std::numeric_limits<double>::infinity()) {
+            std::memcpy(p, "inf", 3);
+            p += 3;
+        } else if (value < 18446744073709551616.0) {
+            auto whole = static_cast<std::uint64_t>(value);
+            std::uint64_t fraction;
+            if (detail::double_fraction(value - static_cast<double>(whole), precision,
+                                        (whole & 1) != 0, fraction)) {
+                ++whole;
+            }
+            p = detail::unsigned_to_chars(p, buffer + sizeof(buffer), whole, 10).ptr;
+            if (precision > 0) {
+                *p++ = '.';
+                p = detail::write_decimal_padded(p, fraction, static_cast<unsigned>(precision));
+            }
+        } else {
+            // Normalise to [1, 10) with a decimal exponent.
+            int exponent = 0;
+            constexpr double steps[] = {1e256, 1e128, 1e64, 1e32, 1e16, 1e8, 1e4, 1e2, 1e1};
+            constexpr int step_exponents[] = {256, 128, 64, 32, 16, 8, 4, 2, 1};
+            for (int i = 0; i < 9; ++i) {
+                if (value >= steps[i]) {
+                    value /= steps[i];
+                    exponent += step_exponents[i];
+                }
+            }
+            auto lead = static_cast<unsigned>(value);
+            std::uint64_t fraction;
+            if (detail::double_fraction(value - lead, precision, (lead & 1) != 0, fraction) &&
+                ++lead == 10) {
+                lead = 1;
+                ++exponent;
+            }
+            *p++ = static_cast<char>('0' + lead);
+            if (precision > 0) {
+                *p++ = '.';
+                p = detail::write_decimal_padded(p, fraction, static_cast<unsigned>(precision));
+            }
+            *p++ = 'e';
+            *p++ = '+';
+            p = detail::write_decimal_padded(p, static_cast<unsigned>(exponent),
+                                             exponent >= 100 ? 3 : 2);
+        }
+    }
+    const auto length = static_cast<std::size_t>(p - buffer);
+    if (length > static_cast<std::size_t>(last - first)) {
+        return {last, chars_status::no_space};
+    }
+    std::memcpy(first, buffer, length);
+    return {first + length, chars_status::ok};
+}
+
+/// Writes @p value with six fraction digits and trailing zeros removed.
+inline to_chars_result to_chars(char* first, char* last, double value) noexcept
+{
+    char buffer[48];
+    const to_chars_result full = to_chars(buffer, buffer + sizeof(buffer), value, 6);
+    if (!full) {
+        return {last, chars_status::no_space};
+    }
+    char* end = full.ptr;
+    if (end[-1] >= '0' && end[-1] <= '9') {
+        auto* exponent =
+            static_cast<char*>(std::memchr(buffer, 'e', static_cast<std::size_t>(end - buffer)));
+        if (exponent == nullptr) {
+            end = detail::trim_fraction(buffer, end);
+        } else {
+            char* mantissa_end = detail::trim_fraction(buffer, exponent);
+            const auto n = static_cast<std::size_t>(end - exponent);
+            std::memmove(mantissa_end, exponent, n);
+            end = mantissa_end + n;
+        }
+    }
+    const auto length = static_cast<std::size_t>(end - buffer);
+    if (length > static_cast<std::size_t>(last - first)) {
+        return {last, chars_status::no_space};
+    }
+    std::memcpy(first, buffer, length);
+    return {first + length, chars_status::ok};
+}
+
+/// Writes the exact value of the fixed-point number @p value rounded to
+/// @p precision fraction digits (halves to even, as printf); a negative precision
+/// selects enough digits to tell neighbouring values apart, with trailing
+/// zeros removed.
+template <typename Fixed, std::enable_if_t<detail::is_fixed_point<Fixed>::value, int> = 0>
+to_chars_result to_chars(char* first, char* last, Fixed value, int precision = -1) noexcept
+{
+    constexpr int frac_bits = Fixed::fraction_bits;
+    constexpr std::uint64_t frac_mask = (std::uint64_t{1} << frac_bits) - 1;
+    const bool trim = precision < 0;
+    if (trim) {
+        precision = (frac_bits * 301 + 999) / 1000;
+    }
+    EMBEC_ASSERT(precision <= 19);
+    char buffer[40];
+    char* p = buffer;
+    const auto raw = static_cast<std::int64_t>(value.raw());
+    if (raw < 0) {
+        *p++ = '-';
+    }
+    const std::uint64_t magnitude = raw < 0 ? 0 - static_cast<std::uint64_t>(raw)
+                                            : static_cast<std::uint64_t>(raw);
+    std::uint64_t whole = magnitude >> frac_bits;
+    std::uint64_t rest = magnitude & frac_mask;
+    char digits[20];
+    for (int i = 0; i < precision; ++i) {
+        rest *= 10;
+        digits[i] = static_cast<char>('0' + (rest >> frac_bits));
+        rest &= frac_mask;
+    }
+    const std::uint64_t half = std::uint64_t{1} << frac_bits;
+    const bool odd = precision > 0 ? (digits[precision - 1] & 1) != 0 : (whole & 1) != 0;
+    if (2 * rest > half || (2 * rest == half && odd)) {
+        int i = precision - 1;
+        for (; i >= 0 && digits[i] == '9'; --i) {
+            digits[i] = '0';
+        }
+        if (i >= 0) {
+            ++digits[i];
+        } else {
+            ++whole;
+        }
+    }
+    p = detail::unsigned_to_chars(p, buffer + sizeof(buffer), whole, 10).ptr;
+    if (precision > 0) {
+        *p++ = '.';
+        std::memcpy(p, digits, static_cast<std::size_t>(precision));
+        p += precision;
+        if (trim) {
+            p = detail::trim_fraction(buffer, p);
+        }
+    }
+    const auto length = static_cast<std::size_t>(p - buffer);
+    if (length > static_cast<std::size_t>(last - first)) {
+        return {last, chars_status::no_space};
+    }
+    std::memcpy(first, buffer, length);
+    return {first + length, chars_status::ok};
+}
+
+// ------------------------------------------------------------------ from_chars
+
+namespace detail {
+
+/// Value of digit @p c in bases up to 36, or 36 for a non-digit.
+constexpr unsigned digit_value(char c) noexcept
+{
+    if (c >= '0' && c <= '9') {
+        return static_cast<unsigned>(c - '0');
+    }
+    const char lower = static_cast<char>(c | 0x20);
+    if (lower >= 'a' && lower <= 'z') {
+        return static_cast<unsigned>(lower - 'a' + 10);
+    }
+    return 36;
+}
+
+inline bool match_word(const char*& p, const char* last, const char* word) noexcept
+{
+    const char* q = p;
+    for (; *word != '\0'; ++word, ++q) {
+        if (q == last || static_cast<char>(*q | 0x20) != *word) {
+            return false;
+        }
+    }
+    p = q;
+    return true;
+}
+
+} // namespace detail
+
+/// Parses an integer in @p base (2 to 36) with an optional leading '-' for
+/// signed types. On failure @p value is left unchanged.
+template <typename Int,
+          std::enable_if_t<std::is_integral<Int>::value && !std::is_same<Int, bool>::value, int> = 0>
+from_chars_result from_chars(const char* first, const char* last, Int& value, int base = 10) noexcept
+{
+    EMBEC_ASSERT(base >= 2 && base <= 36);
+    // Accumulate in at least 32 bits, but never in 64 for narrower types.
+    using UInt = std::conditional_t<(sizeof(Int) <= 4), std::uint32_t, std::uint64_t>;
+    const char* p = first;
+    bool negative = false;
+    if constexpr (std::is_signed<Int>::value) {
+        if (p != last && *p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+    const char* digits = p;
+    const UInt limit = negative ? UInt{0} - static_cast<UInt>(std::numeric_limits<Int>::min())
+                                : static_cast<UInt>(std::numeric_limits<Int>::max());
+    const auto b = static_cast<UInt>(base);
+    const UInt cutoff = limit / b;
+    const auto cutoff_digit = static_cast<unsigned>(limit % b);
+    UInt result = 0;
+    bool overflow = false;
+    for (; p != last; ++p) {
+        const unsigned d = detail::digit_value(*p);
+        if (d >= static_cast<unsigned>(base)) {
+            break;
+        }
+        if (result > cutoff || (result == cutoff && d > cutoff_digit)) {
+            overflow = true;
+        }
+        result = result * b + d;
+    }
+    if (p == digits) {
+        return {first, chars_status::invalid};
+    }
+    if (overflow) {
+        return {p, chars_status::out_of_range};
+    }
+    value = static_cast<Int>(negative ? UInt{0} - result : result);
+    return {p, chars_status::ok};
+}
+
+/// Parses a decimal floating-point number ("-12.5e3", "inf", "nan"). On
+/// failure @p value is left unchanged.
+inline from_chars_result from_chars(const char* first, const char* last, double& value) noexcept
+{
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative) {
+        ++p;
+    }
+    if (detail::match_word(p, last, "inf")) {
+        detail::match_word(p, last, "inity");
+        value = negative ? -std::numeric_limits<double>::infinity()
+                         : std::numeric_limits<double>::infinity();
+        return {p, chars_status::ok};
+    }
+    if (detail::match_word(p, last, "nan")) {
+        value = std::numeric_limits<double>::quiet_NaN();
+        return {p, chars_status::ok};
+    }
+    std::uint64_t mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+        any = true;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            significant += mantissa != 0;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p != last && *p == '.') {
+        ++p;
+        for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+            any = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                significant += mantissa != 0;
+                --exponent;
+            }
+        }
+    }
+    if (!any) {
+        return {first, chars_status::invalid};
+    }
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        const bool negative_exponent = q != last && *q == '-';
+        if (q != last && (*q == '-' || *q == '+')) {
+            ++q;
+        }
+        if (q != last && *q >= '0' && *q <= '9') {
+            int e = 0;
+            for (; q != last && *q >= '0' && *q <= '9'; ++q) {
+                if (e < 100000) {
+                    e = e * 10 + (*q - '0');
+                }
+            }
+            exponent += negative_exponent ? -e : e;
+            p = q;
+        }
+    }
+    if (mantissa > (std::uint64_t{1} << 53)) {
+        // Trailing zeros may be all that keeps the mantissa from being exact.
+        while (mantissa % 10 == 0) {
+            mantissa /= 10;
+            ++exponent;
+        }
+    }
+    double result;
+    if (mantissa == 0) {
+        result = 0;
+    } else if (exponent >= -22 && exponent <= 22) {
+        // Both operands are exact for mantissas up to 2^53, so the single
+        // operation rounds correctly; longer mantissas add one rounding.
+        const auto m = static_cast<double>(mantissa);
+        result = exponent < 0 ? m / detail::pow10_exact[-exponent]
+                              : m * detail::pow10_exact[exponent];
+    } else if (exponent > 310 - significant) {
+        return {p, chars_status::out_of_range};
+    } else if (exponent < -400) {
+        result = 0;
+    } else {
+        result = detail::scale_pow10(static_cast<double>(mantissa), exponent);
+        if (result == std::numeric_limits<double>::infinity()) {
+            return {p, chars_status::out_of_range};
+        }
+    }
+    value = negative ? -result : result;
+    return {p, chars_status::ok};
+}
+
+inline from_chars_result from_chars(const char* first, const char* last, float& value) noexcept
+{
+    double d;
+    from_chars_result r = from_chars(first, last, d);
+    if (r) {
+        const double magnitude = d < 0 ? -d : d;
+        if (magnitude > std::numeric_limits<float>::max() &&
+            magnitude != std::numeric_limits<double>::infinity()) {
+            r.status = chars_status::out_of_range;
+        } else {
+            value = static_cast<float>(d);
+        }
+    }
+    return r;
+}
+
+/// Parses a decimal number ("-1.25") into a fixed-point value, rounding to
+/// the nearest representable value (halves away from zero). Fraction
+/// digits beyond the 18th are ignored. On failure @p value is left
+/// unchanged.
+template <typename Fixed, std::enable_if_t<detail::is_fixed_point<Fixed>::value, int> = 0>
+from_chars_result from_chars(const char* first, const char* last, Fixed& value) noexcept
+{
+    constexpr int frac_bits = Fixed::fraction_bits;
+    const char* p = first;
+    const bool negative = p != last && *p == '-';
+    if (negative) {
+        ++p;
+    }
+    const std::uint64_t limit = negative ? static_cast<std::uint64_t>(-Fixed::raw_min)
+                                         : static_cast<std::uint64_t>(Fixed::raw_max);
+    std::uint64_t whole = 0;
+    bool any = false;
+    bool overflow = false;
+    for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+        any = true;
+        whole = whole * 10 + static_cast<unsigned>(*p - '0');
+        if (whole > (limit >> frac_bits) + 1) {
+            overflow = true;
+            whole = (limit >> frac_bits) + 1;
+        }
+    }
+    std::uint64_t numerator = 0;
+    std::uint64_t denominator = 1;
+    if (p != last && *p == '.') {
+        ++p;
+        for (int n = 0; p != last && *p >= '0' && *p <= '9'; ++p, ++n) {
+            any = true;
+            if (n < 18) {
+                numerator = numerator * 10 + static_cast<unsigned>(*p - '0');
+                denominator *= 10;
+            }
+        }
+    }
+    if (!any) {
+        return {first, chars_status::invalid};
+    }
+    // Long division of the decimal fraction into frac_bits binary digits.
+    std::uint64_t fraction = 0;
+    for (int i = 0; i < frac_bits; ++i) {
+        numerator *= 2;
+        fraction <<= 1;
+        if (numerator >= denominator) {
+            numerator -= denominator;
+            fraction |= 1;
+        }
+    }
+    std::uint64_t magnitude = (whole << frac_bits) + fraction + (2 * numerator >= denominator);
+    if (overflow || magnitude > limit) {
+        return {p, chars_status::out_of_range};
+    }
+    using raw_type = decltype(value.raw());
+    value = Fixed::from_raw(static_cast<raw_type>(
+        negative ? -static_cast<std::int64_t>(magnitude) : static_cast<std::int64_t>(magnitude)));
+    return {p, chars_status::ok};
+}
+
+// ---------------------------------------------------------------------- format
+
+/// A parsed replacement field.
+struct format_spec {
+    char fill = ' ';
+    char align = 0; ///< '<', '>', '^' or 0 for the type's default.
+    bool plus = false;
+    bool zero = false;
+    std::uint8_t width = 0;
+    std::int16_t precision = -1;
+    char type = 0;
+};
+
+namespace detail {
+
+enum class format_error {
+    none,
+    unmatched_brace,
+    too_many_fields,
+    too_few_fields,
+    invalid_spec,
+    type_mismatch,
+};
+
+/// Argument category codes for compile-time checking.
+template <typename T>
+constexpr char format_category() noexcept
+{
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same<U, bool>::value) {
+        return 'b';
+    } else if constexpr (std::is_same<U, char>::value) {
+        return 'c';
+    } else if constexpr (std::is_integral<U>::value || std::is_enum<U>::value) {
+        return 'i';
+    } else if constexpr (std::is_floating_point<U>::value) {
+        return 'f';
+    } else if constexpr (is_fixed_point<U>::value) {
+        return 'q';
+    } else if constexpr (std::is_null_pointer<U>::value) {
+        return 'p';
+    } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+        return 's';
+    } else if constexpr (std::is_pointer<U>::value) {
+        return 'p';
+    } else {
+        static_assert(!sizeof(U), "format arguments must be numbers, strings or pointers");
+        return 0;
+    }
+}
+
+/// True if conversion @p type (0 for none) suits argument @p category.
+constexpr bool format_type_allowed(char category, char type, int precision) noexcept
+{
+    if (precision >= 0 && category != 'f' && category != 'q' && category != 's') {
+        return false;
+    }
+    if (type == 0) {
+        return true;
+    }
+    const char* allowed = category == 'i'   ? "dxXboc"
+                          : category == 'c' ? "cdxX"
+                          : category == 'b' ? "s"
+                          : category == 'f' ? "fe"
+                          : category == 'q' ? "f"
+                          : category == 's' ? "s"
+                                            : "p";
+    for (; *allowed != '\0'; ++allowed) {
+        if (*allowed == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr std::size_t format_length(const char* s) noexcept
+{
+    std::size_t n = 0;
+    while (s[n]) {
+        ++n;
+    }
+    return n;
+}
+
+/// A format string split at compile time into unescaped literal text and
+/// the specs of its Fields replacement fields. Field i follows the text up
+/// to text_end[i]; text_end[Fields] ends the trailing text.
+template <std::size_t Fields, std::size_t Length>
+struct format_program {
+    char text[Length + 1] = {};
+    std::size_t text_end[Fields + 1] = {};
+    format_spec specs[Fields + 1] = {};
+    format_error error = format_error::none;
+};
+
+template <std::size_t Fields, std::size_t Length, typename... Args>
+constexpr format_program<Fields, Length> compile_format(const char* s) noexcept
+{
+    format_program<Fields, Length> program{};
+    const char categories[] = {format_category<Args>()..., '\0'};
+    std::size_t out = 0;
+    std::size_t field = 0;
+    for (std::size_t i = 0; s[i] != '\0'; ++i) {
+        const char c = s[i];
+        if (c == '}') {
+            if (s[i + 1] != '}') {
+                program.error = format_error::unmatched_brace;
+                return program;
+            }
+            program.text[out++] = '}';
+            ++i;
+            continue;
+        }
+        if (c != '{') {
+            program.text[out++] = c;
+            continue;
+        }
+        if (s[i + 1] == '{') {
+            program.text[out++] = '{';
+            ++i;
+            continue;
+        }
+        if (field == Fields) {
+            program.error = format_error::too_many_fields;
+            return program;
+        }
+        program.text_end[field] = out;
+        format_spec& spec = program.specs[field];
+        std::size_t j = i + 1;
+        if (s[j] == ':') {
+            ++j;
+            auto is_align = [](char a) { return a == '<' || a == '>' || a == '^'; };
+            if (s[j] != '\0' && s[j] != '}' && is_align(s[j + 1])) {
+                spec.fill = s[j];
+                spec.align = s[j + 1];
+                j += 2;
+            } else if (is_align(s[j])) {
+                spec.align = s[j++];
+            }
+            if (s[j] == '+') {
+                spec.plus = true;
+                ++j;
+            }
+            if (s[j] == '0') {
+                spec.zero = true;
+                ++j;
+            }
+            unsigned width = 0;
+            for (; s[j] >= '0' && s[j] <= '9'; ++j) {
+                width = width * 10 + static_cast<unsigned>(s[j] - '0');
+                if (width > 255) {
+                    program.error = format_error::invalid_spec;
+                    return program;
+                }
+            }
+            spec.width = static_cast<std::uint8_t>(width);
+            if (s[j] == '.') {
+                ++j;
+                if (s[j] < '0' || s[j] > '9') {
+                    program.error = format_error::invalid_spec;
+                    return program;
+                }
+                int precision = 0;
+                for (; s[j] >= '0' && s[j] <= '9'; ++j) {
+                    precision = precision * 10 + (s[j] - '0');
+                    if (precision > 999) {
+                        program.error = format_error::invalid_spec;
+                        return program;
+                    }
+                }
+                spec.precision = static_cast<std::int16_t>(precision);
+            }
+            if (s[j] != '}' && s[j] != '\0') {
+                spec.type = s[j++];
+            }
+        }
+        if (s[j] != '}') {
+            program.error = format_error::invalid_spec;
+            return program;
+        }
+        const char category = categories[field];
+        if (!format_type_allowed(category, spec.type, spec.precision) ||
+            (category == 'f' && spec.precision > 17) ||
+            (category == 'q' && spec.precision > 19)) {
+            program.error = format_error::type_mismatch;
+            return program;
+        }
+        ++field;
+        i = j;
+    }
+    if (field != Fields) {
+        program.error = format_error::too_few_fields;
+    }
+    program.text_end[Fields] = out;
+    return program;
+}
+
+/// Output cursor that truncates, keeping room for the terminating NUL.
+class format_writer {
+public:
+    format_writer(char* buffer, std::size_t size) noexcept
+        : begin_(buffer), pos_(buffer), end_(size != 0 ? buffer + size - 1 : buffer)
+    {
+    }
+
+    void put(const char* s, std::size_t n) noexcept
+    {
+        const auto room = static_cast<std::size_t>(end_ - pos_);
+        if (EMBEC_UNLIKELY(n > room)) {
+            n = room;
+            truncated_ = true;
+        }
+        if (n != 0) {
+            std::memcpy(pos_, s, n);
+            pos_ += n;
+        }
+    }
+
+    void fill(char c, std::size_t n) noexcept
+    {
+        const auto room = static_cast<std::size_t>(end_ - pos_);
+        if (EMBEC_UNLIKELY(n > room)) {
+            n = room;
+            truncated_ = true;
+        }
+        if (n != 0) {
+            std::memset(pos_, c, n);
+            pos_ += n;
+        }
+    }
+
+    format_result finish(bool terminate) noexcept
+    {
+        if (terminate) {
+            *pos_ = '\0';
+        }
+        return {static_cast<std::size_t>(pos_ - begin_),
+                truncated_ ? chars_status::no_space : chars_status::ok};
+    }
+
+private:
+    char* begin_;
+    char* pos_;
+    char* end_;
+    bool truncated_ = false;
+};
+
+/// Writes @p s padded to the field width. @p numeric selects right
+/// alignment by default and zero padding after the sign for the '0' flag.
+inline void format_padded(format_writer& out, const format_spec& spec, const char* s,
+                          std::size_t n, bool numeric) noexcept
+{
+    if (spec.width <= n) {
+        out.put(s, n);
+        return;
+    }
+    const std::size_t pad = spec.width - n;
+    if (numeric && spec.zero && spec.align == 0) {
+        const std::size_t sign = n != 0 && (s[0] == '-' || s[0] == '+') ? 1 : 0;
+        out.put(s, sign);
+        out.fill('0', pad);
+        out.put(s + sign, n - sign);
+        return;
+    }
+    const char align = spec.align != 0 ? spec.align : numeric ? '>' : '<';
+    const std::size_t before = align == '>' ? pad : align == '^' ? pad / 2 : 0;
+    out.fill(spec.fill, before);
+    out.put(s, n);
+    out.fill(spec.fill, pad - before);
+}
+
+inline void format_upper(char* begin, char* end) noexcept
+{
+    for (; begin != end; ++begin) {
+        if (*begin >= 'a' && *begin <= 'z') {
+            *begin = static_cast<char>(*begin - 'a' + 'A');
+        }
+    }
+}
+
+template <typename T>
+void format_value(format_writer& out, const format_spec& spec, const T& value) noexcept
+{
+    constexpr char category = format_category<T>();
+    char buffer[72];
+    char* p = buffer;
+    char* const end = buffer + sizeof(buffer);
+    if constexpr (category == 's') {
+        std::string_view s = value;
+        if (spec.precision >= 0 && s.size() > static_cast<std::size_t>(spec.precision)) {
+            s = s.substr(0, static_cast<std::size_t>(spec.precision));
+        }
+        format_padded(out, spec, s.data(), s.size(), false);
+        return;
+    } else if constexpr (category == 'b') {
+        format_padded(out, spec, value ? "true" : "false", value ? 4 : 5, false);
+        return;
+    } else if constexpr (category == 'p') {
+        *p++ = '0';
+        *p++ = 'x';
+        p = unsigned_to_chars(p, end, reinterpret_cast<std::uintptr_t>(value), 16).ptr;
+    } else if constexpr (category == 'c' || category == 'i') {
+        const char type = spec.type != 0 ? spec.type : category == 'c' ? 'c' : 'd';
+        if (type == 'c') {
+            const char c = static_cast<char>(value);
+            format_padded(out, spec, &c, 1, false);
+            return;
+        }
+        using Int = std::conditional_t<std::is_enum<T>::value, std::underlying_type<T>,
+                                       std::common_type<T>>;
+        const auto v = static_cast<typename Int::type>(value);
+        if constexpr (std::is_signed<typename Int::type>::value) {
+            if (spec.plus && v >= 0) {
+                *p++ = '+';
+            }
+        } else if (spec.plus) {
+            *p++ = '+';
+        }
+        const int base = type == 'x' || type == 'X' ? 16 : type == 'b' ? 2 : type == 'o' ? 8 : 10;
+        char* digits = p;
+        p = to_chars(p, end, v, base).ptr;
+        if (type == 'X') {
+            format_upper(digits, p);
+        }
+    } else {
+        bool negative;
+        if constexpr (category == 'q') {
+            negative = value.raw() < 0;
+        } else {
+            negative = value < 0;
+        }
+        if (spec.plus && !negative) {
+            *p++ = '+';
+        }
+        if constexpr (category == 'q') {
+            p = to_chars(p, end, value, spec.precision).ptr;
+        } else if (spec.type == 'e') {
+            // to_chars switches to exponent notation only for huge values,
+            // so the exponent form is produced here.
+            const auto d = static_cast<double>(value);
+            const int precision = spec.precision >= 0 ? spec.precision : 6;
+            const double magnitude = d < 0 ? -d : d;
+            if (magnitude >= 18446744073709551616.0 || magnitude != magnitude ||
+                magnitude == std::numeric_limits<double>::infinity()) {
+                p = to_chars(p, end, d, precision).ptr;
+            } else {
+                int exponent = 0;
+                double m = magnitude;
+                if (m != 0) {
+                    while (m >= 10) {
+                        m /= 10;
+                        ++exponent;
+                    }
+                    constexpr double steps[] = {1e256, 1e128, 1e64, 1e32, 1e16, 1e8, 1e4, 1e2, 1e1};
+                    constexpr int step_exponents[] = {256, 128, 64, 32, 16, 8, 4, 2, 1};
+                    for (int i = 0; i < 9; ++i) {
+                        if (m * steps[i] < 10) {
+                            m *= steps[i];
+                            exponent -= step_exponents[i];
+                        }
+                    }
+                }
+                auto lead = static_cast<unsigned>(m);
+                std::uint64_t fraction;
+                if (double_fraction(m - lead, precision, (lead & 1) != 0, fraction) &&
+                    ++lead == 10) {
+                    lead = 1;
+                    ++exponent;
+                }
+                if (d < 0) {
+                    *p++ = '-';
+                }
+                *p++ = static_cast<char>('0' + lead);
+                if (precision > 0) {
+                    *p++ = '.';
+                    p = write_decimal_padded(p, fraction, static_cast<unsigned>(precision));
+                }
+                *p++ = 'e';
+                *p++ = exponent < 0 ? '-' : '+';
+                const auto e = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+                p = write_decimal_padded(p, e, e >= 100 ? 3 : 2);
+            }
+        } else if (spec.precision >= 0) {
+            p = to_chars(p, end, static_cast<double>(value), spec.precision).ptr;
+        } else {
+            p = to_chars(p, end, static_cast<double>(value)).ptr;
+        }
+    }
+    format_padded(out, spec, buffer, static_cast<std::size_t>(p - buffer), true);
+}
+
+} // namespace detail
+
+/// Formats @p args into @p buffer of @p size bytes according to @p format,
+/// an EMBEC_FMT string; see the file documentation. The output is
+/// truncated to size - 1 characters and NUL-terminated if size > 0.
+template <typename Format, typename... Args,
+          std::enable_if_t<std::is_invocable<Format>::value, int> = 0>
+format_result format_to(char* buffer, std::size_t size, Format format, const Args&... args) noexcept
+{
+    constexpr const char* text = format();
+    constexpr std::size_t fields = sizeof...(Args);
+    static constexpr auto program =
+        detail::compile_format<fields, detail::format_length(text), Args...>(text);
+    static_assert(program.error != detail::format_error::unmatched_brace,
+                  "unmatched '{' or '}' in format string");
+    static_assert(program.error != detail::format_error::too_many_fields,
+                  "format string has more replacement fields than arguments");
+    static_assert(program.error != detail::format_error::too_few_fields,
+                  "format string has fewer replacement fields than arguments");
+    static_assert(program.error != detail::format_error::invalid_spec,
+                  "invalid format specification");
+    static_assert(program.error != detail::format_error::type_mismatch,
+                  "format type or precision does not suit the argument type");
+
+    detail::format_writer out(buffer, size);
+    std::size_t field = 0;
+    std::size_t from = 0;
+    [[maybe_unused]] auto emit = [&](const auto& arg) {
+        out.put(program.text + from, program.text_end[field] - from);
+        detail::format_value(out, program.specs[field], arg);
+        from = program.text_end[field++];
+    };
+    (emit(args), ...);
+    out.put(program.text + from, program.text_end[fields] - from);
+    return out.finish(size != 0);
+}
+
+template <std::size_t N, typename Format, typename... Args,
+          std::enable_if_t<std::is_invocable<Format>::value, int> = 0>
+format_result format_to(char (&buffer)[N], Format format, const Args&... args) noexcept
+{
+    return format_to(buffer, N, format, args...);
+}
+
+} // namespace embec
+
+/// Wraps a format string literal for compile-time checking by format_to().
+#define EMBEC_FMT(literal) [] { return literal; }
+
+#endif // EMBEC_FORMAT_HPP
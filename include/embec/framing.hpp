@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file framing.hpp
+/// @brief Types and byte-scanning helpers shared by the framing codecs
+///        (cobs.hpp, slip.hpp).
+
+#ifndef EMBEC_FRAMING_HPP
+#define EMBEC_FRAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace embec {
+
+/// Outcome of a framing encode/decode step.
+enum class frame_status {
+    ok,         ///< Complete result (or complete frame) available.
+    incomplete, ///< Streaming decoder needs more input.
+    overflow,   ///< Output does not fit in the destination buffer.
+    invalid,    ///< Malformed input.
+};
+
+/// Result of a one-shot encode or decode.
+struct frame_result {
+    std::size_t length; ///< Bytes written to the destination (0 on error).
+    frame_status status;
+
+    constexpr explicit operator bool() const noexcept { return status == frame_status::ok; }
+};
+
+namespace detail {
+
+using scan_word = std::uintptr_t;
+
+constexpr scan_word scan_ones = ~scan_word{0} / 0xff; // 0x0101...01
+constexpr scan_word scan_highs = scan_ones * 0x80;    // 0x8080...80
+
+/// True if any byte of @p v is zero.
+constexpr bool word_has_zero(scan_word v) noexcept
+{
+    return ((v - scan_ones) & ~v & scan_highs) != 0;
+}
+
+/// Index of the first byte in [p, p + n) equal to @p a or, if @p Two,
+/// to @p b; n if there is none.
+///
+/// Works a machine word at a time: the pointer is first brought to word
+/// alignment so that the loads are single aligned instructions on every
+/// core, then each word is tested for a matching byte with the classic
+/// "has zero byte" bit trick. Only the word containing a match is rescanned
+/// byte by byte.
+template <bool Two>
+inline std::size_t scan_bytes(const std::uint8_t* p, std::size_t n, std::uint8_t a,
+                              std::uint8_t b) noexcept
+{
+    const auto match = [a, b](std::uint8_t byte) { return byte == a || (Two && byte == b); };
+    std::size_t i = 0;
+    while (i < n && (reinterpret_cast<std::uintptr_t>(p + i) % sizeof(scan_word)) != 0) {
+        if (match(p[i])) {
+            return i;
+        }
+        ++i;
+    }
+    const scan_word pattern_a = scan_ones * a;
+    const scan_word pattern_b = scan_ones * b;
+    if (n >= sizeof(scan_word)) {
+        // Start of the last full word, fixed up front so that the loads
+        // visibly stay within [p, p + n).
+        const std::size_t last = n - sizeof(scan_word);
+        for (; i <= last; i += sizeof(scan_word)) {
+            scan_word word;
+            std::memcpy(&word, p + i, sizeof(word));
+            if (word_has_zero(word ^ pattern_a) || (Two && word_has_zero(word ^ pattern_b))) {
+                break;
+            }
+        }
+    }
+    for (; i < n; ++i) {
+        if (match(p[i])) {
+            return i;
+        }
+    }
+    return n;
+}
+
+/// Index of the first zero byte in [p, p + n), or n if there is none.
+inline std::size_t find_zero(const std::uint8_t* p, std::size_t n) noexcept
+{
+    return scan_bytes<false>(p, n, 0, 0);
+}
+
+/// Index of the first byte equal to @p a or @p b, or n if there is none.
+inline std::size_t find_either(const std::uint8_t* p, std::size_t n, std::uint8_t a,
+                               std::uint8_t b) noexcept
+{
+    return scan_bytes<true>(p, n, a, b);
+}
+
+} // namespace detail
+} // namespace embec
+
+#endif // EMBEC_FRAMING_HPP
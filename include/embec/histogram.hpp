@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file histogram.hpp
+/// @brief Fixed-memory log-linear (HDR-style) histogram with lock-free
+///        recording and mergeable snapshots.
+///
+/// Values below 2^(Precision + 1) get a bucket each; above that every
+/// power-of-two range is split into 2^Precision equal buckets, so a bucket
+/// is never wider than 2^-Precision of the values in it. With the default
+/// precision of 4 that is 6.25 % for 464 buckets over the full 32-bit range
+/// (1856 bytes of counters).
+///
+/// @code
+/// embec::histogram<> isr_latency;            // static storage
+///
+/// void timer_isr()
+/// {
+///     const auto start = embec::cycle_counter::now();
+///     ...
+///     isr_latency.record(static_cast<std::uint32_t>(embec::cycle_counter::now() - start));
+/// }
+///
+/// // Reporting task, once a second:
+/// const auto s = isr_latency.drain();
+/// report(s.percentile(50), s.percentile(99), s.percentile(99.9), s.max());
+/// @endcode
+///
+/// record() is one bucket lookup and a relaxed atomic increment plus a
+/// compare-and-swap for the minimum and maximum when they change, so it is
+/// safe from any thread or interrupt handler and never blocks. It requires
+/// native atomic read-modify-write instructions (e.g. LDREX/STREX), so not
+/// Cortex-M0. snapshot() and drain() copy the counters into a plain
+/// histogram_snapshot for the percentile queries; snapshots of several
+/// histograms (cores, devices, reporting periods) merge by adding counts.
+
+#ifndef EMBEC_HISTOGRAM_HPP
+#define EMBEC_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/bits.hpp"
+
+namespace embec {
+
+/// Bucket layout shared by histogram and histogram_snapshot.
+template <typename Value, unsigned Precision>
+struct histogram_layout {
+    static_assert(std::is_integral<Value>::value && std::is_unsigned<Value>::value,
+                  "histogram values must be unsigned integers");
+    static_assert(Precision >= 1 && Precision + 2 <= 8 * sizeof(Value),
+                  "histogram precision out of range");
+
+    static constexpr unsigned value_bits = 8 * sizeof(Value);
+    static constexpr std::size_t sub_buckets = std::size_t{1} << Precision;
+    static constexpr std::size_t bucket_count = (value_bits - Precision + 1) << Precision;
+
+    /// Bucket holding @p value.
+    static constexpr std::size_t index_of(Value value) noexcept
+    {
+        if (value < 2 * sub_buckets) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned shift = detail::highest_bit(value) - Precision;
+        return ((shift + std::size_t{1}) << Precision) +
+               static_cast<std::size_t>(value >> shift) - sub_buckets;
+    }
+
+    /// Smallest value in bucket @p index.
+    static constexpr Value lowest_in(std::size_t index) noexcept
+    {
+        const std::size_t group = index >> Precision;
+        if (group <= 1) {
+            return static_cast<Value>(index);
+        }
+        return static_cast<Value>(static_cast<Value>(sub_buckets + (index & (sub_buckets - 1)))
+                                  << (group - 1));
+    }
+
+    /// Largest value in bucket @p index.
+    static constexpr Value highest_in(std::size_t index) noexcept
+    {
+        const std::size_t group = index >> Precision;
+        const Value width_minus_one =
+            group <= 1 ? Value{0} : static_cast<Value>((Value{1} << (group - 1)) - 1);
+        return static_cast<Value>(lowest_in(index) + width_minus_one);
+    }
+};
+
+/// Plain copy of a histogram's counters, for queries and merging.
+///
+/// Counts are 32-bit and saturate when snapshots are merged.
+template <typename Value = std::uint32_t, unsigned Precision = 4>
+class histogram_snapshot {
+public:
+    using layout = histogram_layout<Value, Precision>;
+    using value_type = Value;
+
+    static constexpr std::size_t bucket_count() noexcept { return layout::bucket_count; }
+
+    /// Number of recorded values.
+    std::uint64_t count() const noexcept { return total_; }
+    bool empty() const noexcept { return total_ == 0; }
+
+    /// Exact smallest and largest recorded values (0 when empty).
+    Value min() const noexcept { return empty() ? Value{0} : min_; }
+    Value max() const noexcept { return empty() ? Value{0} : max_; }
+
+    /// Smallest value that at least @p percent (0 to 100) percent of the
+    /// recorded values do not exceed, as the upper end of its bucket (so
+    /// never an underestimate) clamped to max(). 0 when empty.
+    Value percentile(double percent) const noexcept
+    {
+        if (empty()) {
+            return 0;
+        }
+        if (percent <= 0) {
+            return min_;
+        }
+        const double wanted = percent >= 100 ? static_cast<double>(total_)
+                                             : percent / 100 * static_cast<double>(total_);
+        std::uint64_t rank = static_cast<std::uint64_t>(wanted);
+        rank += static_cast<double>(rank) < wanted || rank == 0;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                const Value high = layout::highest_in(i);
+                return high < max_ ? (high > min_ ? high : min_) : max_;
+            }
+        }
+        return max_;
+    }
+
+    /// Mean estimated from the bucket midpoints.
+    double mean() const noexcept
+    {
+        if (empty()) {
+            return 0;
+        }
+        double sum = 0;
+        for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+            if (counts_[i] != 0) {
+                const double mid = (static_cast<double>(layout::lowest_in(i)) +
+                                    static_cast<double>(layout::highest_in(i))) /
+                                   2;
+                sum += mid * counts_[i];
+            }
+        }
+        return sum / static_cast<double>(total_);
+    }
+
+    /// Count of bucket @p index, and the range of values it covers.
+    std::uint32_t bucket(std::size_t index) const noexcept
+    {
+        EMBEC_ASSERT(index < layout::bucket_count);
+        return counts_[index];
+    }
+    static constexpr Value bucket_lowest(std::size_t index) noexcept
+    {
+        return layout::lowest_in(index);
+    }
+    static constexpr Value bucket_highest(std::size_t index) noexcept
+    {
+        return layout::highest_in(index);
+    }
+
+    /// Calls @p f(lowest, highest, count) for every non-empty bucket in
+    /// ascending order, for export.
+    template <typename F>
+    void for_each_bucket(F&& f) const
+    {
+        for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+            if (counts_[i] != 0) {
+                f(layout::lowest_in(i), layout::highest_in(i), counts_[i]);
+            }
+        }
+    }
+
+    /// Adds the counts of @p other.
+    void merge(const histogram_snapshot& other) noexcept
+    {
+        for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+            const std::uint32_t room = std::numeric_limits<std::uint32_t>::max() - counts_[i];
+            counts_[i] += other.counts_[i] < room ? other.counts_[i] : room;
+        }
+        min_ = other.min_ < min_ ? other.min_ : min_;
+        max_ = other.max_ > max_ ? other.max_ : max_;
+        total_ += other.total_;
+    }
+
+private:
+    template <typename, unsigned>
+    friend class histogram;
+
+    std::uint32_t counts_[layout::bucket_count] = {};
+    std::uint64_t total_ = 0;
+    // Kept even without counts: a concurrent drain() may separate a value's
+    // count from its minimum and maximum, and merging reunites them.
+    Value min_ = static_cast<Value>(~Value{0});
+    Value max_ = 0;
+};
+
+/// Lock-free histogram with storage inside the object.
+///
+/// @tparam Value     Unsigned integer type of the recorded values.
+/// @tparam Precision log2 of the buckets per power of two.
+template <typename Value = std::uint32_t, unsigned Precision = 4>
+class histogram {
+public:
+    using layout = histogram_layout<Value, Precision>;
+    using value_type = Value;
+    using snapshot_type = histogram_snapshot<Value, Precision>;
+
+    constexpr histogram() noexcept = default;
+    histogram(const histogram&) = delete;
+    histogram& operator=(const histogram&) = delete;
+
+    static constexpr std::size_t bucket_count() noexcept { return layout::bucket_count; }
+
+    /// Records one value.
+    void record(Value value) noexcept
+    {
+        counts_[layout::index_of(value)].fetch_add(1, std::memory_order_relaxed);
+        // Stored complemented so that the zero state means "no minimum".
+        const Value inverted = static_cast<Value>(~value);
+        Value seen = min_inverted_.load(std::memory_order_relaxed);
+        while (inverted > seen &&
+               !min_inverted_.compare_exchange_weak(seen, inverted, std::memory_order_relaxed)) {
+        }
+        seen = max_.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// Copies the counters. Values recorded concurrently may or may not be
+    /// included, bucket by bucket.
+    snapshot_type snapshot() const noexcept
+    {
+        snapshot_type s;
+        for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+            s.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+            s.total_ += s.counts_[i];
+        }
+        s.min_ = static_cast<Value>(~min_inverted_.load(std::memory_order_relaxed));
+        s.max_ = max_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /// Moves the counters into a snapshot and starts over. Every value
+    /// recorded concurrently is counted in exactly one drain, though its
+    /// effect on min() and max() may land in the next (merged snapshots of
+    /// consecutive drains are exact).
+    snapshot_type drain() noexcept
+    {
+        snapshot_type s;
+        s.min_ = static_cast<Value>(~min_inverted_.exchange(0, std::memory_order_relaxed));
+        s.max_ = max_.exchange(0, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < layout::bucket_count; ++i) {
+            s.counts_[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+            s.total_ += s.counts_[i];
+        }
+        return s;
+    }
+
+    /// Clears the histogram. Concurrent records may be lost.
+    void reset() noexcept { drain(); }
+
+private:
+    std::atomic<std::uint32_t> counts_[layout::bucket_count]{};
+    std::atomic<Value> min_inverted_{0};
+    std::atomic<Value> max_{0};
+};
+
+} // namespace embec
+
+#endif // EMBEC_HISTOGRAM_HPP
@@ -0,0 +1,734 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file hsm.hpp
+/// @brief Table-driven hierarchical state machines.
+///
+/// A machine is described by a definition struct; the state hierarchy and
+/// the rules are compiled into constant tables (parent links, a flat
+/// state x event dispatch table and precomputed entry paths), so the
+/// machine object itself holds only the current state and its event queue:
+///
+/// @code
+/// enum class st : std::uint8_t { off, on, idle, busy };
+/// enum class ev : std::uint8_t { power, start, done };
+///
+/// struct oven_def {
+///     using context = oven;
+///     using event = ev;
+///     static constexpr st initial = st::off;
+///     using states = embec::hsm_states<
+///         embec::hsm_state<st::off>,
+///         embec::hsm_state<st::on, embec::hsm_none, st::idle>, // initial child
+///         embec::hsm_state<st::idle, st::on>,
+///         embec::hsm_state<st::busy, st::on>>;
+///     using rules = embec::hsm_rules<
+///         embec::hsm_entry<st::on, &oven::lamp_on>,
+///         embec::hsm_exit<st::on, &oven::lamp_off>,
+///         embec::hsm_transition<st::off, ev::power, st::on>,
+///         embec::hsm_transition<st::on, ev::power, st::off>, // also from idle/busy
+///         embec::hsm_transition<st::idle, ev::start, st::busy, &oven::heat, &oven::door_closed>,
+///         embec::hsm_transition<st::busy, ev::done, st::idle>>;
+/// };
+///
+/// embec::hsm<oven_def> machine(my_oven);
+/// machine.start();
+/// machine.dispatch(ev::power);
+/// @endcode
+///
+/// State and event enumerators index the tables directly, so they should
+/// be dense and start at zero. Actions and guards are plain functions
+/// taking the context (`void(context&)`, `bool(context&)`); a static member
+/// function works as well.
+///
+/// Semantics follow UML state charts: a transition exits the active states
+/// up to the least common proper ancestor of its source and target, runs its
+/// action, then enters down to the target and on through initial children.
+/// A transition declared on a composite state applies to all its
+/// substates; an inner declaration takes precedence, and when its guard
+/// fails the next candidate (same state in declaration order, then the
+/// ancestors) is tried. Events are processed run-to-completion: events
+/// posted from actions are queued and handled after the current one.
+///
+/// Finding the rule for an event is one table lookup; only guard fallbacks
+/// and the exit/entry actions that actually run add work.
+
+#ifndef EMBEC_HSM_HPP
+#define EMBEC_HSM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/cycle_counter.hpp"
+#include "embec/static_deque.hpp"
+
+namespace embec {
+
+/// Marks an absent parent or initial child.
+enum class hsm_none_t { none };
+inline constexpr hsm_none_t hsm_none = hsm_none_t::none;
+
+/// Declares state @p Id with parent @p Parent and the child @p Initial
+/// entered when a transition targets @p Id.
+template <auto Id, auto Parent = hsm_none, auto Initial = hsm_none>
+struct hsm_state;
+
+/// External transition from @p Source to @p Target on @p Event.
+template <auto Source, auto Event, auto Target, auto Action = nullptr, auto Guard = nullptr>
+struct hsm_transition;
+
+/// Internal transition: runs @p Action in @p State without exiting it.
+template <auto State, auto Event, auto Action, auto Guard = nullptr>
+struct hsm_internal;
+
+/// Entry and exit actions of @p State.
+template <auto State, auto Action>
+struct hsm_entry;
+template <auto State, auto Action>
+struct hsm_exit;
+
+template <typename... States>
+struct hsm_states;
+template <typename... Rules>
+struct hsm_rules;
+
+namespace detail {
+
+constexpr std::size_t hsm_npos = ~std::size_t{0};
+
+template <typename T>
+constexpr std::size_t hsm_index(T value) noexcept
+{
+    if constexpr (std::is_same<T, hsm_none_t>::value) {
+        return hsm_npos;
+    } else {
+        static_assert(std::is_enum<T>::value || std::is_integral<T>::value,
+                      "states and events must be enumerators or integers");
+        return static_cast<std::size_t>(value);
+    }
+}
+
+struct hsm_state_info {
+    std::size_t id;
+    std::size_t parent;
+    std::size_t initial;
+};
+
+enum class hsm_rule_kind : std::uint8_t { transition, internal, entry, exit };
+
+template <typename Context>
+struct hsm_rule_info {
+    hsm_rule_kind kind;
+    std::size_t state; ///< Source, or the state owning an entry/exit action.
+    std::size_t event;
+    std::size_t target;
+    void (*action)(Context&);
+    bool (*guard)(Context&);
+    bool has_action;
+};
+
+} // namespace detail
+
+template <auto Id, auto Parent, auto Initial>
+struct hsm_state {
+    static constexpr detail::hsm_state_info info() noexcept
+    {
+        return {detail::hsm_index(Id), detail::hsm_index(Parent), detail::hsm_index(Initial)};
+    }
+};
+
+template <auto Source, auto Event, auto Target, auto Action, auto Guard>
+struct hsm_transition {
+    template <typename Context>
+    static constexpr detail::hsm_rule_info<Context> info() noexcept
+    {
+        return {detail::hsm_rule_kind::transition, detail::hsm_index(Source),
+                detail::hsm_index(Event), detail::hsm_index(Target), Action, Guard,
+                !std::is_same<decltype(Action), std::nullptr_t>::value};
+    }
+};
+
+template <auto State, auto Event, auto Action, auto Guard>
+struct hsm_internal {
+    template <typename Context>
+    static constexpr detail::hsm_rule_info<Context> info() noexcept
+    {
+        return {detail::hsm_rule_kind::internal, detail::hsm_index(State),
+                detail::hsm_index(Event), detail::hsm_npos, Action, Guard,
+                !std::is_same<decltype(Action), std::nullptr_t>::value};
+    }
+};
+
+template <auto State, auto Action>
+struct hsm_entry {
+    template <typename Context>
+    static constexpr detail::hsm_rule_info<Context> info() noexcept
+    {
+        return {detail::hsm_rule_kind::entry, detail::hsm_index(State), detail::hsm_npos,
+                detail::hsm_npos, Action, nullptr,
+                !std::is_same<decltype(Action), std::nullptr_t>::value};
+    }
+};
+
+template <auto State, auto Action>
+struct hsm_exit {
+    template <typename Context>
+    static constexpr detail::hsm_rule_info<Context> info() noexcept
+    {
+        return {detail::hsm_rule_kind::exit, detail::hsm_index(State), detail::hsm_npos,
+                detail::hsm_npos, Action, nullptr,
+                !std::is_same<decltype(Action), std::nullptr_t>::value};
+    }
+};
+
+template <typename... States>
+struct hsm_states {
+    static constexpr std::size_t size = sizeof...(States);
+
+    static constexpr std::array<detail::hsm_state_info, size> infos() noexcept
+    {
+        return {{States::info()...}};
+    }
+};
+
+template <typename... Rules>
+struct hsm_rules {
+    static constexpr std::size_t size = sizeof...(Rules);
+
+    template <typename Context>
+    static constexpr std::array<detail::hsm_rule_info<Context>, size> infos() noexcept
+    {
+        return {{Rules::template info<Context>()...}};
+    }
+};
+
+namespace detail {
+
+/// Compile-time tables of machine definition @p Def.
+template <typename Def>
+struct hsm_tables {
+    using context = typename Def::context;
+    using rule = hsm_rule_info<context>;
+
+    static constexpr std::size_t state_count = Def::states::size;
+    static constexpr std::size_t rule_count = Def::rules::size;
+
+    static constexpr auto states = Def::states::infos();
+    static constexpr auto rules = Def::rules::template infos<context>();
+
+    static_assert(state_count > 0, "a machine needs at least one state");
+
+    static constexpr std::size_t make_event_count() noexcept
+    {
+        std::size_t count = 0;
+        for (const rule& r : rules) {
+            if (r.event != hsm_npos && r.event + 1 > count) {
+                count = r.event + 1;
+            }
+        }
+        return count;
+    }
+
+    static constexpr std::size_t event_count = make_event_count();
+
+    /// Index type of the ROM tables; npos is its maximum value.
+    using index_t = std::conditional_t<(state_count < 0xff && rule_count < 0xff), std::uint8_t,
+                                       std::uint16_t>;
+    static constexpr index_t none = static_cast<index_t>(~index_t{0});
+
+    static constexpr std::array<std::size_t, state_count> make_parents() noexcept
+    {
+        std::array<std::size_t, state_count> parent{};
+        for (const hsm_state_info& s : states) {
+            if (s.id < state_count) {
+                parent[s.id] = s.parent;
+            }
+        }
+        return parent;
+    }
+
+    static constexpr std::array<std::size_t, state_count> parent_of = make_parents();
+
+    static constexpr bool valid_state(std::size_t s) noexcept { return s < state_count; }
+
+    static constexpr bool check_states() noexcept
+    {
+        bool seen[state_count]{};
+        for (const hsm_state_info& s : states) {
+            if (!valid_state(s.id) || seen[s.id]) {
+                return false;
+            }
+            seen[s.id] = true;
+            if (s.parent != hsm_npos && (!valid_state(s.parent) || s.parent == s.id)) {
+                return false;
+            }
+            if (s.initial != hsm_npos && (!valid_state(s.initial) || parent_of[s.initial] != s.id)) {
+                return false;
+            }
+        }
+        // Every parent chain must reach the top.
+        for (std::size_t s = 0; s < state_count; ++s) {
+            std::size_t p = s;
+            std::size_t steps = 0;
+            while (p != hsm_npos && steps <= state_count) {
+                p = parent_of[p];
+                ++steps;
+            }
+            if (p != hsm_npos) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr bool check_rules() noexcept
+    {
+        if (!check_states()) {
+            return true; // reported by the state check
+        }
+        bool has_entry[state_count]{};
+        bool has_exit[state_count]{};
+        for (const rule& r : rules) {
+            if (!valid_state(r.state)) {
+                return false;
+            }
+            switch (r.kind) {
+            case hsm_rule_kind::transition:
+                if (!valid_state(r.target)) {
+                    return false;
+                }
+                break;
+            case hsm_rule_kind::internal:
+                if (!r.has_action) {
+                    return false;
+                }
+                break;
+            case hsm_rule_kind::entry:
+                if (has_entry[r.state] || !r.has_action) {
+                    return false;
+                }
+                has_entry[r.state] = true;
+                break;
+            case hsm_rule_kind::exit:
+                if (has_exit[r.state] || !r.has_action) {
+                    return false;
+                }
+                has_exit[r.state] = true;
+                break;
+            }
+        }
+        return true;
+    }
+
+    static constexpr bool is_proper_ancestor(std::size_t ancestor, std::size_t s) noexcept
+    {
+        for (std::size_t p = parent_of[s]; p != hsm_npos; p = parent_of[p]) {
+            if (p == ancestor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Least common proper ancestor of @p a and @p b, npos for the top.
+    static constexpr std::size_t lcpa(std::size_t a, std::size_t b) noexcept
+    {
+        for (std::size_t p = parent_of[a]; p != hsm_npos; p = parent_of[p]) {
+            if (is_proper_ancestor(p, b)) {
+                return p;
+            }
+        }
+        return hsm_npos;
+    }
+
+    static constexpr bool handles(const rule& r, std::size_t state, std::size_t event) noexcept
+    {
+        return (r.kind == hsm_rule_kind::transition || r.kind == hsm_rule_kind::internal) &&
+               r.state == state && r.event == event;
+    }
+
+    /// First rule for @p event declared on @p state or its ancestors,
+    /// starting the search on @p state at rule @p from.
+    static constexpr std::size_t find_rule(std::size_t state, std::size_t event,
+                                           std::size_t from) noexcept
+    {
+        for (std::size_t s = state; s != hsm_npos; s = parent_of[s], from = 0) {
+            for (std::size_t i = from; i < rule_count; ++i) {
+                if (handles(rules[i], s, event)) {
+                    return i;
+                }
+            }
+        }
+        return hsm_npos;
+    }
+
+    static constexpr index_t narrow(std::size_t i) noexcept
+    {
+        return i == hsm_npos ? none : static_cast<index_t>(i);
+    }
+
+    static constexpr std::array<index_t, state_count> make_parent_table() noexcept
+    {
+        std::array<index_t, state_count> table{};
+        for (std::size_t s = 0; s < state_count; ++s) {
+            table[s] = narrow(parent_of[s]);
+        }
+        return table;
+    }
+
+    static constexpr std::array<index_t, state_count * event_count> make_dispatch() noexcept
+    {
+        std::array<index_t, state_count * event_count> table{};
+        for (std::size_t s = 0; s < state_count; ++s) {
+            for (std::size_t e = 0; e < event_count; ++e) {
+                table[s * event_count + e] = narrow(find_rule(s, e, 0));
+            }
+        }
+        return table;
+    }
+
+    /// Candidate to try when the guard of rule i fails.
+    static constexpr std::array<index_t, rule_count> make_fallback() noexcept
+    {
+        std::array<index_t, rule_count> next{};
+        for (std::size_t i = 0; i < rule_count; ++i) {
+            const rule& r = rules[i];
+            next[i] = r.event == hsm_npos ? none : narrow(find_rule(r.state, r.event, i + 1));
+        }
+        return next;
+    }
+
+    static constexpr std::array<index_t, state_count> make_actions(hsm_rule_kind kind) noexcept
+    {
+        std::array<index_t, state_count> table{};
+        for (index_t& i : table) {
+            i = none;
+        }
+        for (std::size_t i = 0; i < rule_count; ++i) {
+            if (rules[i].kind == kind && valid_state(rules[i].state)) {
+                table[rules[i].state] = narrow(i);
+            }
+        }
+        return table;
+    }
+
+    // Entry paths: for each transition (and, in slot rule_count, for the
+    // initial configuration) the states entered, outermost first.
+
+    static constexpr std::size_t path_length(std::size_t top, std::size_t target) noexcept
+    {
+        std::size_t length = 0;
+        for (std::size_t s = target; s != top; s = parent_of[s]) {
+            ++length;
+        }
+        for (std::size_t s = states_initial(target); s != hsm_npos; s = states_initial(s)) {
+            ++length;
+        }
+        return length;
+    }
+
+    static constexpr std::size_t states_initial(std::size_t s) noexcept
+    {
+        for (const hsm_state_info& info : states) {
+            if (info.id == s) {
+                return info.initial;
+            }
+        }
+        return hsm_npos;
+    }
+
+    static constexpr std::size_t initial_state = hsm_index(Def::initial);
+
+    static constexpr std::size_t path_top(std::size_t i) noexcept
+    {
+        return i == rule_count ? hsm_npos : lcpa(rules[i].state, rules[i].target);
+    }
+    static constexpr std::size_t path_target(std::size_t i) noexcept
+    {
+        return i == rule_count ? initial_state : rules[i].target;
+    }
+    static constexpr bool has_path(std::size_t i) noexcept
+    {
+        return i == rule_count || rules[i].kind == hsm_rule_kind::transition;
+    }
+
+    static constexpr std::size_t make_path_total() noexcept
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i <= rule_count; ++i) {
+            if (has_path(i)) {
+                total += path_length(path_top(i), path_target(i));
+            }
+        }
+        return total;
+    }
+
+    static constexpr bool tables_valid =
+        check_states() && check_rules() && valid_state(initial_state);
+
+    static constexpr std::size_t path_total = tables_valid ? make_path_total() : 0;
+    static_assert(path_total <= 0xffff, "hsm transition paths exceed the 16-bit path offsets");
+
+    struct paths_t {
+        std::array<index_t, path_total + 1> entered;
+        std::array<std::uint16_t, rule_count + 2> offset; // path i: [offset[i], offset[i + 1])
+        std::array<index_t, rule_count> exit_top;         // lcpa, where exits stop
+    };
+
+    static constexpr paths_t make_paths() noexcept
+    {
+        paths_t p{};
+        if (!tables_valid) {
+            return p;
+        }
+        std::size_t out = 0;
+        for (std::size_t i = 0; i <= rule_count; ++i) {
+            p.offset[i] = static_cast<std::uint16_t>(out);
+            if (i < rule_count) {
+                p.exit_top[i] = has_path(i) ? narrow(path_top(i)) : none;
+            }
+            if (!has_path(i)) {
+                continue;
+            }
+            const std::size_t top = path_top(i);
+            const std::size_t target = path_target(i);
+            // Target and its ancestors below top, stored innermost last.
+            std::size_t up = 0;
+            for (std::size_t s = target; s != top; s = parent_of[s]) {
+                ++up;
+            }
+            std::size_t k = up;
+            for (std::size_t s = target; s != top; s = parent_of[s]) {
+                p.entered[out + --k] = static_cast<index_t>(s);
+            }
+            out += up;
+            for (std::size_t s = states_initial(target); s != hsm_npos; s = states_initial(s)) {
+                p.entered[out++] = static_cast<index_t>(s);
+            }
+        }
+        p.offset[rule_count + 1] = static_cast<std::uint16_t>(out);
+        return p;
+    }
+
+    static constexpr auto dispatch = make_dispatch();
+    static constexpr auto fallback = make_fallback();
+    static constexpr auto entry_rule = make_actions(hsm_rule_kind::entry);
+    static constexpr auto exit_rule = make_actions(hsm_rule_kind::exit);
+    static constexpr auto paths = make_paths();
+    static constexpr auto parents = make_parent_table();
+};
+
+} // namespace detail
+
+/// Monitor that records nothing; the default.
+struct hsm_no_monitor {
+    static constexpr bool enabled = false;
+
+    void record(std::size_t, cycles_t) noexcept {}
+};
+
+/// Cycle statistics of one rule.
+struct hsm_rule_timing {
+    std::uint32_t count = 0;
+    cycles_t last = 0;
+    cycles_t max = 0;
+};
+
+/// Monitor recording, for each rule of @p Def, how often it fired and how
+/// many cycles its exits, action and entries took (see cycle_counter.hpp).
+template <typename Def>
+class hsm_timing_monitor {
+public:
+    static constexpr bool enabled = true;
+
+    /// Statistics of the rule at position @p rule in Def::rules.
+    const hsm_rule_timing& operator[](std::size_t rule) const noexcept { return timing_[rule]; }
+
+    void reset() noexcept
+    {
+        for (hsm_rule_timing& t : timing_) {
+            t = hsm_rule_timing{};
+        }
+    }
+
+    void record(std::size_t rule, cycles_t cycles) noexcept
+    {
+        hsm_rule_timing& t = timing_[rule];
+        ++t.count;
+        t.last = cycles;
+        if (cycles > t.max) {
+            t.max = cycles;
+        }
+    }
+
+private:
+    hsm_rule_timing timing_[Def::rules::size == 0 ? 1 : Def::rules::size]{};
+};
+
+/// Hierarchical state machine running definition @p Def on a context
+/// object, with a run-to-completion queue of @p QueueCapacity events.
+///
+/// The machine is a single-context object; feed events from interrupts
+/// through an spsc_ring and dispatch them from the main loop.
+template <typename Def, std::size_t QueueCapacity = 8, typename Monitor = hsm_no_monitor>
+class hsm {
+    using tables = detail::hsm_tables<Def>;
+    using index_t = typename tables::index_t;
+
+    static_assert(tables::check_states(),
+                  "hsm states: ids must be unique and dense, parents acyclic, and initial "
+                  "children direct children");
+    static_assert(tables::check_rules(),
+                  "hsm rules: unknown state, missing action, or duplicate entry/exit action");
+    static_assert(tables::valid_state(tables::initial_state),
+                  "hsm initial state is not a declared state");
+
+public:
+    using context_type = typename Def::context;
+    using state_type = std::remove_cv_t<decltype(Def::initial)>;
+    using event_type = typename Def::event;
+
+    static constexpr std::size_t state_count = tables::state_count;
+    static constexpr std::size_t event_count = tables::event_count;
+
+    explicit hsm(context_type& context) noexcept : context_(context) {}
+    hsm(const hsm&) = delete;
+    hsm& operator=(const hsm&) = delete;
+
+    /// Enters the initial configuration, then handles any queued events.
+    void start() noexcept
+    {
+        EMBEC_ASSERT(!started_);
+        started_ = true;
+        busy_ = true;
+        enter_path(tables::rule_count);
+        busy_ = false;
+        process();
+    }
+
+    bool started() const noexcept { return started_; }
+
+    /// Innermost active state.
+    state_type state() const noexcept { return static_cast<state_type>(current_); }
+
+    /// True if @p s is the innermost active state or one of its ancestors.
+    bool is_in(state_type s) const noexcept
+    {
+        for (std::size_t p = current_; p != tables::none; p = tables::parents[p]) {
+            if (p == static_cast<std::size_t>(s)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Queues @p e without processing it. Returns false if the queue is
+    /// full.
+    bool post(event_type e) noexcept { return queue_.try_push_back(e); }
+
+    /// Queues @p e and, unless called from within an action (or before
+    /// start()), processes the queue to completion. Returns false if the
+    /// queue was full.
+    bool dispatch(event_type e) noexcept
+    {
+        if (!post(e)) {
+            return false;
+        }
+        process();
+        return true;
+    }
+
+    /// Processes queued events until the queue is empty. Returns the number
+    /// of events that triggered a rule.
+    std::size_t process() noexcept
+    {
+        if (busy_ || !started_) {
+            return 0;
+        }
+        busy_ = true;
+        std::size_t handled = 0;
+        while (!queue_.empty()) {
+            const event_type e = queue_.front();
+            queue_.pop_front();
+            handled += handle(e);
+        }
+        busy_ = false;
+        return handled;
+    }
+
+    std::size_t pending() const noexcept { return queue_.size(); }
+
+    Monitor& monitor() noexcept { return monitor_; }
+    const Monitor& monitor() const noexcept { return monitor_; }
+
+private:
+    bool handle(event_type e) noexcept
+    {
+        const auto event = static_cast<std::size_t>(e);
+        if (event >= tables::event_count) {
+            return false;
+        }
+        index_t i = tables::dispatch[current_ * tables::event_count + event];
+        while (i != tables::none) {
+            const auto& r = tables::rules[i];
+            if (!r.guard || r.guard(context_)) {
+                fire(i);
+                return true;
+            }
+            i = tables::fallback[i];
+        }
+        return false;
+    }
+
+    void fire(index_t i) noexcept
+    {
+        cycles_t start = 0;
+        if constexpr (Monitor::enabled) {
+            start = cycle_counter::now();
+        }
+        const auto& r = tables::rules[i];
+        if (r.kind == detail::hsm_rule_kind::internal) {
+            r.action(context_);
+        } else {
+            const index_t top = tables::paths.exit_top[i];
+            for (index_t s = current_; s != top; s = tables::parents[s]) {
+                run(tables::exit_rule[s]);
+            }
+            if (r.action) {
+                r.action(context_);
+            }
+            enter_path(i);
+        }
+        if constexpr (Monitor::enabled) {
+            monitor_.record(i, static_cast<cycles_t>(cycle_counter::now() - start));
+        }
+    }
+
+    void enter_path(std::size_t path) noexcept
+    {
+        const auto& p = tables::paths;
+        for (std::size_t k = p.offset[path]; k < p.offset[path + 1]; ++k) {
+            current_ = p.entered[k];
+            run(tables::entry_rule[current_]);
+        }
+    }
+
+    void run(index_t rule) noexcept
+    {
+        if (rule != tables::none) {
+            tables::rules[rule].action(context_);
+        }
+    }
+
+    context_type& context_;
+    index_t current_ = tables::none;
+    bool started_ = false;
+    bool busy_ = false;
+    static_deque<event_type, QueueCapacity> queue_;
+    Monitor monitor_;
+};
+
+} // namespace embec
+
+#endif // EMBEC_HSM_HPP
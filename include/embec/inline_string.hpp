@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file inline_string.hpp
+/// @brief Character string with fixed capacity and inline storage.
+///
+/// inline_string<N> holds up to N characters plus a terminating NUL, so
+/// c_str() is always valid. It converts implicitly to std::string_view,
+/// which provides the read-only algorithms (find, substr, compare, ...).
+/// As with static_vector, exceeding the capacity is a precondition
+/// violation checked with EMBEC_ASSERT and the try_ variants report it
+/// instead.
+
+#ifndef EMBEC_INLINE_STRING_HPP
+#define EMBEC_INLINE_STRING_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+template <std::size_t N>
+class inline_string {
+public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using traits_type = std::char_traits<char>;
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    static constexpr size_type npos = std::string_view::npos;
+
+    constexpr inline_string() noexcept = default;
+
+    constexpr inline_string(const char* str) : inline_string(std::string_view(str)) {}
+
+    constexpr inline_string(const char* str, size_type length)
+        : inline_string(std::string_view(str, length))
+    {
+    }
+
+    constexpr inline_string(std::string_view str)
+    {
+        EMBEC_ASSERT(str.size() <= N);
+        for (; size_ < str.size(); ++size_) {
+            data_[size_] = str[size_];
+        }
+    }
+
+    constexpr inline_string(size_type count, char ch)
+    {
+        EMBEC_ASSERT(count <= N);
+        for (; size_ < count; ++size_) {
+            data_[size_] = ch;
+        }
+    }
+
+    inline_string& operator=(std::string_view str)
+    {
+        assign(str);
+        return *this;
+    }
+
+    inline_string& assign(std::string_view str)
+    {
+        EMBEC_ASSERT(str.size() <= N);
+        if (!str.empty()) {
+            // memmove: str may view this string.
+            std::memmove(data_, str.data(), str.size());
+        }
+        set_size(str.size());
+        return *this;
+    }
+
+    // ----------------------------------------------------------------- access
+
+    constexpr const char* c_str() const noexcept { return data_; }
+    constexpr char* data() noexcept { return data_; }
+    constexpr const char* data() const noexcept { return data_; }
+
+    constexpr std::string_view view() const noexcept { return {data_, size_}; }
+    constexpr operator std::string_view() const noexcept { return view(); }
+
+    constexpr char& operator[](size_type index) noexcept
+    {
+        EMBEC_ASSERT(index < size_);
+        return data_[index];
+    }
+    constexpr const char& operator[](size_type index) const noexcept
+    {
+        EMBEC_ASSERT(index <= size_);
+        return data_[index];
+    }
+
+    constexpr char& front() noexcept { return (*this)[0]; }
+    constexpr char front() const noexcept { return (*this)[0]; }
+    constexpr char& back() noexcept { return (*this)[size_ - 1]; }
+    constexpr char back() const noexcept { return (*this)[size_ - 1]; }
+
+    constexpr iterator begin() noexcept { return data_; }
+    constexpr const_iterator begin() const noexcept { return data_; }
+    constexpr iterator end() noexcept { return data_ + size_; }
+    constexpr const_iterator end() const noexcept { return data_ + size_; }
+
+    // --------------------------------------------------------------- capacity
+
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr size_type length() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr bool full() const noexcept { return size_ == N; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    // -------------------------------------------------------------- modifiers
+
+    constexpr void clear() noexcept { set_size(0); }
+
+    constexpr void push_back(char ch) noexcept
+    {
+        EMBEC_ASSERT(size_ < N);
+        data_[size_] = ch;
+        set_size(size_ + 1);
+    }
+
+    constexpr bool try_push_back(char ch) noexcept
+    {
+        if (size_ == N) {
+            return false;
+        }
+        data_[size_] = ch;
+        set_size(size_ + 1);
+        return true;
+    }
+
+    constexpr void pop_back() noexcept
+    {
+        EMBEC_ASSERT(size_ > 0);
+        set_size(size_ - 1);
+    }
+
+    inline_string& append(std::string_view str) noexcept
+    {
+        EMBEC_ASSERT(str.size() <= N - size_);
+        if (!str.empty()) {
+            std::memmove(data_ + size_, str.data(), str.size());
+        }
+        set_size(size_ + str.size());
+        return *this;
+    }
+
+    inline_string& append(const char* str, size_type length) noexcept
+    {
+        return append(std::string_view(str, length));
+    }
+
+    inline_string& append(size_type count, char ch) noexcept
+    {
+        EMBEC_ASSERT(count <= N - size_);
+        std::memset(data_ + size_, ch, count);
+        set_size(size_ + count);
+        return *this;
+    }
+
+    /// Appends @p str if it fits completely. Returns false (and leaves the
+    /// string unchanged) otherwise.
+    bool try_append(std::string_view str) noexcept
+    {
+        if (str.size() > N - size_) {
+            return false;
+        }
+        append(str);
+        return true;
+    }
+
+    /// Appends as much of @p str as fits. Returns the number of characters
+    /// appended.
+    size_type append_truncated(std::string_view str) noexcept
+    {
+        const size_type count = str.size() < N - size_ ? str.size() : N - size_;
+        append(str.substr(0, count));
+        return count;
+    }
+
+    inline_string& operator+=(std::string_view str) noexcept { return append(str); }
+    inline_string& operator+=(const char* str) noexcept { return append(str); }
+    inline_string& operator+=(char ch) noexcept
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    inline_string& insert(size_type pos, std::string_view str) noexcept
+    {
+        EMBEC_ASSERT(pos <= size_ && str.size() <= N - size_);
+        const size_type count = str.size();
+        const char* src = str.data();
+        std::memmove(data_ + pos + count, data_ + pos, size_ - pos);
+        if (src >= data_ && src < data_ + size_) {
+            // str views this string: the part at or after pos has just moved
+            // up by count characters.
+            const auto offset = static_cast<size_type>(src - data_);
+            if (offset >= pos) {
+                std::memcpy(data_ + pos, data_ + offset + count, count);
+            } else {
+                const size_type before = count < pos - offset ? count : pos - offset;
+                std::memcpy(data_ + pos, data_ + offset, before);
+                std::memcpy(data_ + pos + before, data_ + pos + count, count - before);
+            }
+        } else if (count) {
+            std::memcpy(data_ + pos, src, count);
+        }
+        set_size(size_ + count);
+        return *this;
+    }
+
+    inline_string& erase(size_type pos = 0, size_type count = npos) noexcept
+    {
+        EMBEC_ASSERT(pos <= size_);
+        if (count > size_ - pos) {
+            count = size_ - pos;
+        }
+        std::memmove(data_ + pos, data_ + pos + count, size_ - pos - count);
+        set_size(size_ - count);
+        return *this;
+    }
+
+    constexpr void resize(size_type count, char ch = '\0') noexcept
+    {
+        EMBEC_ASSERT(count <= N);
+        for (size_type i = size_; i < count; ++i) {
+            data_[i] = ch;
+        }
+        set_size(count);
+    }
+
+    // --------------------------------------------------------------- queries
+
+    constexpr size_type find(std::string_view str, size_type pos = 0) const noexcept
+    {
+        return view().find(str, pos);
+    }
+    constexpr size_type find(char ch, size_type pos = 0) const noexcept
+    {
+        return view().find(ch, pos);
+    }
+    constexpr bool starts_with(std::string_view str) const noexcept
+    {
+        return view().substr(0, str.size()) == str;
+    }
+    constexpr bool ends_with(std::string_view str) const noexcept
+    {
+        return size_ >= str.size() && view().substr(size_ - str.size()) == str;
+    }
+    constexpr int compare(std::string_view str) const noexcept { return view().compare(str); }
+
+private:
+    constexpr void set_size(size_type size) noexcept
+    {
+        size_ = size;
+        data_[size] = '\0';
+    }
+
+    char data_[N + 1]{};
+    size_type size_ = 0;
+};
+
+template <std::size_t N>
+constexpr bool operator==(const inline_string<N>& a, std::string_view b) noexcept
+{
+    return a.view() == b;
+}
+template <std::size_t N>
+constexpr bool operator==(std::string_view a, const inline_string<N>& b) noexcept
+{
+    return a == b.view();
+}
+template <std::size_t N, std::size_t M>
+constexpr bool operator==(const inline_string<N>& a, const inline_string<M>& b) noexcept
+{
+    return a.view() == b.view();
+}
+template <std::size_t N>
+constexpr bool operator!=(const inline_string<N>& a, std::string_view b) noexcept
+{
+    return !(a == b);
+}
+template <std::size_t N>
+constexpr bool operator!=(std::string_view a, const inline_string<N>& b) noexcept
+{
+    return !(a == b);
+}
+template <std::size_t N, std::size_t M>
+constexpr bool operator!=(const inline_string<N>& a, const inline_string<M>& b) noexcept
+{
+    return !(a == b);
+}
+template <std::size_t N, std::size_t M>
+constexpr bool operator<(const inline_string<N>& a, const inline_string<M>& b) noexcept
+{
+    return a.view() < b.view();
+}
+
+} // namespace embec
+
+#endif // EMBEC_INLINE_STRING_HPP
@@ -0,0 +1,1169 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file intrusive.hpp
+/// @brief Intrusive doubly-linked list, red-black tree and pairing heap.
+///
+/// The containers link nodes that live inside the elements, so inserting
+/// never allocates and an element can be in several containers at once, one
+/// hook per container. The hook is a base class of the element, optionally
+/// tagged to tell several apart, or a data member named with member_hook:
+///
+/// @code
+/// struct by_deadline;
+///
+/// struct request : embec::list_hook<>, embec::rb_hook<by_deadline> {
+///     std::uint32_t deadline;
+///     embec::heap_hook<> in_heap;
+///     bool operator<(const request& other) const { return deadline < other.deadline; }
+/// };
+///
+/// embec::intrusive_list<request> pending;
+/// embec::rb_tree<request, std::less<>, embec::rb_hook<by_deadline>> by_time;
+/// embec::pairing_heap<request, std::less<>,
+///                     embec::member_hook<request, embec::heap_hook<>, &request::in_heap>> urgent;
+/// @endcode
+///
+/// Elements must stay in place while linked. Copying an element gives the
+/// copy unlinked hooks.
+///
+/// intrusive_list does not count its elements, so an element can unlink
+/// itself in constant time without knowing its list (list_hook::unlink()),
+/// and does so when destroyed. size() walks the list.
+///
+/// rb_tree is an ordered multiset; equal elements keep their insertion
+/// order, which makes it a stable priority queue as well as a search tree.
+/// The tree caches its first element. The balancing code works on untyped
+/// nodes and is shared by all trees.
+///
+/// pairing_heap keeps the least element on top and has constant-time push,
+/// top and decrease(), and logarithmic amortised pop() and erase() of any
+/// element. It suits queues whose entries are often cancelled or moved
+/// earlier; where almost every entry leaves through pop(), rb_tree is
+/// faster (pop() walks a list of children scattered in memory).
+
+#ifndef EMBEC_INTRUSIVE_HPP
+#define EMBEC_INTRUSIVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+/// Names a hook that is the data member @p Member of @p T, for the Hook
+/// parameter of the containers.
+template <typename T, typename Hook, Hook T::*Member>
+struct member_hook {
+    using hook_type = Hook;
+
+    static Hook& to_hook(T& value) noexcept { return value.*Member; }
+
+    static T& to_value(Hook& hook) noexcept
+    {
+        // Offset of the member, computed through the member pointer on a
+        // suitably aligned address as no object is at hand.
+        const T* probe = reinterpret_cast<const T*>(alignof(T) * 64);
+        const std::ptrdiff_t offset = reinterpret_cast<const char*>(&(probe->*Member)) -
+                                      reinterpret_cast<const char*>(probe);
+        return *reinterpret_cast<T*>(reinterpret_cast<char*>(&hook) - offset);
+    }
+};
+
+namespace detail {
+
+/// Hook access for a base-class hook.
+template <typename T, typename Hook, typename = void>
+struct hook_access {
+    static_assert(std::is_base_of<Hook, T>::value,
+                  "the element type must derive from the hook, or use member_hook");
+    using hook_type = Hook;
+
+    static Hook& to_hook(T& value) noexcept { return value; }
+    static T& to_value(Hook& hook) noexcept { return static_cast<T&>(hook); }
+};
+
+/// Hook access for a member_hook.
+template <typename T, typename Hook>
+struct hook_access<T, Hook, std::void_t<decltype(&Hook::to_value)>> : Hook {};
+
+struct list_node {
+    list_node* next;
+    list_node* prev;
+};
+
+struct rb_node {
+    rb_node* parent;
+    rb_node* left;
+    rb_node* right;
+    std::uint8_t color;
+};
+
+enum : std::uint8_t { rb_unlinked, rb_red, rb_black };
+
+inline bool rb_is_black(const rb_node* n) noexcept
+{
+    return n == nullptr || n->color == rb_black;
+}
+
+inline rb_node* rb_first(rb_node* n) noexcept
+{
+    while (n->left != nullptr) {
+        n = n->left;
+    }
+    return n;
+}
+
+inline rb_node* rb_last(rb_node* n) noexcept
+{
+    while (n->right != nullptr) {
+        n = n->right;
+    }
+    return n;
+}
+
+inline rb_node* rb_next(rb_node* n) noexcept
+{
+    if (n->right != nullptr) {
+        return rb_first(n->right);
+    }
+    while (n->parent != nullptr && n == n->parent->right) {
+        n = n->parent;
+    }
+    return n->parent;
+}
+
+inline rb_node* rb_prev(rb_node* n) noexcept
+{
+    if (n->left != nullptr) {
+        return rb_last(n->left);
+    }
+    while (n->parent != nullptr && n == n->parent->left) {
+        n = n->parent;
+    }
+    return n->parent;
+}
+
+/// Puts @p with in the place of @p n under n's parent.
+inline void rb_replace_child(rb_node*& root, rb_node* n, rb_node* with) noexcept
+{
+    if (n->parent == nullptr) {
+        root = with;
+    } else if (n == n->parent->left) {
+        n->parent->left = with;
+    } else {
+        n->parent->right = with;
+    }
+    if (with != nullptr) {
+        with->parent = n->parent;
+    }
+}
+
+inline void rb_rotate_left(rb_node*& root, rb_node* x) noexcept
+{
+    rb_node* y = x->right;
+    x->right = y->left;
+    if (y->left != nullptr) {
+        y->left->parent = x;
+    }
+    rb_replace_child(root, x, y);
+    y->left = x;
+    x->parent = y;
+}
+
+inline void rb_rotate_right(rb_node*& root, rb_node* x) noexcept
+{
+    rb_node* y = x->left;
+    x->left = y->right;
+    if (y->right != nullptr) {
+        y->right->parent = x;
+    }
+    rb_replace_child(root, x, y);
+    y->right = x;
+    x->parent = y;
+}
+
+/// Links @p z as the @p left or right child of @p parent (null for an
+/// empty tree) and rebalances.
+inline void rb_insert(rb_node*& root, rb_node* parent, bool left, rb_node* z) noexcept
+{
+    z->parent = parent;
+    z->left = nullptr;
+    z->right = nullptr;
+    z->color = rb_red;
+    if (parent == nullptr) {
+        root = z;
+    } else if (left) {
+        parent->left = z;
+    } else {
+        parent->right = z;
+    }
+    while (z->parent != nullptr && z->parent->color == rb_red) {
+        rb_node* p = z->parent;
+        rb_node* g = p->parent; // exists: the root is black
+        if (p == g->left) {
+            rb_node* uncle = g->right;
+            if (!rb_is_black(uncle)) {
+                p->color = rb_black;
+                uncle->color = rb_black;
+                g->color = rb_red;
+                z = g;
+                continue;
+            }
+            if (z == p->right) {
+                rb_rotate_left(root, p);
+                p = z;
+            }
+            p->color = rb_black;
+            g->color = rb_red;
+            rb_rotate_right(root, g);
+            break;
+        } else {
+            rb_node* uncle = g->left;
+            if (!rb_is_black(uncle)) {
+                p->color = rb_black;
+                uncle->color = rb_black;
+                g->color = rb_red;
+                z = g;
+                continue;
+            }
+            if (z == p->left) {
+                rb_rotate_right(root, p);
+                p = z;
+            }
+            p->color = rb_black;
+            g->color = rb_red;
+            rb_rotate_left(root, g);
+            break;
+        }
+    }
+    root->color = rb_black;
+}
+
+/// Unlinks @p z and rebalances.
+inline void rb_erase(rb_node*& root, rb_node* z) noexcept
+{
+    rb_node* x;        // node moving into the removed position, may be null
+    rb_node* parent;   // its parent
+    std::uint8_t removed;
+    if (z->left == nullptr || z->right == nullptr) {
+        x = z->left != nullptr ? z->left : z->right;
+        parent = z->parent;
+        removed = z->color;
+        rb_replace_child(root, z, x);
+    } else {
+        // Replace z by its successor y, which has no left child.
+        rb_node* y = rb_first(z->right);
+        removed = y->color;
+        x = y->right;
+        if (y->parent == z) {
+            parent = y;
+        } else {
+            parent = y->parent;
+            rb_replace_child(root, y, x);
+            y->right = z->right;
+            y->right->parent = y;
+        }
+        rb_replace_child(root, z, y);
+        y->left = z->left;
+        y->left->parent = y;
+        y->color = z->color;
+    }
+    z->parent = z->left = z->right = nullptr;
+    z->color = rb_unlinked;
+    if (removed != rb_black) {
+        return;
+    }
+    // x carries an extra black; a null x is the child of parent whose
+    // sibling is not null.
+    while (x != root && rb_is_black(x)) {
+        if (x == parent->left) {
+            rb_node* w = parent->right;
+            if (w->color == rb_red) {
+                w->color = rb_black;
+                parent->color = rb_red;
+                rb_rotate_left(root, parent);
+                w = parent->right;
+            }
+            if (rb_is_black(w->left) && rb_is_black(w->right)) {
+                w->color = rb_red;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+            if (rb_is_black(w->right)) {
+                w->left->color = rb_black;
+                w->color = rb_red;
+                rb_rotate_right(root, w);
+                w = parent->right;
+            }
+            w->color = parent->color;
+            parent->color = rb_black;
+            w->right->color = rb_black;
+            rb_rotate_left(root, parent);
+        } else {
+            rb_node* w = parent->left;
+            if (w->color == rb_red) {
+                w->color = rb_black;
+                parent->color = rb_red;
+                rb_rotate_right(root, parent);
+                w = parent->left;
+            }
+            if (rb_is_black(w->left) && rb_is_black(w->right)) {
+                w->color = rb_red;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+            if (rb_is_black(w->left)) {
+                w->right->color = rb_black;
+                w->color = rb_red;
+                rb_rotate_left(root, w);
+                w = parent->left;
+            }
+            w->color = parent->color;
+            parent->color = rb_black;
+            w->left->color = rb_black;
+            rb_rotate_right(root, parent);
+        }
+        x = root;
+    }
+    if (x != nullptr) {
+        x->color = rb_black;
+    }
+}
+
+struct heap_node {
+    heap_node* child; ///< First child.
+    heap_node* next;  ///< Next sibling.
+    heap_node* prev;  ///< Previous sibling, parent for a first child, self for the root.
+};
+
+/// Makes the greater of two roots the first child of the other.
+template <typename Less>
+heap_node* heap_meld(heap_node* a, heap_node* b, Less less) noexcept
+{
+    if (less(b, a)) {
+        std::swap(a, b);
+    }
+    b->prev = a;
+    b->next = a->child;
+    if (a->child != nullptr) {
+        a->child->prev = b;
+    }
+    a->child = b;
+    return a;
+}
+
+/// Two-pass pairing of the sibling list starting at @p first; returns the
+/// new subtree root (its next and prev are not set).
+template <typename Less>
+heap_node* heap_merge_pairs(heap_node* first, Less less) noexcept
+{
+    if (first == nullptr) {
+        return nullptr;
+    }
+    // Left to right, meld pairs and stack the results through next.
+    heap_node* pairs = nullptr;
+    while (first != nullptr) {
+        heap_node* a = first;
+        heap_node* b = a->next;
+        if (b == nullptr) {
+            a->next = pairs;
+            pairs = a;
+            break;
+        }
+        first = b->next;
+        heap_node* m = heap_meld(a, b, less);
+        m->next = pairs;
+        pairs = m;
+    }
+    // Right to left, meld the pairs into one tree.
+    heap_node* result = pairs;
+    pairs = pairs->next;
+    while (pairs != nullptr) {
+        heap_node* rest = pairs->next;
+        result = heap_meld(pairs, result, less);
+        pairs = rest;
+    }
+    return result;
+}
+
+} // namespace detail
+
+// -----------------------------------------------------------------------------
+// intrusive_list
+// -----------------------------------------------------------------------------
+
+template <typename T, typename Hook>
+class intrusive_list;
+
+/// Hook for intrusive_list. @p Tag distinguishes several list hooks in one
+/// element.
+template <typename Tag = void>
+class list_hook : private detail::list_node {
+public:
+    constexpr list_hook() noexcept : detail::list_node{nullptr, nullptr} {}
+    list_hook(const list_hook&) noexcept : list_hook() {}
+    list_hook& operator=(const list_hook&) noexcept { return *this; }
+    ~list_hook() { unlink(); }
+
+    bool linked() const noexcept { return next != nullptr; }
+
+    /// Removes the element from its list, if any.
+    void unlink() noexcept
+    {
+        if (next != nullptr) {
+            next->prev = prev;
+            prev->next = next;
+            next = nullptr;
+            prev = nullptr;
+        }
+    }
+
+private:
+    template <typename, typename>
+    friend class intrusive_list;
+};
+
+/// Doubly-linked list of @p T elements through @p Hook, a list_hook base
+/// class of T or a member_hook.
+template <typename T, typename Hook = list_hook<>>
+class intrusive_list {
+    using access = detail::hook_access<T, Hook>;
+    using hook_type = typename access::hook_type;
+    using node = detail::list_node;
+
+    static node* to_node(T& value) noexcept { return &access::to_hook(value); }
+    static T& to_value(node* n) noexcept
+    {
+        return access::to_value(static_cast<hook_type&>(*n));
+    }
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        basic_iterator() noexcept = default;
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) noexcept : node_(other.node_)
+        {
+        }
+
+        reference operator*() const noexcept { return to_value(node_); }
+        pointer operator->() const noexcept { return &to_value(node_); }
+
+        basic_iterator& operator++() noexcept
+        {
+            node_ = node_->next;
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept
+        {
+            basic_iterator old = *this;
+            node_ = node_->next;
+            return old;
+        }
+        basic_iterator& operator--() noexcept
+        {
+            node_ = node_->prev;
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept
+        {
+            basic_iterator old = *this;
+            node_ = node_->prev;
+            return old;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept
+        {
+            return a.node_ == b.node_;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept
+        {
+            return a.node_ != b.node_;
+        }
+
+    private:
+        friend class intrusive_list;
+        template <bool>
+        friend class basic_iterator;
+        explicit basic_iterator(node* n) noexcept : node_(n) {}
+        node* node_ = nullptr;
+    };
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    constexpr intrusive_list() noexcept : head_{&head_, &head_} {}
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+    ~intrusive_list() { clear(); }
+
+    bool empty() const noexcept { return head_.next == &head_; }
+
+    /// Number of elements; walks the list.
+    size_type size() const noexcept
+    {
+        size_type n = 0;
+        for (const node* p = head_.next; p != &head_; p = p->next) {
+            ++n;
+        }
+        return n;
+    }
+
+    T& front() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(head_.next);
+    }
+    const T& front() const noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(head_.next);
+    }
+    T& back() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(head_.prev);
+    }
+    const T& back() const noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(head_.prev);
+    }
+
+    iterator begin() noexcept { return iterator(head_.next); }
+    const_iterator begin() const noexcept { return const_iterator(head_.next); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(&head_); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<node*>(&head_)); }
+    const_iterator cend() const noexcept { return end(); }
+
+    void push_front(T& value) noexcept { link_before(head_.next, to_node(value)); }
+    void push_back(T& value) noexcept { link_before(&head_, to_node(value)); }
+
+    void pop_front() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        unlink(head_.next);
+    }
+    void pop_back() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        unlink(head_.prev);
+    }
+
+    /// Inserts @p value before @p pos.
+    iterator insert(const_iterator pos, T& value) noexcept
+    {
+        node* n = to_node(value);
+        link_before(pos.node_, n);
+        return iterator(n);
+    }
+
+    /// Unlinks the element at @p pos; returns the iterator following it.
+    iterator erase(const_iterator pos) noexcept
+    {
+        EMBEC_ASSERT(pos.node_ != &head_);
+        node* next = pos.node_->next;
+        unlink(pos.node_);
+        return iterator(next);
+    }
+
+    /// Unlinks @p value, which must be in this list.
+    void erase(T& value) noexcept { unlink(to_node(value)); }
+
+    /// Unlinks all elements.
+    void clear() noexcept
+    {
+        node* p = head_.next;
+        while (p != &head_) {
+            node* next = p->next;
+            p->next = nullptr;
+            p->prev = nullptr;
+            p = next;
+        }
+        head_.next = &head_;
+        head_.prev = &head_;
+    }
+
+    /// Moves all elements of @p other before @p pos.
+    void splice(const_iterator pos, intrusive_list& other) noexcept
+    {
+        if (other.empty() || &other == this) {
+            return;
+        }
+        node* first = other.head_.next;
+        node* last = other.head_.prev;
+        other.head_.next = &other.head_;
+        other.head_.prev = &other.head_;
+        node* at = pos.node_;
+        first->prev = at->prev;
+        at->prev->next = first;
+        last->next = at;
+        at->prev = last;
+    }
+
+    iterator iterator_to(T& value) noexcept { return iterator(to_node(value)); }
+    const_iterator iterator_to(const T& value) const noexcept
+    {
+        return const_iterator(to_node(const_cast<T&>(value)));
+    }
+
+private:
+    static void link_before(node* at, node* n) noexcept
+    {
+        EMBEC_ASSERT(n->next == nullptr);
+        n->next = at;
+        n->prev = at->prev;
+        at->prev->next = n;
+        at->prev = n;
+    }
+
+    static void unlink(node* n) noexcept
+    {
+        n->next->prev = n->prev;
+        n->prev->next = n->next;
+        n->next = nullptr;
+        n->prev = nullptr;
+    }
+
+    node head_;
+};
+
+// -----------------------------------------------------------------------------
+// rb_tree
+// -----------------------------------------------------------------------------
+
+template <typename T, typename Compare, typename Hook>
+class rb_tree;
+
+/// Hook for rb_tree. @p Tag distinguishes several tree hooks in one element.
+template <typename Tag = void>
+class rb_hook : private detail::rb_node {
+public:
+    constexpr rb_hook() noexcept : detail::rb_node{nullptr, nullptr, nullptr, detail::rb_unlinked}
+    {
+    }
+    rb_hook(const rb_hook&) noexcept : rb_hook() {}
+    rb_hook& operator=(const rb_hook&) noexcept { return *this; }
+
+    bool linked() const noexcept { return color != detail::rb_unlinked; }
+
+private:
+    template <typename, typename, typename>
+    friend class rb_tree;
+};
+
+/// Red-black tree of @p T elements ordered by @p Compare, through @p Hook,
+/// an rb_hook base class of T or a member_hook. Equal elements are allowed.
+///
+/// Lookups take any key type that @p Compare can compare with T in both
+/// orders, such as the key member for a transparent comparator.
+template <typename T, typename Compare = std::less<>, typename Hook = rb_hook<>>
+class rb_tree {
+    using access = detail::hook_access<T, Hook>;
+    using hook_type = typename access::hook_type;
+    using node = detail::rb_node;
+
+    static node* to_node(T& value) noexcept { return &access::to_hook(value); }
+    static T& to_value(node* n) noexcept { return access::to_value(static_cast<hook_type&>(*n)); }
+
+    template <bool Const>
+    class basic_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+
+        basic_iterator() noexcept = default;
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) noexcept
+            : node_(other.node_), tree_(other.tree_)
+        {
+        }
+
+        reference operator*() const noexcept { return to_value(node_); }
+        pointer operator->() const noexcept { return &to_value(node_); }
+
+        basic_iterator& operator++() noexcept
+        {
+            node_ = detail::rb_next(node_);
+            return *this;
+        }
+        basic_iterator operator++(int) noexcept
+        {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        basic_iterator& operator--() noexcept
+        {
+            node_ = node_ != nullptr ? detail::rb_prev(node_) : detail::rb_last(tree_->root_);
+            return *this;
+        }
+        basic_iterator operator--(int) noexcept
+        {
+            basic_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept
+        {
+            return a.node_ == b.node_;
+        }
+        friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept
+        {
+            return a.node_ != b.node_;
+        }
+
+    private:
+        friend class rb_tree;
+        template <bool>
+        friend class basic_iterator;
+        basic_iterator(node* n, const rb_tree* tree) noexcept : node_(n), tree_(tree) {}
+        node* node_ = nullptr;
+        const rb_tree* tree_ = nullptr;
+    };
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    constexpr rb_tree() noexcept(std::is_nothrow_default_constructible<Compare>::value) = default;
+    constexpr explicit rb_tree(const Compare& compare) : compare_(compare) {}
+    rb_tree(const rb_tree&) = delete;
+    rb_tree& operator=(const rb_tree&) = delete;
+    ~rb_tree() { clear(); }
+
+    bool empty() const noexcept { return root_ == nullptr; }
+    size_type size() const noexcept { return size_; }
+
+    /// Least element.
+    T& front() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(first_);
+    }
+    const T& front() const noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(first_);
+    }
+    /// Greatest element.
+    T& back() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(detail::rb_last(root_));
+    }
+    const T& back() const noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(detail::rb_last(root_));
+    }
+
+    iterator begin() noexcept { return iterator(first_, this); }
+    const_iterator begin() const noexcept { return const_iterator(first_, this); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(nullptr, this); }
+    const_iterator end() const noexcept { return const_iterator(nullptr, this); }
+    const_iterator cend() const noexcept { return end(); }
+
+    /// Inserts @p value after any equal elements.
+    iterator insert(T& value) noexcept
+    {
+        node* n = to_node(value);
+        EMBEC_ASSERT(n->color == detail::rb_unlinked);
+        node* parent = nullptr;
+        bool left = false;
+        bool leftmost = true;
+        for (node* p = root_; p != nullptr;) {
+            parent = p;
+            left = compare_(value, to_value(p));
+            if (left) {
+                p = p->left;
+            } else {
+                p = p->right;
+                leftmost = false;
+            }
+        }
+        detail::rb_insert(root_, parent, left, n);
+        if (leftmost) {
+            first_ = n;
+        }
+        ++size_;
+        return iterator(n, this);
+    }
+
+    /// Inserts @p value unless an equal element is present, which is
+    /// returned instead.
+    std::pair<iterator, bool> insert_unique(T& value) noexcept
+    {
+        const iterator it = lower_bound(value);
+        if (it != end() && !compare_(value, *it)) {
+            return {it, false};
+        }
+        return {insert(value), true};
+    }
+
+    /// Unlinks the element at @p pos; returns the iterator following it.
+    iterator erase(const_iterator pos) noexcept
+    {
+        node* n = pos.node_;
+        node* next = detail::rb_next(n);
+        unlink(n);
+        return iterator(next, this);
+    }
+
+    /// Unlinks @p value, which must be in this tree.
+    void erase(T& value) noexcept { unlink(to_node(value)); }
+
+    /// Unlinks and returns the least element.
+    T& pop_front() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        node* n = first_;
+        unlink(n);
+        return to_value(n);
+    }
+
+    /// Unlinks all elements.
+    void clear() noexcept
+    {
+        // Walk down to a leaf, unlink it and continue from its parent.
+        node* n = root_;
+        while (n != nullptr) {
+            if (n->left != nullptr) {
+                n = n->left;
+            } else if (n->right != nullptr) {
+                n = n->right;
+            } else {
+                node* parent = n->parent;
+                if (parent != nullptr) {
+                    (parent->left == n ? parent->left : parent->right) = nullptr;
+                }
+                n->parent = nullptr;
+                n->color = detail::rb_unlinked;
+                n = parent;
+            }
+        }
+        root_ = nullptr;
+        first_ = nullptr;
+        size_ = 0;
+    }
+
+    /// First element not less than @p key.
+    template <typename K>
+    iterator lower_bound(const K& key) noexcept
+    {
+        return iterator(lower(key), this);
+    }
+    template <typename K>
+    const_iterator lower_bound(const K& key) const noexcept
+    {
+        return const_iterator(lower(key), this);
+    }
+
+    /// First element greater than @p key.
+    template <typename K>
+    iterator upper_bound(const K& key) noexcept
+    {
+        return iterator(upper(key), this);
+    }
+    template <typename K>
+    const_iterator upper_bound(const K& key) const noexcept
+    {
+        return const_iterator(upper(key), this);
+    }
+
+    /// First element equal to @p key, or end().
+    template <typename K>
+    iterator find(const K& key) noexcept
+    {
+        node* n = lower(key);
+        return iterator(n != nullptr && !compare_(key, to_value(n)) ? n : nullptr, this);
+    }
+    template <typename K>
+    const_iterator find(const K& key) const noexcept
+    {
+        node* n = lower(key);
+        return const_iterator(n != nullptr && !compare_(key, to_value(n)) ? n : nullptr, this);
+    }
+
+    template <typename K>
+    bool contains(const K& key) const noexcept
+    {
+        return find(key) != end();
+    }
+
+    iterator iterator_to(T& value) noexcept { return iterator(to_node(value), this); }
+    const_iterator iterator_to(const T& value) const noexcept
+    {
+        return const_iterator(to_node(const_cast<T&>(value)), this);
+    }
+
+    value_compare value_comp() const { return compare_; }
+
+private:
+    void unlink(node* n) noexcept
+    {
+        EMBEC_ASSERT(n->color != detail::rb_unlinked);
+        if (n == first_) {
+            first_ = detail::rb_next(n);
+        }
+        detail::rb_erase(root_, n);
+        --size_;
+    }
+
+    template <typename K>
+    node* lower(const K& key) const noexcept
+    {
+        node* result = nullptr;
+        for (node* p = root_; p != nullptr;) {
+            if (compare_(to_value(p), key)) {
+                p = p->right;
+            } else {
+                result = p;
+                p = p->left;
+            }
+        }
+        return result;
+    }
+
+    template <typename K>
+    node* upper(const K& key) const noexcept
+    {
+        node* result = nullptr;
+        for (node* p = root_; p != nullptr;) {
+            if (compare_(key, to_value(p))) {
+                result = p;
+                p = p->left;
+            } else {
+                p = p->right;
+            }
+        }
+        return result;
+    }
+
+    node* root_ = nullptr;
+    node* first_ = nullptr;
+    size_type size_ = 0;
+    Compare compare_{};
+};
+
+// -----------------------------------------------------------------------------
+// pairing_heap
+// -----------------------------------------------------------------------------
+
+template <typename T, typename Compare, typename Hook>
+class pairing_heap;
+
+/// Hook for pairing_heap. @p Tag distinguishes several heap hooks in one
+/// element.
+template <typename Tag = void>
+class heap_hook : private detail::heap_node {
+public:
+    constexpr heap_hook() noexcept : detail::heap_node{nullptr, nullptr, nullptr} {}
+    heap_hook(const heap_hook&) noexcept : heap_hook() {}
+    heap_hook& operator=(const heap_hook&) noexcept { return *this; }
+
+    bool linked() const noexcept { return prev != nullptr; }
+
+private:
+    template <typename, typename, typename>
+    friend class pairing_heap;
+};
+
+/// Pairing heap of @p T elements with the least by @p Compare on top,
+/// through @p Hook, a heap_hook base class of T or a member_hook. Use
+/// std::greater<> to have the greatest on top.
+template <typename T, typename Compare = std::less<>, typename Hook = heap_hook<>>
+class pairing_heap {
+    using access = detail::hook_access<T, Hook>;
+    using hook_type = typename access::hook_type;
+    using node = detail::heap_node;
+
+    static node* to_node(T& value) noexcept { return &access::to_hook(value); }
+    static T& to_value(node* n) noexcept { return access::to_value(static_cast<hook_type&>(*n)); }
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    constexpr pairing_heap() noexcept(std::is_nothrow_default_constructible<Compare>::value) =
+        default;
+    constexpr explicit pairing_heap(const Compare& compare) : compare_(compare) {}
+    pairing_heap(const pairing_heap&) = delete;
+    pairing_heap& operator=(const pairing_heap&) = delete;
+    ~pairing_heap() { clear(); }
+
+    bool empty() const noexcept { return root_ == nullptr; }
+    size_type size() const noexcept { return size_; }
+
+    /// Least element.
+    T& top() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(root_);
+    }
+    const T& top() const noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        return to_value(root_);
+    }
+
+    void push(T& value) noexcept
+    {
+        node* n = to_node(value);
+        EMBEC_ASSERT(n->prev == nullptr);
+        n->child = nullptr;
+        n->next = nullptr;
+        set_root(root_ != nullptr ? detail::heap_meld(root_, n, less()) : n);
+        ++size_;
+    }
+
+    /// Unlinks and returns the least element.
+    T& pop() noexcept
+    {
+        EMBEC_ASSERT(!empty());
+        node* n = root_;
+        root_ = nullptr;
+        if (node* rest = detail::heap_merge_pairs(n->child, less())) {
+            set_root(rest);
+        }
+        clear_node(n);
+        --size_;
+        return to_value(n);
+    }
+
+    /// Unlinks @p value, which must be in this heap.
+    void erase(T& value) noexcept
+    {
+        node* n = to_node(value);
+        if (n == root_) {
+            pop();
+            return;
+        }
+        cut(n);
+        if (node* rest = detail::heap_merge_pairs(n->child, less())) {
+            set_root(detail::heap_meld(root_, rest, less()));
+        }
+        clear_node(n);
+        --size_;
+    }
+
+    /// Restores the order after the key of @p value, which must be in this
+    /// heap, has decreased (moved towards the top).
+    void decrease(T& value) noexcept
+    {
+        node* n = to_node(value);
+        if (n != root_) {
+            cut(n);
+            set_root(detail::heap_meld(root_, n, less()));
+        }
+    }
+
+    /// Restores the order after the key of @p value, which must be in this
+    /// heap, has changed in either direction.
+    void update(T& value) noexcept
+    {
+        erase(value);
+        push(value);
+    }
+
+    /// Unlinks all elements.
+    void clear() noexcept
+    {
+        // Walk the tree as one list: each node's children are spliced in
+        // ahead of its remaining siblings.
+        node* n = root_;
+        if (n != nullptr) {
+            n->next = nullptr;
+        }
+        while (n != nullptr) {
+            node* rest = n->next;
+            if (n->child != nullptr) {
+                node* last = n->child;
+                while (last->next != nullptr) {
+                    last = last->next;
+                }
+                last->next = rest;
+                rest = n->child;
+            }
+            clear_node(n);
+            n = rest;
+        }
+        root_ = nullptr;
+        size_ = 0;
+    }
+
+    value_compare value_comp() const { return compare_; }
+
+private:
+    auto less() const noexcept
+    {
+        return [this](node* a, node* b) { return compare_(to_value(a), to_value(b)); };
+    }
+
+    void set_root(node* n) noexcept
+    {
+        n->next = nullptr;
+        n->prev = n;
+        root_ = n;
+    }
+
+    /// Detaches the subtree at @p n (not the root) from its parent.
+    static void cut(node* n) noexcept
+    {
+        if (n->prev->child == n) {
+            n->prev->child = n->next;
+        } else {
+            n->prev->next = n->next;
+        }
+        if (n->next != nullptr) {
+            n->next->prev = n->prev;
+        }
+        n->next = nullptr;
+    }
+
+    static void clear_node(node* n) noexcept
+    {
+        n->child = nullptr;
+        n->next = nullptr;
+        n->prev = nullptr;
+    }
+
+    node* root_ = nullptr;
+    size_type size_ = 0;
+    Compare compare_{};
+};
+
+} // namespace embec
+
+#endif // EMBEC_INTRUSIVE_HPP
@@ -0,0 +1,701 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file kv_store.hpp
+/// @brief Log-structured key-value store for NOR flash.
+///
+/// kv_store keeps small values (configuration, calibration, counters)
+/// under 16-bit keys in a log of records appended to flash. The sectors form
+/// a ring: records are always appended to the head sector, and the garbage
+/// collector copies the live records out of the oldest (tail) sector and
+/// erases it. Every sector therefore passes through the ring in turn and is
+/// erased equally often, whatever the write pattern. A hash index in RAM
+/// maps each key to the flash address of its latest record, so a read is a
+/// single flash read.
+///
+/// @code
+/// embec::kv_store<board_flash, 64> store(flash);
+/// if (store.mount() != embec::kv_status::ok) {
+///     store.format();
+/// }
+/// store.put(key_boot_count, &boots, sizeof(boots));
+/// std::uint8_t mac[6];
+/// auto result = store.get(key_mac, mac, sizeof(mac));
+/// @endcode
+///
+/// The @p Flash type provides the geometry and three operations, each
+/// returning false on failure:
+///
+/// @code
+/// static constexpr std::size_t sector_size;   // erase unit, in bytes
+/// static constexpr std::size_t sector_count;  // at least 3
+/// static constexpr std::size_t program_size;  // program unit, a power of two
+/// bool read(std::size_t address, void* data, std::size_t length);
+/// bool program(std::size_t address, const void* data, std::size_t length);
+/// bool erase(std::size_t sector);
+/// @endcode
+///
+/// program() is only called on erased (all 0xff) memory, with address and
+/// length multiples of program_size. flash_sim.hpp provides a simulator for
+/// host tests.
+///
+/// On flash, each sector starts with a header holding a magic number and a
+/// sequence number that increases with every sector opened, and each record
+/// is a header {key, length | tombstone flag, CRC-32} followed by the value,
+/// padded to program_size (at least four bytes). An erased record header
+/// ends the log of a sector. Erasing a key appends a tombstone record.
+///
+/// Power loss at any point loses at most the write in progress. mount()
+/// rebuilds the index by replaying the sectors in sequence order, stopping
+/// in each at the first record that does not check out, and repairs what an
+/// interrupted operation left behind. Before the collector erases a sector
+/// it appends a marker record naming it, so a sector whose erase was
+/// interrupted is recognised as retired even if it still looks valid, and
+/// the records in it (in particular older values of erased keys) are not
+/// replayed. The spare sector that the collector needs is never handed to
+/// ordinary writes, so collection can always complete.
+///
+/// Collection is incremental: once no more than two sectors are erased,
+/// every put() first scans up to four times its record size of the tail
+/// sector, copying live records and erasing the sector once it is done.
+/// This keeps up with the writes as long as the tail sectors are less than
+/// about three quarters live, and a put() then costs at most its own record,
+/// four times that in copies and one sector erase. When writes outpace the
+/// collector, put() collects whole tail sectors until it has room, which is
+/// one sector of copying and one erase in all but nearly full stores.
+/// collect_step() lets idle time do the work instead.
+///
+/// Every operation reports flash failures as kv_status::flash_error and
+/// leaves the store unmounted; mount() recovers.
+
+#ifndef EMBEC_KV_STORE_HPP
+#define EMBEC_KV_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "embec/config.hpp"
+#include "embec/crc.hpp"
+#include "embec/hash_map.hpp"
+
+namespace embec {
+
+/// Outcome of a key-value store operation.
+enum class kv_status {
+    ok,
+    not_found,   ///< No value for the key.
+    too_large,   ///< Value exceeds max_value_size, or the buffer is too small.
+    no_space,    ///< The index or the flash is full.
+    flash_error, ///< A flash operation failed; the store must be remounted.
+};
+
+/// Result of kv_store::get().
+struct kv_result {
+    std::size_t length; ///< Length of the stored value (0 if not found).
+    kv_status status;
+
+    constexpr explicit operator bool() const noexcept { return status == kv_status::ok; }
+};
+
+/// Key-value store on @p Flash holding up to @p MaxKeys keys.
+template <typename Flash, std::size_t MaxKeys>
+class kv_store {
+    static constexpr std::size_t align_up(std::size_t n, std::size_t a) noexcept
+    {
+        return (n + a - 1) / a * a;
+    }
+
+    static constexpr std::size_t program_size = Flash::program_size;
+    static constexpr std::size_t align = program_size < 4 ? 4 : program_size;
+    static_assert((program_size & (program_size - 1)) == 0, "program_size must be a power of two");
+    static_assert(Flash::sector_count >= 3, "the ring needs at least three sectors");
+
+    struct sector_header {
+        std::uint32_t magic;
+        std::uint32_t seq;
+        std::uint32_t crc; ///< CRC-32 of magic and seq.
+    };
+
+    struct record_header {
+        std::uint16_t key;
+        std::uint16_t info; ///< Value length | tombstone_flag.
+        std::uint32_t crc;  ///< CRC-32 of key, info and the value.
+    };
+    static_assert(sizeof(record_header) == 8, "record_header must not be padded");
+
+    static constexpr std::uint32_t magic = 0x31564b45u; // "EKV1"
+    static constexpr std::uint16_t tombstone_flag = 0x8000u;
+    static constexpr std::uint16_t marker_key = 0xfffeu;
+    static constexpr std::uint16_t erased_key = 0xffffu;
+
+    static constexpr std::size_t header_size = align_up(sizeof(sector_header), align);
+    static constexpr std::size_t marker_size = align_up(sizeof(record_header) + 4, align);
+    // Ordinary records stop short of the sector end so that the retirement
+    // marker always fits after the collector's copies.
+    static constexpr std::size_t record_limit = Flash::sector_size - marker_size;
+    static constexpr std::size_t max_record_size =
+        (record_limit - header_size) / 4 / align * align;
+    static constexpr std::size_t chunk_size = align > 32 ? align : 32;
+
+    static_assert(Flash::sector_size % align == 0, "sector_size must be a multiple of program_size");
+    static_assert(max_record_size > sizeof(record_header), "sectors are too small");
+
+    static constexpr std::size_t record_size(std::size_t length) noexcept
+    {
+        return align_up(sizeof(record_header) + length, align);
+    }
+
+    struct entry {
+        std::uint32_t address;
+        std::uint16_t length;
+    };
+
+public:
+    using key_type = std::uint16_t;
+
+    /// Largest usable key; 0xfffe and 0xffff are reserved.
+    static constexpr key_type max_key = 0xfffdu;
+
+    /// Longest value: a quarter of a sector, less the record header.
+    static constexpr std::size_t max_value_size =
+        max_record_size - sizeof(record_header) < 0x7fff ? max_record_size - sizeof(record_header)
+                                                         : 0x7fff;
+
+    /// Flash space that live records (values plus headers and padding) may
+    /// take. Two sectors are kept for the collector, and one maximal record
+    /// per sector is allowed for as waste at the sector end.
+    static constexpr std::size_t max_live_bytes =
+        (Flash::sector_count - 2) * (record_limit - header_size - max_record_size);
+
+    explicit kv_store(Flash& flash) noexcept : flash_(flash) {}
+    kv_store(const kv_store&) = delete;
+    kv_store& operator=(const kv_store&) = delete;
+
+    /// Scans the flash, rebuilds the index and repairs the effects of an
+    /// interrupted operation. Flash without a single valid sector header is
+    /// erased and initialised as an empty store. Returns no_space if the
+    /// flash holds more than MaxKeys keys.
+    kv_status mount() noexcept
+    {
+        mounted_ = false;
+        index_.clear();
+        live_bytes_ = 0;
+
+        bool valid[Flash::sector_count] = {};
+        bool any_valid = false;
+        std::size_t head = 0;
+        for (std::size_t s = 0; s < Flash::sector_count; ++s) {
+            sector_header header;
+            if (!flash_.read(s * Flash::sector_size, &header, sizeof(header))) {
+                return kv_status::flash_error;
+            }
+            valid[s] = header.magic == magic && header.crc == header_crc(header);
+            seq_[s] = header.seq;
+            if (valid[s] && (!any_valid || header.seq > seq_[head])) {
+                head = s;
+                any_valid = true;
+            }
+        }
+
+        if (!any_valid) {
+            for (std::size_t s = 0; s < Flash::sector_count; ++s) {
+                bool blank;
+                if (!is_blank(s * Flash::sector_size, Flash::sector_size, blank) ||
+                    (!blank && !flash_.erase(s))) {
+                    return kv_status::flash_error;
+                }
+            }
+            head_ = Flash::sector_count - 1;
+            tail_ = 0;
+            used_ = 0;
+            next_seq_ = 1;
+            gc_offset_ = header_size;
+            return open_sector() ? finish_mount() : kv_status::flash_error;
+        }
+
+        // The ring runs backwards from the newest sector through decreasing
+        // sequence numbers.
+        head_ = head;
+        tail_ = head;
+        used_ = 1;
+        next_seq_ = seq_[head] + 1;
+        while (used_ < Flash::sector_count) {
+            const std::size_t prev = previous(tail_);
+            if (!valid[prev] || seq_[prev] >= seq_[tail_]) {
+                break;
+            }
+            tail_ = prev;
+            ++used_;
+        }
+
+        bool retired = false;
+        std::uint32_t retired_seq = 0;
+        for (std::size_t i = 0, s = tail_; i < used_; ++i, s = next(s)) {
+            if (!scan_sector(s, retired, retired_seq)) {
+                return kv_status::flash_error;
+            }
+        }
+        // Finish an erase that the marker shows was started.
+        while (retired && used_ > 1 && seq_[tail_] <= retired_seq) {
+            if (!flash_.erase(tail_)) {
+                return kv_status::flash_error;
+            }
+            tail_ = next(tail_);
+            --used_;
+        }
+        // A collection was interrupted after taking the spare sector, which
+        // then holds nothing but copies of tail records: start it again.
+        if (used_ == Flash::sector_count) {
+            if (!flash_.erase(head_)) {
+                return kv_status::flash_error;
+            }
+            head_ = previous(head_);
+            --used_;
+        }
+        for (std::size_t i = used_, s = next(head_); i < Flash::sector_count; ++i, s = next(s)) {
+            bool blank;
+            if (!is_blank(s * Flash::sector_size, Flash::sector_size, blank) ||
+                (!blank && !flash_.erase(s))) {
+                return kv_status::flash_error;
+            }
+        }
+
+        for (std::size_t i = 0, s = tail_; i < used_; ++i, s = next(s)) {
+            for (std::size_t offset = header_size; offset < end_[s];) {
+                record_header header;
+                if (!read_header(s, offset, header)) {
+                    return kv_status::flash_error;
+                }
+                const std::size_t length = header.info & ~tombstone_flag;
+                if (header.key != marker_key) {
+                    if (header.info & tombstone_flag) {
+                        index_.erase(header.key);
+                    } else {
+                        const entry e{static_cast<std::uint32_t>(address_of(s, offset)),
+                                      static_cast<std::uint16_t>(length)};
+                        if (index_.insert_or_assign(header.key, e).first == index_.end()) {
+                            return kv_status::no_space;
+                        }
+                    }
+                }
+                offset += record_size(length);
+            }
+        }
+        for (const auto& kv : index_) {
+            live_bytes_ += record_size(kv.second.length);
+        }
+
+        // Whatever an interrupted write left after the last good record
+        // cannot be programmed over, so such a head takes no more records.
+        write_ = end_[head_];
+        bool blank;
+        if (!is_blank(address_of(head_, write_), Flash::sector_size - write_, blank)) {
+            return kv_status::flash_error;
+        }
+        if (!blank) {
+            write_ = Flash::sector_size;
+        }
+        gc_offset_ = header_size;
+        return finish_mount();
+    }
+
+    /// Erases the whole flash and mounts the empty store.
+    kv_status format() noexcept
+    {
+        mounted_ = false;
+        for (std::size_t s = 0; s < Flash::sector_count; ++s) {
+            if (!flash_.erase(s)) {
+                return kv_status::flash_error;
+            }
+        }
+        return mount();
+    }
+
+    bool mounted() const noexcept { return mounted_; }
+
+    /// Stores @p length bytes at @p data as the value of @p key.
+    kv_status put(key_type key, const void* data, std::size_t length) noexcept
+    {
+        EMBEC_ASSERT(key <= max_key);
+        if (!mounted_) {
+            return kv_status::flash_error;
+        }
+        if (length > max_value_size) {
+            return kv_status::too_large;
+        }
+        const auto it = index_.find(key);
+        if (it == index_.end() && index_.full()) {
+            return kv_status::no_space;
+        }
+        const std::size_t size = record_size(length);
+        const std::size_t old = it != index_.end() ? record_size(it->second.length) : 0;
+        if (live_bytes_ - old + size > max_live_bytes) {
+            return kv_status::no_space;
+        }
+        kv_status status = collect(4 * size);
+        if (status == kv_status::ok) {
+            status = make_room(size);
+        }
+        std::size_t address = 0;
+        if (status == kv_status::ok) {
+            status = append(key, static_cast<std::uint16_t>(length),
+                            static_cast<const std::uint8_t*>(data), length, address);
+        }
+        if (status != kv_status::ok) {
+            return status;
+        }
+        index_.insert_or_assign(key, entry{static_cast<std::uint32_t>(address),
+                                           static_cast<std::uint16_t>(length)});
+        live_bytes_ = live_bytes_ - old + size;
+        return kv_status::ok;
+    }
+
+    /// Copies the value of @p key to @p out. If it is longer than
+    /// @p capacity, nothing is copied and the result is too_large with the
+    /// length of the value, so get(key, nullptr, 0) queries the length.
+    kv_result get(key_type key, void* out, std::size_t capacity) const noexcept
+    {
+        if (!mounted_) {
+            return {0, kv_status::flash_error};
+        }
+        const auto it = index_.find(key);
+        if (it == index_.end()) {
+            return {0, kv_status::not_found};
+        }
+        const std::size_t length = it->second.length;
+        if (length > capacity) {
+            return {length, kv_status::too_large};
+        }
+        if (length != 0 && !flash_.read(it->second.address + sizeof(record_header), out, length)) {
+            return {0, kv_status::flash_error};
+        }
+        return {length, kv_status::ok};
+    }
+
+    /// Removes @p key. Returns not_found if it has no value.
+    kv_status erase(key_type key) noexcept
+    {
+        EMBEC_ASSERT(key <= max_key);
+        if (!mounted_) {
+            return kv_status::flash_error;
+        }
+        const auto it = index_.find(key);
+        if (it == index_.end()) {
+            return kv_status::not_found;
+        }
+        const std::size_t size = record_size(0);
+        kv_status status = collect(4 * size);
+        if (status == kv_status::ok) {
+            status = make_room(size);
+        }
+        std::size_t address = 0;
+        if (status == kv_status::ok) {
+            status = append(key, tombstone_flag, nullptr, 0, address);
+        }
+        if (status != kv_status::ok) {
+            return status;
+        }
+        live_bytes_ -= record_size(index_.find(key)->second.length);
+        index_.erase(key);
+        return kv_status::ok;
+    }
+
+    bool contains(key_type key) const noexcept { return index_.contains(key); }
+
+    /// Does a slice of garbage collection (up to a quarter sector of
+    /// records) if the store is running short of erased sectors, so that
+    /// later writes find them ready.
+    kv_status collect_step() noexcept
+    {
+        if (!mounted_) {
+            return kv_status::flash_error;
+        }
+        return collect(Flash::sector_size / 4);
+    }
+
+    /// Number of keys stored.
+    std::size_t size() const noexcept { return index_.size(); }
+    static constexpr std::size_t capacity() noexcept { return MaxKeys; }
+
+    /// Flash space taken by the live records.
+    std::size_t live_bytes() const noexcept { return live_bytes_; }
+
+    /// Sectors that are erased and ready for new records.
+    std::size_t free_sectors() const noexcept { return Flash::sector_count - used_; }
+
+private:
+    static constexpr std::size_t gc_threshold = 2;
+
+    static std::uint32_t header_crc(const sector_header& header) noexcept
+    {
+        return crc_engine<crc_catalog::crc32>::compute(&header, 2 * sizeof(std::uint32_t));
+    }
+
+    static constexpr std::size_t next(std::size_t sector) noexcept
+    {
+        return sector + 1 == Flash::sector_count ? 0 : sector + 1;
+    }
+
+    static constexpr std::size_t previous(std::size_t sector) noexcept
+    {
+        return sector == 0 ? Flash::sector_count - 1 : sector - 1;
+    }
+
+    static constexpr std::size_t address_of(std::size_t sector, std::size_t offset) noexcept
+    {
+        return sector * Flash::sector_size + offset;
+    }
+
+    kv_status finish_mount() noexcept
+    {
+        mounted_ = true;
+        return kv_status::ok;
+    }
+
+    kv_status fail() noexcept
+    {
+        mounted_ = false;
+        return kv_status::flash_error;
+    }
+
+    bool read_header(std::size_t sector, std::size_t offset, record_header& header) const noexcept
+    {
+        return flash_.read(address_of(sector, offset), &header, sizeof(header));
+    }
+
+    bool is_blank(std::size_t address, std::size_t length, bool& blank) const noexcept
+    {
+        std::uint8_t buffer[chunk_size];
+        blank = true;
+        for (std::size_t done = 0; done < length && blank;) {
+            const std::size_t n = length - done < chunk_size ? length - done : chunk_size;
+            if (!flash_.read(address + done, buffer, n)) {
+                return false;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                blank = blank && buffer[i] == 0xff;
+            }
+            done += n;
+        }
+        return true;
+    }
+
+    /// Sets end_[sector] past the last good record and records the newest
+    /// retirement marker. False on a flash error.
+    bool scan_sector(std::size_t sector, bool& retired, std::uint32_t& retired_seq) noexcept
+    {
+        std::size_t offset = header_size;
+        while (offset + sizeof(record_header) <= Flash::sector_size) {
+            record_header header;
+            if (!read_header(sector, offset, header)) {
+                return false;
+            }
+            if (header.key == erased_key) {
+                break;
+            }
+            const bool tombstone = (header.info & tombstone_flag) != 0;
+            const std::size_t length = header.info & ~tombstone_flag;
+            const std::size_t size = record_size(length);
+            if (size > Flash::sector_size - offset || (tombstone && length != 0) ||
+                (header.key == marker_key && (tombstone || length != 4))) {
+                break;
+            }
+            crc_engine<crc_catalog::crc32> crc;
+            crc.update(&header, 2 * sizeof(std::uint16_t));
+            std::uint8_t buffer[chunk_size];
+            for (std::size_t done = 0; done < length;) {
+                const std::size_t n = length - done < chunk_size ? length - done : chunk_size;
+                if (!flash_.read(address_of(sector, offset) + sizeof(header) + done, buffer, n)) {
+                    return false;
+                }
+                crc.update(buffer, n);
+                done += n;
+            }
+            if (crc.value() != header.crc) {
+                break;
+            }
+            if (header.key == marker_key) {
+                std::uint32_t seq;
+                std::memcpy(&seq, buffer, sizeof(seq));
+                if (!retired || seq > retired_seq) {
+                    retired_seq = seq;
+                }
+                retired = true;
+            }
+            offset += size;
+        }
+        end_[sector] = static_cast<std::uint32_t>(offset);
+        return true;
+    }
+
+    /// Starts a new head sector in the next erased one.
+    bool open_sector() noexcept
+    {
+        const std::size_t sector = next(head_);
+        sector_header header{magic, next_seq_, 0};
+        header.crc = header_crc(header);
+        std::uint8_t buffer[header_size];
+        std::memset(buffer, 0xff, sizeof(buffer));
+        std::memcpy(buffer, &header, sizeof(header));
+        if (!flash_.program(address_of(sector, 0), buffer, sizeof(buffer))) {
+            return false;
+        }
+        head_ = sector;
+        seq_[sector] = next_seq_++;
+        end_[sector] = header_size;
+        write_ = header_size;
+        ++used_;
+        return true;
+    }
+
+    /// Makes room in the head for an ordinary record of @p size bytes. The
+    /// last erased sector is left to the collector.
+    kv_status make_room(std::size_t size) noexcept
+    {
+        for (std::size_t attempt = 0; write_ + size > record_limit; ++attempt) {
+            if (free_sectors() >= 2) {
+                if (!open_sector()) {
+                    return fail();
+                }
+            } else if (attempt > Flash::sector_count) {
+                return kv_status::no_space;
+            } else {
+                const std::size_t tail = tail_;
+                const kv_status status = collect(static_cast<std::size_t>(-1));
+                if (status != kv_status::ok) {
+                    return status;
+                }
+                if (tail_ == tail) {
+                    return kv_status::no_space;
+                }
+            }
+        }
+        return kv_status::ok;
+    }
+
+    /// Collects the tail sector, scanning at least one record and at most
+    /// @p budget bytes unless the spare sector had to be taken, in which case
+    /// the sector is finished so that the spare is given back.
+    kv_status collect(std::size_t budget) noexcept
+    {
+        if (free_sectors() > gc_threshold || used_ < 2) {
+            return kv_status::ok;
+        }
+        for (std::size_t scanned = 0; gc_offset_ < end_[tail_];) {
+            if (scanned >= budget && free_sectors() > 0) {
+                return kv_status::ok;
+            }
+            record_header header;
+            if (!read_header(tail_, gc_offset_, header)) {
+                return fail();
+            }
+            const std::size_t length = header.info & ~tombstone_flag;
+            const std::size_t size = record_size(length);
+            const std::size_t from = address_of(tail_, gc_offset_);
+            const auto it = header.key == marker_key ? index_.end() : index_.find(header.key);
+            if (it != index_.end() && it->second.address == from) {
+                if (write_ + size > record_limit) {
+                    EMBEC_ASSERT(free_sectors() > 0);
+                    if (!open_sector()) {
+                        return fail();
+                    }
+                }
+                const std::size_t to = address_of(head_, write_);
+                if (!copy(from, to, size)) {
+                    write_ = Flash::sector_size;
+                    return fail();
+                }
+                it->second.address = static_cast<std::uint32_t>(to);
+                write_ += size;
+                end_[head_] = static_cast<std::uint32_t>(write_);
+            }
+            gc_offset_ += size;
+            scanned += size;
+        }
+
+        if (write_ + marker_size > Flash::sector_size) {
+            EMBEC_ASSERT(free_sectors() > 0);
+            if (!open_sector()) {
+                return fail();
+            }
+        }
+        std::uint32_t seq = seq_[tail_];
+        std::size_t address;
+        if (append(marker_key, sizeof(seq), reinterpret_cast<const std::uint8_t*>(&seq),
+                   sizeof(seq), address) != kv_status::ok ||
+            !flash_.erase(tail_)) {
+            return fail();
+        }
+        tail_ = next(tail_);
+        --used_;
+        gc_offset_ = header_size;
+        return kv_status::ok;
+    }
+
+    /// Appends a record to the head sector, which must have room for it.
+    kv_status append(key_type key, std::uint16_t info, const std::uint8_t* data,
+                     std::size_t length, std::size_t& address) noexcept
+    {
+        const std::size_t size = record_size(length);
+        EMBEC_ASSERT(write_ + size <= Flash::sector_size);
+        record_header header{key, info, 0};
+        crc_engine<crc_catalog::crc32> crc;
+        crc.update(&header, 2 * sizeof(std::uint16_t)).update(data, length);
+        header.crc = crc.value();
+
+        address = address_of(head_, write_);
+        std::uint8_t buffer[chunk_size];
+        for (std::size_t offset = 0; offset < size;) {
+            const std::size_t n = size - offset < chunk_size ? size - offset : chunk_size;
+            std::size_t fill = 0;
+            if (offset == 0) {
+                std::memcpy(buffer, &header, sizeof(header));
+                fill = sizeof(header);
+            }
+            const std::size_t at = offset + fill - sizeof(header);
+            if (at < length) {
+                const std::size_t k = length - at < n - fill ? length - at : n - fill;
+                std::memcpy(buffer + fill, data + at, k);
+                fill += k;
+            }
+            std::memset(buffer + fill, 0xff, n - fill);
+            if (!flash_.program(address + offset, buffer, n)) {
+                write_ = Flash::sector_size;
+                return fail();
+            }
+            offset += n;
+        }
+        write_ += size;
+        end_[head_] = static_cast<std::uint32_t>(write_);
+        return kv_status::ok;
+    }
+
+    bool copy(std::size_t from, std::size_t to, std::size_t size) noexcept
+    {
+        std::uint8_t buffer[chunk_size];
+        for (std::size_t offset = 0; offset < size;) {
+            const std::size_t n = size - offset < chunk_size ? size - offset : chunk_size;
+            if (!flash_.read(from + offset, buffer, n) || !flash_.program(to + offset, buffer, n)) {
+                return false;
+            }
+            offset += n;
+        }
+        return true;
+    }
+
+    Flash& flash_;
+    hash_map<key_type, entry, MaxKeys> index_;
+    std::uint32_t seq_[Flash::sector_count] = {};
+    std::uint32_t end_[Flash::sector_count] = {};
+    std::size_t head_ = 0;
+    std::size_t tail_ = 0;
+    std::size_t used_ = 0;
+    std::size_t write_ = 0;
+    std::size_t gc_offset_ = 0;
+    std::uint32_t next_seq_ = 1;
+    std::size_t live_bytes_ = 0;
+    bool mounted_ = false;
+};
+
+} // namespace embec
+
+#endif // EMBEC_KV_STORE_HPP
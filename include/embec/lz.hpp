@@ -0,0 +1,493 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file lz.hpp
+/// @brief Streaming LZ77 (LZSS) compressor and decompressor for small RAM
+///        windows.
+///
+/// The format is a bit stream in the style of heatshrink: each token is a
+/// 1 bit followed by a literal byte, or a 0 bit followed by a WindowBits
+/// wide distance and a LookaheadBits wide length. Matches start at the
+/// shortest length that is cheaper than literals, so small windows (from
+/// 16 bytes) still compress. Both sides must use the same WindowBits and
+/// LookaheadBits; the last byte is padded with zero bits.
+///
+/// Both directions have the heatshrink-style poll interface and never
+/// allocate:
+///
+/// @code
+/// embec::lz_encoder<8, 4> encoder;            // 256-byte window
+/// std::size_t at = 0;
+/// while (at < length) {
+///     at += encoder.sink(data + at, length - at);
+///     embec::lz_status status;
+///     do {
+///         const std::size_t n = encoder.poll(chunk, sizeof(chunk), status);
+///         send(chunk, n);
+///     } while (status == embec::lz_status::more_output);
+/// }
+/// encoder.finish();
+/// ... poll until lz_status::done ...
+/// @endcode
+///
+/// The encoder keeps two windows of input and finds matches through a hash
+/// table of the most recent position for each 2- or 3-byte prefix, followed
+/// along a chain of earlier positions up to ChainDepth candidates (1 leaves
+/// the chain table out). Its memory is 2 * window bytes of input, 2 * 2^
+/// HashBits bytes of hash table and, with a chain, 4 * window bytes of
+/// chain links; the decoder needs the window, its input staging buffer and
+/// a few words of state.
+
+#ifndef EMBEC_LZ_HPP
+#define EMBEC_LZ_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "embec/config.hpp"
+#include "embec/framing.hpp"
+
+namespace embec {
+
+/// Progress reported by the poll functions.
+enum class lz_status {
+    need_input,  ///< All input so far is processed: sink more or finish().
+    more_output, ///< The output buffer is full: poll again.
+    done,        ///< finish() was called and the stream is complete.
+    invalid,     ///< Decoder only: the input is not a valid stream.
+};
+
+/// Largest compressed size of @p length bytes (all literals, padded).
+constexpr std::size_t lz_max_compressed_size(std::size_t length) noexcept
+{
+    return (9 * length + 7) / 8;
+}
+
+namespace detail {
+
+template <unsigned WindowBits, unsigned LookaheadBits>
+struct lz_format {
+    static_assert(WindowBits >= 4 && WindowBits <= 14, "window must be 16 bytes to 16 KiB");
+    static_assert(LookaheadBits >= 3 && LookaheadBits < WindowBits,
+                  "lookahead must be 3 bits or more and smaller than the window");
+
+    static constexpr std::size_t window = std::size_t{1} << WindowBits;
+    static constexpr unsigned match_bits = 1 + WindowBits + LookaheadBits;
+    /// Shortest match that takes fewer bits than the same literals.
+    static constexpr std::size_t min_match = match_bits / 9 + 1;
+    static constexpr std::size_t max_match = min_match + (std::size_t{1} << LookaheadBits) - 1;
+};
+
+} // namespace detail
+
+/// Streaming LZ compressor with storage inside the object.
+///
+/// @tparam WindowBits    log2 of the window (distance range), 4 to 14.
+/// @tparam LookaheadBits Width of the length field; the longest match is
+///                       about 2^LookaheadBits bytes.
+/// @tparam HashBits      log2 of the hash table entries.
+/// @tparam ChainDepth    Candidates examined per position; more finds
+///                       longer matches at the cost of speed.
+template <unsigned WindowBits, unsigned LookaheadBits, unsigned HashBits = WindowBits,
+          unsigned ChainDepth = 8>
+class lz_encoder {
+    using format = detail::lz_format<WindowBits, LookaheadBits>;
+    static_assert(HashBits >= 4 && HashBits <= 16, "hash table must have 2^4 to 2^16 entries");
+    static_assert(ChainDepth >= 1, "at least one candidate must be examined");
+
+public:
+    constexpr lz_encoder() noexcept = default;
+    lz_encoder(const lz_encoder&) = delete;
+    lz_encoder& operator=(const lz_encoder&) = delete;
+
+    /// Starts a new stream.
+    void reset() noexcept
+    {
+        std::memset(head_, 0, sizeof(head_));
+        pos_ = 0;
+        end_ = 0;
+        bits_ = 0;
+        bit_count_ = 0;
+        finishing_ = false;
+    }
+
+    /// Takes up to @p length bytes of input. Returns the number taken,
+    /// which is 0 when the input buffer is full and poll() must run first.
+    std::size_t sink(const std::uint8_t* data, std::size_t length) noexcept
+    {
+        EMBEC_ASSERT(!finishing_);
+        if (end_ == buffer_size) {
+            slide();
+        }
+        const std::size_t room = buffer_size - end_;
+        const std::size_t n = length < room ? length : room;
+        std::memcpy(buffer_ + end_, data, n);
+        end_ += n;
+        return n;
+    }
+
+    /// Marks the end of the input; poll() then flushes everything.
+    void finish() noexcept { finishing_ = true; }
+
+    /// Writes up to @p capacity compressed bytes to @p out and returns the
+    /// number written.
+    std::size_t poll(std::uint8_t* out, std::size_t capacity, lz_status& status) noexcept
+    {
+        std::size_t produced = 0;
+        for (;;) {
+            while (bit_count_ >= 8) {
+                if (produced == capacity) {
+                    status = lz_status::more_output;
+                    return produced;
+                }
+                bit_count_ -= 8;
+                out[produced++] = static_cast<std::uint8_t>(bits_ >> bit_count_);
+            }
+            const std::size_t available = end_ - pos_;
+            if (available == 0 && finishing_) {
+                if (bit_count_ != 0) {
+                    if (produced == capacity) {
+                        status = lz_status::more_output;
+                        return produced;
+                    }
+                    out[produced++] = static_cast<std::uint8_t>(bits_ << (8 - bit_count_));
+                    bit_count_ = 0;
+                }
+                status = lz_status::done;
+                return produced;
+            }
+            // Without the full lookahead a longer match might be missed.
+            if (available == 0 || (available < format::max_match && !finishing_)) {
+                status = lz_status::need_input;
+                return produced;
+            }
+            encode(available < format::max_match ? available : format::max_match);
+        }
+    }
+
+private:
+    static constexpr std::size_t buffer_size = 2 * format::window;
+    static constexpr std::size_t hash_bytes = format::min_match <= 2 ? 2 : 3;
+    static constexpr bool chained = ChainDepth > 1;
+
+    /// Emits one token for the input at pos_, looking at most @p limit
+    /// bytes ahead.
+    void encode(std::size_t limit) noexcept
+    {
+        std::size_t best_length = 0;
+        std::size_t best_distance = 0;
+        if (limit >= hash_bytes) {
+            find_match(limit, best_length, best_distance);
+        }
+        if (best_length >= format::min_match) {
+            put(((best_distance - 1) << LookaheadBits) | (best_length - format::min_match),
+                format::match_bits);
+            for (std::size_t i = 0; i < best_length; ++i) {
+                insert(pos_ + i);
+            }
+            pos_ += best_length;
+        } else {
+            put(0x100u | buffer_[pos_], 9);
+            insert(pos_);
+            ++pos_;
+        }
+    }
+
+    void find_match(std::size_t limit, std::size_t& best_length,
+                    std::size_t& best_distance) const noexcept
+    {
+        const std::uint8_t* current = buffer_ + pos_;
+        std::size_t candidate = head_[hash(current)];
+        for (unsigned depth = 0; depth < ChainDepth && candidate != 0; ++depth) {
+            const std::size_t at = candidate - 1;
+            const std::size_t distance = pos_ - at;
+            if (distance > format::window) {
+                break; // chains only get older
+            }
+            const std::uint8_t* earlier = buffer_ + at;
+            // Only a candidate that agrees on the byte after the best match
+            // so far can beat it (best_length < limit here).
+            if (earlier[best_length] == current[best_length]) {
+                std::size_t length = 0;
+                while (length < limit && earlier[length] == current[length]) {
+                    ++length;
+                }
+                if (length > best_length) {
+                    best_length = length;
+                    best_distance = distance;
+                    if (length == limit) {
+                        break;
+                    }
+                }
+            }
+            if (!chained) {
+                break;
+            }
+            candidate = prev_[at];
+        }
+    }
+
+    static std::size_t hash(const std::uint8_t* p) noexcept
+    {
+        std::uint32_t v = p[0] | static_cast<std::uint32_t>(p[1]) << 8;
+        if (hash_bytes == 3) {
+            v |= static_cast<std::uint32_t>(p[2]) << 16;
+        }
+        return (v * 2654435761u) >> (32 - HashBits);
+    }
+
+    void insert(std::size_t at) noexcept
+    {
+        if (at + hash_bytes > end_) {
+            return;
+        }
+        const std::size_t h = hash(buffer_ + at);
+        if (chained) {
+            prev_[at] = head_[h];
+        }
+        head_[h] = static_cast<std::uint16_t>(at + 1);
+    }
+
+    /// Drops input older than one window before pos_.
+    void slide() noexcept
+    {
+        if (pos_ <= format::window) {
+            return;
+        }
+        const std::size_t shift = pos_ - format::window;
+        std::memmove(buffer_, buffer_ + shift, end_ - shift);
+        const auto rebase = [shift](std::uint16_t& link) {
+            link = link > shift ? static_cast<std::uint16_t>(link - shift) : 0;
+        };
+        for (auto& link : head_) {
+            rebase(link);
+        }
+        if (chained) {
+            std::memmove(prev_, prev_ + shift, (end_ - shift) * sizeof(prev_[0]));
+            for (std::size_t i = 0; i < end_ - shift; ++i) {
+                rebase(prev_[i]);
+            }
+        }
+        pos_ -= shift;
+        end_ -= shift;
+    }
+
+    void put(std::size_t value, unsigned count) noexcept
+    {
+        bits_ = (bits_ << count) | value;
+        bit_count_ += count;
+    }
+
+    std::uint8_t buffer_[buffer_size] = {};
+    std::uint16_t head_[std::size_t{1} << HashBits] = {}; ///< Position + 1, 0 if none.
+    std::uint16_t prev_[chained ? buffer_size : 1] = {};  ///< Earlier position with the same hash.
+    std::size_t pos_ = 0;                                  ///< Next byte to encode.
+    std::size_t end_ = 0;                                  ///< End of the input.
+    std::uint64_t bits_ = 0;
+    unsigned bit_count_ = 0;
+    bool finishing_ = false;
+};
+
+/// Streaming LZ decompressor with storage inside the object.
+///
+/// @tparam InputSize Bytes of compressed input staged between sink() and
+///                   poll().
+template <unsigned WindowBits, unsigned LookaheadBits, std::size_t InputSize = 32>
+class lz_decoder {
+    using format = detail::lz_format<WindowBits, LookaheadBits>;
+    static_assert(InputSize >= 1, "input staging buffer must not be empty");
+
+public:
+    constexpr lz_decoder() noexcept = default;
+    lz_decoder(const lz_decoder&) = delete;
+    lz_decoder& operator=(const lz_decoder&) = delete;
+
+    /// Starts a new stream.
+    void reset() noexcept
+    {
+        in_pos_ = 0;
+        in_end_ = 0;
+        bits_ = 0;
+        bit_count_ = 0;
+        head_ = 0;
+        history_ = 0;
+        copy_remaining_ = 0;
+        copy_distance_ = 0;
+        finishing_ = false;
+        invalid_ = false;
+    }
+
+    /// Takes up to @p length bytes of compressed input. Returns the number
+    /// taken, which is 0 when the staging buffer is full and poll() must
+    /// run first.
+    std::size_t sink(const std::uint8_t* data, std::size_t length) noexcept
+    {
+        EMBEC_ASSERT(!finishing_);
+        if (in_pos_ != 0) {
+            std::memmove(input_, input_ + in_pos_, in_end_ - in_pos_);
+            in_end_ -= in_pos_;
+            in_pos_ = 0;
+        }
+        const std::size_t room = InputSize - in_end_;
+        const std::size_t n = length < room ? length : room;
+        std::memcpy(input_ + in_end_, data, n);
+        in_end_ += n;
+        return n;
+    }
+
+    /// Marks the end of the compressed input.
+    void finish() noexcept { finishing_ = true; }
+
+    /// Writes up to @p capacity decompressed bytes to @p out and returns
+    /// the number written.
+    std::size_t poll(std::uint8_t* out, std::size_t capacity, lz_status& status) noexcept
+    {
+        std::size_t produced = 0;
+        if (invalid_) {
+            status = lz_status::invalid;
+            return 0;
+        }
+        for (;;) {
+            while (copy_remaining_ != 0) {
+                if (produced == capacity) {
+                    status = lz_status::more_output;
+                    return produced;
+                }
+                out[produced++] = emit(window_[(head_ - copy_distance_) & mask]);
+                --copy_remaining_;
+            }
+            refill();
+            if (bit_count_ == 0 || !has_token()) {
+                // At the end, up to 7 bits of padding may be left over.
+                if (!finishing_) {
+                    status = lz_status::need_input;
+                } else if (bit_count_ >= 8) {
+                    invalid_ = true;
+                    status = lz_status::invalid;
+                } else {
+                    status = lz_status::done;
+                }
+                return produced;
+            }
+            if (take(1) != 0) {
+                if (produced == capacity) {
+                    ++bit_count_; // leave the literal for the next poll
+                    status = lz_status::more_output;
+                    return produced;
+                }
+                out[produced++] = emit(static_cast<std::uint8_t>(take(8)));
+            } else {
+                const std::size_t distance = take(WindowBits) + 1;
+                const std::size_t length = take(LookaheadBits) + format::min_match;
+                if (distance > history_) {
+                    invalid_ = true;
+                    status = lz_status::invalid;
+                    return produced;
+                }
+                copy_distance_ = distance;
+                copy_remaining_ = length;
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t mask = format::window - 1;
+
+    std::uint8_t emit(std::uint8_t byte) noexcept
+    {
+        window_[head_ & mask] = byte;
+        ++head_;
+        history_ += history_ < format::window;
+        return byte;
+    }
+
+    void refill() noexcept
+    {
+        while (bit_count_ <= 56 && in_pos_ != in_end_) {
+            bits_ = (bits_ << 8) | input_[in_pos_++];
+            bit_count_ += 8;
+        }
+    }
+
+    /// True if a whole token is buffered.
+    bool has_token() const noexcept
+    {
+        const bool literal = ((bits_ >> (bit_count_ - 1)) & 1) != 0;
+        return bit_count_ >= (literal ? 9 : format::match_bits);
+    }
+
+    std::size_t take(unsigned count) noexcept
+    {
+        bit_count_ -= count;
+        return static_cast<std::size_t>(bits_ >> bit_count_) & ((std::size_t{1} << count) - 1);
+    }
+
+    std::uint8_t window_[format::window] = {};
+    std::uint8_t input_[InputSize] = {};
+    std::size_t in_pos_ = 0;
+    std::size_t in_end_ = 0;
+    std::uint64_t bits_ = 0;
+    unsigned bit_count_ = 0;
+    std::size_t head_ = 0;    ///< Bytes produced (window write position).
+    std::size_t history_ = 0; ///< Valid bytes in the window.
+    std::size_t copy_remaining_ = 0;
+    std::size_t copy_distance_ = 0;
+    bool finishing_ = false;
+    bool invalid_ = false;
+};
+
+/// Compresses @p length bytes at @p src into @p dst with @p encoder (which
+/// is reset first).
+template <typename Encoder>
+frame_result lz_compress(Encoder& encoder, const std::uint8_t* src, std::size_t length,
+                         std::uint8_t* dst, std::size_t capacity) noexcept
+{
+    encoder.reset();
+    std::size_t written = 0;
+    lz_status status = lz_status::need_input;
+    for (std::size_t at = 0;;) {
+        at += encoder.sink(src + at, length - at);
+        if (at == length) {
+            encoder.finish();
+        }
+        written += encoder.poll(dst + written, capacity - written, status);
+        if (status == lz_status::done) {
+            return {written, frame_status::ok};
+        }
+        if (status == lz_status::more_output) {
+            return {0, frame_status::overflow};
+        }
+    }
+}
+
+/// Decompresses the @p length byte stream at @p src into @p dst with
+/// @p decoder (which is reset first).
+template <typename Decoder>
+frame_result lz_decompress(Decoder& decoder, const std::uint8_t* src, std::size_t length,
+                           std::uint8_t* dst, std::size_t capacity) noexcept
+{
+    decoder.reset();
+    std::size_t written = 0;
+    lz_status status = lz_status::need_input;
+    for (std::size_t at = 0;;) {
+        const std::size_t n = decoder.sink(src + at, length - at);
+        at += n;
+        if (at == length) {
+            decoder.finish();
+        }
+        written += decoder.poll(dst + written, capacity - written, status);
+        switch (status) {
+        case lz_status::done:
+            return {written, frame_status::ok};
+        case lz_status::more_output:
+            return {0, frame_status::overflow};
+        case lz_status::invalid:
+            return {0, frame_status::invalid};
+        case lz_status::need_input:
+            break;
+        }
+    }
+}
+
+} // namespace embec
+
+#endif // EMBEC_LZ_HPP
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file mpmc_queue.hpp
+/// @brief Bounded lock-free multi-producer/multi-consumer queue.
+///
+/// Any number of producers and consumers (threads, cores, or interrupt
+/// handlers) may use the queue at the same time. It is D. Vyukov's bounded
+/// MPMC queue: every slot carries a sequence counter that says whether it
+/// is ready for the producer or the consumer of a given lap, so a push or
+/// pop takes one compare-and-swap on the shared index and touches no other
+/// shared state. Batched push and pop claim a run of slots with a single
+/// compare-and-swap.
+///
+/// The queue is lock-free but not wait-free per element: a producer that
+/// has claimed a slot and is then preempted (for example by an interrupt
+/// that pops) holds back the consumers of that slot, which see the queue as
+/// empty until the producer resumes. Likewise a preempted consumer makes
+/// its slot look full. Neither side ever spins, so this is safe from
+/// interrupt handlers, but an ISR must not wait for the queue to change.
+///
+/// For one producer and one consumer, spsc_ring is cheaper.
+
+#ifndef EMBEC_MPMC_QUEUE_HPP
+#define EMBEC_MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+/// Fixed-capacity MPMC queue with inline storage.
+///
+/// @tparam T Element type. Must be trivially copyable: elements are copied
+///           in and out of their slots.
+/// @tparam N Capacity in elements. Must be a power of two.
+///
+/// Each slot stores its sequence relative to its own index, so that the
+/// all-zero state is the empty queue and a queue with static storage
+/// duration needs no constructor to run. The enqueue and dequeue indices
+/// sit on cache lines of their own, apart from the slots.
+///
+/// size() and empty() return a snapshot that may be stale by the time it is
+/// used.
+template <typename T, std::size_t N>
+class mpmc_queue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "mpmc_queue capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mpmc_queue element type must be trivially copyable");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    constexpr mpmc_queue() noexcept = default;
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    static constexpr size_type capacity() noexcept { return N; }
+
+    size_type size() const noexcept
+    {
+        const size_type tail = dequeue_.load(std::memory_order_acquire);
+        const size_type head = enqueue_.load(std::memory_order_acquire);
+        // Consumers may have advanced between the two loads.
+        return head - tail < N ? head - tail : N;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /// Discards all content. No other context may use the queue during the
+    /// call.
+    void reset() noexcept
+    {
+        for (slot& s : slots_) {
+            s.sequence.store(0, std::memory_order_relaxed);
+        }
+        enqueue_.store(0, std::memory_order_relaxed);
+        dequeue_.store(0, std::memory_order_relaxed);
+    }
+
+    /// Appends one element. Returns false if the queue is full.
+    bool push(const T& value) noexcept
+    {
+        size_type pos = enqueue_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot& s = slots_[pos & mask];
+            const auto lag = distance(s.sequence.load(std::memory_order_acquire), lap(pos));
+            if (lag == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    s.value = value;
+                    s.sequence.store(lap(pos) + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false; // the slot still holds an element from the previous lap
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Removes the oldest element into @p out. Returns false if empty.
+    bool pop(T& out) noexcept
+    {
+        size_type pos = dequeue_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot& s = slots_[pos & mask];
+            const auto lag = distance(s.sequence.load(std::memory_order_acquire), lap(pos) + 1);
+            if (lag == 0) {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = s.value;
+                    s.sequence.store(lap(pos) + N, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false; // not yet written in this lap
+            } else {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Appends up to @p count elements from @p src as one contiguous run.
+    /// Returns the number appended, which is less than @p count only when
+    /// the queue runs out of free slots.
+    size_type push(const T* src, size_type count) noexcept
+    {
+        size_type pos = enqueue_.load(std::memory_order_relaxed);
+        size_type n;
+        for (;;) {
+            n = ready_run(pos, count, 0);
+            if (n == 0) {
+                // Full, unless another producer has moved on.
+                const size_type now = enqueue_.load(std::memory_order_relaxed);
+                if (now == pos) {
+                    return 0;
+                }
+                pos = now;
+            } else if (enqueue_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (size_type i = 0; i < n; ++i) {
+            slot& s = slots_[(pos + i) & mask];
+            s.value = src[i];
+            s.sequence.store(lap(pos + i) + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /// Removes up to @p count of the oldest elements into @p dst. Returns
+    /// the number removed.
+    size_type pop(T* dst, size_type count) noexcept
+    {
+        size_type pos = dequeue_.load(std::memory_order_relaxed);
+        size_type n;
+        for (;;) {
+            n = ready_run(pos, count, 1);
+            if (n == 0) {
+                const size_type now = dequeue_.load(std::memory_order_relaxed);
+                if (now == pos) {
+                    return 0;
+                }
+                pos = now;
+            } else if (dequeue_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (size_type i = 0; i < n; ++i) {
+            slot& s = slots_[(pos + i) & mask];
+            dst[i] = s.value;
+            s.sequence.store(lap(pos + i) + N, std::memory_order_release);
+        }
+        return n;
+    }
+
+private:
+    static constexpr size_type mask = N - 1;
+
+    struct slot {
+        /// Sequence minus the slot index: lap(pos) when free for the
+        /// producer of position pos, lap(pos) + 1 when holding its element.
+        std::atomic<size_type> sequence{0};
+        T value{};
+    };
+
+    /// First position of the lap containing @p pos.
+    static constexpr size_type lap(size_type pos) noexcept { return pos & ~mask; }
+
+    static constexpr std::ptrdiff_t distance(size_type sequence, size_type expected) noexcept
+    {
+        return static_cast<std::ptrdiff_t>(sequence - expected);
+    }
+
+    /// Number of consecutive slots from @p pos (at most @p count) that are
+    /// ready: free for a producer when @p offset is 0, written when 1. A
+    /// ready slot stays ready until its position is claimed, so the run is
+    /// still valid if the index has not moved when it is claimed.
+    size_type ready_run(size_type pos, size_type count, size_type offset) const noexcept
+    {
+        size_type n = 0;
+        while (n < count && n < N &&
+               slots_[(pos + n) & mask].sequence.load(std::memory_order_acquire) ==
+                   lap(pos + n) + offset) {
+            ++n;
+        }
+        return n;
+    }
+
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<size_type> enqueue_{0};
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<size_type> dequeue_{0};
+    alignas(EMBEC_CACHE_LINE_SIZE) slot slots_[N]{};
+};
+
+} // namespace embec
+
+#endif // EMBEC_MPMC_QUEUE_HPP
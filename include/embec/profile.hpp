@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file profile.hpp
+/// @brief Always-on instrumentation: named counters and latency histograms
+///        with scoped timers, compiled out by EMBEC_NO_PROFILE.
+///
+/// @code
+/// EMBEC_PROFILE_COUNTER(rx_frames);          // namespace scope
+/// EMBEC_PROFILE_HISTOGRAM(rx_handler_cycles);
+///
+/// void on_frame(const frame& f)
+/// {
+///     EMBEC_PROFILE_SCOPE(rx_handler_cycles); // cycles until return
+///     EMBEC_PROFILE_COUNT(rx_frames);
+///     ...
+/// }
+///
+/// // Reporting task:
+/// for (auto* c = embec::profile_counter::first(); c != nullptr; c = c->next()) {
+///     send(c->name(), c->value());
+/// }
+/// for (auto* h = embec::profile_histogram::first(); h != nullptr; h = h->next()) {
+///     const auto s = h->drain();
+///     send(h->name(), s.percentile(50), s.percentile(99), s.max());
+/// }
+/// @endcode
+///
+/// Counters and histograms register themselves in lists at construction,
+/// so a reporter can enumerate them without knowing the names. They are
+/// never unregistered and so must have static storage duration: define
+/// them at namespace scope (the EXTERN macros declare them for other
+/// files).
+///
+/// Updates are relaxed atomic increments, safe from any thread or
+/// interrupt handler (not Cortex-M0, see histogram.hpp). Times come from
+/// cycle_counter and saturate at 2^32 - 1 cycles; the histograms have
+/// 2^EMBEC_PROFILE_PRECISION buckets per power of two.
+///
+/// With EMBEC_NO_PROFILE defined every macro expands to nothing, and its
+/// arguments are not evaluated.
+
+#ifndef EMBEC_PROFILE_HPP
+#define EMBEC_PROFILE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "embec/config.hpp"
+#include "embec/cycle_counter.hpp"
+#include "embec/histogram.hpp"
+
+/// log2 of the buckets per power of two in profile histograms: 3 gives a
+/// resolution of 12.5 % in 240 buckets (960 bytes).
+#ifndef EMBEC_PROFILE_PRECISION
+#define EMBEC_PROFILE_PRECISION 3
+#endif
+
+namespace embec {
+
+namespace detail {
+
+/// Pushes @p node onto a registration list; safe against concurrent
+/// registration (function-local statics, several threads).
+template <typename Node>
+void profile_register(std::atomic<Node*>& head, Node* node, Node*& link) noexcept
+{
+    Node* first = head.load(std::memory_order_relaxed);
+    do {
+        link = first;
+    } while (!head.compare_exchange_weak(first, node, std::memory_order_release,
+                                         std::memory_order_relaxed));
+}
+
+} // namespace detail
+
+/// Named event counter, registered for enumeration.
+class profile_counter {
+public:
+    explicit profile_counter(const char* name) noexcept : name_(name)
+    {
+        detail::profile_register(head_, this, next_);
+    }
+    profile_counter(const profile_counter&) = delete;
+    profile_counter& operator=(const profile_counter&) = delete;
+
+    void add(std::uint32_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+
+    /// Current count (wraps).
+    std::uint32_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+    /// Returns the count and restarts it from zero without losing events.
+    std::uint32_t drain() noexcept { return value_.exchange(0, std::memory_order_relaxed); }
+
+    const char* name() const noexcept { return name_; }
+
+    /// Registered counters, most recently constructed first.
+    static profile_counter* first() noexcept { return head_.load(std::memory_order_acquire); }
+    profile_counter* next() const noexcept { return next_; }
+
+private:
+    static inline std::atomic<profile_counter*> head_{nullptr};
+
+    const char* name_;
+    profile_counter* next_ = nullptr;
+    std::atomic<std::uint32_t> value_{0};
+};
+
+/// Named histogram of durations in cycles, registered for enumeration.
+class profile_histogram : public histogram<std::uint32_t, EMBEC_PROFILE_PRECISION> {
+public:
+    explicit profile_histogram(const char* name) noexcept : name_(name)
+    {
+        detail::profile_register(head_, this, next_);
+    }
+
+    /// Records the cycles elapsed since @p start, a cycle_counter::now()
+    /// reading.
+    void record_since(cycles_t start) noexcept
+    {
+        const auto elapsed = static_cast<cycles_t>(cycle_counter::now() - start);
+        constexpr auto limit = static_cast<cycles_t>(~std::uint32_t{0});
+        record(static_cast<std::uint32_t>(elapsed < limit ? elapsed : limit));
+    }
+
+    const char* name() const noexcept { return name_; }
+
+    /// Registered histograms, most recently constructed first.
+    static profile_histogram* first() noexcept { return head_.load(std::memory_order_acquire); }
+    profile_histogram* next() const noexcept { return next_; }
+
+private:
+    static inline std::atomic<profile_histogram*> head_{nullptr};
+
+    const char* name_;
+    profile_histogram* next_ = nullptr;
+};
+
+/// Records the lifetime of the object, in cycles, into a histogram.
+class scoped_timer {
+public:
+    explicit scoped_timer(profile_histogram& target) noexcept
+        : target_(target), start_(cycle_counter::now())
+    {
+    }
+    ~scoped_timer() { target_.record_since(start_); }
+
+    scoped_timer(const scoped_timer&) = delete;
+    scoped_timer& operator=(const scoped_timer&) = delete;
+
+private:
+    profile_histogram& target_;
+    cycles_t start_;
+};
+
+} // namespace embec
+
+#define EMBEC_PROFILE_CAT_(a, b) EMBEC_PROFILE_CAT_IMPL_(a, b)
+#define EMBEC_PROFILE_CAT_IMPL_(a, b) a##b
+
+#if !defined(EMBEC_NO_PROFILE)
+
+/// Defines a counter named @p name.
+#define EMBEC_PROFILE_COUNTER(name) ::embec::profile_counter name{#name}
+/// Declares a counter defined in another file.
+#define EMBEC_PROFILE_EXTERN_COUNTER(name) extern ::embec::profile_counter name
+/// Adds 1 (or @p n) to a counter.
+#define EMBEC_PROFILE_COUNT(name) (name).add()
+#define EMBEC_PROFILE_ADD(name, n) (name).add(n)
+
+/// Defines a latency histogram named @p name.
+#define EMBEC_PROFILE_HISTOGRAM(name) ::embec::profile_histogram name{#name}
+/// Declares a histogram defined in another file.
+#define EMBEC_PROFILE_EXTERN_HISTOGRAM(name) extern ::embec::profile_histogram name
+/// Records the cycles from here to the end of the enclosing scope.
+#define EMBEC_PROFILE_SCOPE(name) \
+    const ::embec::scoped_timer EMBEC_PROFILE_CAT_(embec_profile_scope_, __LINE__)(name)
+/// Records @p value (cycles, or any other unsigned 32-bit quantity).
+#define EMBEC_PROFILE_RECORD(name, value) (name).record(value)
+
+#else
+
+#define EMBEC_PROFILE_COUNTER(name) static_assert(true, "")
+#define EMBEC_PROFILE_EXTERN_COUNTER(name) static_assert(true, "")
+#define EMBEC_PROFILE_COUNT(name) static_cast<void>(0)
+#define EMBEC_PROFILE_ADD(name, n) static_cast<void>(0)
+#define EMBEC_PROFILE_HISTOGRAM(name) static_assert(true, "")
+#define EMBEC_PROFILE_EXTERN_HISTOGRAM(name) static_assert(true, "")
+#define EMBEC_PROFILE_SCOPE(name) static_cast<void>(0)
+#define EMBEC_PROFILE_RECORD(name, value) static_cast<void>(0)
+
+#endif // EMBEC_NO_PROFILE
+
+#endif // EMBEC_PROFILE_HPP
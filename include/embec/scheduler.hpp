@@ -0,0 +1,717 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file scheduler.hpp
+/// @brief Cooperative priority scheduler for stackless tasks.
+///
+/// Tasks are statically allocated objects that run until they suspend:
+/// they yield, sleep on a timer_wheel, wait for an event or block on a
+/// channel. No task has a stack of its own, so a context switch is a
+/// function return followed by a function call. Two task flavours share
+/// the scheduler and the synchronisation primitives:
+///
+///  - C++20 coroutines (when the toolchain supports them), whose frames are
+///    placed in caller-provided task_storage:
+///    @code
+///    embec::task_storage<256> blink_storage;
+///
+///    embec::coroutine blink(embec::coroutine_storage&, embec::timer_wheel<>& wheel)
+///    {
+///        for (;;) {
+///            toggle_led();
+///            co_await embec::sleep_for(wheel, 500);
+///        }
+///    }
+///
+///    sched.spawn(blink(blink_storage, wheel), 3);
+///    @endcode
+///
+///  - Protothreads, which work with any C++17 compiler. Local variables do
+///    not survive a suspension, so keep state in members:
+///    @code
+///    struct blinker : embec::protothread<blinker> {
+///        embec::timer_wheel<>* wheel;
+///
+///        void run()
+///        {
+///            EMBEC_PT_BEGIN();
+///            for (;;) {
+///                toggle_led();
+///                EMBEC_PT_SLEEP(*wheel, 500);
+///            }
+///            EMBEC_PT_END();
+///        }
+///    };
+///    @endcode
+///
+/// There are 32 priority levels, 0 being the most urgent. Each level has a
+/// FIFO ready queue and a bitmap records the non-empty levels, so picking
+/// the next task is a count-trailing-zeros instruction. Tasks of equal
+/// priority run round-robin as they yield.
+///
+/// The scheduler and all primitives here are single-context objects: use
+/// them from task code and the scheduler loop only.
+
+#ifndef EMBEC_SCHEDULER_HPP
+#define EMBEC_SCHEDULER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "embec/config.hpp"
+#include "embec/detail/bits.hpp"
+#include "embec/static_deque.hpp"
+#include "embec/timer_wheel.hpp"
+
+/// Defined to 1 when C++20 coroutine tasks are available. Define
+/// EMBEC_NO_COROUTINES to use protothreads only.
+#if !defined(EMBEC_NO_COROUTINES) && defined(__cpp_impl_coroutine) && \
+    __has_include(<coroutine>)
+#define EMBEC_HAS_COROUTINES 1
+#include <coroutine>
+#include <exception>
+#endif
+
+namespace embec {
+
+class scheduler;
+class wait_list;
+
+/// Common part of coroutine and protothread tasks.
+///
+/// The suspension functions yield(), sleep() and wait() may only be called
+/// by the task itself while it runs, immediately before it returns to the
+/// scheduler; the awaitables and EMBEC_PT_* macros do this.
+class task {
+public:
+    using resume_type = void (*)(task&);
+
+    enum class status : std::uint8_t {
+        idle,     ///< never spawned
+        ready,    ///< queued to run
+        running,
+        waiting,  ///< sleeping or blocked on a wait_list
+        finished,
+    };
+
+    constexpr explicit task(resume_type resume) noexcept : resume_(resume) {}
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    status state() const noexcept { return status_; }
+    unsigned priority() const noexcept { return priority_; }
+    bool done() const noexcept { return status_ == status::finished; }
+
+    /// Requeues the task behind the other ready tasks of its priority.
+    void yield() noexcept;
+
+    /// Suspends the task for @p ticks ticks of @p wheel.
+    template <unsigned LevelBits, unsigned Levels>
+    void sleep(timer_wheel<LevelBits, Levels>& wheel, tick_t ticks) noexcept
+    {
+        EMBEC_ASSERT(status_ == status::running);
+        status_ = status::waiting;
+        timer_.set_callback(&timer_expired, this);
+        wheel.start(timer_, ticks);
+    }
+
+    /// Suspends the task on @p list until it is woken. If @p retry is
+    /// given, the scheduler calls retry(@p context) before resuming the task
+    /// and puts the task back on @p list if it returns false, so the task
+    /// only resumes once the operation it waits for has completed.
+    void wait(wait_list& list, bool (*retry)(void*) = nullptr, void* context = nullptr) noexcept;
+
+    /// Marks the task finished; it will not run again unless respawned.
+    void finish() noexcept { status_ = status::finished; }
+
+private:
+    friend class scheduler;
+    friend class wait_list;
+
+    static void timer_expired(timer& t) noexcept;
+
+    resume_type resume_;
+    task* next_ = nullptr;
+    scheduler* scheduler_ = nullptr;
+    wait_list* waiting_on_ = nullptr;
+    bool (*retry_)(void*) = nullptr;
+    void* retry_context_ = nullptr;
+    timer timer_;
+    std::uint8_t priority_ = 0;
+    status status_ = status::idle;
+};
+
+/// FIFO of tasks blocked on a condition.
+class wait_list {
+public:
+    constexpr wait_list() noexcept = default;
+    wait_list(const wait_list&) = delete;
+    wait_list& operator=(const wait_list&) = delete;
+
+    bool empty() const noexcept { return head_ == nullptr; }
+
+    /// Makes the longest-waiting task ready. Returns false if none waits.
+    bool wake_one() noexcept;
+
+    /// Makes all waiting tasks ready. Returns the number woken.
+    std::size_t wake_all() noexcept
+    {
+        std::size_t woken = 0;
+        while (wake_one()) {
+            ++woken;
+        }
+        return woken;
+    }
+
+private:
+    friend class task;
+    friend class scheduler;
+
+    void push(task& t) noexcept
+    {
+        t.next_ = nullptr;
+        if (tail_) {
+            tail_->next_ = &t;
+        } else {
+            head_ = &t;
+        }
+        tail_ = &t;
+    }
+
+    task* head_ = nullptr;
+    task* tail_ = nullptr;
+};
+
+#if EMBEC_HAS_COROUTINES
+class coroutine;
+#endif
+
+/// Runs ready tasks in priority order.
+class scheduler {
+public:
+    static constexpr unsigned priorities = 32;
+
+    constexpr scheduler() noexcept = default;
+    scheduler(const scheduler&) = delete;
+    scheduler& operator=(const scheduler&) = delete;
+
+    /// Makes @p t ready at @p priority (0 is the most urgent). @p t must be
+    /// idle or finished.
+    void spawn(task& t, unsigned priority) noexcept
+    {
+        EMBEC_ASSERT(priority < priorities);
+        EMBEC_ASSERT(t.status_ == task::status::idle || t.status_ == task::status::finished);
+        t.scheduler_ = this;
+        t.priority_ = static_cast<std::uint8_t>(priority);
+        enqueue(t);
+    }
+
+#if EMBEC_HAS_COROUTINES
+    /// Starts coroutine @p c at @p priority. Returns false if its frame did
+    /// not fit the task_storage it was created with.
+    bool spawn(coroutine&& c, unsigned priority) noexcept;
+#endif
+
+    /// Runs the most urgent ready task until it suspends. Returns false if
+    /// no task was ready.
+    bool run_once() noexcept
+    {
+        if (!ready_) {
+            return false;
+        }
+        const unsigned level = detail::count_trailing_zeros(ready_);
+        task& t = *head_[level];
+        head_[level] = t.next_;
+        if (!head_[level]) {
+            tail_[level] = nullptr;
+            ready_ &= ~(std::uint32_t{1} << level);
+        }
+        t.next_ = nullptr;
+        if (t.retry_) {
+            if (!t.retry_(t.retry_context_)) {
+                t.status_ = task::status::waiting;
+                t.waiting_on_->push(t);
+                return true;
+            }
+            t.retry_ = nullptr;
+            t.waiting_on_ = nullptr;
+        }
+        t.status_ = task::status::running;
+        current_ = &t;
+        // A finished coroutine frees its frame, so t is not touched again.
+        t.resume_(t);
+        current_ = nullptr;
+        return true;
+    }
+
+    /// Runs tasks until none is ready. Returns the number of task resumptions.
+    std::size_t run_until_idle() noexcept
+    {
+        std::size_t runs = 0;
+        while (run_once()) {
+            ++runs;
+        }
+        return runs;
+    }
+
+    /// True when no task is ready to run.
+    bool idle() const noexcept { return ready_ == 0; }
+
+    /// The task being run, or nullptr outside run_once().
+    task* current() const noexcept { return current_; }
+
+private:
+    friend class task;
+    friend class wait_list;
+
+    void wake(task& t) noexcept
+    {
+        if (t.status_ == task::status::waiting) {
+            enqueue(t);
+        }
+    }
+
+    void enqueue(task& t) noexcept
+    {
+        t.status_ = task::status::ready;
+        t.next_ = nullptr;
+        const unsigned level = t.priority_;
+        if (tail_[level]) {
+            tail_[level]->next_ = &t;
+        } else {
+            head_[level] = &t;
+            ready_ |= std::uint32_t{1} << level;
+        }
+        tail_[level] = &t;
+    }
+
+    std::uint32_t ready_ = 0;
+    task* current_ = nullptr;
+    task* head_[priorities]{};
+    task* tail_[priorities]{};
+};
+
+inline void task::yield() noexcept
+{
+    EMBEC_ASSERT(status_ == status::running);
+    scheduler_->enqueue(*this);
+}
+
+inline void task::wait(wait_list& list, bool (*retry)(void*), void* context) noexcept
+{
+    EMBEC_ASSERT(status_ == status::running);
+    status_ = status::waiting;
+    waiting_on_ = &list;
+    retry_ = retry;
+    retry_context_ = context;
+    list.push(*this);
+}
+
+inline void task::timer_expired(timer& t) noexcept
+{
+    task& self = *static_cast<task*>(t.context());
+    self.scheduler_->wake(self);
+}
+
+inline bool wait_list::wake_one() noexcept
+{
+    task* t = head_;
+    if (!t) {
+        return false;
+    }
+    head_ = t->next_;
+    if (!head_) {
+        tail_ = nullptr;
+    }
+    t->scheduler_->wake(*t);
+    return true;
+}
+
+/// Manual-reset event: set() releases all waiters and later waits pass
+/// until reset().
+class event {
+public:
+    constexpr event() noexcept = default;
+    event(const event&) = delete;
+    event& operator=(const event&) = delete;
+
+    bool is_set() const noexcept { return set_; }
+
+    void set() noexcept
+    {
+        set_ = true;
+        waiters_.wake_all();
+    }
+
+    void reset() noexcept { set_ = false; }
+
+    wait_list& waiters() noexcept { return waiters_; }
+
+#if EMBEC_HAS_COROUTINES
+    struct awaiter {
+        event& ev;
+
+        bool await_ready() const noexcept { return ev.set_; }
+        template <typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            h.promise().wait(ev.waiters_, &retry, &ev);
+        }
+        void await_resume() const noexcept {}
+
+        static bool retry(void* context) noexcept { return static_cast<event*>(context)->set_; }
+    };
+
+    /// co_await ev.wait() resumes once the event is set.
+    awaiter wait() noexcept { return {*this}; }
+#endif
+
+private:
+    bool set_ = false;
+    wait_list waiters_;
+};
+
+/// Bounded FIFO between tasks. Senders block while it is full, receivers
+/// while it is empty. T must be default constructible and movable.
+template <typename T, std::size_t Capacity>
+class channel {
+public:
+    constexpr channel() noexcept = default;
+    channel(const channel&) = delete;
+    channel& operator=(const channel&) = delete;
+
+    std::size_t size() const noexcept { return items_.size(); }
+    bool empty() const noexcept { return items_.empty(); }
+    bool full() const noexcept { return items_.size() == Capacity; }
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    template <typename U>
+    bool try_send(U&& value)
+    {
+        if (full()) {
+            return false;
+        }
+        items_.push_back(std::forward<U>(value));
+        receivers_.wake_one();
+        return true;
+    }
+
+    bool try_receive(T& out)
+    {
+        if (items_.empty()) {
+            return false;
+        }
+        out = std::move(items_.front());
+        items_.pop_front();
+        senders_.wake_one();
+        return true;
+    }
+
+    wait_list& send_waiters() noexcept { return senders_; }
+    wait_list& receive_waiters() noexcept { return receivers_; }
+
+#if EMBEC_HAS_COROUTINES
+    struct send_awaiter {
+        channel& ch;
+        T value;
+
+        bool await_ready() { return ch.try_send(std::move(value)); }
+        template <typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            h.promise().wait(ch.senders_, &retry, this);
+        }
+        void await_resume() const noexcept {}
+
+        static bool retry(void* context)
+        {
+            auto& self = *static_cast<send_awaiter*>(context);
+            return self.ch.try_send(std::move(self.value));
+        }
+    };
+
+    struct receive_awaiter {
+        channel& ch;
+        T value{};
+
+        bool await_ready() { return ch.try_receive(value); }
+        template <typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            h.promise().wait(ch.receivers_, &retry, this);
+        }
+        T await_resume() { return std::move(value); }
+
+        static bool retry(void* context)
+        {
+            auto& self = *static_cast<receive_awaiter*>(context);
+            return self.ch.try_receive(self.value);
+        }
+    };
+
+    /// co_await ch.send(v) resumes once @p value has been queued.
+    send_awaiter send(T value) { return {*this, std::move(value)}; }
+
+    /// co_await ch.receive() yields the oldest item.
+    receive_awaiter receive() { return {*this}; }
+#endif
+
+private:
+    static_deque<T, Capacity> items_;
+    wait_list senders_;
+    wait_list receivers_;
+};
+
+/// Base of protothread tasks; @p Derived provides a public `void run()`
+/// written with the EMBEC_PT_* macros.
+template <typename Derived>
+class protothread : public task {
+public:
+    constexpr protothread() noexcept : task(&resume) {}
+
+    /// Restarts run() from EMBEC_PT_BEGIN() on its next resumption.
+    void restart() noexcept { pt_line_ = 0; }
+
+protected:
+    unsigned pt_line_ = 0;
+
+private:
+    static void resume(task& t) noexcept
+    {
+        auto& self = static_cast<Derived&>(t);
+        self.run();
+        // Returning without suspending, other than through EMBEC_PT_END(),
+        // ends the task as well.
+        if (self.state() == status::running) {
+            self.pt_line_ = 0;
+            self.finish();
+        }
+    }
+};
+
+#define EMBEC_PT_BEGIN() \
+    switch (this->pt_line_) { \
+    case 0:
+
+#define EMBEC_PT_END() \
+    } \
+    this->pt_line_ = 0; \
+    this->finish(); \
+    return
+
+/// Lets other ready tasks of the same priority run.
+#define EMBEC_PT_YIELD() \
+    do { \
+        this->pt_line_ = __LINE__; \
+        this->yield(); \
+        return; \
+    case __LINE__:; \
+    } while (0)
+
+/// Sleeps for @p ticks ticks of timer wheel @p wheel.
+#define EMBEC_PT_SLEEP(wheel, ticks) \
+    do { \
+        this->pt_line_ = __LINE__; \
+        this->sleep((wheel), (ticks)); \
+        return; \
+    case __LINE__:; \
+    } while (0)
+
+/// Blocks on wait_list @p list until @p condition holds. The condition is
+/// re-evaluated each time the task is woken.
+#define EMBEC_PT_WAIT_UNTIL(list, condition) \
+    do { \
+        this->pt_line_ = __LINE__; \
+        [[fallthrough]]; \
+    case __LINE__: \
+        if (!(condition)) { \
+            this->wait(list); \
+            return; \
+        } \
+    } while (0)
+
+/// Waits until event @p ev is set.
+#define EMBEC_PT_WAIT(ev) EMBEC_PT_WAIT_UNTIL((ev).waiters(), (ev).is_set())
+
+/// Sends @p value to channel @p ch, waiting while it is full.
+#define EMBEC_PT_SEND(ch, value) EMBEC_PT_WAIT_UNTIL((ch).send_waiters(), (ch).try_send(value))
+
+/// Receives from channel @p ch into @p out, waiting while it is empty.
+#define EMBEC_PT_RECEIVE(ch, out) \
+    EMBEC_PT_WAIT_UNTIL((ch).receive_waiters(), (ch).try_receive(out))
+
+#if EMBEC_HAS_COROUTINES
+
+/// Memory for one coroutine frame; see task_storage.
+class coroutine_storage {
+public:
+    coroutine_storage(const coroutine_storage&) = delete;
+    coroutine_storage& operator=(const coroutine_storage&) = delete;
+
+    /// True while a coroutine created with this storage exists.
+    bool busy() const noexcept { return busy_; }
+    std::size_t capacity() const noexcept { return size_; }
+
+    /// Frame size requested by the last allocation attempt; use it to size
+    /// the storage.
+    std::size_t required() const noexcept { return required_; }
+
+protected:
+    constexpr coroutine_storage(unsigned char* data, std::size_t size) noexcept
+        : data_(data), size_(size)
+    {
+    }
+
+private:
+    friend class coroutine;
+
+    struct alignas(alignof(std::max_align_t)) header {
+        coroutine_storage* owner;
+    };
+
+    void* allocate(std::size_t size) noexcept
+    {
+        required_ = size + sizeof(header);
+        if (busy_ || required_ > size_) {
+            return nullptr;
+        }
+        busy_ = true;
+        ::new (data_) header{this};
+        return data_ + sizeof(header);
+    }
+
+    static void release(void* frame) noexcept
+    {
+        auto* h = reinterpret_cast<header*>(static_cast<unsigned char*>(frame) - sizeof(header));
+        h->owner->busy_ = false;
+    }
+
+    unsigned char* data_;
+    std::size_t size_;
+    std::size_t required_ = 0;
+    bool busy_ = false;
+};
+
+/// Statically allocatable storage for a coroutine frame of up to @p Bytes
+/// bytes (including a small header). The frame size is only known to the
+/// compiler; if creating a coroutine fails, required() reports it.
+template <std::size_t Bytes>
+class task_storage : public coroutine_storage {
+public:
+    constexpr task_storage() noexcept : coroutine_storage(data_, Bytes) {}
+
+private:
+    alignas(std::max_align_t) unsigned char data_[Bytes];
+};
+
+/// Return type of coroutine tasks. The coroutine's first parameter must be
+/// the coroutine_storage holding its frame. The coroutine does not start
+/// until it is passed to scheduler::spawn(); its frame is released when
+/// the body returns.
+class coroutine {
+public:
+    struct promise_type : task {
+        promise_type() noexcept : task(&resume) {}
+
+        template <typename... Args>
+        static void* operator new(std::size_t size, coroutine_storage& storage, Args&...) noexcept
+        {
+            return storage.allocate(size);
+        }
+        static void operator delete(void* frame) noexcept { coroutine_storage::release(frame); }
+
+        static coroutine get_return_object_on_allocation_failure() noexcept { return coroutine(); }
+
+        coroutine get_return_object() noexcept
+        {
+            return coroutine(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void resume(task& t) noexcept
+        {
+            auto h = std::coroutine_handle<promise_type>::from_promise(static_cast<promise_type&>(t));
+            h.resume();
+            if (h.done()) {
+                h.destroy();
+            }
+        }
+    };
+
+    coroutine(coroutine&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    coroutine& operator=(coroutine&&) = delete;
+
+    /// Destroys a coroutine that was never spawned.
+    ~coroutine()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /// False if the frame could not be allocated.
+    explicit operator bool() const noexcept { return static_cast<bool>(handle_); }
+
+private:
+    friend class scheduler;
+
+    coroutine() noexcept = default;
+    explicit coroutine(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+inline bool scheduler::spawn(coroutine&& c, unsigned priority) noexcept
+{
+    if (!c.handle_) {
+        return false;
+    }
+    spawn(std::exchange(c.handle_, nullptr).promise(), priority);
+    return true;
+}
+
+struct yield_awaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept
+    {
+        h.promise().yield();
+    }
+    void await_resume() const noexcept {}
+};
+
+/// co_await embec::yield() lets other ready tasks of the same priority run.
+inline yield_awaiter yield() noexcept { return {}; }
+
+template <typename Wheel>
+struct sleep_awaiter {
+    Wheel& wheel;
+    tick_t ticks;
+
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> h) noexcept
+    {
+        h.promise().sleep(wheel, ticks);
+    }
+    void await_resume() const noexcept {}
+};
+
+/// co_await embec::sleep_for(wheel, n) suspends for @p ticks ticks.
+template <unsigned LevelBits, unsigned Levels>
+sleep_awaiter<timer_wheel<LevelBits, Levels>> sleep_for(timer_wheel<LevelBits, Levels>& wheel,
+                                                        tick_t ticks) noexcept
+{
+    return {wheel, ticks};
+}
+
+#endif // EMBEC_HAS_COROUTINES
+
+} // namespace embec
+
+#endif // EMBEC_SCHEDULER_HPP
@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file slip.hpp
+/// @brief SLIP (RFC 1055) framing.
+///
+/// SLIP ends each frame with END (0xC0) and escapes END and ESC (0xDB)
+/// bytes inside the frame. The interface mirrors cobs.hpp: one-shot
+/// slip_encode()/slip_decode() (decoding may be done in place), the
+/// byte-at-a-time slip_encoder for transmit ISRs, the streaming
+/// slip_decoder that accepts bytes, blocks or an spsc_ring, and
+/// slip_write() that encodes straight into an spsc_ring.
+///
+/// Encoded frames start and end with END, as recommended by RFC 1055, so
+/// that line noise before a frame is flushed as an (ignored) empty frame.
+
+#ifndef EMBEC_SLIP_HPP
+#define EMBEC_SLIP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "embec/framing.hpp"
+
+namespace embec {
+
+namespace slip {
+constexpr std::uint8_t end = 0xc0;
+constexpr std::uint8_t esc = 0xdb;
+constexpr std::uint8_t esc_end = 0xdc;
+constexpr std::uint8_t esc_esc = 0xdd;
+} // namespace slip
+
+/// Worst-case encoded size of a @p length byte frame, including both END
+/// bytes.
+constexpr std::size_t slip_max_encoded_size(std::size_t length) noexcept
+{
+    return 2 * length + 2;
+}
+
+/// Encodes @p length bytes at @p src into @p dst, framed by END bytes.
+/// @p dst must not overlap @p src.
+inline frame_result slip_encode(const std::uint8_t* src, std::size_t length, std::uint8_t* dst,
+                                std::size_t capacity) noexcept
+{
+    if (capacity < 2) {
+        return {0, frame_status::overflow};
+    }
+    std::size_t out = 0;
+    std::size_t in = 0;
+    dst[out++] = slip::end;
+    while (in < length) {
+        const std::size_t run = detail::find_either(src + in, length - in, slip::end, slip::esc);
+        if (run > capacity - out) {
+            return {0, frame_status::overflow};
+        }
+        if (run) {
+            std::memcpy(dst + out, src + in, run);
+        }
+        out += run;
+        in += run;
+        if (in == length) {
+            break;
+        }
+        if (capacity - out < 2) {
+            return {0, frame_status::overflow};
+        }
+        dst[out++] = slip::esc;
+        dst[out++] = src[in++] == slip::end ? slip::esc_end : slip::esc_esc;
+    }
+    if (out == capacity) {
+        return {0, frame_status::overflow};
+    }
+    dst[out++] = slip::end;
+    return {out, frame_status::ok};
+}
+
+/// Decodes one frame of @p length bytes at @p src, which must not contain
+/// END bytes (strip the delimiters first). @p dst may equal @p src.
+inline frame_result slip_decode(const std::uint8_t* src, std::size_t length, std::uint8_t* dst,
+                                std::size_t capacity) noexcept
+{
+    std::size_t out = 0;
+    std::size_t in = 0;
+    while (in < length) {
+        const std::size_t run = detail::find_either(src + in, length - in, slip::end, slip::esc);
+        if (run > capacity - out) {
+            return {0, frame_status::overflow};
+        }
+        if (run) {
+            std::memmove(dst + out, src + in, run);
+        }
+        out += run;
+        in += run;
+        if (in == length) {
+            break;
+        }
+        if (src[in] == slip::end || in + 1 == length) {
+            return {0, frame_status::invalid};
+        }
+        const std::uint8_t escaped = src[in + 1];
+        if (escaped != slip::esc_end && escaped != slip::esc_esc) {
+            return {0, frame_status::invalid};
+        }
+        if (out == capacity) {
+            return {0, frame_status::overflow};
+        }
+        dst[out++] = escaped == slip::esc_end ? slip::end : slip::esc;
+        in += 2;
+    }
+    return {out, frame_status::ok};
+}
+
+/// Byte-at-a-time SLIP encoder for transmit ISRs. See cobs_encoder.
+class slip_encoder {
+public:
+    constexpr slip_encoder() noexcept = default;
+
+    /// Starts encoding @p length bytes at @p frame. The frame must stay
+    /// valid until next() returns false.
+    void begin(const std::uint8_t* frame, std::size_t length) noexcept
+    {
+        src_ = frame;
+        remaining_ = length;
+        state_ = state::start;
+    }
+
+    bool busy() const noexcept { return state_ != state::idle; }
+
+    /// Produces the next encoded byte. Returns false when the frame,
+    /// including the closing END, has been emitted.
+    bool next(std::uint8_t& out) noexcept
+    {
+        switch (state_) {
+        case state::start:
+            out = slip::end;
+            state_ = state::data;
+            return true;
+        case state::data:
+            if (remaining_ == 0) {
+                out = slip::end;
+                state_ = state::idle;
+                return true;
+            }
+            out = *src_;
+            if (out == slip::end || out == slip::esc) {
+                out = slip::esc;
+                state_ = state::escaped;
+                return true;
+            }
+            ++src_;
+            --remaining_;
+            return true;
+        case state::escaped:
+            out = *src_++ == slip::end ? slip::esc_end : slip::esc_esc;
+            --remaining_;
+            state_ = state::data;
+            return true;
+        case state::idle:
+            break;
+        }
+        return false;
+    }
+
+private:
+    enum class state : std::uint8_t { idle, start, data, escaped };
+
+    const std::uint8_t* src_ = nullptr;
+    std::size_t remaining_ = 0;
+    state state_ = state::idle;
+};
+
+/// Streaming SLIP decoder writing into a caller-provided frame buffer.
+///
+/// END terminates a frame; empty frames are ignored. After an overflow or
+/// an invalid escape the rest of the frame is discarded.
+class slip_decoder {
+public:
+    constexpr slip_decoder(std::uint8_t* buffer, std::size_t capacity) noexcept
+        : buffer_(buffer), capacity_(capacity)
+    {
+    }
+
+    /// Decoded frame, valid after a push returned frame_status::ok and until
+    /// the next push.
+    const std::uint8_t* data() const noexcept { return buffer_; }
+    std::size_t size() const noexcept { return size_; }
+
+    /// Drops any partially received frame.
+    void reset() noexcept
+    {
+        size_ = 0;
+        escape_ = false;
+        discard_ = false;
+        complete_ = false;
+    }
+
+    /// Processes one received byte.
+    frame_status push(std::uint8_t byte) noexcept
+    {
+        if (complete_) {
+            size_ = 0;
+            complete_ = false;
+        }
+        if (byte == slip::end) {
+            const bool deliver = !discard_ && !escape_ && size_ != 0;
+            const bool broken_escape = escape_ && !discard_;
+            const std::size_t size = size_;
+            reset();
+            if (broken_escape) {
+                return frame_status::invalid;
+            }
+            if (!deliver) {
+                return frame_status::incomplete;
+            }
+            size_ = size;
+            complete_ = true;
+            return frame_status::ok;
+        }
+        if (discard_) {
+            return frame_status::incomplete;
+        }
+        if (escape_) {
+            escape_ = false;
+            if (byte == slip::esc_end) {
+                byte = slip::end;
+            } else if (byte == slip::esc_esc) {
+                byte = slip::esc;
+            } else {
+                return fail(frame_status::invalid);
+            }
+        } else if (byte == slip::esc) {
+            escape_ = true;
+            return frame_status::incomplete;
+        }
+        if (size_ == capacity_) {
+            return fail(frame_status::overflow);
+        }
+        buffer_[size_++] = byte;
+        return frame_status::incomplete;
+    }
+
+    /// Processes up to @p length bytes, stopping right after a frame ends.
+    /// Returns the number of bytes consumed; @p status receives the outcome.
+    std::size_t push(const std::uint8_t* data, std::size_t length, frame_status& status) noexcept
+    {
+        std::size_t i = 0;
+        status = frame_status::incomplete;
+        while (i < length) {
+            if (!escape_ && !complete_) {
+                // Copy (or skip, when discarding) plain bytes in one go.
+                std::size_t run =
+                    detail::find_either(data + i, length - i, slip::end, slip::esc);
+                if (discard_) {
+                    i += run;
+                    run = 0;
+                } else if (run > capacity_ - size_) {
+                    run = capacity_ - size_;
+                }
+                if (run) {
+                    std::memcpy(buffer_ + size_, data + i, run);
+                    size_ += run;
+                    i += run;
+                    continue;
+                }
+                if (i == length) {
+                    break;
+                }
+            }
+            status = push(data[i++]);
+            if (status != frame_status::incomplete) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    /// Consumes bytes from @p ring without copying them elsewhere until a
+    /// frame ends (or fails) or the ring is empty.
+    template <typename Ring>
+    frame_status push(Ring& ring) noexcept
+    {
+        for (;;) {
+            const auto region = ring.claim_read();
+            if (region.empty()) {
+                return frame_status::incomplete;
+            }
+            frame_status status;
+            ring.commit_read(push(region.data, region.size, status));
+            if (status != frame_status::incomplete) {
+                return status;
+            }
+        }
+    }
+
+private:
+    frame_status fail(frame_status status) noexcept
+    {
+        discard_ = true;
+        return status;
+    }
+
+    std::uint8_t* buffer_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+    bool escape_ = false;
+    bool discard_ = false;
+    bool complete_ = false;
+};
+
+/// Encodes @p length bytes at @p src, framed by END bytes, directly into the
+/// byte ring @p ring. Nothing is written unless the worst-case encoded frame
+/// fits in the free space. Must be called from the ring's producer context.
+template <typename Ring>
+bool slip_write(Ring& ring, const std::uint8_t* src, std::size_t length) noexcept
+{
+    if (Ring::capacity() - ring.size() < slip_max_encoded_size(length)) {
+        return false;
+    }
+    const std::uint8_t end = slip::end;
+    ring.write(&end, 1);
+    std::size_t in = 0;
+    while (in < length) {
+        const std::size_t run = detail::find_either(src + in, length - in, slip::end, slip::esc);
+        ring.write(src + in, run);
+        in += run;
+        if (in == length) {
+            break;
+        }
+        const std::uint8_t escaped[2] = {slip::esc,
+                                         src[in++] == slip::end ? slip::esc_end : slip::esc_esc};
+        ring.write(escaped, 2);
+    }
+    ring.write(&end, 1);
+    return true;
+}
+
+} // namespace embec
+
+#endif // EMBEC_SLIP_HPP
@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file snapshot.hpp
+/// @brief Latest-value publication from one writer: seqlock and triple
+///        buffer.
+///
+/// Both let a writer (typically an ISR sampling sensors) publish a whole
+/// struct that readers see either entirely old or entirely new, without
+/// locks and without masking interrupts:
+///  - seqlock: one copy of the payload and a sequence counter. The writer
+///    never waits; a reader that overlaps a write retries. Any number of
+///    readers. Needs only atomic loads and stores, so it also works on
+///    cores without read-modify-write instructions (Cortex-M0).
+///  - triple_buffer: three copies of the payload. Both the writer and the
+///    single reader are wait-free and the reader gets a reference instead
+///    of a copy, which suits large payloads. Requires native atomic
+///    read-modify-write instructions (e.g. LDREX/STREX), so not Cortex-M0.
+///
+/// A seqlock reader spins while a write is in progress, so it must not run
+/// at a higher priority than the writer on the same core (it would wait
+/// for a writer that cannot resume): read from the lower priority context,
+/// use try_load() there, or use triple_buffer.
+///
+/// The memory ordering is the same on single-core MCUs, where it only
+/// restrains the compiler, and on SMP hosts, where it also orders the
+/// hardware.
+
+#ifndef EMBEC_SNAPSHOT_HPP
+#define EMBEC_SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+/// Sequence lock around a trivially copyable payload, for one writer and
+/// any number of readers.
+///
+/// The payload is kept as machine words accessed with release stores and
+/// acquire loads, so concurrent reads and writes are well defined in the
+/// C++ memory model and visible to ThreadSanitizer (which does not model
+/// fences). On x86 these are plain moves; on Arm they cost a barrier or a
+/// load-acquire per word. The counter is odd while a write is in progress;
+/// a read is valid if it saw the same even count before and after copying.
+template <typename T>
+class seqlock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "seqlock payload must be trivially copyable");
+
+    using word = std::uintptr_t;
+    static constexpr std::size_t words = (sizeof(T) + sizeof(word) - 1) / sizeof(word);
+
+public:
+    using value_type = T;
+
+    constexpr seqlock() noexcept = default;
+    explicit seqlock(const T& initial) noexcept { store(initial); }
+    seqlock(const seqlock&) = delete;
+    seqlock& operator=(const seqlock&) = delete;
+
+    /// Publishes @p value. Writer only; never waits.
+    void store(const T& value) noexcept
+    {
+        word buffer[words] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        const std::uint32_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        // Release keeps each payload store after the odd count.
+        for (std::size_t i = 0; i < words; ++i) {
+            data_[i].store(buffer[i], std::memory_order_release);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Copies the payload into @p out unless a write is in progress or
+    /// overlapped the copy, in which case @p out is unspecified and false
+    /// is returned.
+    bool try_load(T& out) const noexcept
+    {
+        word buffer[words];
+        const std::uint32_t before = sequence_.load(std::memory_order_acquire);
+        if ((before & 1) != 0) {
+            return false;
+        }
+        // Acquire keeps each payload load before the second count load.
+        for (std::size_t i = 0; i < words; ++i) {
+            buffer[i] = data_[i].load(std::memory_order_acquire);
+        }
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, buffer, sizeof(T));
+        return true;
+    }
+
+    /// Returns a consistent copy of the payload, retrying while writes
+    /// overlap.
+    T load() const noexcept
+    {
+        T out;
+        while (!try_load(out)) {
+        }
+        return out;
+    }
+
+    /// Number of completed stores (wraps).
+    std::uint32_t version() const noexcept
+    {
+        return sequence_.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    std::atomic<std::uint32_t> sequence_{0};
+    std::atomic<word> data_[words]{};
+};
+
+/// Wait-free triple buffer for one writer and one reader.
+///
+/// The writer fills its back buffer and swaps it with the middle one; the
+/// reader swaps its front buffer with the middle one when the middle holds
+/// a newer value. Neither ever waits for the other and the reader always
+/// holds the latest complete value, so intermediate values are dropped
+/// when the writer is faster. T needs to be default constructible and
+/// copy assignable.
+template <typename T>
+class triple_buffer {
+public:
+    using value_type = T;
+
+    triple_buffer() = default;
+    explicit triple_buffer(const T& initial)
+    {
+        for (auto& b : buffers_) {
+            b.value = initial;
+        }
+    }
+    triple_buffer(const triple_buffer&) = delete;
+    triple_buffer& operator=(const triple_buffer&) = delete;
+
+    // ------------------------------------------------------------------ writer
+
+    /// The buffer the writer may fill in place before publish().
+    T& back() noexcept { return buffers_[back_].value; }
+
+    /// Makes the back buffer the latest value.
+    void publish() noexcept
+    {
+        const auto published = static_cast<std::uint8_t>(back_ | fresh);
+        back_ = static_cast<std::uint8_t>(
+            middle_.exchange(published, std::memory_order_acq_rel) & index_mask);
+    }
+
+    /// Copies @p value into the back buffer and publishes it.
+    void write(const T& value)
+    {
+        back() = value;
+        publish();
+    }
+
+    // ------------------------------------------------------------------ reader
+
+    /// True if a value newer than the one returned by the last read() has
+    /// been published.
+    bool updated() const noexcept
+    {
+        return (middle_.load(std::memory_order_relaxed) & fresh) != 0;
+    }
+
+    /// The latest published value (or the initial one). The reference stays
+    /// valid and unchanged until the next read().
+    const T& read() noexcept
+    {
+        if (updated()) {
+            front_ = static_cast<std::uint8_t>(
+                middle_.exchange(front_, std::memory_order_acq_rel) & index_mask);
+        }
+        return buffers_[front_].value;
+    }
+
+private:
+    static constexpr std::uint8_t index_mask = 0x3;
+    static constexpr std::uint8_t fresh = 0x4;
+
+    // Each buffer on its own line so that writer and reader do not share.
+    struct alignas(EMBEC_CACHE_LINE_SIZE) slot {
+        T value{};
+    };
+
+    slot buffers_[3];
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<std::uint8_t> middle_{1};
+    alignas(EMBEC_CACHE_LINE_SIZE) std::uint8_t back_ = 2; ///< Writer-owned.
+    alignas(EMBEC_CACHE_LINE_SIZE) std::uint8_t front_ = 0; ///< Reader-owned.
+};
+
+} // namespace embec
+
+#endif // EMBEC_SNAPSHOT_HPP
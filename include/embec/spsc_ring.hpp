@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file spsc_ring.hpp
+/// @brief Lock-free single-producer/single-consumer ring buffer.
+///
+/// The producer and the consumer may run in different execution contexts
+/// (for example an ISR and the main loop, or two threads) without any
+/// locking or interrupt masking. Besides the copying push/pop/write/read
+/// API, the ring hands out contiguous regions of its storage through
+/// claim_write()/commit_write() and claim_read()/commit_read() so that DMA
+/// engines and drivers can move data in and out with no intermediate copy.
+
+#ifndef EMBEC_SPSC_RING_HPP
+#define EMBEC_SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "embec/config.hpp"
+
+namespace embec {
+
+/// Contiguous run of ring storage returned by the claim functions.
+template <typename T>
+struct ring_region {
+    T* data;
+    std::size_t size;
+
+    constexpr bool empty() const noexcept { return size == 0; }
+};
+
+/// Fixed-capacity SPSC ring buffer.
+///
+/// @tparam T Element type. Must be trivially copyable because elements are
+///           moved with memcpy and exposed directly to DMA.
+/// @tparam N Capacity in elements. Must be a power of two so that index
+///           wrapping is a single mask operation. All N slots are usable.
+///
+/// Indices run freely and are only masked when the storage is accessed,
+/// which distinguishes full from empty without sacrificing a slot. Each side
+/// keeps a private copy of the other side's index and only reloads the
+/// shared atomic when the cached value says the ring is full (or empty).
+///
+/// Functions in the "producer" group may only be called from the single
+/// producer context and those in the "consumer" group only from the single
+/// consumer context. size(), empty() and full() may be called from either
+/// side and return a snapshot.
+template <typename T, std::size_t N>
+class spsc_ring {
+    static_assert(N >= 2 && (N & (N - 1)) == 0,
+                  "spsc_ring capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "spsc_ring element type must be trivially copyable");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    constexpr spsc_ring() noexcept = default;
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    static constexpr size_type capacity() noexcept { return N; }
+
+    size_type size() const noexcept
+    {
+        const size_type tail = tail_.load(std::memory_order_acquire);
+        const size_type head = head_.load(std::memory_order_acquire);
+        // The producer may have advanced between the two loads.
+        return head - tail < N ? head - tail : N;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    bool full() const noexcept { return size() == N; }
+
+    /// Discards all content. Neither side may be active during the call.
+    void reset() noexcept
+    {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        cached_head_ = 0;
+        cached_tail_ = 0;
+    }
+
+    // ---------------------------------------------------------------- producer
+
+    /// Appends one element. Returns false if the ring is full.
+    bool push(const T& value) noexcept
+    {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        if (EMBEC_UNLIKELY(head - cached_tail_ == N)) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ == N) {
+                return false;
+            }
+        }
+        buffer_[head & mask] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Copies up to @p count elements from @p src. Returns the number of
+    /// elements actually written, which is less than @p count only when the
+    /// ring runs out of space.
+    size_type write(const T* src, size_type count) noexcept
+    {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        size_type space = N - (head - cached_tail_);
+        if (space < count) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            space = N - (head - cached_tail_);
+            if (count > space) {
+                count = space;
+            }
+        }
+        copy_in(head & mask, src, count);
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Returns the largest contiguous free region starting at the write
+    /// position. The region may be shorter than the total free space when it
+    /// reaches the end of the storage; claim again after committing to get
+    /// the wrapped part. Returns an empty region when the ring is full.
+    ring_region<T> claim_write() noexcept
+    {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        const size_type index = head & mask;
+        const size_type space = N - (head - cached_tail_);
+        const size_type run = N - index;
+        return {&buffer_[index], space < run ? space : run};
+    }
+
+    /// Publishes @p count elements written into the last claimed region.
+    void commit_write(size_type count) noexcept
+    {
+        const size_type head = head_.load(std::memory_order_relaxed);
+        EMBEC_ASSERT(count <= N - (head - cached_tail_));
+        EMBEC_ASSERT(count <= N - (head & mask));
+        head_.store(head + count, std::memory_order_release);
+    }
+
+    // ---------------------------------------------------------------- consumer
+
+    /// Removes the oldest element into @p out. Returns false if empty.
+    bool pop(T& out) noexcept
+    {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if (EMBEC_UNLIKELY(cached_head_ == tail)) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (cached_head_ == tail) {
+                return false;
+            }
+        }
+        out = buffer_[tail & mask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Copies the oldest element into @p out without removing it.
+    bool peek(T& out) noexcept
+    {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        if (cached_head_ == tail) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (cached_head_ == tail) {
+                return false;
+            }
+        }
+        out = buffer_[tail & mask];
+        return true;
+    }
+
+    /// Moves up to @p count elements into @p dst. Returns the number of
+    /// elements actually read.
+    size_type read(T* dst, size_type count) noexcept
+    {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        size_type avail = cached_head_ - tail;
+        if (avail < count) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            avail = cached_head_ - tail;
+            if (count > avail) {
+                count = avail;
+            }
+        }
+        copy_out(tail & mask, dst, count);
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /// Returns the largest contiguous readable region starting at the read
+    /// position. Returns an empty region when the ring is empty.
+    ring_region<const T> claim_read() noexcept
+    {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        cached_head_ = head_.load(std::memory_order_acquire);
+        const size_type index = tail & mask;
+        const size_type avail = cached_head_ - tail;
+        const size_type run = N - index;
+        return {&buffer_[index], avail < run ? avail : run};
+    }
+
+    /// Releases @p count elements of the last claimed region back to the
+    /// producer.
+    void commit_read(size_type count) noexcept
+    {
+        const size_type tail = tail_.load(std::memory_order_relaxed);
+        EMBEC_ASSERT(count <= cached_head_ - tail);
+        tail_.store(tail + count, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_type mask = N - 1;
+
+    void copy_in(size_type index, const T* src, size_type count) noexcept
+    {
+        const size_type first = count < N - index ? count : N - index;
+        if (first != 0) {
+            std::memcpy(&buffer_[index], src, first * sizeof(T));
+        }
+        if (count != first) {
+            std::memcpy(&buffer_[0], src + first, (count - first) * sizeof(T));
+        }
+    }
+
+    void copy_out(size_type index, T* dst, size_type count) const noexcept
+    {
+        const size_type first = count < N - index ? count : N - index;
+        if (first != 0) {
+            std::memcpy(dst, &buffer_[index], first * sizeof(T));
+        }
+        if (count != first) {
+            std::memcpy(dst + first, &buffer_[0], (count - first) * sizeof(T));
+        }
+    }
+
+    // Producer-owned line: write index plus the producer's view of tail_.
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<size_type> head_{0};
+    size_type cached_tail_ = 0;
+
+    // Consumer-owned line: read index plus the consumer's view of head_.
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<size_type> tail_{0};
+    size_type cached_head_ = 0;
+
+    alignas(EMBEC_CACHE_LINE_SIZE) T buffer_[N]{};
+};
+
+} // namespace embec
+
+#endif // EMBEC_SPSC_RING_HPP
@@ -0,0 +1,360 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file static_deque.hpp
+/// @brief Double-ended queue with fixed capacity and inline storage.
+///
+/// Elements live in a circular buffer inside the object, so pushing and
+/// popping at either end is O(1) and never moves other elements. Unlike
+/// spsc_ring this is an ordinary single-context container: it accepts any
+/// element type and offers random access and iterators. Exceeding the
+/// capacity is a precondition violation checked with EMBEC_ASSERT; the
+/// try_ variants report it instead.
+
+#ifndef EMBEC_STATIC_DEQUE_HPP
+#define EMBEC_STATIC_DEQUE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "embec/config.hpp"
+#include "embec/detail/inline_storage.hpp"
+
+namespace embec {
+
+namespace detail {
+
+template <typename T, std::size_t N, bool = std::is_trivially_destructible<T>::value>
+struct static_deque_base {
+    inline_storage<T, N> storage_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+template <typename T, std::size_t N>
+struct static_deque_base<T, N, false> {
+    static_deque_base() = default;
+    static_deque_base(const static_deque_base&) = delete;
+    static_deque_base& operator=(const static_deque_base&) = delete;
+    ~static_deque_base()
+    {
+        for (std::size_t i = 0, slot = head_; i < size_; ++i) {
+            storage_.destroy(slot);
+            slot = slot + 1 == N ? 0 : slot + 1;
+        }
+    }
+
+    inline_storage<T, N> storage_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+/// Random-access iterator over a static_deque. Holds the container and a
+/// logical index, so it stays valid across wrap-around.
+template <typename Deque, typename Value>
+class static_deque_iterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    constexpr static_deque_iterator() noexcept = default;
+    constexpr static_deque_iterator(Deque* deque, std::size_t index) noexcept
+        : deque_(deque), index_(index)
+    {
+    }
+
+    // Conversion from iterator to const_iterator.
+    template <typename OtherDeque, typename OtherValue,
+              typename = std::enable_if_t<std::is_convertible<OtherValue*, Value*>::value>>
+    constexpr static_deque_iterator(
+        const static_deque_iterator<OtherDeque, OtherValue>& other) noexcept
+        : deque_(other.deque_), index_(other.index_)
+    {
+    }
+
+    constexpr reference operator*() const noexcept { return (*deque_)[index_]; }
+    constexpr pointer operator->() const noexcept { return &(*deque_)[index_]; }
+    constexpr reference operator[](difference_type n) const noexcept
+    {
+        return (*deque_)[index_ + n];
+    }
+
+    constexpr static_deque_iterator& operator++() noexcept { ++index_; return *this; }
+    constexpr static_deque_iterator& operator--() noexcept { --index_; return *this; }
+    constexpr static_deque_iterator operator++(int) noexcept { auto it = *this; ++index_; return it; }
+    constexpr static_deque_iterator operator--(int) noexcept { auto it = *this; --index_; return it; }
+    constexpr static_deque_iterator& operator+=(difference_type n) noexcept { index_ += n; return *this; }
+    constexpr static_deque_iterator& operator-=(difference_type n) noexcept { index_ -= n; return *this; }
+
+    friend constexpr static_deque_iterator operator+(static_deque_iterator it, difference_type n) noexcept
+    {
+        return it += n;
+    }
+    friend constexpr static_deque_iterator operator+(difference_type n, static_deque_iterator it) noexcept
+    {
+        return it += n;
+    }
+    friend constexpr static_deque_iterator operator-(static_deque_iterator it, difference_type n) noexcept
+    {
+        return it -= n;
+    }
+    friend constexpr difference_type operator-(const static_deque_iterator& a,
+                                               const static_deque_iterator& b) noexcept
+    {
+        return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+    }
+    friend constexpr bool operator==(const static_deque_iterator& a, const static_deque_iterator& b) noexcept
+    {
+        return a.index_ == b.index_;
+    }
+    friend constexpr bool operator!=(const static_deque_iterator& a, const static_deque_iterator& b) noexcept
+    {
+        return a.index_ != b.index_;
+    }
+    friend constexpr bool operator<(const static_deque_iterator& a, const static_deque_iterator& b) noexcept
+    {
+        return a.index_ < b.index_;
+    }
+    friend constexpr bool operator>(const static_deque_iterator& a, const static_deque_iterator& b) noexcept
+    {
+        return b < a;
+    }
+    friend constexpr bool operator<=(const static_deque_iterator& a, const static_deque_iterator& b) noexcept
+    {
+        return !(b < a);
+    }
+    friend constexpr bool operator>=(const static_deque_iterator& a, const static_deque_iterator& b) noexcept
+    {
+        return !(a < b);
+    }
+
+private:
+    template <typename, typename>
+    friend class static_deque_iterator;
+
+    Deque* deque_ = nullptr;
+    std::size_t index_ = 0;
+};
+
+} // namespace detail
+
+template <typename T, std::size_t N>
+class static_deque : private detail::static_deque_base<T, N> {
+    static_assert(N > 0, "static_deque capacity must be non-zero");
+
+    using base = detail::static_deque_base<T, N>;
+    using base::head_;
+    using base::size_;
+    using base::storage_;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = detail::static_deque_iterator<static_deque, T>;
+    using const_iterator = detail::static_deque_iterator<const static_deque, const T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr static_deque() noexcept = default;
+
+    constexpr static_deque(std::initializer_list<T> init)
+    {
+        EMBEC_ASSERT(init.size() <= N);
+        for (const T& value : init) {
+            storage_.construct(size_++, value);
+        }
+    }
+
+    static_deque(const static_deque& other) { copy_from(other); }
+
+    static_deque(static_deque&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        move_from(other);
+    }
+
+    static_deque& operator=(const static_deque& other)
+    {
+        if (this != &other) {
+            clear();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    static_deque& operator=(static_deque&& other) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other) {
+            clear();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    // ----------------------------------------------------------------- access
+
+    constexpr reference operator[](size_type index) noexcept
+    {
+        EMBEC_ASSERT(index < size_);
+        return storage_.data()[slot(index)];
+    }
+    constexpr const_reference operator[](size_type index) const noexcept
+    {
+        EMBEC_ASSERT(index < size_);
+        return storage_.data()[slot(index)];
+    }
+
+    constexpr reference front() noexcept { return (*this)[0]; }
+    constexpr const_reference front() const noexcept { return (*this)[0]; }
+    constexpr reference back() noexcept { return (*this)[size_ - 1]; }
+    constexpr const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+    constexpr iterator begin() noexcept { return {this, 0}; }
+    constexpr const_iterator begin() const noexcept { return {this, 0}; }
+    constexpr const_iterator cbegin() const noexcept { return {this, 0}; }
+    constexpr iterator end() noexcept { return {this, size_}; }
+    constexpr const_iterator end() const noexcept { return {this, size_}; }
+    constexpr const_iterator cend() const noexcept { return {this, size_}; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // --------------------------------------------------------------- capacity
+
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr bool full() const noexcept { return size_ == N; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    // -------------------------------------------------------------- modifiers
+
+    template <typename... Args>
+    constexpr reference emplace_back(Args&&... args)
+    {
+        EMBEC_ASSERT(size_ < N);
+        const size_type index = slot(size_);
+        storage_.construct(index, std::forward<Args>(args)...);
+        ++size_;
+        return storage_.data()[index];
+    }
+
+    template <typename... Args>
+    constexpr reference emplace_front(Args&&... args)
+    {
+        EMBEC_ASSERT(size_ < N);
+        const size_type index = head_ == 0 ? N - 1 : head_ - 1;
+        storage_.construct(index, std::forward<Args>(args)...);
+        head_ = index;
+        ++size_;
+        return storage_.data()[index];
+    }
+
+    constexpr void push_back(const T& value) { emplace_back(value); }
+    constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+    constexpr void push_front(const T& value) { emplace_front(value); }
+    constexpr void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    /// Appends @p value unless the deque is full. Returns false if full.
+    constexpr bool try_push_back(const T& value)
+    {
+        if (size_ == N) {
+            return false;
+        }
+        emplace_back(value);
+        return true;
+    }
+
+    /// Prepends @p value unless the deque is full. Returns false if full.
+    constexpr bool try_push_front(const T& value)
+    {
+        if (size_ == N) {
+            return false;
+        }
+        emplace_front(value);
+        return true;
+    }
+
+    constexpr void pop_front() noexcept
+    {
+        EMBEC_ASSERT(size_ > 0);
+        storage_.destroy(head_);
+        head_ = head_ + 1 == N ? 0 : head_ + 1;
+        --size_;
+    }
+
+    constexpr void pop_back() noexcept
+    {
+        EMBEC_ASSERT(size_ > 0);
+        storage_.destroy(slot(size_ - 1));
+        --size_;
+    }
+
+    void clear() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            while (size_) {
+                pop_back();
+            }
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    // Physical slot of the element at logical @p index (index <= N).
+    constexpr size_type slot(size_type index) const noexcept
+    {
+        const size_type s = head_ + index;
+        return s >= N ? s - N : s;
+    }
+
+    // Copies the elements of @p other into this empty deque as at most two
+    // contiguous runs, so trivially copyable types become two memcpy calls.
+    void copy_from(const static_deque& other)
+    {
+        const size_type first = std::min(other.size_, N - other.head_);
+        detail::uninitialized_copy_n(other.storage_.data() + other.head_, first,
+                                     storage_.data());
+        detail::uninitialized_copy_n(other.storage_.data(), other.size_ - first,
+                                     storage_.data() + first);
+        head_ = 0;
+        size_ = other.size_;
+    }
+
+    void move_from(static_deque& other)
+    {
+        const size_type first = std::min(other.size_, N - other.head_);
+        detail::uninitialized_move_n(other.storage_.data() + other.head_, first,
+                                     storage_.data());
+        detail::uninitialized_move_n(other.storage_.data(), other.size_ - first,
+                                     storage_.data() + first);
+        head_ = 0;
+        size_ = other.size_;
+    }
+};
+
+template <typename T, std::size_t N>
+bool operator==(const static_deque<T, N>& a, const static_deque<T, N>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, std::size_t N>
+bool operator!=(const static_deque<T, N>& a, const static_deque<T, N>& b)
+{
+    return !(a == b);
+}
+
+} // namespace embec
+
+#endif // EMBEC_STATIC_DEQUE_HPP
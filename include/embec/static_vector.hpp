@@ -0,0 +1,445 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file static_vector.hpp
+/// @brief Vector with fixed capacity and inline storage.
+///
+/// static_vector follows the std::vector interface where it makes sense for
+/// a container that never allocates. Exceeding the capacity is a
+/// precondition violation checked with EMBEC_ASSERT; the try_ variants
+/// report it instead. Moving a static_vector moves its elements one by one
+/// (there is no buffer to steal), and trivially copyable element types are
+/// copied, moved, inserted and erased with memcpy/memmove.
+///
+/// For trivial element types static_vector is a literal type, so it can be
+/// built and inspected in constant expressions:
+/// @code
+/// constexpr embec::static_vector<int, 4> primes{2, 3, 5, 7};
+/// static_assert(primes.back() == 7);
+/// @endcode
+
+#ifndef EMBEC_STATIC_VECTOR_HPP
+#define EMBEC_STATIC_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "embec/config.hpp"
+#include "embec/detail/inline_storage.hpp"
+
+namespace embec {
+
+namespace detail {
+
+template <typename T, std::size_t N, bool = std::is_trivially_destructible<T>::value>
+struct static_vector_base {
+    inline_storage<T, N> storage_;
+    std::size_t size_ = 0;
+};
+
+template <typename T, std::size_t N>
+struct static_vector_base<T, N, false> {
+    static_vector_base() = default;
+    static_vector_base(const static_vector_base&) = delete;
+    static_vector_base& operator=(const static_vector_base&) = delete;
+    ~static_vector_base() { destroy_n(storage_.data(), size_); }
+
+    inline_storage<T, N> storage_;
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+
+template <typename T, std::size_t N>
+class static_vector : private detail::static_vector_base<T, N> {
+    static_assert(N > 0, "static_vector capacity must be non-zero");
+
+    using base = detail::static_vector_base<T, N>;
+    using base::size_;
+    using base::storage_;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr static_vector() noexcept = default;
+
+    constexpr static_vector(std::initializer_list<T> init)
+    {
+        EMBEC_ASSERT(init.size() <= N);
+        for (const T& value : init) {
+            storage_.construct(size_++, value);
+        }
+    }
+
+    explicit static_vector(size_type count) { resize(count); }
+
+    static_vector(size_type count, const T& value) { assign(count, value); }
+
+    template <typename InputIt, typename = detail::require_input_iterator<InputIt>>
+    static_vector(InputIt first, InputIt last)
+    {
+        assign(first, last);
+    }
+
+    constexpr static_vector(const static_vector& other)
+    {
+        if constexpr (std::is_trivial<T>::value) {
+            for (; size_ < other.size_; ++size_) {
+                storage_.elems[size_] = other.storage_.elems[size_];
+            }
+        } else {
+            detail::uninitialized_copy_n(other.data(), other.size_, data());
+            size_ = other.size_;
+        }
+    }
+
+    constexpr static_vector(static_vector&& other) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+    {
+        if constexpr (std::is_trivial<T>::value) {
+            for (; size_ < other.size_; ++size_) {
+                storage_.elems[size_] = other.storage_.elems[size_];
+            }
+        } else {
+            detail::uninitialized_move_n(other.data(), other.size_, data());
+            size_ = other.size_;
+        }
+    }
+
+    static_vector& operator=(const static_vector& other)
+    {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    static_vector& operator=(static_vector&& other) noexcept(
+        std::is_nothrow_move_assignable<T>::value &&
+        std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other) {
+            const size_type common = std::min(size_, other.size_);
+            std::move(other.begin(), other.begin() + common, begin());
+            if (other.size_ > size_) {
+                detail::uninitialized_move_n(other.data() + common, other.size_ - common,
+                                             data() + common);
+            } else {
+                detail::destroy_n(data() + common, size_ - common);
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    static_vector& operator=(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(size_type count, const T& value)
+    {
+        EMBEC_ASSERT(count <= N);
+        clear();
+        for (; size_ < count; ++size_) {
+            storage_.construct(size_, value);
+        }
+    }
+
+    template <typename InputIt, typename = detail::require_input_iterator<InputIt>>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        if constexpr (detail::is_pointer_to<InputIt, T>) {
+            const auto count = static_cast<size_type>(last - first);
+            EMBEC_ASSERT(count <= N);
+            detail::uninitialized_copy_n(static_cast<const T*>(first), count, data());
+            size_ = count;
+        } else {
+            for (; first != last; ++first) {
+                EMBEC_ASSERT(size_ < N);
+                storage_.construct(size_++, *first);
+            }
+        }
+    }
+
+    // ----------------------------------------------------------------- access
+
+    constexpr T* data() noexcept { return storage_.data(); }
+    constexpr const T* data() const noexcept { return storage_.data(); }
+
+    constexpr reference operator[](size_type index) noexcept
+    {
+        EMBEC_ASSERT(index < size_);
+        return data()[index];
+    }
+    constexpr const_reference operator[](size_type index) const noexcept
+    {
+        EMBEC_ASSERT(index < size_);
+        return data()[index];
+    }
+
+    constexpr reference front() noexcept { return (*this)[0]; }
+    constexpr const_reference front() const noexcept { return (*this)[0]; }
+    constexpr reference back() noexcept { return (*this)[size_ - 1]; }
+    constexpr const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+    constexpr iterator begin() noexcept { return data(); }
+    constexpr const_iterator begin() const noexcept { return data(); }
+    constexpr const_iterator cbegin() const noexcept { return data(); }
+    constexpr iterator end() noexcept { return data() + size_; }
+    constexpr const_iterator end() const noexcept { return data() + size_; }
+    constexpr const_iterator cend() const noexcept { return data() + size_; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // --------------------------------------------------------------- capacity
+
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr bool full() const noexcept { return size_ == N; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    // -------------------------------------------------------------- modifiers
+
+    constexpr void push_back(const T& value)
+    {
+        EMBEC_ASSERT(size_ < N);
+        storage_.construct(size_++, value);
+    }
+
+    constexpr void push_back(T&& value)
+    {
+        EMBEC_ASSERT(size_ < N);
+        storage_.construct(size_++, std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr reference emplace_back(Args&&... args)
+    {
+        EMBEC_ASSERT(size_ < N);
+        storage_.construct(size_, std::forward<Args>(args)...);
+        return data()[size_++];
+    }
+
+    /// Appends @p value unless the vector is full. Returns false if full.
+    constexpr bool try_push_back(const T& value)
+    {
+        if (size_ == N) {
+            return false;
+        }
+        storage_.construct(size_++, value);
+        return true;
+    }
+
+    constexpr bool try_push_back(T&& value)
+    {
+        if (size_ == N) {
+            return false;
+        }
+        storage_.construct(size_++, std::move(value));
+        return true;
+    }
+
+    /// Constructs an element at the end unless the vector is full. Returns
+    /// the new element, or nullptr if full.
+    template <typename... Args>
+    constexpr T* try_emplace_back(Args&&... args)
+    {
+        if (size_ == N) {
+            return nullptr;
+        }
+        storage_.construct(size_, std::forward<Args>(args)...);
+        return &data()[size_++];
+    }
+
+    constexpr void pop_back() noexcept
+    {
+        EMBEC_ASSERT(size_ > 0);
+        storage_.destroy(--size_);
+    }
+
+    void clear() noexcept
+    {
+        detail::destroy_n(data(), size_);
+        size_ = 0;
+    }
+
+    void resize(size_type count)
+    {
+        EMBEC_ASSERT(count <= N);
+        if (count < size_) {
+            detail::destroy_n(data() + count, size_ - count);
+            size_ = count;
+        }
+        for (; size_ < count; ++size_) {
+            ::new (static_cast<void*>(data() + size_)) T();
+        }
+    }
+
+    void resize(size_type count, const T& value)
+    {
+        EMBEC_ASSERT(count <= N);
+        if (count < size_) {
+            detail::destroy_n(data() + count, size_ - count);
+            size_ = count;
+        }
+        for (; size_ < count; ++size_) {
+            storage_.construct(size_, value);
+        }
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        const size_type index = offset(pos);
+        EMBEC_ASSERT(size_ < N);
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            // Built before the gap opens because args may refer to elements.
+            const T value = detail::make_value<T>(std::forward<Args>(args)...);
+            open_gap(index, 1);
+            std::memcpy(static_cast<void*>(data() + index), &value, sizeof(T));
+            return data() + index;
+        } else {
+            storage_.construct(size_++, std::forward<Args>(args)...);
+            std::rotate(data() + index, data() + size_ - 1, data() + size_);
+            return data() + index;
+        }
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+        const size_type index = offset(pos);
+        EMBEC_ASSERT(count <= N - size_);
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            const T copy = value; // value may alias an element that moves
+            open_gap(index, count);
+            for (size_type i = 0; i < count; ++i) {
+                std::memcpy(static_cast<void*>(data() + index + i), &copy, sizeof(T));
+            }
+        } else {
+            const size_type old_size = size_;
+            for (size_type i = 0; i < count; ++i) {
+                storage_.construct(size_++, value);
+            }
+            std::rotate(data() + index, data() + old_size, data() + size_);
+        }
+        return data() + index;
+    }
+
+    template <typename InputIt, typename = detail::require_input_iterator<InputIt>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_type index = offset(pos);
+        if constexpr (detail::is_pointer_to<InputIt, T> &&
+                      std::is_trivially_copyable<T>::value) {
+            const auto count = static_cast<size_type>(last - first);
+            EMBEC_ASSERT(count <= N - size_);
+            open_gap(index, count);
+            detail::uninitialized_copy_n(static_cast<const T*>(first), count, data() + index);
+        } else {
+            const size_type old_size = size_;
+            for (; first != last; ++first) {
+                EMBEC_ASSERT(size_ < N);
+                storage_.construct(size_++, *first);
+            }
+            std::rotate(data() + index, data() + old_size, data() + size_);
+        }
+        return data() + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos) noexcept { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        const size_type index = offset(first);
+        const size_type count = static_cast<size_type>(last - first);
+        EMBEC_ASSERT(index + count <= size_);
+        detail::erase_gap(data(), size_, index, count);
+        size_ -= count;
+        return data() + index;
+    }
+
+    void swap(static_vector& other) noexcept(std::is_nothrow_swappable<T>::value &&
+                                             std::is_nothrow_move_constructible<T>::value)
+    {
+        static_vector& shorter = size_ < other.size_ ? *this : other;
+        static_vector& longer = size_ < other.size_ ? other : *this;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        const size_type common = shorter.size_;
+        detail::uninitialized_move_n(longer.data() + common, longer.size_ - common,
+                                     shorter.data() + common);
+        detail::destroy_n(longer.data() + common, longer.size_ - common);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    size_type offset(const_iterator pos) const noexcept
+    {
+        EMBEC_ASSERT(pos >= begin() && pos <= end());
+        return static_cast<size_type>(pos - begin());
+    }
+
+    // Moves the elements from @p index up by @p count. Only used for
+    // trivially copyable T, so the vacated slots need no destruction.
+    void open_gap(size_type index, size_type count) noexcept
+    {
+        if (size_ != index) {
+            std::memmove(static_cast<void*>(data() + index + count), data() + index,
+                         (size_ - index) * sizeof(T));
+        }
+        size_ += count;
+    }
+};
+
+template <typename T, std::size_t N>
+bool operator==(const static_vector<T, N>& a, const static_vector<T, N>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, std::size_t N>
+bool operator!=(const static_vector<T, N>& a, const static_vector<T, N>& b)
+{
+    return !(a == b);
+}
+
+template <typename T, std::size_t N>
+bool operator<(const static_vector<T, N>& a, const static_vector<T, N>& b)
+{
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template <typename T, std::size_t N>
+void swap(static_vector<T, N>& a, static_vector<T, N>& b) noexcept(noexcept(a.swap(b)))
+{
+    a.swap(b);
+}
+
+} // namespace embec
+
+#endif // EMBEC_STATIC_VECTOR_HPP
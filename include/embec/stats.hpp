@@ -0,0 +1,535 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file stats.hpp
+/// @brief Streaming statistics in constant memory: mean and variance,
+///        sliding-window minimum and maximum, and quantile estimates.
+///
+/// None of the accumulators keeps a sample history beyond its window:
+///  - running_stats tracks count, mean, variance, minimum and maximum with
+///    Welford's update, and merges partial results (for example from
+///    several blocks or channels) with Chan's formula;
+///  - sliding_min_max tracks the minimum and maximum of the last @p Window
+///    samples with a monotonic deque, amortised O(1) per sample;
+///  - p2_quantile estimates a quantile (median, 95th percentile, ...) with
+///    the P-square algorithm of Jain and Chlamtac, from five markers.
+///
+/// @code
+/// embec::running_stats<std::int16_t> adc_stats;
+/// embec::p2_quantile<std::int16_t> adc_p95(0.95f);
+/// adc_stats.add(block, block_length);
+/// adc_p95.add(block, block_length);
+/// float noise = adc_stats.stddev();
+/// @endcode
+///
+/// Samples may be integers, fixed-point numbers or floating point (see
+/// detail/sample_traits.hpp). Means, variances and quantiles are computed
+/// in @p Real, which defaults to float for integer and fixed-point samples
+/// and to the sample type otherwise.
+///
+/// running_stats::add() on a block summarises up to 256 samples at a time
+/// and merges the summary. For samples of up to 16 bits the block sums are
+/// exact integers, so the only rounding is in the merge; float and 16-bit
+/// samples use SSE2 on host builds (see EMBEC_SIMD_SSE2). Block results may
+/// differ from sample-by-sample ones in the last bits.
+
+#ifndef EMBEC_STATS_HPP
+#define EMBEC_STATS_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/sample_traits.hpp"
+#include "embec/static_deque.hpp"
+
+#if defined(EMBEC_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace embec {
+
+/// Count, mean, variance, minimum and maximum of a sample stream.
+template <typename T, typename Real = detail::default_real_t<T>>
+class running_stats {
+    using traits = detail::sample_traits<T>;
+    static_assert(std::is_floating_point<Real>::value, "Real must be a floating-point type");
+
+public:
+    using sample_type = T;
+    using real_type = Real;
+
+    constexpr running_stats() noexcept = default;
+
+    void add(T x) noexcept
+    {
+        const Real v = traits::template to_real<Real>(x);
+        ++count_;
+        if (count_ == 1) {
+            mean_ = v;
+            m2_ = 0;
+            min_ = max_ = x;
+            return;
+        }
+        const Real delta = v - mean_;
+        mean_ += delta / static_cast<Real>(count_);
+        m2_ += delta * (v - mean_);
+        min_ = x < min_ ? x : min_;
+        max_ = max_ < x ? x : max_;
+    }
+
+    /// Adds @p n samples.
+    void add(const T* x, std::size_t n) noexcept
+    {
+        while (n != 0) {
+            const std::size_t m = n < block_size ? n : block_size;
+            merge(summarize(x, m));
+            x += m;
+            n -= m;
+        }
+    }
+
+    /// Adds the samples summarised by @p other.
+    void merge(const running_stats& other) noexcept
+    {
+        if (other.count_ == 0) {
+            return;
+        }
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        const auto n_a = static_cast<Real>(count_);
+        const auto n_b = static_cast<Real>(other.count_);
+        const Real n = n_a + n_b;
+        const Real delta = other.mean_ - mean_;
+        mean_ += delta * (n_b / n);
+        m2_ += other.m2_ + delta * delta * (n_a / n * n_b);
+        count_ += other.count_;
+        min_ = other.min_ < min_ ? other.min_ : min_;
+        max_ = max_ < other.max_ ? other.max_ : max_;
+    }
+
+    void reset() noexcept { *this = running_stats(); }
+
+    std::uint32_t count() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+
+    /// Mean, or zero if no samples were added.
+    Real mean() const noexcept { return mean_; }
+    /// Population variance (divided by n).
+    Real variance() const noexcept { return count_ != 0 ? m2_ / static_cast<Real>(count_) : 0; }
+    /// Sample variance (divided by n - 1).
+    Real sample_variance() const noexcept
+    {
+        return count_ > 1 ? m2_ / static_cast<Real>(count_ - 1) : 0;
+    }
+    /// Population standard deviation.
+    Real stddev() const noexcept { return std::sqrt(variance()); }
+
+    T min() const noexcept
+    {
+        EMBEC_ASSERT(count_ != 0);
+        return min_;
+    }
+    T max() const noexcept
+    {
+        EMBEC_ASSERT(count_ != 0);
+        return max_;
+    }
+
+private:
+    static constexpr std::size_t block_size = 256;
+
+    /// Statistics of @p n (1 to block_size) samples.
+    static running_stats summarize(const T* x, std::size_t n) noexcept
+    {
+        running_stats s;
+        s.count_ = static_cast<std::uint32_t>(n);
+        T lo = x[0];
+        T hi = x[0];
+        std::size_t i = 0;
+        if constexpr (!traits::is_floating && traits::raw_bits <= 16) {
+            // Exact integer sums: n * sum(x^2) - sum(x)^2 stays below 2^49.
+            std::int64_t s1 = 0;
+            std::int64_t s2 = 0;
+#if defined(EMBEC_SIMD_SSE2)
+            if constexpr (traits::raw_bits == 16 && traits::is_signed) {
+                summarize_sse2_i16(x, n, i, s1, s2, lo, hi);
+            }
+#endif
+            for (; i < n; ++i) {
+                const std::int64_t r = traits::raw(x[i]);
+                s1 += r;
+                s2 += r * r;
+                lo = x[i] < lo ? x[i] : lo;
+                hi = hi < x[i] ? x[i] : hi;
+            }
+            const auto count = static_cast<std::int64_t>(n);
+            constexpr Real scale =
+                Real(1) / static_cast<Real>(std::int64_t{1} << traits::fraction_bits);
+            s.mean_ = static_cast<Real>(s1) * scale / static_cast<Real>(count);
+            s.m2_ = static_cast<Real>(s2 * count - s1 * s1) * (scale * scale) /
+                    static_cast<Real>(count);
+        } else {
+            // Sums of deviations from the first sample keep the cancellation
+            // in the second moment small.
+            const Real k = traits::template to_real<Real>(x[0]);
+            Real s1 = 0;
+            Real s2 = 0;
+#if defined(EMBEC_SIMD_SSE2)
+            if constexpr (std::is_same<T, float>::value && std::is_same<Real, float>::value) {
+                summarize_sse2_float(x, n, k, i, s1, s2, lo, hi);
+            }
+#endif
+            for (; i < n; ++i) {
+                const Real d = traits::template to_real<Real>(x[i]) - k;
+                s1 += d;
+                s2 += d * d;
+                lo = x[i] < lo ? x[i] : lo;
+                hi = hi < x[i] ? x[i] : hi;
+            }
+            const auto count = static_cast<Real>(n);
+            const Real m2 = s2 - s1 * s1 / count;
+            s.mean_ = k + s1 / count;
+            s.m2_ = m2 > 0 ? m2 : 0;
+        }
+        s.min_ = lo;
+        s.max_ = hi;
+        return s;
+    }
+
+#if defined(EMBEC_SIMD_SSE2)
+    static void summarize_sse2_i16(const T* x, std::size_t n, std::size_t& i, std::int64_t& s1,
+                                   std::int64_t& s2, T& lo, T& hi) noexcept
+    {
+        const std::size_t vector_end = n & ~std::size_t{7};
+        if (vector_end == 0) {
+            return;
+        }
+        // Pair sums of x fit 32 bits over a whole block. Pair sums of x^2
+        // reach 2^31 only for two -32768s, which wrap to INT32_MIN and are
+        // mapped back when widening, as in fixed.hpp's dot().
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i int_min = _mm_set1_epi32(INT32_MIN);
+        __m128i sum = _mm_setzero_si128();
+        __m128i squares = _mm_setzero_si128();
+        __m128i vlo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x));
+        __m128i vhi = vlo;
+        for (; i < vector_end; i += 8) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(v, ones));
+            const __m128i pairs = _mm_madd_epi16(v, v);
+            const __m128i high =
+                _mm_andnot_si128(_mm_cmpeq_epi32(pairs, int_min), _mm_srai_epi32(pairs, 31));
+            squares = _mm_add_epi64(squares, _mm_unpacklo_epi32(pairs, high));
+            squares = _mm_add_epi64(squares, _mm_unpackhi_epi32(pairs, high));
+            vlo = _mm_min_epi16(vlo, v);
+            vhi = _mm_max_epi16(vhi, v);
+        }
+        std::int32_t sums[4];
+        std::int64_t square_sums[2];
+        T lows[8];
+        T highs[8];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(square_sums), squares);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lows), vlo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(highs), vhi);
+        s1 = std::int64_t{sums[0]} + sums[1] + sums[2] + sums[3];
+        s2 = square_sums[0] + square_sums[1];
+        for (int lane = 0; lane < 8; ++lane) {
+            lo = lows[lane] < lo ? lows[lane] : lo;
+            hi = hi < highs[lane] ? highs[lane] : hi;
+        }
+    }
+
+    static void summarize_sse2_float(const T* x, std::size_t n, Real k, std::size_t& i, Real& s1,
+                                     Real& s2, T& lo, T& hi) noexcept
+    {
+        const std::size_t vector_end = n & ~std::size_t{3};
+        if (vector_end == 0) {
+            return;
+        }
+        const __m128 vk = _mm_set1_ps(k);
+        __m128 sum = _mm_setzero_ps();
+        __m128 squares = _mm_setzero_ps();
+        __m128 vlo = _mm_loadu_ps(x);
+        __m128 vhi = vlo;
+        for (; i < vector_end; i += 4) {
+            const __m128 v = _mm_loadu_ps(x + i);
+            const __m128 d = _mm_sub_ps(v, vk);
+            sum = _mm_add_ps(sum, d);
+            squares = _mm_add_ps(squares, _mm_mul_ps(d, d));
+            vlo = _mm_min_ps(vlo, v);
+            vhi = _mm_max_ps(vhi, v);
+        }
+        float sums[4];
+        float square_sums[4];
+        float lows[4];
+        float highs[4];
+        _mm_storeu_ps(sums, sum);
+        _mm_storeu_ps(square_sums, squares);
+        _mm_storeu_ps(lows, vlo);
+        _mm_storeu_ps(highs, vhi);
+        s1 = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        s2 = (square_sums[0] + square_sums[1]) + (square_sums[2] + square_sums[3]);
+        for (int lane = 0; lane < 4; ++lane) {
+            lo = lows[lane] < lo ? lows[lane] : lo;
+            hi = hi < highs[lane] ? highs[lane] : hi;
+        }
+    }
+#endif
+
+    std::uint32_t count_ = 0;
+    Real mean_ = 0;
+    Real m2_ = 0; ///< Sum of squared deviations from the mean.
+    T min_{};
+    T max_{};
+};
+
+/// Minimum and maximum of the last @p Window samples.
+template <typename T, std::size_t Window>
+class sliding_min_max {
+    static_assert(Window > 0, "Window must be non-zero");
+
+    struct entry {
+        T value;
+        std::uint32_t index;
+    };
+
+public:
+    using sample_type = T;
+
+    static constexpr std::size_t window() noexcept { return Window; }
+
+    void push(T x) noexcept
+    {
+        // Entries that left the window can only be at the fronts. Behind
+        // them, each deque keeps the samples that may still become the
+        // extreme: increasing values for the minimum, decreasing for the
+        // maximum.
+        if (!low_.empty() && next_ - low_.front().index >= Window) {
+            low_.pop_front();
+        }
+        if (!high_.empty() && next_ - high_.front().index >= Window) {
+            high_.pop_front();
+        }
+        while (!low_.empty() && !(low_.back().value < x)) {
+            low_.pop_back();
+        }
+        low_.push_back({x, next_});
+        while (!high_.empty() && !(x < high_.back().value)) {
+            high_.pop_back();
+        }
+        high_.push_back({x, next_});
+        ++next_;
+        size_ += size_ < Window;
+    }
+
+    /// Pushes @p n samples.
+    void push(const T* x, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            push(x[i]);
+        }
+    }
+
+    /// Pushes @p n samples and stores the window minimum and maximum after
+    /// each in @p min_out and @p max_out.
+    void process(const T* in, T* min_out, T* max_out, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            push(in[i]);
+            min_out[i] = low_.front().value;
+            max_out[i] = high_.front().value;
+        }
+    }
+
+    T min() const noexcept
+    {
+        EMBEC_ASSERT(size_ != 0);
+        return low_.front().value;
+    }
+    T max() const noexcept
+    {
+        EMBEC_ASSERT(size_ != 0);
+        return high_.front().value;
+    }
+
+    /// Samples in the window: the number pushed, up to Window.
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    bool full() const noexcept { return size_ == Window; }
+
+    void reset() noexcept
+    {
+        low_.clear();
+        high_.clear();
+        size_ = 0;
+    }
+
+private:
+    static_deque<entry, Window> low_;
+    static_deque<entry, Window> high_;
+    std::uint32_t next_ = 0; ///< Index of the next sample; wraps harmlessly.
+    std::size_t size_ = 0;
+};
+
+/// Estimate of the @p p quantile of a sample stream (P-square algorithm).
+///
+/// Five markers track the minimum, the p/2, p and (1+p)/2 quantiles and the
+/// maximum; each sample moves each marker by at most one position, along a
+/// parabola through its neighbours. Until five samples have been seen the
+/// quantile is exact. Since the markers move one position per sample, an
+/// estimate that starts far off (after unrepresentative first samples)
+/// converges only slowly; quantiles near the median are the most robust.
+template <typename T, typename Real = detail::default_real_t<T>>
+class p2_quantile {
+    using traits = detail::sample_traits<T>;
+    static_assert(std::is_floating_point<Real>::value, "Real must be a floating-point type");
+
+public:
+    using sample_type = T;
+    using real_type = Real;
+
+    /// @p p must be in (0, 1).
+    explicit p2_quantile(Real p) noexcept : p_(p)
+    {
+        EMBEC_ASSERT(p > 0 && p < 1);
+        reset();
+    }
+
+    void add(T sample) noexcept
+    {
+        const Real x = traits::template to_real<Real>(sample);
+        if (count_ < 5) {
+            // Insertion sort into the markers.
+            std::uint32_t i = count_++;
+            for (; i > 0 && x < height_[i - 1]; --i) {
+                height_[i] = height_[i - 1];
+            }
+            height_[i] = x;
+            return;
+        }
+        ++count_;
+
+        int k;
+        if (x < height_[0]) {
+            height_[0] = x;
+            k = 0;
+        } else if (!(x < height_[4])) {
+            height_[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (!(x < height_[k + 1])) {
+                ++k;
+            }
+        }
+        for (int i = k + 1; i < 5; ++i) {
+            ++position_[i];
+        }
+        for (int i = 0; i < 5; ++i) {
+            desired_[i] += increment(i);
+        }
+
+        for (int i = 1; i < 4; ++i) {
+            const Real d = desired_[i] - static_cast<Real>(position_[i]);
+            const bool up = d >= 1 && position_[i + 1] - position_[i] > 1;
+            const bool down = d <= -1 && position_[i] - position_[i - 1] > 1;
+            if (!up && !down) {
+                continue;
+            }
+            const int s = up ? 1 : -1;
+            const Real h = parabolic(i, s);
+            if (height_[i - 1] < h && h < height_[i + 1]) {
+                height_[i] = h;
+            } else {
+                const Real span =
+                    static_cast<Real>(position_[i + s]) - static_cast<Real>(position_[i]);
+                height_[i] += static_cast<Real>(s) * (height_[i + s] - height_[i]) / span;
+            }
+            position_[i] += static_cast<std::uint32_t>(s);
+        }
+    }
+
+    /// Adds @p n samples.
+    void add(const T* x, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            add(x[i]);
+        }
+    }
+
+    /// Current estimate; zero if no samples were added. Below five samples,
+    /// the sample of rank round(p * (count - 1)).
+    Real value() const noexcept
+    {
+        if (count_ >= 5) {
+            return height_[2];
+        }
+        if (count_ == 0) {
+            return 0;
+        }
+        const auto rank =
+            static_cast<std::uint32_t>(p_ * static_cast<Real>(count_ - 1) + Real(0.5));
+        return height_[rank];
+    }
+
+    Real quantile() const noexcept { return p_; }
+    std::uint32_t count() const noexcept { return count_; }
+
+    void reset() noexcept
+    {
+        count_ = 0;
+        for (int i = 0; i < 5; ++i) {
+            position_[i] = static_cast<std::uint32_t>(i + 1);
+            height_[i] = 0;
+        }
+        desired_[0] = 1;
+        desired_[1] = 1 + 2 * p_;
+        desired_[2] = 1 + 4 * p_;
+        desired_[3] = 3 + 2 * p_;
+        desired_[4] = 5;
+    }
+
+private:
+    Real increment(int i) const noexcept
+    {
+        switch (i) {
+        case 0:
+            return 0;
+        case 1:
+            return p_ / 2;
+        case 2:
+            return p_;
+        case 3:
+            return (1 + p_) / 2;
+        default:
+            return 1;
+        }
+    }
+
+    /// Piecewise-parabolic prediction for moving marker @p i by @p s.
+    Real parabolic(int i, int s) const noexcept
+    {
+        const auto n_prev = static_cast<Real>(position_[i - 1]);
+        const auto n = static_cast<Real>(position_[i]);
+        const auto n_next = static_cast<Real>(position_[i + 1]);
+        const auto ds = static_cast<Real>(s);
+        return height_[i] +
+               ds / (n_next - n_prev) *
+                   ((n - n_prev + ds) * (height_[i + 1] - height_[i]) / (n_next - n) +
+                    (n_next - n - ds) * (height_[i] - height_[i - 1]) / (n - n_prev));
+    }
+
+    Real p_;
+    std::uint32_t count_ = 0;
+    Real height_[5];            ///< Marker heights (sample values).
+    std::uint32_t position_[5]; ///< Marker positions, 1-based ranks.
+    Real desired_[5];           ///< Desired marker positions.
+};
+
+} // namespace embec
+
+#endif // EMBEC_STATS_HPP
@@ -0,0 +1,301 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file timer_wheel.hpp
+/// @brief Hierarchical timer wheel for large numbers of software timers.
+///
+/// Timers are intrusive nodes owned by the application (typically members
+/// of the objects they time out), so the wheel itself needs no storage per
+/// timer. Starting and stopping a timer is O(1). Each tick visits one slot;
+/// a timer further away than one wheel rotation waits in a coarser level
+/// and is moved down ("cascaded") at most once per level, so tick
+/// processing is amortised O(1) per timer.
+///
+/// For tickless operation, next_event() reports how many ticks may pass
+/// before the wheel needs attention, and advance() catches up after sleeping
+/// while skipping empty slots.
+///
+/// The wheel is a single-context object: tick(), advance(), start() and
+/// stop() must not run concurrently (call them from the same thread, or
+/// mask the tick interrupt around start/stop).
+
+#ifndef EMBEC_TIMER_WHEEL_HPP
+#define EMBEC_TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/bits.hpp"
+
+namespace embec {
+
+using tick_t = std::uint32_t;
+
+template <unsigned LevelBits, unsigned Levels>
+class timer_wheel;
+
+/// Intrusive timer node.
+class timer {
+public:
+    using callback_type = void (*)(timer&);
+
+    constexpr timer() noexcept = default;
+    constexpr explicit timer(callback_type callback, void* context = nullptr) noexcept
+        : callback_(callback), context_(context)
+    {
+    }
+
+    timer(const timer&) = delete;
+    timer& operator=(const timer&) = delete;
+
+    void set_callback(callback_type callback, void* context = nullptr) noexcept
+    {
+        callback_ = callback;
+        context_ = context;
+    }
+
+    void* context() const noexcept { return context_; }
+
+    /// True while the timer is armed.
+    bool active() const noexcept { return pprev_ != nullptr; }
+
+    /// Absolute tick at which the timer fires. Only meaningful while active.
+    tick_t expiry() const noexcept { return expires_; }
+
+    /// Reload interval of a periodic timer, 0 for one-shot timers.
+    tick_t period() const noexcept { return period_; }
+
+private:
+    template <unsigned, unsigned>
+    friend class timer_wheel;
+
+    timer* next_ = nullptr;
+    timer** pprev_ = nullptr; // address of the pointer that points here
+    tick_t expires_ = 0;
+    tick_t period_ = 0;
+    std::uint16_t slot_ = 0;
+    callback_type callback_ = nullptr;
+    void* context_ = nullptr;
+};
+
+/// Timer wheel with @p Levels levels of 2^@p LevelBits slots each.
+///
+/// Delays up to 2^(LevelBits * Levels) - 1 ticks are placed exactly; longer
+/// ones are parked in the last slot of the top level and re-placed when
+/// they are cascaded. The default covers 2^24 ticks (4.6 hours at 1 kHz)
+/// in 256 slot pointers. Delays must be below 2^31 ticks.
+template <unsigned LevelBits = 6, unsigned Levels = 4>
+class timer_wheel {
+    static_assert(LevelBits >= 1 && LevelBits <= 6, "LevelBits must be 1..6");
+    static_assert(Levels >= 1 && LevelBits * Levels <= 31,
+                  "wheel range must fit in 31 bits");
+
+public:
+    /// Returned by next_event() when no timer is armed.
+    static constexpr tick_t no_event = ~tick_t{0};
+
+    static constexpr unsigned slots_per_level = 1u << LevelBits;
+    static constexpr tick_t range = tick_t{1} << (LevelBits * Levels);
+
+    constexpr timer_wheel() noexcept = default;
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+
+    /// Current time in ticks.
+    tick_t now() const noexcept { return now_; }
+
+    /// Number of armed timers.
+    std::size_t size() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+
+    /// Arms @p t to fire after @p delay ticks (at least one), and then every
+    /// @p period ticks if @p period is non-zero. Re-arms an active timer.
+    void start(timer& t, tick_t delay, tick_t period = 0) noexcept
+    {
+        EMBEC_ASSERT(delay < 0x80000000u && period < 0x80000000u);
+        if (t.active()) {
+            unlink(t);
+        } else {
+            ++count_;
+        }
+        t.expires_ = now_ + (delay ? delay : 1);
+        t.period_ = period;
+        insert(t);
+    }
+
+    /// Disarms @p t. Returns false if it was not armed.
+    bool stop(timer& t) noexcept
+    {
+        if (!t.active()) {
+            return false;
+        }
+        unlink(t);
+        --count_;
+        return true;
+    }
+
+    /// Advances time by one tick and runs the callbacks of the timers that
+    /// expire. Returns the number of callbacks run.
+    std::size_t tick() noexcept
+    {
+        ++now_;
+        for (unsigned level = 1; level < Levels; ++level) {
+            if (index(now_, level - 1) != 0) {
+                break;
+            }
+            cascade(level, index(now_, level));
+        }
+        return expire(index(now_, 0));
+    }
+
+    /// Advances time by @p ticks, running expiring timers in order. Only
+    /// ticks at which something is due are processed individually.
+    std::size_t advance(tick_t ticks) noexcept
+    {
+        std::size_t fired = 0;
+        while (ticks) {
+            const tick_t until = next_event();
+            if (until > ticks) {
+                now_ += ticks;
+                break;
+            }
+            now_ += until - 1;
+            ticks -= until;
+            fired += tick();
+        }
+        return fired;
+    }
+
+    /// Number of ticks until the wheel next has work to do, or no_event.
+    ///
+    /// This is exact when the earliest timer is within one level-0 rotation.
+    /// For timers further away it is the tick at which their slot is
+    /// cascaded, which is never later than the expiry. A tickless system
+    /// sleeps for this long, then calls advance() with the elapsed ticks.
+    tick_t next_event() const noexcept
+    {
+        if (count_ == 0) {
+            return no_event;
+        }
+        tick_t best = no_event;
+        for (unsigned level = 0; level < Levels; ++level) {
+            const bitmap_t occupied = occupied_[level];
+            if (!occupied) {
+                continue;
+            }
+            // Distance in slots (1..slots_per_level) to the next occupied
+            // slot after the current one, wrapping around.
+            const unsigned current = index(now_, level);
+            const unsigned start = (current + 1) & slot_mask;
+            const unsigned distance =
+                detail::count_trailing_zeros(
+                    detail::rotate_right(occupied, start, slots_per_level)) + 1;
+            const unsigned shift = LevelBits * level;
+            const tick_t event = (((now_ >> shift) + distance) << shift) - now_;
+            if (event < best) {
+                best = event;
+            }
+        }
+        return best;
+    }
+
+private:
+    using bitmap_t = std::conditional_t<(LevelBits <= 5), std::uint32_t, std::uint64_t>;
+
+    static constexpr unsigned slot_mask = slots_per_level - 1;
+
+    static constexpr unsigned index(tick_t time, unsigned level) noexcept
+    {
+        return (time >> (LevelBits * level)) & slot_mask;
+    }
+
+    void insert(timer& t) noexcept
+    {
+        tick_t delta = t.expires_ - now_;
+        if (delta >= range) {
+            delta = range - 1;
+        }
+        unsigned level = 0;
+        while (level + 1 < Levels && delta >= (tick_t{1} << (LevelBits * (level + 1)))) {
+            ++level;
+        }
+        const unsigned slot = level * slots_per_level + index(now_ + delta, level);
+        timer*& head = slots_[slot];
+        t.next_ = head;
+        if (head) {
+            head->pprev_ = &t.next_;
+        }
+        head = &t;
+        t.pprev_ = &head;
+        t.slot_ = static_cast<std::uint16_t>(slot);
+        occupied_[level] |= bitmap_t{1} << (slot & slot_mask);
+    }
+
+    void unlink(timer& t) noexcept
+    {
+        // The slot becomes empty if t was its only timer.
+        if (!t.next_ && t.pprev_ == &slots_[t.slot_]) {
+            occupied_[t.slot_ >> LevelBits] &= ~(bitmap_t{1} << (t.slot_ & slot_mask));
+        }
+        *t.pprev_ = t.next_;
+        if (t.next_) {
+            t.next_->pprev_ = t.pprev_;
+        }
+        t.next_ = nullptr;
+        t.pprev_ = nullptr;
+    }
+
+    timer* detach(unsigned level, unsigned idx) noexcept
+    {
+        timer*& head = slots_[level * slots_per_level + idx];
+        timer* list = head;
+        head = nullptr;
+        occupied_[level] &= ~(bitmap_t{1} << idx);
+        return list;
+    }
+
+    void cascade(unsigned level, unsigned idx) noexcept
+    {
+        timer* t = detach(level, idx);
+        while (t) {
+            timer* next = t->next_;
+            insert(*t);
+            t = next;
+        }
+    }
+
+    std::size_t expire(unsigned idx) noexcept
+    {
+        // Move the due timers to a local list first so callbacks can start
+        // and stop any timer, including ones still waiting in this list.
+        timer* pending = detach(0, idx);
+        if (pending) {
+            pending->pprev_ = &pending;
+        }
+        std::size_t fired = 0;
+        while (pending) {
+            timer& t = *pending;
+            unlink(t);
+            if (t.period_) {
+                t.expires_ += t.period_;
+                insert(t);
+            } else {
+                --count_;
+            }
+            ++fired;
+            if (t.callback_) {
+                t.callback_(t);
+            }
+        }
+        return fired;
+    }
+
+    timer* slots_[Levels * slots_per_level]{};
+    bitmap_t occupied_[Levels]{};
+    tick_t now_ = 0;
+    std::size_t count_ = 0;
+};
+
+} // namespace embec
+
+#endif // EMBEC_TIMER_WHEEL_HPP
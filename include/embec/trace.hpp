@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file trace.hpp
+/// @brief Binary trace logging with host-side formatting.
+///
+/// EMBEC_TRACE(buffer, "format", args...) records a format-string ID, a
+/// timestamp and the raw argument words into a trace_buffer; nothing is
+/// formatted on the target. The format string and a signature of the
+/// argument types are emitted at compile time into a constant named
+/// `embec_trace_entry`, one per call site, and the ID is that constant's
+/// offset from embec::detail::trace_anchor. tools/embec_trace_decode.py
+/// finds the entries through the ELF symbol table and turns the drained
+/// records back into text:
+///
+/// @code
+/// embec::trace_buffer<1024> trace;           // one per core
+///
+/// EMBEC_TRACE(trace, "adc ch%u = %d mV", channel, millivolts);
+///
+/// // Background task: ship records to the host (UART, RTT, file...).
+/// std::uint8_t chunk[256];
+/// std::size_t n = trace.drain(chunk, sizeof(chunk));
+/// @endcode
+///
+/// $ tools/embec_trace_decode.py firmware.elf trace.bin
+///
+/// Arguments may be integers, enumerations, bool, float, double and
+/// pointers; strings cannot be deferred. The number of arguments is checked
+/// against the conversions in the format string at compile time.
+///
+/// A log call reserves space with one compare-and-swap and then performs
+/// plain word stores, so it is safe from any thread or interrupt handler and
+/// never blocks: when the buffer is full the record is dropped and counted.
+/// Give each core its own buffer to keep the reservation uncontended.
+/// drain() must be called from a single consumer context.
+
+#ifndef EMBEC_TRACE_HPP
+#define EMBEC_TRACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/cycle_counter.hpp"
+
+namespace embec {
+
+namespace detail {
+
+/// Reference point for format IDs.
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((used))
+#endif
+inline constexpr char trace_anchor[1] = {0};
+
+/// Signature code of one argument type; the host decoder knows the codes.
+template <typename T>
+constexpr char trace_code() noexcept
+{
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same<U, float>::value) {
+        return 'f';
+    } else if constexpr (std::is_same<U, double>::value) {
+        return 'd';
+    } else if constexpr (std::is_pointer<U>::value || std::is_null_pointer<U>::value) {
+        return sizeof(void*) == 8 ? 'P' : 'p';
+    } else if constexpr (std::is_enum<U>::value) {
+        return trace_code<std::underlying_type_t<U>>();
+    } else {
+        static_assert(std::is_integral<U>::value,
+                      "trace arguments must be integers, enums, floats or pointers");
+        if constexpr (sizeof(U) > 4) {
+            return std::is_signed<U>::value ? 'q' : 'Q';
+        } else {
+            return std::is_signed<U>::value ? 'i' : 'u';
+        }
+    }
+}
+
+template <typename T>
+constexpr std::size_t trace_words() noexcept
+{
+    const char code = trace_code<T>();
+    return code == 'd' || code == 'q' || code == 'Q' || code == 'P' ? 2 : 1;
+}
+
+constexpr std::size_t trace_length(const char* s) noexcept
+{
+    std::size_t n = 0;
+    while (s[n]) {
+        ++n;
+    }
+    return n;
+}
+
+/// Number of printf conversions in @p s ("%%" excluded).
+constexpr std::size_t trace_conversions(const char* s) noexcept
+{
+    std::size_t n = 0;
+    for (std::size_t i = 0; s[i]; ++i) {
+        if (s[i] == '%') {
+            if (s[i + 1] == '%') {
+                ++i;
+            } else {
+                ++n;
+            }
+        }
+    }
+    return n;
+}
+
+/// Signature, NUL, format string, NUL.
+template <std::size_t Size>
+struct trace_entry {
+    char text[Size];
+};
+
+template <std::size_t Size, typename Format, typename... Args>
+constexpr trace_entry<Size> make_trace_entry(Format format) noexcept
+{
+    trace_entry<Size> entry{};
+    const char signature[] = {trace_code<Args>()..., '\0'};
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < sizeof...(Args); ++i) {
+        entry.text[out++] = signature[i];
+    }
+    entry.text[out++] = '\0';
+    const char* text = format();
+    for (std::size_t i = 0; text[i]; ++i) {
+        entry.text[out++] = text[i];
+    }
+    return entry;
+}
+
+template <typename T>
+inline void trace_store(std::atomic<std::uint32_t>* words, std::uint32_t mask,
+                        std::uint32_t& pos, const T& value) noexcept
+{
+    using U = std::decay_t<T>;
+    // 64-bit values are split low word first, independent of endianness.
+    std::uint64_t bits;
+    if constexpr (std::is_pointer<U>::value || std::is_null_pointer<U>::value) {
+        bits = reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value));
+    } else if constexpr (std::is_same<U, float>::value) {
+        std::uint32_t narrow;
+        std::memcpy(&narrow, &value, sizeof(narrow));
+        bits = narrow;
+    } else if constexpr (std::is_same<U, double>::value) {
+        std::memcpy(&bits, &value, sizeof(bits));
+    } else if constexpr (trace_code<U>() == 'i') {
+        // Narrow signed values are sign-extended so the host sees an int32.
+        bits = static_cast<std::uint32_t>(static_cast<std::int32_t>(value));
+    } else {
+        bits = static_cast<std::uint64_t>(value);
+    }
+    const std::uint32_t parts[2] = {static_cast<std::uint32_t>(bits),
+                                    static_cast<std::uint32_t>(bits >> 32)};
+    for (std::size_t i = 0; i < trace_words<U>(); ++i) {
+        words[pos++ & mask].store(parts[i], std::memory_order_relaxed);
+    }
+}
+
+} // namespace detail
+
+/// Multi-producer, single-consumer trace record buffer of @p Words 32-bit
+/// words (a power of two).
+///
+/// Each record is a header word (0x80 | record length in words), the
+/// format ID, the low 32 bits of cycle_counter::now() and the argument
+/// words. The header is published last, so the consumer stops at a record
+/// that is still being written even if later ones are complete.
+template <std::size_t Words>
+class trace_buffer {
+    static_assert(Words >= 8 && (Words & (Words - 1)) == 0, "Words must be a power of two >= 8");
+
+public:
+    /// Format ID of the record reporting dropped records (one argument: the
+    /// number dropped).
+    static constexpr std::uint32_t dropped_id = 0xffffffffu;
+
+    constexpr trace_buffer() noexcept = default;
+    trace_buffer(const trace_buffer&) = delete;
+    trace_buffer& operator=(const trace_buffer&) = delete;
+
+    /// Used by EMBEC_TRACE; @p format returns the format string literal.
+    template <typename Format, typename... Args>
+    bool log(Format format, const char*, const Args&... args) noexcept
+    {
+        constexpr const char* text = format();
+        static_assert(detail::trace_conversions(text) == sizeof...(Args),
+                      "number of trace arguments does not match the format string");
+        constexpr std::size_t size = sizeof...(Args) + 2 + detail::trace_length(text);
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((used))
+#endif
+        static constexpr detail::trace_entry<size> embec_trace_entry =
+            detail::make_trace_entry<size, Format, Args...>(format);
+
+        constexpr std::size_t length = 3 + (detail::trace_words<Args>() + ... + 0);
+        static_assert(length < 0x80, "too many trace arguments");
+        std::uint32_t pos;
+        if (!reserve(length, pos)) {
+            return false;
+        }
+        const std::uint32_t start = pos++;
+        words_[pos++ & mask].store(
+            static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&embec_trace_entry) -
+                                       reinterpret_cast<std::uintptr_t>(detail::trace_anchor)),
+            std::memory_order_relaxed);
+        words_[pos++ & mask].store(static_cast<std::uint32_t>(cycle_counter::now()),
+                                   std::memory_order_relaxed);
+        (detail::trace_store(words_, mask, pos, args), ...);
+        words_[start & mask].store(0x80u | static_cast<std::uint32_t>(length),
+                                   std::memory_order_release);
+        return true;
+    }
+
+    /// Copies complete records, oldest first, to @p out as native-endian
+    /// words and frees their space. Records that do not fit entirely are
+    /// left for the next call. If records were dropped since the last call,
+    /// a dropped_id record follows the copied ones. Returns the number of
+    /// bytes written.
+    std::size_t drain(std::uint8_t* out, std::size_t capacity) noexcept
+    {
+        std::size_t written = 0;
+        std::uint32_t tail = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::uint32_t header = words_[tail & mask].load(std::memory_order_acquire);
+            if (header == 0) {
+                break;
+            }
+            const std::uint32_t length = header & 0x7fu;
+            if (capacity - written < length * sizeof(std::uint32_t)) {
+                break;
+            }
+            for (std::uint32_t i = 0; i < length; ++i) {
+                std::atomic<std::uint32_t>& word = words_[(tail + i) & mask];
+                const std::uint32_t value = word.load(std::memory_order_relaxed);
+                std::memcpy(out + written, &value, sizeof(value));
+                written += sizeof(value);
+                word.store(0, std::memory_order_relaxed);
+            }
+            tail += length;
+            tail_.store(tail, std::memory_order_release);
+        }
+        const std::uint32_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped && capacity - written >= 4 * sizeof(std::uint32_t)) {
+            dropped_.fetch_sub(dropped, std::memory_order_relaxed);
+            const std::uint32_t record[4] = {0x80u | 4u, dropped_id, 0, dropped};
+            std::memcpy(out + written, record, sizeof(record));
+            written += sizeof(record);
+        }
+        return written;
+    }
+
+    /// Records dropped because the buffer was full and not yet reported by
+    /// drain().
+    std::uint32_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    static constexpr std::size_t capacity() noexcept { return Words; }
+
+private:
+    static constexpr std::uint32_t mask = static_cast<std::uint32_t>(Words - 1);
+
+    bool reserve(std::size_t length, std::uint32_t& pos) noexcept
+    {
+        std::uint32_t head = head_.load(std::memory_order_relaxed);
+        do {
+            if (head - tail_.load(std::memory_order_acquire) + length > Words) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!head_.compare_exchange_weak(head, head + static_cast<std::uint32_t>(length),
+                                              std::memory_order_relaxed));
+        pos = head;
+        return true;
+    }
+
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<std::uint32_t> head_{0};
+    std::atomic<std::uint32_t> dropped_{0};
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<std::uint32_t> tail_{0};
+    alignas(EMBEC_CACHE_LINE_SIZE) std::atomic<std::uint32_t> words_[Words]{};
+};
+
+} // namespace embec
+
+#define EMBEC_TRACE_FIRST_(...) EMBEC_TRACE_FIRST_IMPL_(__VA_ARGS__, 0)
+#define EMBEC_TRACE_FIRST_IMPL_(first, ...) first
+
+/// Records "format", args... into @p buffer (a trace_buffer). Evaluates to
+/// false if the record was dropped.
+#define EMBEC_TRACE(buffer, ...) \
+    (buffer).log([] { return EMBEC_TRACE_FIRST_(__VA_ARGS__); }, __VA_ARGS__)
+
+#endif // EMBEC_TRACE_HPP
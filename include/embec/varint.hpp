@@ -0,0 +1,362 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file varint.hpp
+/// @brief LEB128 variable-length integers, zigzag mapping and delta /
+///        delta-of-delta codecs, with an SSE2 bulk decoder on host builds.
+///
+/// A varint stores 7 bits per byte, least significant group first, with
+/// the top bit set on every byte but the last (the protobuf encoding).
+/// Signed types are zigzag-mapped first (0, -1, 1, -2, ... become 0, 1, 2,
+/// 3, ...) so that small negative numbers stay short:
+///
+/// @code
+/// std::uint8_t buffer[64];
+/// const embec::frame_result r = embec::varint_encode_array(samples, 16, buffer, sizeof(buffer));
+/// ...
+/// std::int16_t decoded[16];
+/// if (!embec::varint_decode_array(buffer, r.length, decoded, 16)) {
+///     return false;
+/// }
+/// @endcode
+///
+/// Decoding rejects encodings longer than the type allows and values that
+/// do not fit; non-canonical padding within that length (0x80 0x00 for 0)
+/// is accepted, as protobuf does.
+///
+/// varint_delta_encode<1> stores the differences of consecutive values and
+/// varint_delta_encode<2> the differences of those (delta-of-delta), which
+/// turns regularly spaced timestamps into runs of one-byte zeros. The
+/// differences wrap in the width of the type, so every sequence round-trips.
+///
+/// With EMBEC_SIMD_SSE2 the bulk decoders of 32-bit values test the
+/// continuation bits of 16 input bytes at once and widen sixteen one-byte
+/// values (small counters, delta-of-delta timestamps) with four unpacks;
+/// blocks with longer values, and the final bytes of every buffer, go
+/// through the portable decoder, so results and errors are the same.
+
+#ifndef EMBEC_VARINT_HPP
+#define EMBEC_VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "embec/config.hpp"
+#include "embec/detail/bits.hpp"
+#include "embec/framing.hpp"
+
+#if defined(EMBEC_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace embec {
+
+/// Maps a signed integer to an unsigned one with small magnitudes first.
+template <typename T>
+constexpr std::make_unsigned_t<T> zigzag_encode(T value) noexcept
+{
+    static_assert(std::is_integral<T>::value && std::is_signed<T>::value,
+                  "zigzag_encode takes signed integers");
+    using U = std::make_unsigned_t<T>;
+    const auto u = static_cast<U>(value);
+    return static_cast<U>(static_cast<U>(u << 1) ^ (value < 0 ? static_cast<U>(~U{0}) : U{0}));
+}
+
+/// Inverse of zigzag_encode.
+template <typename U>
+constexpr std::make_signed_t<U> zigzag_decode(U value) noexcept
+{
+    static_assert(std::is_integral<U>::value && std::is_unsigned<U>::value,
+                  "zigzag_decode takes unsigned integers");
+    return static_cast<std::make_signed_t<U>>(
+        static_cast<U>((value >> 1) ^ static_cast<U>(U{0} - (value & 1u))));
+}
+
+/// Longest encoding of a value of type T (5 bytes for 32 bits, 10 for 64).
+template <typename T>
+constexpr std::size_t varint_max_size = (8 * sizeof(T) + 6) / 7;
+
+/// Bytes needed to encode @p value (unsigned; zigzag-map signed values
+/// first).
+constexpr std::size_t varint_size(std::uint64_t value) noexcept
+{
+    return value < 0x80 ? 1 : (detail::highest_bit(value) + 7) / 7;
+}
+
+namespace detail {
+
+template <typename T>
+using varint_unsigned = std::make_unsigned_t<T>;
+
+template <typename T>
+constexpr void check_varint_type() noexcept
+{
+    static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                  "varints hold integers");
+}
+
+/// Unsigned form in which @p value is encoded.
+template <typename T>
+constexpr varint_unsigned<T> varint_map(T value) noexcept
+{
+    if constexpr (std::is_signed<T>::value) {
+        return zigzag_encode(value);
+    } else {
+        return value;
+    }
+}
+
+template <typename T>
+constexpr T varint_unmap(varint_unsigned<T> value) noexcept
+{
+    if constexpr (std::is_signed<T>::value) {
+        return zigzag_decode(value);
+    } else {
+        return value;
+    }
+}
+
+/// Writes @p value, for which the caller has checked the room.
+template <typename U>
+inline std::size_t varint_put(U value, std::uint8_t* out) noexcept
+{
+    std::size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<std::uint8_t>(value | 0x80);
+        value = static_cast<U>(value >> 7);
+    }
+    out[n++] = static_cast<std::uint8_t>(value);
+    return n;
+}
+
+/// Reads one value of type U from [data, end). Returns the bytes consumed,
+/// or 0 with @p status set to incomplete or invalid.
+template <typename U>
+inline std::size_t varint_get(const std::uint8_t* data, const std::uint8_t* end, U& value,
+                              frame_status& status) noexcept
+{
+    constexpr std::size_t max_size = varint_max_size<U>;
+    // The bits of U left for the last possible byte.
+    constexpr unsigned last_bits = 8 * sizeof(U) - 7 * (max_size - 1);
+    const std::size_t available = static_cast<std::size_t>(end - data);
+    const std::size_t limit = available < max_size ? available : max_size;
+    U result = 0;
+    for (std::size_t i = 0; i < limit; ++i) {
+        const std::uint8_t byte = data[i];
+        result = static_cast<U>(result | static_cast<U>(static_cast<U>(byte & 0x7f) << (7 * i)));
+        if (byte < 0x80) {
+            if (i == max_size - 1 && byte >= (1u << last_bits)) {
+                break;
+            }
+            value = result;
+            return i + 1;
+        }
+    }
+    if (limit == max_size) {
+        status = frame_status::invalid;
+        return 0;
+    }
+    status = frame_status::incomplete;
+    return 0;
+}
+
+#if defined(EMBEC_SIMD_SSE2)
+/// Decodes up to @p count 32-bit values from @p data while at least 16
+/// bytes remain, advancing @p data. Stops at an error and leaves it to the
+/// caller's varint_get() to report. Returns the number of values decoded.
+inline std::size_t varint_decode_sse2(const std::uint8_t*& data, const std::uint8_t* end,
+                                      std::uint32_t* out, std::size_t count) noexcept
+{
+    const std::uint8_t* p = data;
+    std::size_t n = 0;
+    while (end - p >= 16 && n < count) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto continued = static_cast<unsigned>(_mm_movemask_epi8(bytes));
+        if (continued == 0 && count - n >= 16) {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            auto* o = reinterpret_cast<__m128i*>(out + n);
+            _mm_storeu_si128(o, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(o + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(o + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(o + 3, _mm_unpackhi_epi16(high, zero));
+            p += 16;
+            n += 16;
+            continue;
+        }
+        // Otherwise decode the values that start in these 16 bytes one by
+        // one; the next block may start with a run of one-byte values.
+        const std::uint8_t* const block_end = p + 16;
+        while (p < block_end && n < count) {
+            frame_status status;
+            const std::size_t length = varint_get(p, end, out[n], status);
+            if (length == 0) {
+                data = p;
+                return n;
+            }
+            p += length;
+            ++n;
+        }
+    }
+    data = p;
+    return n;
+}
+#endif
+
+/// Decodes @p count unsigned values.
+template <typename U>
+inline frame_result varint_decode_unsigned(const std::uint8_t* data, std::size_t length, U* out,
+                                           std::size_t count) noexcept
+{
+    const std::uint8_t* p = data;
+    const std::uint8_t* const end = data + length;
+    std::size_t i = 0;
+#if defined(EMBEC_SIMD_SSE2)
+    if constexpr (std::is_same<U, std::uint32_t>::value) {
+        i = varint_decode_sse2(p, end, out, count);
+    }
+#endif
+    frame_status status = frame_status::ok;
+    for (; i < count; ++i) {
+        const std::size_t n = varint_get(p, end, out[i], status);
+        if (n == 0) {
+            return {0, status};
+        }
+        p += n;
+    }
+    return {static_cast<std::size_t>(p - data), frame_status::ok};
+}
+
+} // namespace detail
+
+/// Encodes @p value into @p out. Returns the bytes written, or 0 if more
+/// than @p capacity are needed.
+template <typename T>
+inline std::size_t varint_encode(T value, std::uint8_t* out, std::size_t capacity) noexcept
+{
+    detail::check_varint_type<T>();
+    const auto u = detail::varint_map(value);
+    if (varint_size(u) > capacity) {
+        return 0;
+    }
+    return detail::varint_put(u, out);
+}
+
+/// Decodes one value from the @p length bytes at @p data. Returns the bytes
+/// consumed, or 0 if the input ends inside the value or it does not fit in
+/// T.
+template <typename T>
+inline std::size_t varint_decode(const std::uint8_t* data, std::size_t length, T& value) noexcept
+{
+    detail::check_varint_type<T>();
+    detail::varint_unsigned<T> u;
+    frame_status status;
+    const std::size_t n = detail::varint_get(data, data + length, u, status);
+    if (n != 0) {
+        value = detail::varint_unmap<T>(u);
+    }
+    return n;
+}
+
+/// Encodes @p count values. The result holds the bytes written, or
+/// overflow.
+template <typename T>
+inline frame_result varint_encode_array(const T* values, std::size_t count, std::uint8_t* out,
+                                        std::size_t capacity) noexcept
+{
+    detail::check_varint_type<T>();
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto u = detail::varint_map(values[i]);
+        // Check the room per value only near the end of the buffer.
+        if (EMBEC_UNLIKELY(capacity - written < varint_max_size<T> &&
+                           varint_size(u) > capacity - written)) {
+            return {0, frame_status::overflow};
+        }
+        written += detail::varint_put(u, out + written);
+    }
+    return {written, frame_status::ok};
+}
+
+/// Decodes exactly @p count values from the @p length bytes at @p data.
+/// The result holds the bytes consumed, or incomplete if the input ends
+/// first, or invalid if a value does not fit in T. @p out is unspecified
+/// on failure.
+template <typename T>
+inline frame_result varint_decode_array(const std::uint8_t* data, std::size_t length, T* out,
+                                        std::size_t count) noexcept
+{
+    detail::check_varint_type<T>();
+    using U = detail::varint_unsigned<T>;
+    // A signed type may be accessed through its unsigned counterpart.
+    auto* u = reinterpret_cast<U*>(out);
+    const frame_result result = detail::varint_decode_unsigned(data, length, u, count);
+    if constexpr (std::is_signed<T>::value) {
+        if (result) {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = zigzag_decode(u[i]);
+            }
+        }
+    }
+    return result;
+}
+
+/// Encodes the differences (Order 1) or the differences of differences
+/// (Order 2) of @p count values as zigzag varints, starting from zero. The
+/// result holds the bytes written, or overflow.
+template <unsigned Order, typename T>
+inline frame_result varint_delta_encode(const T* values, std::size_t count, std::uint8_t* out,
+                                        std::size_t capacity) noexcept
+{
+    static_assert(Order == 1 || Order == 2, "delta order must be 1 or 2");
+    detail::check_varint_type<T>();
+    using U = detail::varint_unsigned<T>;
+    using S = std::make_signed_t<T>;
+    U previous = 0;
+    U previous_delta = 0;
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto value = static_cast<U>(values[i]);
+        const auto delta = static_cast<U>(value - previous);
+        const auto residual = Order == 1 ? delta : static_cast<U>(delta - previous_delta);
+        previous = value;
+        previous_delta = delta;
+        const U u = zigzag_encode(static_cast<S>(residual));
+        if (EMBEC_UNLIKELY(capacity - written < varint_max_size<T> &&
+                           varint_size(u) > capacity - written)) {
+            return {0, frame_status::overflow};
+        }
+        written += detail::varint_put(u, out + written);
+    }
+    return {written, frame_status::ok};
+}
+
+/// Decodes @p count values written by varint_delta_encode<Order>. The
+/// result holds the bytes consumed, or incomplete or invalid as for
+/// varint_decode_array.
+template <unsigned Order, typename T>
+inline frame_result varint_delta_decode(const std::uint8_t* data, std::size_t length, T* out,
+                                        std::size_t count) noexcept
+{
+    static_assert(Order == 1 || Order == 2, "delta order must be 1 or 2");
+    detail::check_varint_type<T>();
+    using U = detail::varint_unsigned<T>;
+    auto* u = reinterpret_cast<U*>(out);
+    const frame_result result = detail::varint_decode_unsigned(data, length, u, count);
+    if (result) {
+        U previous = 0;
+        U previous_delta = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto residual = static_cast<U>(zigzag_decode(u[i]));
+            const auto delta = Order == 1 ? residual : static_cast<U>(previous_delta + residual);
+            previous = static_cast<U>(previous + delta);
+            previous_delta = delta;
+            out[i] = static_cast<T>(previous);
+        }
+    }
+    return result;
+}
+
+} // namespace embec
+
+#endif // EMBEC_VARINT_HPP
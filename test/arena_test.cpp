@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstring>
+#include <vector>
+
+#include "embec/arena.hpp"
+
+#include "test.hpp"
+
+#if EMBEC_HAS_PMR
+#include <new>
+#include <string>
+#include <string_view>
+#endif
+
+namespace {
+
+struct block {
+    unsigned char* data;
+    std::size_t size;
+    unsigned char fill;
+};
+
+struct frame {
+    embec::arena::checkpoint mark;
+    std::size_t blocks;
+    std::size_t used[2];
+};
+
+/// Whether @p size bytes aligned to @p align fit in what is left of @p a.
+bool fits(const embec::arena& a, const unsigned char* buffer, std::size_t size, std::size_t align)
+{
+    const auto next = reinterpret_cast<std::uintptr_t>(buffer) + a.used();
+    const std::size_t begin = a.used() + ((align - next % align) % align);
+    return begin + size <= a.capacity();
+}
+
+EMBEC_TEST(model, "arena/model")
+{
+    // Random allocations in a two-arena chain, with nested checkpoints
+    // rewound at random. Every live block must be aligned, inside one of
+    // the buffers, disjoint from the others and keep its contents.
+    embec::test::property(200, [](embec::test::rng& r) {
+        alignas(64) unsigned char secondary_memory[512];
+        alignas(64) unsigned char primary_memory[256];
+        embec::arena secondary(secondary_memory);
+        embec::arena primary(primary_memory, &secondary);
+        std::vector<block> live;
+        std::vector<frame> frames;
+        std::size_t failures = 0;
+        for (int step = 0; step < 200; ++step) {
+            if (r.chance(10)) {
+                frames.push_back({primary.mark(), live.size(), {primary.used(), secondary.used()}});
+            } else if (!frames.empty() && r.chance(10)) {
+                const frame f = frames.back();
+                frames.pop_back();
+                primary.rewind(f.mark);
+                live.resize(f.blocks);
+                EMBEC_REQUIRE(primary.used() == f.used[0] && secondary.used() == f.used[1]);
+            } else {
+                const std::size_t size = r.below(r.chance(20) ? 300 : 24);
+                const std::size_t align = std::size_t{1} << r.below(7);
+                const bool in_primary = fits(primary, primary_memory, size, align);
+                const bool in_secondary = fits(secondary, secondary_memory, size, align);
+                const std::size_t room = primary.remaining() + secondary.remaining();
+                auto* p = static_cast<unsigned char*>(primary.allocate(size, align));
+                if (p == nullptr) {
+                    EMBEC_REQUIRE(!in_primary && !in_secondary);
+                    ++failures;
+                    continue;
+                }
+                EMBEC_REQUIRE(reinterpret_cast<std::uintptr_t>(p) % align == 0);
+                // A zero-size block may sit one past the end of its buffer.
+                EMBEC_REQUIRE(size == 0 || (in_primary ? primary.owns(p)
+                                                       : in_secondary && secondary.owns(p)));
+                EMBEC_REQUIRE(in_primary || in_secondary);
+                EMBEC_REQUIRE(primary.remaining() + secondary.remaining() + size <= room);
+                const auto fill = static_cast<unsigned char>(r.next());
+                std::memset(p, fill, size);
+                live.push_back({p, size, fill});
+            }
+            for (const block& b : live) {
+                for (std::size_t k = 0; k < b.size; ++k) {
+                    EMBEC_REQUIRE(b.data[k] == b.fill);
+                }
+                EMBEC_REQUIRE(b.size == 0 ||
+                              primary.owns(b.data) == primary.owns(b.data + b.size - 1));
+            }
+        }
+        const embec::arena_stats s = primary.stats();
+        EMBEC_REQUIRE(s.failures == failures && s.capacity == sizeof(primary_memory));
+        EMBEC_REQUIRE(s.used == primary.used() && s.high_water >= s.used);
+        EMBEC_REQUIRE(secondary.stats().failures == failures);
+        primary.reset();
+        EMBEC_REQUIRE(primary.used() == 0 && secondary.used() == 0);
+    });
+}
+
+EMBEC_TEST(basics, "arena/basics")
+{
+    embec::static_arena<64, 16> a;
+    EMBEC_CHECK(a.capacity() == 64 && a.used() == 0 && a.remaining() == 64);
+    auto* c = static_cast<char*>(a.allocate(3, 1));
+    auto* i = a.create<std::uint32_t>(7u);
+    EMBEC_CHECK(c != nullptr && i != nullptr && *i == 7);
+    EMBEC_CHECK(reinterpret_cast<std::uintptr_t>(i) % alignof(std::uint32_t) == 0);
+    EMBEC_CHECK(reinterpret_cast<unsigned char*>(i) - reinterpret_cast<unsigned char*>(c) == 4);
+    EMBEC_CHECK(a.used() == 8);
+
+    // Fills exactly, then fails without a fallback.
+    EMBEC_CHECK(a.allocate_array<std::uint64_t>(7) != nullptr && a.remaining() == 0);
+    EMBEC_CHECK(a.allocate(1, 1) == nullptr);
+    EMBEC_CHECK(a.allocate_array<std::uint64_t>(static_cast<std::size_t>(-1) / 4) == nullptr);
+    EMBEC_CHECK(a.stats().failures == 2 && a.stats().high_water == 64);
+
+    a.reset();
+    a.reset_stats();
+    EMBEC_CHECK(a.used() == 0 && a.stats().high_water == 0 && a.stats().failures == 0);
+    EMBEC_CHECK(a.allocate(0) != nullptr && a.used() == 0);
+}
+
+EMBEC_TEST(scope, "arena/scope")
+{
+    alignas(8) unsigned char memory[128];
+    embec::arena a(memory);
+    a.allocate(10, 1);
+    {
+        embec::arena_scope outer(a);
+        a.allocate(20, 1);
+        {
+            embec::arena_scope inner(a);
+            a.allocate(30, 1);
+            EMBEC_CHECK(a.used() == 60);
+        }
+        EMBEC_CHECK(a.used() == 30);
+    }
+    EMBEC_CHECK(a.used() == 10 && a.stats().high_water == 60);
+}
+
+EMBEC_TEST(chain, "arena/chain")
+{
+    // Overflow goes down the chain; a scope on the head frees it too.
+    embec::static_arena<256> third;
+    embec::static_arena<64> second(&third);
+    embec::static_arena<16> first(&second);
+    EMBEC_CHECK(first.fallback() == &second && third.fallback() == nullptr);
+    {
+        embec::arena_scope scope(first);
+        void* a = first.allocate(16);
+        void* b = first.allocate(48);
+        void* c = first.allocate(100);
+        EMBEC_CHECK(first.owns(a) && second.owns(b) && third.owns(c));
+        EMBEC_CHECK(first.stats().overflows == 2 && second.stats().overflows == 1);
+        EMBEC_CHECK(first.allocate(1000) == nullptr);
+        EMBEC_CHECK(first.stats().failures == 1 && third.stats().failures == 1);
+    }
+    EMBEC_CHECK(first.used() == 0 && second.used() == 0 && third.used() == 0);
+
+    // An empty arena only forwards.
+    embec::arena forwarder(&third);
+    EMBEC_CHECK(forwarder.capacity() == 0 && third.owns(forwarder.allocate(8)));
+}
+
+#if EMBEC_HAS_PMR
+
+EMBEC_TEST(memory_resource, "arena/memory_resource")
+{
+    embec::static_arena<4096> a;
+    embec::arena_resource resource(a);
+    EMBEC_CHECK(resource.is_equal(resource) && &resource.get_arena() == &a);
+    {
+        embec::arena_scope scope(a);
+        std::pmr::vector<std::pmr::string> words(&resource);
+        for (int i = 0; i < 20; ++i) {
+            words.emplace_back(std::string(40, static_cast<char>('a' + i)));
+        }
+        EMBEC_CHECK(words.size() == 20 && std::string_view(words[19]) == std::string(40, 't'));
+        EMBEC_CHECK(a.owns(words.data()) && a.owns(words[3].data()));
+        EMBEC_CHECK(a.used() > 20 * 40);
+    }
+    EMBEC_CHECK(a.used() == 0);
+
+    // Exhaustion throws by default, or spills to an upstream resource.
+    bool threw = false;
+    try {
+        void* p = resource.allocate(8192);
+        EMBEC_CHECK(p == nullptr); // not reached
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    EMBEC_CHECK(threw);
+    embec::arena_resource spilling(a, std::pmr::new_delete_resource());
+    void* big = spilling.allocate(8192, 64);
+    EMBEC_CHECK(big != nullptr && !a.owns(big));
+    EMBEC_CHECK(reinterpret_cast<std::uintptr_t>(big) % 64 == 0);
+    spilling.deallocate(big, 8192, 64); // back to the heap (checked by ASan)
+    void* small = spilling.allocate(8);
+    EMBEC_CHECK(a.owns(small));
+    spilling.deallocate(small, 8);
+}
+
+#endif // EMBEC_HAS_PMR
+
+} // namespace
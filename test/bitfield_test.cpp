@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstring>
+
+#include "embec/bitfield.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using embec::byte_order;
+
+enum class mode : std::uint8_t { idle, run, fault = 7 };
+
+struct record {
+    std::uint8_t id;
+    std::int16_t temp;
+    bool alarm;
+    mode state;
+    std::uint64_t wide;
+    std::int32_t offset;
+    std::uint16_t reg;
+    std::int8_t tiny;
+};
+
+// Big-endian fields at awkward offsets, a 61-bit field spanning eight
+// bytes, and little-endian register-style fields.
+using layout = embec::bit_layout<20,
+    embec::bit_field<&record::id, 0, 4>,
+    embec::bit_field<&record::temp, 4, 12>,
+    embec::bit_field<&record::alarm, 23, 1>,
+    embec::bit_field<&record::state, 16, 3>,
+    embec::bit_field<&record::wide, 27, 61>,
+    embec::bit_field<&record::offset, 96, 23, byte_order::little>,
+    embec::bit_field<&record::reg, 121, 16, byte_order::little>,
+    embec::bit_field<&record::tiny, 140, 2, byte_order::little>>;
+
+/// Bit-at-a-time reference extraction following the numbering rules of
+/// bitfield.hpp.
+std::uint64_t reference_get(const std::uint8_t* data, std::size_t offset, std::size_t width,
+                            byte_order order)
+{
+    std::uint64_t value = 0;
+    for (std::size_t j = 0; j < width; ++j) {
+        const std::size_t k = offset + j;
+        if (order == byte_order::big) {
+            value = value << 1 | ((data[k / 8] >> (7 - k % 8)) & 1u);
+        } else {
+            value |= static_cast<std::uint64_t>((data[k / 8] >> (k % 8)) & 1u) << j;
+        }
+    }
+    return value;
+}
+
+std::int64_t sign_extend(std::uint64_t value, std::size_t width)
+{
+    const std::uint64_t sign = std::uint64_t{1} << (width - 1);
+    return static_cast<std::int64_t>((value ^ sign) - sign);
+}
+
+std::uint64_t low_bits(std::uint64_t value, std::size_t width)
+{
+    return width == 64 ? value : value & ((std::uint64_t{1} << width) - 1);
+}
+
+EMBEC_TEST(documented_example, "bitfield/documented_example")
+{
+    // id=0x5, temp=-2 (12 bits: 0xffe), alarm set in the last bit.
+    static constexpr std::uint8_t frame[3] = {0x5f, 0xfe, 0x01};
+    struct telemetry {
+        std::uint8_t id;
+        std::int16_t temp;
+        bool alarm;
+    };
+    using telemetry_layout = embec::bit_layout<3,
+        embec::bit_field<&telemetry::id, 0, 4>,
+        embec::bit_field<&telemetry::temp, 4, 12>,
+        embec::bit_field<&telemetry::alarm, 23, 1>>;
+    const telemetry t = telemetry_layout::unpack(frame);
+    EMBEC_CHECK(t.id == 5 && t.temp == -2 && t.alarm);
+    std::uint8_t out[3];
+    telemetry_layout::pack(t, out);
+    EMBEC_CHECK(std::memcmp(out, frame, 3) == 0);
+    static_assert(telemetry_layout::get<&telemetry::temp>(frame) == -2,
+                  "field access is constexpr");
+}
+
+EMBEC_TEST(matches_reference, "bitfield/matches_reference")
+{
+    embec::test::property(2000, [](embec::test::rng& r) {
+        std::uint8_t data[layout::size];
+        r.fill(data, sizeof(data));
+        const record rec = layout::unpack(data);
+        EMBEC_CHECK(rec.id == reference_get(data, 0, 4, byte_order::big));
+        EMBEC_CHECK(rec.temp == sign_extend(reference_get(data, 4, 12, byte_order::big), 12));
+        EMBEC_CHECK(rec.alarm == (reference_get(data, 23, 1, byte_order::big) != 0));
+        EMBEC_CHECK(static_cast<unsigned>(rec.state) ==
+                    reference_get(data, 16, 3, byte_order::big));
+        EMBEC_CHECK(rec.wide == reference_get(data, 27, 61, byte_order::big));
+        EMBEC_CHECK(rec.offset ==
+                    sign_extend(reference_get(data, 96, 23, byte_order::little), 23));
+        EMBEC_CHECK(rec.reg == reference_get(data, 121, 16, byte_order::little));
+        EMBEC_CHECK(rec.tiny == sign_extend(reference_get(data, 140, 2, byte_order::little), 2));
+        EMBEC_CHECK(layout::get<&record::wide>(data) == rec.wide);
+
+        // pack() reproduces every field bit and zeroes the rest.
+        std::uint8_t packed[layout::size];
+        std::memset(packed, 0xa5, sizeof(packed));
+        layout::pack(rec, packed);
+        const record again = layout::unpack(packed);
+        EMBEC_CHECK(std::memcmp(&again.wide, &rec.wide, sizeof(rec.wide)) == 0 &&
+                    again.offset == rec.offset && again.temp == rec.temp &&
+                    again.tiny == rec.tiny && again.reg == rec.reg);
+        EMBEC_CHECK(reference_get(packed, 19, 4, byte_order::big) == 0);
+        EMBEC_CHECK(reference_get(packed, 88, 8, byte_order::big) == 0);
+        EMBEC_CHECK(reference_get(packed, 142, 18, byte_order::little) == 0);
+    });
+}
+
+EMBEC_TEST(set_preserves_neighbours, "bitfield/set_preserves_neighbours")
+{
+    embec::test::property(2000, [](embec::test::rng& r) {
+        std::uint8_t data[layout::size];
+        r.fill(data, sizeof(data));
+        std::uint8_t before[layout::size];
+        std::memcpy(before, data, sizeof(data));
+
+        const std::uint64_t wide = r.next();
+        const auto offset = static_cast<std::int32_t>(r.range(-(1 << 22), (1 << 22) - 1));
+        layout::set<&record::wide>(data, wide);
+        layout::set<&record::offset>(data, offset);
+        EMBEC_CHECK(layout::get<&record::wide>(data) == low_bits(wide, 61));
+        EMBEC_CHECK(layout::get<&record::offset>(data) == offset);
+
+        // Every bit outside the two fields is unchanged. k counts in
+        // big-endian bit numbering; le is the same bit in little-endian
+        // numbering.
+        for (std::size_t k = 0; k < layout::size * 8; ++k) {
+            const std::size_t le = k / 8 * 8 + (7 - k % 8);
+            const bool in_wide = k >= 27 && k < 88;
+            const bool in_offset = le >= 96 && le < 119;
+            if (!in_wide && !in_offset) {
+                const unsigned bit = 7 - k % 8;
+                EMBEC_REQUIRE(((data[k / 8] ^ before[k / 8]) >> bit & 1u) == 0);
+            }
+        }
+    });
+}
+
+EMBEC_TEST(unpack_array, "bitfield/unpack_array")
+{
+    std::uint8_t records[layout::size * 37];
+    embec::test::rng r(42);
+    r.fill(records, sizeof(records));
+    std::int16_t temps[37];
+    layout::unpack_array<&record::temp>(records, 37, temps);
+    for (std::size_t i = 0; i < 37; ++i) {
+        EMBEC_CHECK(temps[i] == layout::get<&record::temp>(records + i * layout::size));
+    }
+}
+
+} // namespace
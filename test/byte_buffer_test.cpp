@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstring>
+#include <vector>
+
+#include "embec/byte_buffer.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using embec::byte_order;
+
+enum class kind : std::uint16_t { a = 1, b = 0x1234 };
+
+/// Reference encoding, one byte at a time.
+template <byte_order Order>
+void reference_put(std::vector<std::uint8_t>& out, std::uint64_t bits, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        const std::size_t shift = Order == byte_order::big ? 8 * (size - 1 - i) : 8 * i;
+        out.push_back(static_cast<std::uint8_t>(bits >> shift));
+    }
+}
+
+template <typename T>
+std::uint64_t bits_of(T value)
+{
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T)); // little-endian host
+    return bits;
+}
+
+EMBEC_TEST(known_layout, "byte_buffer/known_layout")
+{
+    std::uint8_t buf[16];
+    embec::be_writer w(buf);
+    w.write<std::uint16_t>(0x1234);
+    w.write<std::int32_t>(-2);
+    w.write(kind::b);
+    w.write(1.0f);
+    EMBEC_CHECK(w.ok() && w.position() == 12);
+    const std::uint8_t expected[] = {0x12, 0x34, 0xff, 0xff, 0xff, 0xfe,
+                                     0x12, 0x34, 0x3f, 0x80, 0x00, 0x00};
+    EMBEC_CHECK(std::memcmp(buf, expected, sizeof(expected)) == 0);
+
+    embec::le_reader r(buf, 12);
+    EMBEC_CHECK(r.read<std::uint16_t>() == 0x3412);
+    EMBEC_CHECK(r.peek<std::uint8_t>(3) == 0xfe && r.position() == 2);
+    EMBEC_CHECK(r.read<std::uint32_t>() == 0xfeffffffu);
+    EMBEC_CHECK(r.read<kind>() == static_cast<kind>(0x3412));
+    EMBEC_CHECK(r.remaining() == 4 && r.ok());
+}
+
+template <byte_order Order>
+void check_round_trip(embec::test::rng& r)
+{
+    // A random sequence of typed writes matches the reference bytes and
+    // reads back identically; array paths use random lengths and
+    // misaligned buffers.
+    std::vector<std::uint8_t> expected;
+    std::vector<std::uint8_t> storage(2048 + 8);
+    std::uint8_t* buf = storage.data() + r.below(8);
+    embec::byte_writer<Order> w(buf, 2048);
+    struct op {
+        unsigned type;
+        std::uint64_t bits;
+        std::size_t count;
+    };
+    std::vector<op> ops;
+    std::vector<std::uint16_t> u16s;
+    std::vector<std::uint32_t> u32s;
+    std::vector<std::uint64_t> u64s;
+    while (expected.size() < 1500) {
+        op o{static_cast<unsigned>(r.below(8)), r.next(), 1 + r.below(40)};
+        switch (o.type) {
+        case 0:
+            w.template write<std::uint8_t>(static_cast<std::uint8_t>(o.bits));
+            reference_put<Order>(expected, o.bits, 1);
+            break;
+        case 1:
+            w.template write<std::int16_t>(static_cast<std::int16_t>(o.bits));
+            reference_put<Order>(expected, o.bits, 2);
+            break;
+        case 2:
+            w.template write<std::uint32_t>(static_cast<std::uint32_t>(o.bits));
+            reference_put<Order>(expected, o.bits, 4);
+            break;
+        case 3:
+            w.template write<std::int64_t>(static_cast<std::int64_t>(o.bits));
+            reference_put<Order>(expected, o.bits, 8);
+            break;
+        case 4: {
+            double d;
+            std::memcpy(&d, &o.bits, sizeof(d));
+            w.write(d);
+            reference_put<Order>(expected, o.bits, 8);
+            break;
+        }
+        case 5: {
+            const std::size_t first = u16s.size();
+            for (std::size_t i = 0; i < o.count; ++i) {
+                u16s.push_back(static_cast<std::uint16_t>(r.next()));
+                reference_put<Order>(expected, u16s.back(), 2);
+            }
+            w.write_array(u16s.data() + first, o.count);
+            break;
+        }
+        case 6: {
+            const std::size_t first = u32s.size();
+            for (std::size_t i = 0; i < o.count; ++i) {
+                u32s.push_back(static_cast<std::uint32_t>(r.next()));
+                reference_put<Order>(expected, u32s.back(), 4);
+            }
+            w.write_array(u32s.data() + first, o.count);
+            break;
+        }
+        default: {
+            const std::size_t first = u64s.size();
+            for (std::size_t i = 0; i < o.count; ++i) {
+                u64s.push_back(r.next());
+                reference_put<Order>(expected, u64s.back(), 8);
+            }
+            w.write_array(u64s.data() + first, o.count);
+            break;
+        }
+        }
+        ops.push_back(o);
+    }
+    EMBEC_REQUIRE(w.ok() && w.position() == expected.size());
+    EMBEC_REQUIRE(std::memcmp(buf, expected.data(), expected.size()) == 0);
+
+    embec::byte_reader<Order> rd(buf, w.position());
+    std::size_t i16 = 0;
+    std::size_t i32 = 0;
+    std::size_t i64 = 0;
+    for (const op& o : ops) {
+        switch (o.type) {
+        case 0:
+            EMBEC_REQUIRE(rd.template read<std::uint8_t>() == static_cast<std::uint8_t>(o.bits));
+            break;
+        case 1:
+            EMBEC_REQUIRE(rd.template read<std::int16_t>() == static_cast<std::int16_t>(o.bits));
+            break;
+        case 2:
+            EMBEC_REQUIRE(rd.template read<std::uint32_t>() ==
+                          static_cast<std::uint32_t>(o.bits));
+            break;
+        case 3:
+            EMBEC_REQUIRE(rd.template read<std::int64_t>() == static_cast<std::int64_t>(o.bits));
+            break;
+        case 4:
+            EMBEC_REQUIRE(bits_of(rd.template read<double>()) == o.bits);
+            break;
+        case 5: {
+            std::uint16_t out[40];
+            EMBEC_REQUIRE(rd.read_array(out, o.count));
+            EMBEC_REQUIRE(std::memcmp(out, u16s.data() + i16, o.count * 2) == 0);
+            i16 += o.count;
+            break;
+        }
+        case 6: {
+            std::uint32_t out[40];
+            EMBEC_REQUIRE(rd.read_array(out, o.count));
+            EMBEC_REQUIRE(std::memcmp(out, u32s.data() + i32, o.count * 4) == 0);
+            i32 += o.count;
+            break;
+        }
+        default: {
+            std::uint64_t out[40];
+            EMBEC_REQUIRE(rd.read_array(out, o.count));
+            EMBEC_REQUIRE(std::memcmp(out, u64s.data() + i64, o.count * 8) == 0);
+            i64 += o.count;
+            break;
+        }
+        }
+    }
+    EMBEC_CHECK(rd.ok() && rd.empty());
+}
+
+EMBEC_TEST(round_trip, "byte_buffer/round_trip")
+{
+    embec::test::property(300, check_round_trip<byte_order::big>);
+    embec::test::property(300, check_round_trip<byte_order::little>);
+}
+
+EMBEC_TEST(overrun_is_sticky, "byte_buffer/overrun_is_sticky")
+{
+    const std::uint8_t data[6] = {1, 2, 3, 4, 5, 6};
+    embec::be_reader r(data);
+    EMBEC_CHECK(r.read<std::uint32_t>() == 0x01020304u);
+    EMBEC_CHECK(r.read<std::uint32_t>() == 0 && !r.ok());
+    // After a failure even a read that would have fit fails.
+    std::uint8_t b = 0xaa;
+    EMBEC_CHECK(!r.read(b) && b == 0xaa && r.remaining() == 0);
+    EMBEC_CHECK(r.bytes(0) != nullptr && r.bytes(1) == nullptr);
+
+    embec::le_reader a(data);
+    std::uint16_t out[4];
+    EMBEC_CHECK(!a.read_array(out, 4) && !a.ok() && a.position() == 0);
+
+    std::uint8_t buf[5];
+    embec::le_writer w(buf);
+    EMBEC_CHECK(w.write<std::uint32_t>(7) && !w.write<std::uint16_t>(8));
+    EMBEC_CHECK(!w.ok() && !w.write<std::uint8_t>(9) && w.position() == 4);
+    EMBEC_CHECK(w.reserve(0) != nullptr && w.reserve(1) == nullptr);
+
+    embec::be_writer empty;
+    EMBEC_CHECK(!empty.write<std::uint8_t>(1) && !empty.ok());
+    embec::be_reader none;
+    EMBEC_CHECK(none.read<std::uint8_t>() == 0 && !none.ok());
+}
+
+EMBEC_TEST(patch_and_sub, "byte_buffer/patch_and_sub")
+{
+    // Length-prefixed record written with patch() and parsed with sub().
+    std::uint8_t buf[32];
+    embec::be_writer w(buf);
+    w.write<std::uint16_t>(0);
+    w.write<std::uint8_t>(0xab);
+    w.fill(0xee, 3);
+    const std::uint8_t tail[] = {9, 8};
+    w.write_bytes(tail, 2);
+    EMBEC_CHECK(w.patch<std::uint16_t>(0, static_cast<std::uint16_t>(w.position() - 2)));
+    EMBEC_CHECK(!w.patch<std::uint32_t>(6, 0) && !w.ok()); // past the written part
+    EMBEC_CHECK(buf[0] == 0 && buf[1] == 6);
+
+    embec::be_reader r(buf, 8);
+    embec::be_reader body = r.sub(r.read<std::uint16_t>());
+    EMBEC_CHECK(r.ok() && r.empty());
+    EMBEC_CHECK(body.read<std::uint8_t>() == 0xab && body.skip(3));
+    std::uint8_t got[2];
+    EMBEC_CHECK(body.read_bytes(got, 2) && got[0] == 9 && got[1] == 8 && body.empty());
+    EMBEC_CHECK(!body.read_bytes(got, 1) && !body.ok());
+
+    embec::be_reader short_reader(buf, 3);
+    EMBEC_CHECK(!short_reader.sub(4).ok() && !short_reader.ok());
+}
+
+} // namespace
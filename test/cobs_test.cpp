@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "embec/cobs.hpp"
+#include "embec/spsc_ring.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using bytes = std::vector<std::uint8_t>;
+
+bytes encode(const bytes& in)
+{
+    bytes out(embec::cobs_max_encoded_size(in.size()));
+    const auto r = embec::cobs_encode(in.data(), in.size(), out.data(), out.size());
+    out.resize(r ? r.length : 0);
+    return out;
+}
+
+bytes sequence(std::size_t length, std::uint8_t first)
+{
+    bytes b(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        b[i] = static_cast<std::uint8_t>(first + i);
+    }
+    return b;
+}
+
+EMBEC_TEST(known_vectors, "cobs/known_vectors")
+{
+    // Examples from the COBS paper and its common test suites.
+    EMBEC_CHECK(encode({}) == bytes({0x01}));
+    EMBEC_CHECK(encode({0x00}) == bytes({0x01, 0x01}));
+    EMBEC_CHECK(encode({0x00, 0x00}) == bytes({0x01, 0x01, 0x01}));
+    EMBEC_CHECK(encode({0x11, 0x22, 0x00, 0x33}) == bytes({0x03, 0x11, 0x22, 0x02, 0x33}));
+    EMBEC_CHECK(encode({0x11, 0x22, 0x33, 0x44}) == bytes({0x05, 0x11, 0x22, 0x33, 0x44}));
+    EMBEC_CHECK(encode({0x11, 0x00, 0x00, 0x00}) == bytes({0x02, 0x11, 0x01, 0x01, 0x01}));
+
+    bytes expected = sequence(254, 0x01);
+    expected.insert(expected.begin(), 0xff);
+    EMBEC_CHECK(encode(sequence(254, 0x01)) == expected);
+
+    expected = sequence(254, 0x01);
+    expected.insert(expected.begin(), 0xff);
+    expected.insert(expected.begin(), 0x01);
+    EMBEC_CHECK(encode(sequence(255, 0x00)) == expected);
+}
+
+EMBEC_TEST(decode_rejects_malformed, "cobs/decode_rejects_malformed")
+{
+    std::uint8_t out[16];
+    const std::uint8_t zero_code[] = {0x00, 0x11};
+    EMBEC_CHECK(embec::cobs_decode(zero_code, 2, out, 16).status == embec::frame_status::invalid);
+    const std::uint8_t short_block[] = {0x05, 0x11, 0x22};
+    EMBEC_CHECK(embec::cobs_decode(short_block, 3, out, 16).status == embec::frame_status::invalid);
+    const std::uint8_t embedded_zero[] = {0x03, 0x11, 0x00};
+    EMBEC_CHECK(embec::cobs_decode(embedded_zero, 3, out, 16).status ==
+                embec::frame_status::invalid);
+    const std::uint8_t fits[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+    EMBEC_CHECK(embec::cobs_decode(fits, 5, out, 3).status == embec::frame_status::overflow);
+    EMBEC_CHECK(embec::cobs_decode(fits, 5, out, 4).length == 4);
+}
+
+EMBEC_TEST(encode_overflow, "cobs/encode_overflow")
+{
+    const bytes in = sequence(300, 0x01);
+    std::uint8_t out[400];
+    const std::size_t needed = encode(in).size();
+    EMBEC_CHECK(needed == embec::cobs_max_encoded_size(300));
+    EMBEC_CHECK(embec::cobs_encode(in.data(), in.size(), out, needed - 1).status ==
+                embec::frame_status::overflow);
+    EMBEC_CHECK(embec::cobs_encode(in.data(), in.size(), out, needed).length == needed);
+}
+
+EMBEC_TEST(round_trip, "cobs/round_trip")
+{
+    embec::test::property(2000, [](embec::test::rng& r) {
+        bytes in(r.below(700));
+        r.fill_biased(in.data(), in.size(), 0x00, 0xff);
+        const bytes enc = encode(in);
+        EMBEC_REQUIRE(!enc.empty() && enc.size() <= embec::cobs_max_encoded_size(in.size()));
+        EMBEC_CHECK(std::memchr(enc.data(), 0, enc.size()) == nullptr);
+
+        // Out of place, then in place.
+        bytes dec(in.size() + 1);
+        auto d = embec::cobs_decode(enc.data(), enc.size(), dec.data(), dec.size());
+        EMBEC_CHECK(d && d.length == in.size() && std::equal(in.begin(), in.end(), dec.begin()));
+        bytes inplace = enc;
+        d = embec::cobs_decode(inplace.data(), inplace.size(), inplace.data(), inplace.size());
+        EMBEC_CHECK(d && d.length == in.size() &&
+                    std::equal(in.begin(), in.end(), inplace.begin()));
+
+        // The byte-at-a-time encoder emits the same bytes plus a delimiter.
+        embec::cobs_encoder encoder;
+        encoder.begin(in.data(), in.size());
+        bytes streamed;
+        std::uint8_t byte;
+        while (encoder.next(byte)) {
+            streamed.push_back(byte);
+        }
+        bytes framed = enc;
+        framed.push_back(0);
+        EMBEC_CHECK(streamed == framed);
+        EMBEC_CHECK(!encoder.busy());
+    });
+}
+
+EMBEC_TEST(streaming_decoder, "cobs/streaming_decoder")
+{
+    embec::test::property(500, [](embec::test::rng& r) {
+        // Several frames with random chunking, extra delimiters and an
+        // occasional corrupted frame that must be skipped. An encoded empty
+        // frame is delivered; a bare delimiter is not.
+        std::vector<bytes> frames;
+        bytes stream;
+        std::vector<bool> valid;
+        const std::size_t count = 1 + r.below(6);
+        for (std::size_t f = 0; f < count; ++f) {
+            bytes in(r.below(300));
+            r.fill_biased(in.data(), in.size(), 0x00, 0x01);
+            bytes enc = encode(in);
+            bool ok = true;
+            if (r.chance(15) && enc.size() > 2 && enc.size() < 200) {
+                // The first block now runs past the delimiter.
+                enc[0] = static_cast<std::uint8_t>(enc.size() + 5);
+                ok = false;
+            }
+            if (r.chance(20)) {
+                stream.push_back(0);
+            }
+            stream.insert(stream.end(), enc.begin(), enc.end());
+            stream.push_back(0);
+            frames.push_back(in);
+            valid.push_back(ok);
+        }
+
+        std::uint8_t buffer[256];
+        embec::cobs_decoder decoder(buffer, sizeof(buffer));
+        std::vector<bytes> got;
+        std::size_t pos = 0;
+        while (pos < stream.size()) {
+            const std::size_t chunk = 1 + r.below(40);
+            const std::size_t n = chunk < stream.size() - pos ? chunk : stream.size() - pos;
+            embec::frame_status status;
+            const std::size_t used = decoder.push(stream.data() + pos, n, status);
+            EMBEC_REQUIRE(used >= 1 && used <= n);
+            pos += used;
+            if (status == embec::frame_status::ok) {
+                got.emplace_back(decoder.data(), decoder.data() + decoder.size());
+            }
+        }
+        std::vector<bytes> expected;
+        for (std::size_t f = 0; f < frames.size(); ++f) {
+            if (valid[f] && frames[f].size() <= sizeof(buffer)) {
+                expected.push_back(frames[f]);
+            }
+        }
+        EMBEC_CHECK(got == expected);
+    });
+}
+
+EMBEC_TEST(ring_write_and_decode, "cobs/ring_write_and_decode")
+{
+    embec::spsc_ring<std::uint8_t, 1024> ring;
+    std::uint8_t buffer[300];
+    embec::cobs_decoder decoder(buffer, sizeof(buffer));
+    embec::test::property(300, [&](embec::test::rng& r) {
+        bytes in(r.below(300));
+        r.fill_biased(in.data(), in.size(), 0x00, 0x00);
+        EMBEC_REQUIRE(embec::cobs_write(ring, in.data(), in.size()));
+        const embec::frame_status status = decoder.push(ring);
+        EMBEC_CHECK(status == embec::frame_status::ok && decoder.size() == in.size() &&
+                    std::equal(in.begin(), in.end(), decoder.data()));
+        EMBEC_CHECK(ring.empty());
+    });
+    // A frame that cannot fit is not written at all.
+    bytes big(1100, 1);
+    EMBEC_CHECK(!embec::cobs_write(ring, big.data(), big.size()));
+    EMBEC_CHECK(ring.empty());
+}
+
+} // namespace
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <vector>
+
+#include "embec/crc.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using embec::crc_strategy;
+
+constexpr std::uint8_t check_input[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+// Check values from the CRC RevEng catalogue.
+using crc5_usb = embec::crc_spec<5, 0x05, 0x1f, true, true, 0x1f>;
+using crc24_openpgp = embec::crc_spec<24, 0x864cfb, 0xb704ce, false, false, 0x000000>;
+
+static_assert(embec::crc_engine<embec::crc_catalog::crc32>::compute(check_input, 9) ==
+                  0xcbf43926,
+              "CRC tables and computation are usable in constant expressions");
+
+template <typename Spec, crc_strategy Strategy>
+bool check_value(std::uint64_t expected)
+{
+    return embec::crc_engine<Spec, Strategy>::compute(check_input, sizeof(check_input)) ==
+           expected;
+}
+
+template <typename Spec>
+void check_all_strategies(std::uint64_t expected)
+{
+    EMBEC_CHECK((check_value<Spec, crc_strategy::bitwise>(expected)));
+    EMBEC_CHECK((check_value<Spec, crc_strategy::nibble>(expected)));
+    EMBEC_CHECK((check_value<Spec, crc_strategy::byte>(expected)));
+    EMBEC_CHECK((check_value<Spec, crc_strategy::slice8>(expected)));
+}
+
+EMBEC_TEST(catalogue, "crc/catalogue")
+{
+    namespace cat = embec::crc_catalog;
+    check_all_strategies<cat::crc8_smbus>(0xf4);
+    check_all_strategies<cat::crc8_maxim>(0xa1);
+    check_all_strategies<cat::crc7_mmc>(0x75);
+    check_all_strategies<cat::crc16_ccitt_false>(0x29b1);
+    check_all_strategies<cat::crc16_xmodem>(0x31c3);
+    check_all_strategies<cat::crc16_kermit>(0x2189);
+    check_all_strategies<cat::crc16_modbus>(0x4b37);
+    check_all_strategies<cat::crc32>(0xcbf43926);
+    check_all_strategies<cat::crc32c>(0xe3069283);
+    check_all_strategies<cat::crc32_mpeg2>(0x0376e6e7);
+    check_all_strategies<cat::crc64_xz>(0x995dc9bbdf1939fa);
+    check_all_strategies<crc5_usb>(0x19);
+    check_all_strategies<crc24_openpgp>(0x21cf02);
+}
+
+template <typename Spec>
+void check_incremental(embec::test::rng& r)
+{
+    // Every strategy agrees with the bitwise reference on random data fed
+    // in random pieces, including unaligned starts.
+    std::vector<std::uint8_t> data(1 + r.below(300));
+    r.fill(data.data(), data.size());
+    const auto expected = embec::crc_engine<Spec, crc_strategy::bitwise>::compute(
+        data.data(), data.size());
+    embec::crc_engine<Spec, crc_strategy::nibble> nibble;
+    embec::crc_engine<Spec, crc_strategy::byte> byte;
+    embec::crc_engine<Spec, crc_strategy::slice8> slice8;
+    std::size_t pos = 0;
+    while (pos < data.size()) {
+        const std::size_t n = r.below(data.size() - pos + 1);
+        nibble.update(data.data() + pos, n);
+        byte.update(data.data() + pos, n);
+        slice8.update(data.data() + pos, n);
+        pos += n;
+    }
+    EMBEC_CHECK(nibble.value() == expected);
+    EMBEC_CHECK(byte.value() == expected);
+    EMBEC_CHECK(slice8.value() == expected);
+
+    // value() leaves the engine untouched; reset() restarts it.
+    slice8.reset();
+    EMBEC_CHECK(slice8.value() ==
+                (embec::crc_engine<Spec, crc_strategy::slice8>::compute(data.data(), 0)));
+}
+
+EMBEC_TEST(strategies_agree, "crc/strategies_agree")
+{
+    namespace cat = embec::crc_catalog;
+    embec::test::property(200, check_incremental<cat::crc7_mmc>);
+    embec::test::property(200, check_incremental<cat::crc16_kermit>);
+    embec::test::property(200, check_incremental<cat::crc32_mpeg2>);
+    embec::test::property(200, check_incremental<cat::crc32c>);
+    embec::test::property(200, check_incremental<cat::crc64_xz>);
+    embec::test::property(200, check_incremental<crc5_usb>);
+}
+
+} // namespace
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "embec/cycle_counter.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+EMBEC_TEST(advances, "cycle_counter/advances")
+{
+    embec::cycle_counter::enable();
+    embec::cycle_counter::enable();
+    EMBEC_CHECK(std::strlen(embec::cycle_counter::name()) > 0);
+
+    // Readings on one thread never go backwards, and time passing shows.
+    embec::cycles_t previous = embec::cycle_counter::now();
+    const embec::cycles_t first = previous;
+    for (int i = 0; i < 100000; ++i) {
+        const embec::cycles_t now = embec::cycle_counter::now();
+        EMBEC_REQUIRE(static_cast<embec::cycles_t>(now - previous) <= ~embec::cycles_t{0} / 2);
+        previous = now;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EMBEC_CHECK(embec::cycle_counter::now() != first);
+}
+
+} // namespace
@@ -0,0 +1,247 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+#include "embec/filter.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+template <typename T, std::size_t Window>
+void check_moving_average()
+{
+    embec::test::property(100, [](embec::test::rng& r) {
+        embec::moving_average<T, Window> filter;
+        std::deque<std::int64_t> model;
+        T in[32];
+        T out[32];
+        for (int step = 0; step < 100; ++step) {
+            const std::size_t n = 1 + r.below(32);
+            for (std::size_t i = 0; i < n; ++i) {
+                in[i] = static_cast<T>(r.range(-32768, 32767));
+            }
+            filter.process(in, out, n);
+            for (std::size_t i = 0; i < n; ++i) {
+                model.push_back(in[i]);
+                if (model.size() > Window) {
+                    model.pop_front();
+                }
+                std::int64_t sum = 0;
+                for (std::int64_t x : model) {
+                    sum += x;
+                }
+                const auto size = static_cast<std::int64_t>(model.size());
+                EMBEC_REQUIRE(out[i] == static_cast<T>(embec::detail::div_round(sum, size)));
+            }
+        }
+    });
+}
+
+EMBEC_TEST(moving_average, "filter/moving_average")
+{
+    check_moving_average<std::int16_t, 1>();
+    check_moving_average<std::int16_t, 8>();
+    check_moving_average<std::int32_t, 13>();
+
+    // Fixed point averages exactly; rounding is to nearest, halves away
+    // from zero.
+    embec::moving_average<embec::q15, 4> q;
+    EMBEC_CHECK(q.value() == embec::q15(0.0) && q.size() == 0);
+    q.process(embec::q15::from_raw(3));
+    EMBEC_CHECK(q.process(embec::q15::from_raw(-8)).raw() == -3);
+    q.reset();
+    EMBEC_CHECK(q.process(embec::q15(0.5)) == embec::q15(0.5));
+
+    // Floating point does not drift over many windows.
+    embec::moving_average<float, 10> f;
+    for (int i = 0; i < 100000; ++i) {
+        f.process(i % 2 ? 1e4f : 1e-3f);
+    }
+    for (int i = 0; i < 10; ++i) {
+        f.process(0.25f);
+    }
+    EMBEC_CHECK(f.value() == 0.25f && f.size() == 10);
+}
+
+EMBEC_TEST(exponential_average, "filter/exponential_average")
+{
+    // Integer and fixed-point outputs settle exactly on a step.
+    embec::exponential_average<std::int16_t> slow(0.01);
+    EMBEC_CHECK(slow.process(-1000) == -1000); // starts from the first sample
+    std::int16_t y = 0;
+    int steps = 0;
+    for (; y != 1000 && steps < 5000; ++steps) {
+        y = slow.process(1000);
+    }
+    EMBEC_CHECK(y == 1000 && steps > 300);
+
+    embec::exponential_average<embec::q15> q(0.25);
+    q.process(embec::q15(0.0));
+    EMBEC_CHECK(q.process(embec::q15(0.5)) == embec::q15(0.125));
+    for (int i = 0; i < 200; ++i) {
+        q.process(embec::q15::lowest());
+    }
+    EMBEC_CHECK(q.value() == embec::q15::lowest());
+
+    embec::exponential_average<std::int32_t> wide(0.5);
+    wide.process(INT32_MAX);
+    EMBEC_CHECK(wide.process(INT32_MIN) == 0);
+    for (int i = 0; i < 100; ++i) {
+        wide.process(INT32_MIN);
+    }
+    EMBEC_CHECK(wide.value() == INT32_MIN);
+
+    // Floating point follows the recurrence; alpha = 1 passes the input.
+    embec::exponential_average<double> d(0.5);
+    const double in[] = {4, 0, 0, 8};
+    double out[4];
+    d.process(in, out, 4);
+    EMBEC_CHECK(out[0] == 4 && out[1] == 2 && out[2] == 1 && out[3] == 4.5);
+    embec::exponential_average<float> pass(1);
+    EMBEC_CHECK(pass.process(3) == 3 && pass.process(-7) == -7);
+    pass.reset();
+    EMBEC_CHECK(pass.value() == 0);
+}
+
+/// Double-precision direct form I with the same coefficients.
+struct reference_biquad {
+    embec::biquad_coefficients c;
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    double process(double x)
+    {
+        const double y = c.b0 * x + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        return y;
+    }
+};
+
+template <typename T>
+void check_biquad(const embec::biquad_coefficients& c, double scale, double tolerance)
+{
+    embec::test::property(30, [&](embec::test::rng& r) {
+        embec::biquad<T> filter(c);
+        reference_biquad reference{c};
+        std::vector<T> in(2000);
+        for (T& x : in) {
+            // Random steps with noise: a signal the filter has to follow,
+            // small enough that the high-pass overshoot does not saturate.
+            x = static_cast<T>((r.chance(1) ? r.range(-20000, 20000) : 0) * scale);
+        }
+        T level = 0;
+        for (T& x : in) {
+            level = x != 0 ? x : level;
+            x = static_cast<T>(level / 4 + r.range(-2000, 2000) * scale);
+        }
+        std::vector<T> out(in.size());
+        filter.process(in.data(), out.data(), in.size());
+        double worst = 0;
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            worst = std::max(worst, std::fabs(static_cast<double>(out[i]) -
+                                              reference.process(static_cast<double>(in[i]))));
+        }
+        EMBEC_REQUIRE(worst <= tolerance * scale);
+    });
+}
+
+EMBEC_TEST(biquad, "filter/biquad")
+{
+    const auto lowpass = embec::biquad_coefficients::lowpass(50, 1000);
+    const auto highpass = embec::biquad_coefficients::highpass(10, 1000, 2);
+    // Integer filters truncate each output, and the error recirculates
+    // through the feedback, with a gain that grows as the poles approach the
+    // unit circle. Float errors are relative to signals of about 2^13.
+    check_biquad<std::int16_t>(lowpass, 1, 4);
+    check_biquad<std::int16_t>(highpass, 1, 20);
+    check_biquad<std::int32_t>(lowpass, 1000, 0.01);
+    check_biquad<float>(lowpass, 1, 0.1);
+    check_biquad<double>(highpass, 1, 1e-9);
+
+    // Unity DC gain: a constant input comes out unchanged.
+    embec::biquad<embec::q15> q(lowpass);
+    embec::q15 y;
+    for (int i = 0; i < 1000; ++i) {
+        y = q.process(embec::q15(0.5));
+    }
+    EMBEC_CHECK(y == embec::q15(0.5));
+    q.reset();
+    EMBEC_CHECK(q.process(embec::q15(0.0)) == embec::q15(0.0));
+}
+
+template <typename T, std::size_t Window>
+void check_median_filter()
+{
+    embec::test::property(100, [](embec::test::rng& r) {
+        embec::median_filter<T, Window> filter;
+        std::deque<T> model;
+        T in[16];
+        T out[16];
+        for (int step = 0; step < 100; ++step) {
+            const std::size_t n = 1 + r.below(16);
+            for (std::size_t i = 0; i < n; ++i) {
+                in[i] = static_cast<T>(r.below(r.chance(50) ? 4 : 1000)); // with duplicates
+            }
+            if (r.chance(5)) {
+                filter.reset();
+                model.clear();
+            }
+            filter.process(in, out, n);
+            for (std::size_t i = 0; i < n; ++i) {
+                model.push_back(in[i]);
+                if (model.size() > Window) {
+                    model.pop_front();
+                }
+                std::vector<T> sorted(model.begin(), model.end());
+                std::sort(sorted.begin(), sorted.end());
+                EMBEC_REQUIRE(out[i] == sorted[(sorted.size() - 1) / 2]);
+            }
+            EMBEC_REQUIRE(filter.size() == model.size());
+        }
+    });
+}
+
+EMBEC_TEST(median_filter, "filter/median_filter")
+{
+    check_median_filter<int, 1>();
+    check_median_filter<int, 3>();
+    check_median_filter<float, 9>();
+
+    // A single spike disappears.
+    embec::median_filter<embec::q15, 3> despike;
+    EMBEC_CHECK(despike.value() == embec::q15(0.0));
+    despike.process(embec::q15(0.25));
+    despike.process(embec::q15(0.25));
+    EMBEC_CHECK(despike.process(embec::q15::max()) == embec::q15(0.25));
+    EMBEC_CHECK(despike.process(embec::q15(0.25)) == embec::q15(0.25));
+}
+
+EMBEC_TEST(debouncer, "filter/debouncer")
+{
+    embec::debouncer<3> button;
+    EMBEC_CHECK(!button.state() && !button.changed());
+    // Bounces shorter than three samples are absorbed.
+    const bool bouncy[] = {true, false, true, true, false, true, true, true};
+    int rises = 0;
+    for (bool b : bouncy) {
+        button.update(b);
+        rises += button.rose();
+    }
+    EMBEC_CHECK(button.state() && rises == 1);
+    EMBEC_CHECK(button.update(false) && button.update(false) && !button.changed());
+    EMBEC_CHECK(!button.update(false) && button.fell());
+    EMBEC_CHECK(!button.update(true) && !button.changed());
+
+    embec::debouncer<1> direct(true);
+    EMBEC_CHECK(direct.state() && !direct.update(false) && direct.update(true));
+    direct.reset(false);
+    EMBEC_CHECK(!direct.state() && !direct.changed());
+}
+
+} // namespace
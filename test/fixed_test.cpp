@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cmath>
+#include <vector>
+
+#include "embec/fixed.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using embec::overflow;
+using embec::rounding;
+
+__extension__ typedef __int128 wide_t;
+
+/// Floor division for the reference model.
+wide_t floor_div(wide_t num, wide_t den)
+{
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    wide_t q = num / den;
+    if (num % den != 0 && num < 0) {
+        --q;
+    }
+    return q;
+}
+
+template <typename T>
+wide_t reference_narrow(wide_t value)
+{
+    if (T::overflow_policy == overflow::saturate) {
+        return value > T::raw_max ? T::raw_max : value < T::raw_min ? T::raw_min : value;
+    }
+    const wide_t span = wide_t{1} << T::total_bits;
+    wide_t low = ((value % span) + span) % span;
+    return low > T::raw_max ? low - span : low;
+}
+
+/// Divides by 2^shift with the format's rounding, exactly.
+template <typename T>
+wide_t reference_round(wide_t num, wide_t den)
+{
+    if (T::rounding_policy == rounding::truncate) {
+        return floor_div(num, den);
+    }
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    return floor_div(2 * num + den, 2 * den); // halves round up
+}
+
+template <typename T>
+void check_arithmetic(embec::test::rng& r)
+{
+    auto random_raw = [&r] {
+        // Mix full-range values with small ones and the extremes.
+        switch (r.below(4)) {
+        case 0:
+            return r.chance(50) ? T::raw_max : T::raw_min;
+        case 1:
+            return static_cast<std::int64_t>(r.range(-300, 300));
+        default:
+            return r.range(T::raw_min, T::raw_max);
+        }
+    };
+    const std::int64_t a = random_raw();
+    const std::int64_t b = random_raw();
+    const T x = T::from_raw(static_cast<typename T::raw_type>(a));
+    const T y = T::from_raw(static_cast<typename T::raw_type>(b));
+    constexpr int F = T::fraction_bits;
+
+    EMBEC_CHECK((x + y).raw() == reference_narrow<T>(wide_t{a} + b));
+    EMBEC_CHECK((x - y).raw() == reference_narrow<T>(wide_t{a} - b));
+    EMBEC_CHECK((-x).raw() == reference_narrow<T>(-wide_t{a}));
+    EMBEC_CHECK((x * y).raw() ==
+                reference_narrow<T>(reference_round<T>(wide_t{a} * b, wide_t{1} << F)));
+    if (b != 0) {
+        EMBEC_CHECK((x / y).raw() ==
+                    reference_narrow<T>(reference_round<T>(wide_t{a} << F, b)));
+    }
+    EMBEC_CHECK(x.to_int() == reference_round<T>(a, wide_t{1} << F));
+    EMBEC_CHECK((x < y) == (a < b) && (x == y) == (a == b));
+
+    // Every raw value converts to double exactly and back.
+    EMBEC_CHECK(T(x.to_double()) == x);
+}
+
+EMBEC_TEST(arithmetic, "fixed/arithmetic")
+{
+    embec::test::property(5000, check_arithmetic<embec::q15>);
+    embec::test::property(5000, check_arithmetic<embec::q31>);
+    embec::test::property(5000, check_arithmetic<embec::q15_16>);
+    embec::test::property(5000, check_arithmetic<embec::fixed<3, 12, rounding::truncate>>);
+    embec::test::property(5000, check_arithmetic<embec::fixed<7, 8, rounding::nearest,
+                                                              overflow::wrap>>);
+    embec::test::property(5000, check_arithmetic<embec::fixed<20, 4, rounding::truncate,
+                                                              overflow::wrap>>);
+}
+
+EMBEC_TEST(conversions, "fixed/conversions")
+{
+    using q3_12 = embec::fixed<3, 12>;
+    EMBEC_CHECK(q3_12(1).raw() == 4096 && q3_12(-8).raw() == -32768);
+    EMBEC_CHECK(q3_12(8) == q3_12::max() && q3_12(-9) == q3_12::lowest());
+    EMBEC_CHECK(q3_12(100u) == q3_12::max());
+    EMBEC_CHECK(q3_12(0.5).raw() == 2048 && q3_12(-0.5).raw() == -2048);
+    EMBEC_CHECK(q3_12(1e9) == q3_12::max() && q3_12(-1e9) == q3_12::lowest());
+    EMBEC_CHECK(q3_12(std::nan("")).raw() == 0);
+    // Halves of the LSB round up under rounding::nearest.
+    EMBEC_CHECK(q3_12(1.0 / 8192).raw() == 1 && q3_12(-1.0 / 8192).raw() == 0);
+    using q3_12_truncate = embec::fixed<3, 12, rounding::truncate>;
+    EMBEC_CHECK(q3_12_truncate(-1.0 / 8192).raw() == -1);
+
+    // Between formats: narrowing rounds, widening is exact.
+    const embec::q15_16 wide = embec::q15_16::from_raw(0x18000); // 1.5
+    EMBEC_CHECK(q3_12(wide).raw() == 6144);
+    EMBEC_CHECK(embec::q15(wide) == embec::q15::max());
+    EMBEC_CHECK(embec::q15_16(q3_12::from_raw(-1)).raw() == -16);
+    using q7_8 = embec::fixed<7, 8>;
+    EMBEC_CHECK(q7_8(embec::q15::from_raw(0x0040)).raw() == 1); // half rounds up
+
+    static_assert((embec::q15_16(2) * embec::q15_16(3)).to_int() == 6,
+                  "arithmetic is constexpr");
+}
+
+template <typename T>
+void check_math(embec::test::rng& r)
+{
+    const double lsb = 1.0 / (1 << T::fraction_bits);
+    const T x = T::from_raw(static_cast<typename T::raw_type>(r.range(T::raw_min, T::raw_max)));
+    const T y = T::from_raw(static_cast<typename T::raw_type>(r.range(T::raw_min, T::raw_max)));
+    const double xd = x.to_double();
+    const double yd = y.to_double();
+
+    EMBEC_CHECK(std::fabs(sin(x).to_double() - std::sin(xd)) <= lsb + 1e-5);
+    EMBEC_CHECK(std::fabs(cos(x).to_double() - std::cos(xd)) <= lsb + 1e-5);
+    if (T::integer_bits >= 2) {
+        EMBEC_CHECK(std::fabs(atan2(y, x).to_double() - std::atan2(yd, xd)) <= lsb + 1e-7);
+    }
+
+    // sqrt is the exactly rounded integer square root of raw * 2^F.
+    if (x.raw() > 0) {
+        const wide_t n = wide_t{x.raw()} << T::fraction_bits;
+        const wide_t root = sqrt(x).raw();
+        if (T::rounding_policy == rounding::truncate) {
+            EMBEC_CHECK(root * root <= n && (root + 1) * (root + 1) > n);
+        } else if (root != T::raw_max) {
+            EMBEC_CHECK((2 * root - 1) * (2 * root - 1) <= 4 * n &&
+                        (2 * root + 1) * (2 * root + 1) >= 4 * n);
+        }
+    } else {
+        EMBEC_CHECK(sqrt(x).raw() == 0);
+    }
+
+    const double e = std::exp(xd);
+    const T ex = exp(x);
+    if (e < T::max().to_double()) {
+        EMBEC_CHECK(std::fabs(ex.to_double() - e) <= lsb + e * 1e-7);
+    } else {
+        EMBEC_CHECK(ex == T::max());
+    }
+}
+
+EMBEC_TEST(math, "fixed/math")
+{
+    embec::test::property(5000, check_math<embec::q15_16>);
+    embec::test::property(5000, check_math<embec::fixed<3, 12>>);
+    embec::test::property(5000, check_math<embec::fixed<2, 29, rounding::truncate>>);
+    embec::test::property(2000, check_math<embec::q15>);
+
+    // Raw lowest() needs 31 bits once negated.
+    using embec::q15_16;
+    const double lsb = 1.0 / (1 << 16);
+    const auto near = [lsb](q15_16 angle, double expected) {
+        return std::fabs(angle.to_double() - expected) <= lsb + 1e-7;
+    };
+    const double pi = std::acos(-1.0);
+    EMBEC_CHECK(near(atan2(q15_16::lowest(), q15_16::from_raw(5)), -pi / 2));
+    EMBEC_CHECK(near(atan2(q15_16::lowest(), q15_16::lowest()), -3 * pi / 4));
+    EMBEC_CHECK(near(atan2(q15_16::max(), q15_16::lowest()), 3 * pi / 4));
+    EMBEC_CHECK(near(atan2(q15_16{}, q15_16::lowest()), pi));
+    EMBEC_CHECK(near(atan2(q15_16::from_raw(-1), q15_16::lowest()), -pi));
+    EMBEC_CHECK(near(atan2(q15_16::lowest(), q15_16{}), -pi / 2));
+    // q31 saturates outside [-1, 1).
+    EMBEC_CHECK(atan2(embec::q31::lowest(), embec::q31::lowest()) == embec::q31::lowest());
+    EMBEC_CHECK(atan2(embec::q31::max(), embec::q31::lowest()) == embec::q31::max());
+    EMBEC_CHECK(atan2(embec::q31::lowest(), embec::q31::from_raw(1)) == embec::q31::lowest());
+}
+
+template <typename T>
+void check_arrays(embec::test::rng& r)
+{
+    // dot(), scale() and fir() agree with scalar reference arithmetic,
+    // which exercises the SSE2 paths against the portable code.
+    // 32-bit formats keep few guard bits, so their operands stay small
+    // enough for the 64-bit accumulator.
+    constexpr std::int64_t limit = sizeof(typename T::raw_type) == 4 ? 1 << 24 : T::raw_max;
+    const std::size_t n = r.below(70);
+    std::vector<T> a(n + 8);
+    std::vector<T> b(n + 8);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        const bool extreme = limit == T::raw_max && r.chance(10);
+        a[i] = extreme ? T::lowest()
+                       : T::from_raw(static_cast<typename T::raw_type>(r.range(-limit, limit)));
+        b[i] = extreme ? T::lowest()
+                       : T::from_raw(static_cast<typename T::raw_type>(r.range(-limit, limit)));
+    }
+    constexpr int drop = embec::detail::fixed_dot_drop<T::integer_bits, T::fraction_bits,
+                                                       T::rounding_policy, T::overflow_policy>;
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += (std::int64_t{a[i].raw()} * b[i].raw()) >> drop;
+    }
+    EMBEC_CHECK(dot(a.data(), b.data(), n) == T::from_wide(sum, 2 * T::fraction_bits - drop));
+
+    std::vector<T> scaled(n);
+    scale(a.data(), b[0], scaled.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        EMBEC_REQUIRE(scaled[i] == a[i] * b[0]);
+    }
+
+    const std::size_t taps = 1 + r.below(8);
+    std::vector<T> out(n);
+    fir(b.data(), taps, a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+        EMBEC_REQUIRE(out[i] == dot(b.data(), a.data() + i, taps));
+    }
+}
+
+EMBEC_TEST(arrays, "fixed/arrays")
+{
+    embec::test::property(2000, check_arrays<embec::q15>);
+    embec::test::property(2000, check_arrays<embec::fixed<3, 12, rounding::truncate>>);
+    embec::test::property(2000, check_arrays<embec::fixed<0, 15, rounding::nearest,
+                                                          overflow::wrap>>);
+    embec::test::property(2000, check_arrays<embec::fixed<7, 8>>);
+    embec::test::property(2000, check_arrays<embec::q15_16>);
+}
+
+} // namespace
@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "embec/fixed.hpp"
+#include "embec/format.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using embec::chars_status;
+
+template <typename T>
+std::string to_string(T value)
+{
+    char buf[80];
+    const auto r = embec::to_chars(buf, buf + sizeof(buf), value);
+    return r ? std::string(buf, r.ptr) : std::string("<error>");
+}
+
+/// to_chars() with a base for integers and a precision otherwise.
+template <typename T>
+std::string to_string(T value, int base_or_precision)
+{
+    char buf[80];
+    const auto r = embec::to_chars(buf, buf + sizeof(buf), value, base_or_precision);
+    return r ? std::string(buf, r.ptr) : std::string("<error>");
+}
+
+template <typename... Args>
+std::string printf_string(const char* format, Args... args)
+{
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), format, args...);
+    return buf;
+}
+
+/// Random integer biased towards small values and the type's extremes.
+template <typename Int>
+Int random_int(embec::test::rng& r)
+{
+    switch (r.below(4)) {
+    case 0:
+        return r.chance(50) ? std::numeric_limits<Int>::max() : std::numeric_limits<Int>::min();
+    case 1:
+        return static_cast<Int>(r.range(-1000, 1000));
+    case 2:
+        return static_cast<Int>(r.next() >> r.below(64));
+    default:
+        return static_cast<Int>(r.next());
+    }
+}
+
+template <typename Int>
+void check_integer(embec::test::rng& r)
+{
+    const Int v = random_int<Int>(r);
+    const auto wide = static_cast<long long>(v);
+    const auto bits = static_cast<unsigned long long>(static_cast<std::make_unsigned_t<Int>>(v));
+    if (std::is_signed<Int>::value) {
+        EMBEC_CHECK(to_string(v) == printf_string("%lld", wide));
+    } else {
+        EMBEC_CHECK(to_string(v) == printf_string("%llu", bits));
+    }
+    if (!std::is_signed<Int>::value || v >= 0) {
+        EMBEC_CHECK(to_string(v, 16) == printf_string("%llx", bits));
+        EMBEC_CHECK(to_string(v, 8) == printf_string("%llo", bits));
+    }
+
+    // Every base parses back to the same value.
+    const int base = static_cast<int>(r.range(2, 36));
+    const std::string text = to_string(v, base);
+    Int back = 0;
+    const auto parsed = embec::from_chars(text.data(), text.data() + text.size(), back, base);
+    EMBEC_CHECK(parsed && parsed.ptr == text.data() + text.size() && back == v);
+
+    // Output that does not fit reports no_space.
+    char small[4];
+    if (text.size() > sizeof(small)) {
+        EMBEC_CHECK(embec::to_chars(small, small + sizeof(small), v, base).status ==
+                    chars_status::no_space);
+    }
+}
+
+EMBEC_TEST(integers, "format/integers")
+{
+    embec::test::property(5000, check_integer<std::int8_t>);
+    embec::test::property(5000, check_integer<std::uint16_t>);
+    embec::test::property(5000, check_integer<std::int32_t>);
+    embec::test::property(5000, check_integer<std::uint32_t>);
+    embec::test::property(5000, check_integer<std::int64_t>);
+    embec::test::property(5000, check_integer<std::uint64_t>);
+}
+
+EMBEC_TEST(integer_parse_errors, "format/integer_parse_errors")
+{
+    // Random digit strings agree with strtoll about overflow.
+    embec::test::property(5000, [](embec::test::rng& r) {
+        char text[24];
+        std::size_t n = 0;
+        if (r.chance(30)) {
+            text[n++] = '-';
+        }
+        const std::size_t digits = 1 + r.below(21);
+        for (std::size_t i = 0; i < digits; ++i) {
+            text[n++] = static_cast<char>('0' + r.below(10));
+        }
+        text[n] = '\0';
+        errno = 0;
+        const long long expected = std::strtoll(text, nullptr, 10);
+        const bool range_error = errno == ERANGE;
+        std::int64_t value = 42;
+        const auto result = embec::from_chars(text, text + n, value);
+        EMBEC_CHECK(result.ptr == text + n);
+        if (range_error) {
+            EMBEC_CHECK(result.status == chars_status::out_of_range && value == 42);
+        } else {
+            EMBEC_CHECK(result && value == expected);
+        }
+    });
+
+    std::int32_t v = 7;
+    const char* cases[] = {"", "-", "+1", " 1", "x"};
+    for (const char* text : cases) {
+        const auto r = embec::from_chars(text, text + std::strlen(text), v);
+        EMBEC_CHECK(r.status == chars_status::invalid && r.ptr == text && v == 7);
+    }
+    std::uint8_t u = 0;
+    const char* minus = "-1";
+    EMBEC_CHECK(embec::from_chars(minus, minus + 2, u).status == chars_status::invalid);
+    const char* big = "256";
+    EMBEC_CHECK(embec::from_chars(big, big + 3, u).status == chars_status::out_of_range);
+    const char* hex = "ffZ";
+    const auto r = embec::from_chars(hex, hex + 3, u, 16);
+    EMBEC_CHECK(r && u == 255 && r.ptr == hex + 2);
+}
+
+/// A double with at most about 12 significant digits, where formatting is
+/// exact.
+double random_moderate_double(embec::test::rng& r)
+{
+    const double mantissa = static_cast<double>(r.range(-(std::int64_t{1} << 40),
+                                                        std::int64_t{1} << 40));
+    return std::ldexp(mantissa, static_cast<int>(r.range(-40, 0)) - static_cast<int>(r.below(8)));
+}
+
+EMBEC_TEST(double_output, "format/double_output")
+{
+    embec::test::property(20000, [](embec::test::rng& r) {
+        const double v = random_moderate_double(r);
+        const int precision = static_cast<int>(r.below(7));
+        EMBEC_CHECK(to_string(v, precision) == printf_string("%.*f", precision, v));
+
+        // Default: %f with trailing zeros (and a bare point) removed.
+        std::string expected = printf_string("%f", v);
+        expected.erase(expected.find_last_not_of('0') + 1);
+        if (expected.back() == '.') {
+            expected.pop_back();
+        }
+        EMBEC_CHECK(to_string(v) == expected);
+    });
+
+    const double inf = std::numeric_limits<double>::infinity();
+    EMBEC_CHECK(to_string(inf) == "inf" && to_string(-inf) == "-inf");
+    EMBEC_CHECK(to_string(std::nan("")) == "nan");
+    EMBEC_CHECK(to_string(1e21) == "1e+21" && to_string(1.5e20, 2) == "1.50e+20");
+    EMBEC_CHECK(to_string(0.5, 0) == "0" && to_string(1.5, 0) == "2");
+    EMBEC_CHECK(to_string(-0.125, 2) == "-0.12");
+}
+
+EMBEC_TEST(double_parse, "format/double_parse")
+{
+    embec::test::property(20000, [](embec::test::rng& r) {
+        // Random bit patterns of finite doubles across the whole range.
+        double v;
+        do {
+            const std::uint64_t bits = r.next();
+            std::memcpy(&v, &bits, sizeof(v));
+        } while (!std::isfinite(v) || std::fabs(v) < 1e-300);
+        const bool short_form = r.chance(50);
+        char text[40];
+        const int n = std::snprintf(text, sizeof(text), short_form ? "%.15g" : "%.17g", v);
+        const double expected = std::strtod(text, nullptr);
+        double parsed = 0;
+        const auto result = embec::from_chars(text, text + n, parsed);
+        EMBEC_REQUIRE(result && result.ptr == text + n);
+
+        int exponent = 0;
+        std::frexp(expected, &exponent);
+        const double ulp = std::ldexp(1.0, exponent - 53);
+        const double error = std::fabs(parsed - expected) / ulp;
+        const char* e = std::strchr(text, 'e');
+        const int decimal_exponent = e ? std::atoi(e + 1) : 0;
+        if (short_form && decimal_exponent >= -7 && decimal_exponent <= 7) {
+            EMBEC_CHECK(parsed == expected); // 15 digits, small exponent: exact
+        } else {
+            EMBEC_CHECK(error <= 8);
+        }
+    });
+
+    const char* cases[] = {"inf", "-infinity", "nan", "1e400", "-0", "12.5e-1x"};
+    double d = 0;
+    EMBEC_CHECK(embec::from_chars(cases[0], cases[0] + 3, d) && std::isinf(d) && d > 0);
+    EMBEC_CHECK(embec::from_chars(cases[1], cases[1] + 9, d) && std::isinf(d) && d < 0);
+    EMBEC_CHECK(embec::from_chars(cases[2], cases[2] + 3, d) && std::isnan(d));
+    d = 1;
+    EMBEC_CHECK(embec::from_chars(cases[3], cases[3] + 5, d).status == chars_status::out_of_range &&
+                d == 1);
+    EMBEC_CHECK(embec::from_chars(cases[4], cases[4] + 2, d) && d == 0 && std::signbit(d));
+    const auto r = embec::from_chars(cases[5], cases[5] + 8, d);
+    EMBEC_CHECK(r && d == 1.25 && r.ptr == cases[5] + 7);
+    float f = 0;
+    EMBEC_CHECK(embec::from_chars(cases[3], cases[3] + 5, f).status == chars_status::out_of_range);
+}
+
+template <typename Fixed>
+void check_fixed(embec::test::rng& r)
+{
+    // Fixed-point output is exact, so it matches printf of the (exactly
+    // representable) double value; the default output parses back to the
+    // same value.
+    const Fixed v = Fixed::from_raw(static_cast<decltype(Fixed().raw())>(
+        r.range(Fixed::raw_min, Fixed::raw_max)));
+    const int precision = static_cast<int>(r.below(10));
+    EMBEC_CHECK(to_string(v, precision) ==
+                printf_string("%.*f", precision, v.to_double()));
+    const std::string text = to_string(v, -1);
+    Fixed back;
+    const auto parsed = embec::from_chars(text.data(), text.data() + text.size(), back);
+    EMBEC_CHECK(parsed && back == v);
+}
+
+EMBEC_TEST(fixed_point, "format/fixed_point")
+{
+    embec::test::property(5000, check_fixed<embec::q15>);
+    embec::test::property(5000, check_fixed<embec::q15_16>);
+    embec::test::property(5000, check_fixed<embec::q31>);
+    embec::test::property(5000, check_fixed<embec::fixed<7, 8>>);
+
+    embec::q15 q;
+    const char* one = "1.0";
+    EMBEC_CHECK(embec::from_chars(one, one + 3, q).status == chars_status::out_of_range);
+    const char* nearly = "0.99998"; // 32767.34 LSBs
+    EMBEC_CHECK(embec::from_chars(nearly, nearly + 7, q) && q.raw() == 32767);
+    const char* rounds_up = "0.99999"; // 32767.67 LSBs rounds past the maximum
+    EMBEC_CHECK(embec::from_chars(rounds_up, rounds_up + 7, q).status ==
+                chars_status::out_of_range);
+    const char* min = "-1";
+    EMBEC_CHECK(embec::from_chars(min, min + 2, q) && q == embec::q15::lowest());
+}
+
+EMBEC_TEST(format_fields, "format/format_fields")
+{
+    char out[96];
+    auto check = [&](embec::format_result r, const char* expected) {
+        return r && r.length == std::strlen(expected) && std::strcmp(out, expected) == 0;
+    };
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("plain")), "plain"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{{{}}}"), 5), "{5}"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("[{:>6}|{:<6}|{:^6}]"), 42, -7, 3u),
+                      "[    42|-7    |  3   ]"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{:*^9}"), "mid"), "***mid***"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{:+05}|{:08X}|{:#<4x}"), 42, 0xbeefu, 10),
+                      "+0042|0000BEEF|a###"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{:b}|{:o}|{:c}"), 5, 8, 65), "101|10|A"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{}|{:d}|{}"), 'x', 'x', true),
+                      "x|120|true"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{:.2f}|{:e}|{}"), 3.14159, 1234.5, 0.1),
+                      "3.14|1.234500e+03|0.1"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{:08.3f}"), -2.5), "-002.500"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{}|{:.2f}"), embec::q15_16(1.75),
+                                       embec::q15_16(-0.125)),
+                      "1.75|-0.12"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{:.3}|{}"), "truncate",
+                                       std::string_view("view")),
+                      "tru|view"));
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{}"), static_cast<const void*>(nullptr)),
+                      "0x0"));
+    enum class color : std::uint8_t { red = 2 };
+    EMBEC_CHECK(check(embec::format_to(out, EMBEC_FMT("{}"), color::red), "2"));
+}
+
+EMBEC_TEST(truncation, "format/truncation")
+{
+    char out[8];
+    std::memset(out, 'z', sizeof(out));
+    auto r = embec::format_to(out, EMBEC_FMT("{}-{}"), 12345, 678);
+    EMBEC_CHECK(r.status == chars_status::no_space && r.length == 7);
+    EMBEC_CHECK(std::strcmp(out, "12345-6") == 0);
+
+    // Random lengths: the output is always the NUL-terminated prefix of the
+    // untruncated text.
+    embec::test::property(2000, [](embec::test::rng& r) {
+        char full[64];
+        const auto v = static_cast<std::int32_t>(r.next());
+        const double d = random_moderate_double(r);
+        const auto whole = embec::format_to(full, EMBEC_FMT("v={:>12} d={:.3f} {}"), v, d, "end");
+        EMBEC_REQUIRE(whole);
+        char buf[64];
+        std::memset(buf, 'z', sizeof(buf));
+        const std::size_t size = r.below(whole.length + 2);
+        const auto part = embec::format_to(buf, size, EMBEC_FMT("v={:>12} d={:.3f} {}"), v, d,
+                                           "end");
+        if (size == 0) {
+            EMBEC_CHECK(part.length == 0 && buf[0] == 'z');
+            return;
+        }
+        const std::size_t kept = size - 1 < whole.length ? size - 1 : whole.length;
+        EMBEC_CHECK(part.length == kept && buf[kept] == '\0' &&
+                    std::memcmp(buf, full, kept) == 0 && buf[size] == 'z');
+        EMBEC_CHECK((part.status == chars_status::ok) == (kept == whole.length));
+    });
+}
+
+} // namespace
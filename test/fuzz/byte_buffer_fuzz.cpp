@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: byte_reader parsing an arbitrary length-prefixed message.
+//
+// The input is read as a sequence of {tag, fields} records whose layout the
+// tags choose, nested with sub(). Whatever is read is written back with a
+// byte_writer of the same byte order, which must reproduce the consumed
+// input exactly; reads past the end must fail without touching memory.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "embec/byte_buffer.hpp"
+
+namespace {
+
+/// Returns false if the input, or a nested record, was malformed.
+template <embec::byte_order Order>
+bool parse(embec::byte_reader<Order>& in, embec::byte_writer<Order>& out, int depth)
+{
+    while (!in.empty() && in.ok()) {
+        const std::uint8_t tag = in.template read<std::uint8_t>();
+        out.template write<std::uint8_t>(tag);
+        switch (tag % 8) {
+        case 0:
+            out.write(in.template read<std::uint16_t>());
+            break;
+        case 1:
+            out.write(in.template read<std::int32_t>());
+            break;
+        case 2:
+            out.write(in.template read<std::uint64_t>());
+            break;
+        case 3: {
+            // Bit patterns of floats survive the round trip, NaNs included.
+            const std::uint32_t bits = in.template peek<std::uint32_t>(0);
+            const float value = in.template read<float>();
+            std::uint32_t again;
+            std::memcpy(&again, &value, sizeof(again));
+            if (in.ok() && again != bits) {
+                std::abort();
+            }
+            out.write(value);
+            break;
+        }
+        case 4: {
+            std::uint16_t values[16];
+            const std::size_t count = tag / 8 % 17;
+            if (in.read_array(values, count)) {
+                out.write_array(values, count);
+            }
+            break;
+        }
+        case 5: {
+            const std::uint8_t length = in.template read<std::uint8_t>();
+            const std::uint8_t* bytes = in.bytes(length);
+            if (in.ok()) {
+                out.template write<std::uint8_t>(length);
+                out.write_bytes(bytes, length);
+            }
+            break;
+        }
+        case 6:
+            if (depth < 8) {
+                const std::uint16_t length = in.template read<std::uint16_t>();
+                embec::byte_reader<Order> inner = in.sub(length);
+                if (in.ok()) {
+                    out.write(length);
+                    if (!parse(inner, out, depth + 1)) {
+                        return false;
+                    }
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return in.ok();
+}
+
+template <embec::byte_order Order>
+void check(const std::uint8_t* data, std::size_t size)
+{
+    static std::uint8_t copy[4096];
+    embec::byte_reader<Order> in(data, size);
+    embec::byte_writer<Order> out(copy, sizeof(copy));
+    const bool well_formed = parse(in, out, 0);
+    if (in.remaining() > size || !out.ok()) {
+        std::abort();
+    }
+    if (well_formed && (out.position() != size || std::memcmp(copy, data, size) != 0)) {
+        std::abort();
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size > 4096) {
+        return 0;
+    }
+    check<embec::byte_order::big>(data, size);
+    check<embec::byte_order::little>(data, size);
+    return 0;
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: COBS decoding of arbitrary input, in one piece and streamed.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "embec/cobs.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size > 4096) {
+        return 0;
+    }
+    static std::uint8_t decoded[4096];
+    static std::uint8_t encoded[embec::cobs_max_encoded_size(4096)];
+    static std::uint8_t again[4096];
+
+    // A successful decode re-encodes to a frame that decodes to the same
+    // bytes.
+    const embec::frame_result result = embec::cobs_decode(data, size, decoded, sizeof(decoded));
+    if (result) {
+        const embec::frame_result re =
+            embec::cobs_encode(decoded, result.length, encoded, sizeof(encoded));
+        const embec::frame_result back = embec::cobs_decode(encoded, re.length, again, sizeof(again));
+        if (!re || !back || back.length != result.length ||
+            std::memcmp(again, decoded, result.length) != 0) {
+            std::abort();
+        }
+    }
+
+    // The streaming decoder only delivers frames that cobs_decode accepts,
+    // with the same contents.
+    std::uint8_t frame[64];
+    embec::cobs_decoder decoder(frame, sizeof(frame));
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const embec::frame_status status = decoder.push(data[i]);
+        if (data[i] == 0) {
+            if (status == embec::frame_status::ok) {
+                const embec::frame_result check =
+                    embec::cobs_decode(data + start, i - start, again, sizeof(again));
+                if (!check || check.length != decoder.size() ||
+                    std::memcmp(again, decoder.data(), check.length) != 0) {
+                    std::abort();
+                }
+            }
+            start = i + 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: from_chars on arbitrary text, and to_chars on what it parsed.
+//
+// Every parse must stay within the input and report a consistent status.
+// Integers and fixed-point values that parse must print and parse back to
+// the same value; doubles must print to text that parses back close by.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include "embec/fixed.hpp"
+#include "embec/format.hpp"
+
+namespace {
+
+void expect(bool condition)
+{
+    if (!condition) {
+        std::abort();
+    }
+}
+
+void check_result(const char* first, const char* last, embec::from_chars_result r)
+{
+    expect(r.ptr >= first && r.ptr <= last);
+    expect((r.status == embec::chars_status::invalid) == (r.ptr == first));
+}
+
+template <typename Int>
+void check_integer(const char* first, const char* last, int base)
+{
+    Int value = 42;
+    const embec::from_chars_result r = embec::from_chars(first, last, value, base);
+    check_result(first, last, r);
+    if (!r) {
+        expect(value == 42);
+        return;
+    }
+    char text[80];
+    const embec::to_chars_result w = embec::to_chars(text, text + sizeof(text), value, base);
+    expect(static_cast<bool>(w));
+    Int again = 0;
+    const embec::from_chars_result back = embec::from_chars(text, w.ptr, again, base);
+    expect(back && back.ptr == w.ptr && again == value);
+}
+
+template <typename Fixed>
+void check_fixed(const char* first, const char* last)
+{
+    Fixed value;
+    const embec::from_chars_result r = embec::from_chars(first, last, value);
+    check_result(first, last, r);
+    if (!r) {
+        return;
+    }
+    char text[48];
+    const embec::to_chars_result w = embec::to_chars(text, text + sizeof(text), value);
+    expect(static_cast<bool>(w));
+    Fixed again;
+    const embec::from_chars_result back = embec::from_chars(text, w.ptr, again);
+    expect(back && back.ptr == w.ptr && again.raw() == value.raw());
+}
+
+void check_double(const char* first, const char* last)
+{
+    double value = 0;
+    const embec::from_chars_result r = embec::from_chars(first, last, value);
+    check_result(first, last, r);
+    if (!r) {
+        return;
+    }
+    char text[48];
+    const embec::to_chars_result w = embec::to_chars(text, text + sizeof(text), value);
+    expect(static_cast<bool>(w));
+    double again = 0;
+    const embec::from_chars_result back = embec::from_chars(text, w.ptr, again);
+    expect(back && back.ptr == w.ptr);
+    if (std::isnan(value)) {
+        expect(std::isnan(again));
+    } else if (std::isinf(value)) {
+        expect(again == value);
+    } else {
+        // Six fraction digits, in fixed or exponent notation.
+        expect(std::fabs(again - value) <= 1e-6 + 1e-6 * std::fabs(value));
+    }
+
+    float single = 0;
+    check_result(first, last, embec::from_chars(first, last, single));
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    // The first byte picks the integer base, the rest is the text.
+    const int base = 2 + data[0] % 35;
+    const char* first = reinterpret_cast<const char*>(data + 1);
+    const char* last = first + (size - 1);
+    for (const char* p = first; p <= last; p += 1 + (last - p) / 4) {
+        check_integer<std::int64_t>(p, last, base);
+        check_integer<std::uint32_t>(p, last, base);
+        check_integer<std::int8_t>(p, last, 10);
+        check_fixed<embec::q15>(p, last);
+        check_fixed<embec::q15_16>(p, last);
+        check_double(p, last);
+        if (p == last) {
+            break;
+        }
+    }
+    return 0;
+}
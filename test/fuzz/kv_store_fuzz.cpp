@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: kv_store on flash that the input corrupts.
+//
+// The input is a program of puts, erases, remounts, power cuts and bit
+// flips in the raw flash. Whatever the flash holds, mount() must not crash
+// or index more than MaxKeys keys, reads must stay within their buffers,
+// and a mounted store must read back the value it has just written.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "embec/byte_buffer.hpp"
+#include "embec/flash_sim.hpp"
+#include "embec/kv_store.hpp"
+
+namespace {
+
+using flash_type = embec::flash_sim<1024, 6, 8>;
+using store_type = embec::kv_store<flash_type, 32>;
+
+void expect(bool condition)
+{
+    if (!condition) {
+        std::abort();
+    }
+}
+
+void check_contents(const store_type& store)
+{
+    expect(store.size() <= store.capacity() && store.live_bytes() <= store.max_live_bytes);
+    std::uint8_t out[store_type::max_value_size + 1];
+    for (std::uint16_t key = 0; key < 40; ++key) {
+        out[store_type::max_value_size] = 0x5a;
+        const embec::kv_result r = store.get(key, out, store_type::max_value_size);
+        expect(out[store_type::max_value_size] == 0x5a);
+        expect(r.status != embec::kv_status::ok || store.contains(key));
+        expect(r.length <= store_type::max_value_size);
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    flash_type flash;
+    if (!flash.open()) {
+        return 0;
+    }
+    store_type store(flash);
+    store.mount();
+
+    embec::le_reader in(data, size);
+    while (!in.empty()) {
+        const auto op = in.read<std::uint8_t>();
+        switch (op % 6) {
+        case 0:
+        case 1: {
+            // Put a value taken from the input.
+            const std::uint16_t key = in.read<std::uint8_t>() % 40;
+            const std::size_t length = in.read<std::uint8_t>() % 48;
+            const std::uint8_t* value = in.bytes(length < in.remaining() ? length : 0);
+            if (value == nullptr || !store.mounted()) {
+                break;
+            }
+            const embec::kv_status status = store.put(key, value, length);
+            if (status == embec::kv_status::ok) {
+                std::uint8_t out[store_type::max_value_size];
+                const embec::kv_result r = store.get(key, out, sizeof(out));
+                expect(r && r.length == length && std::memcmp(out, value, length) == 0);
+            }
+            expect(status != embec::kv_status::too_large || length > store.max_value_size);
+            break;
+        }
+        case 2:
+            if (store.mounted()) {
+                const std::uint16_t key = in.read<std::uint8_t>() % 40;
+                const embec::kv_status status = store.erase(key);
+                expect(status == embec::kv_status::flash_error || !store.contains(key));
+            }
+            break;
+        case 3: {
+            // Flip bits anywhere in the flash, then remount.
+            const std::size_t address = in.read<std::uint16_t>() % flash_type::size;
+            flash.data()[address] ^= static_cast<std::uint8_t>(1u << (op >> 5));
+            if (store.mount() == embec::kv_status::ok) {
+                check_contents(store);
+            }
+            break;
+        }
+        case 4:
+            flash.cut_power_after(in.read<std::uint8_t>() % 16, op);
+            break;
+        default:
+            flash.power_on();
+            flash.cancel_power_cut();
+            if (store.mount() == embec::kv_status::ok) {
+                check_contents(store);
+                store.collect_step();
+            }
+            break;
+        }
+    }
+    flash.power_on();
+    flash.cancel_power_cut();
+    if (store.mount() == embec::kv_status::ok) {
+        check_contents(store);
+    }
+    return 0;
+}
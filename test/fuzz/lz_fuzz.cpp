@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: LZ decompression of arbitrary input, and compression round
+// trips of the same bytes.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "embec/lz.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size > 4096) {
+        return 0;
+    }
+    static embec::lz_encoder<8, 4> encoder;
+    static embec::lz_decoder<8, 4> decoder;
+    static embec::lz_decoder<8, 4, 1> byte_decoder;
+    static std::uint8_t decoded[16 * 4096]; // beyond the largest expansion
+    static std::uint8_t streamed[16 * 4096];
+    static std::uint8_t compressed[embec::lz_max_compressed_size(4096)];
+    static std::uint8_t again[4096];
+
+    // Decoding in one piece and byte by byte agree: same status, and the
+    // same output when the stream is valid. Nothing reads out of bounds.
+    const embec::frame_result result = embec::lz_decompress(decoder, data, size, decoded,
+                                                            sizeof(decoded));
+    byte_decoder.reset();
+    embec::lz_status status = embec::lz_status::need_input;
+    std::size_t produced = 0;
+    for (std::size_t i = 0; i <= size && status != embec::lz_status::invalid; ++i) {
+        if (i < size) {
+            byte_decoder.sink(data + i, 1);
+        } else {
+            byte_decoder.finish();
+        }
+        do {
+            const std::size_t room = sizeof(streamed) - produced;
+            produced += byte_decoder.poll(streamed + produced, room < 7 ? room : 7, status);
+        } while (status == embec::lz_status::more_output && produced < sizeof(streamed));
+    }
+    if (result.status == embec::frame_status::ok &&
+        (status != embec::lz_status::done || produced != result.length ||
+         std::memcmp(streamed, decoded, produced) != 0)) {
+        std::abort();
+    }
+    if (result.status == embec::frame_status::invalid && status != embec::lz_status::invalid) {
+        std::abort();
+    }
+
+    // Any input compresses within the bound and decompresses to itself.
+    const embec::frame_result c =
+        embec::lz_compress(encoder, data, size, compressed, sizeof(compressed));
+    if (!c || c.length > embec::lz_max_compressed_size(size)) {
+        std::abort();
+    }
+    const embec::frame_result d =
+        embec::lz_decompress(decoder, compressed, c.length, again, sizeof(again));
+    if (!d || d.length != size || std::memcmp(again, data, size) != 0) {
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Stand-alone driver for the fuzz targets when libFuzzer is not available.
+//
+// Usage: embec_fuzz_<target> [--runs N] [--seed N] [--max-len N] [FILE...]
+//
+// Runs LLVMFuzzerTestOneInput on each FILE (for example a crash reproducer
+// saved by libFuzzer), then on N generated inputs. The inputs mix random
+// bytes with bytes drawn from small alphabets (framing bytes, number
+// syntax), so structured inputs turn up without a coverage-guided engine.
+// Input i is generated from seed + i alone; when an input fails (a
+// sanitizer report or an EMBEC_ASSERT) its seed is printed, and
+// --seed S --runs 1 replays it.
+
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+extern "C" void __sanitizer_set_death_callback(void (*callback)()) __attribute__((weak));
+
+namespace {
+
+/// xorshift64*.
+struct generator {
+    std::uint64_t state;
+
+    std::uint64_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545f4914f6cdd1dull;
+    }
+    std::size_t below(std::size_t n) { return static_cast<std::size_t>(next() % n); }
+};
+
+constexpr const char* alphabets[] = {
+    "\x00\x01\x02\x03\xfe\xff",           // COBS codes
+    "\xc0\xdb\xdc\xdd\x00\x55",           // SLIP specials
+    "0123456789+-.eExXabcdefABCDEF \t",   // number syntax
+    "0123456789.-+",                      // decimal numbers
+};
+constexpr std::size_t alphabet_sizes[] = {6, 6, 31, 13};
+
+volatile std::uint64_t current_seed = 0;
+volatile bool running = false;
+
+void report_seed()
+{
+    if (running) {
+        char line[64];
+        const int n = std::snprintf(line, sizeof(line), "failing input: --seed %llu --runs 1\n",
+                                    static_cast<unsigned long long>(current_seed));
+        std::fwrite(line, 1, static_cast<std::size_t>(n), stderr);
+        running = false;
+    }
+}
+
+extern "C" void on_signal(int signal)
+{
+    report_seed();
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+
+void generate(generator& g, std::vector<std::uint8_t>& input, std::size_t max_length)
+{
+    input.resize(g.below(max_length + 1));
+    const std::size_t mode = g.below(5);
+    for (std::uint8_t& byte : input) {
+        if (mode < 4 && g.below(8) != 0) {
+            byte = static_cast<std::uint8_t>(alphabets[mode][g.below(alphabet_sizes[mode])]);
+        } else {
+            byte = static_cast<std::uint8_t>(g.next());
+        }
+    }
+}
+
+bool run_file(const char* path)
+{
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    std::vector<std::uint8_t> data;
+    std::uint8_t chunk[4096];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    std::fclose(f);
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned long long runs = 10000;
+    std::uint64_t seed = 1;
+    std::size_t max_length = 512;
+    bool files_ok = true;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--runs") && has_value) {
+            runs = std::strtoull(argv[++i], nullptr, 0);
+        } else if (!std::strcmp(argv[i], "--seed") && has_value) {
+            seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (!std::strcmp(argv[i], "--max-len") && has_value) {
+            max_length = std::strtoull(argv[++i], nullptr, 0);
+        } else if (argv[i][0] == '-') {
+            std::fprintf(stderr, "usage: %s [--runs N] [--seed N] [--max-len N] [FILE...]\n",
+                         argv[0]);
+            return 1;
+        } else {
+            files_ok = run_file(argv[i]) && files_ok;
+        }
+    }
+
+    if (__sanitizer_set_death_callback != nullptr) {
+        __sanitizer_set_death_callback(&report_seed);
+    }
+    std::signal(SIGABRT, &on_signal);
+    std::signal(SIGSEGV, &on_signal);
+
+    std::vector<std::uint8_t> input;
+    for (unsigned long long run = 0; run < runs; ++run) {
+        current_seed = seed + run;
+        generator g{current_seed * 0x9e3779b97f4a7c15ull | 1};
+        generate(g, input, max_length);
+        running = true;
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+        running = false;
+    }
+    std::printf("%s: %llu generated inputs, no failures\n", argv[0], runs);
+    return files_ok ? 0 : 1;
+}
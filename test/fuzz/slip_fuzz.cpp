@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: SLIP decoding of arbitrary input, in one piece and streamed.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "embec/slip.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size > 4096) {
+        return 0;
+    }
+    static std::uint8_t decoded[4096];
+    static std::uint8_t encoded[embec::slip_max_encoded_size(4096)];
+    static std::uint8_t again[4096];
+
+    // A successful decode re-encodes to a frame that, without its END
+    // delimiters, decodes to the same bytes.
+    const embec::frame_result result = embec::slip_decode(data, size, decoded, sizeof(decoded));
+    if (result) {
+        const embec::frame_result re =
+            embec::slip_encode(decoded, result.length, encoded, sizeof(encoded));
+        if (!re || re.length < 2) {
+            std::abort();
+        }
+        const embec::frame_result back =
+            embec::slip_decode(encoded + 1, re.length - 2, again, sizeof(again));
+        if (!back || back.length != result.length ||
+            std::memcmp(again, decoded, result.length) != 0) {
+            std::abort();
+        }
+    }
+
+    // Streamed in random-sized blocks (sizes taken from the input itself),
+    // the decoder never reports a frame larger than its buffer.
+    std::uint8_t frame[64];
+    embec::slip_decoder decoder(frame, sizeof(frame));
+    for (std::size_t at = 0; at < size;) {
+        const std::size_t block = 1 + data[at] % 17;
+        embec::frame_status status;
+        const std::size_t used =
+            decoder.push(data + at, block < size - at ? block : size - at, status);
+        if (used == 0 || (status == embec::frame_status::ok && decoder.size() > sizeof(frame))) {
+            std::abort();
+        }
+        at += used;
+    }
+    return 0;
+}
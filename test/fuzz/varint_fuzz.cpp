@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Fuzz target: bulk varint decoding of arbitrary input against the
+// value-by-value decoder, and re-encoding of what was decoded.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "embec/varint.hpp"
+
+namespace {
+
+template <typename T>
+void check(const std::uint8_t* data, std::size_t size)
+{
+    static T bulk[4096];
+    static T single[4096];
+    static std::uint8_t encoded[4096 * embec::varint_max_size<T>];
+
+    // Decode as many values as the input could hold, then again with the
+    // count that succeeded: both decoders agree on values and length.
+    std::size_t count = 0;
+    std::size_t at = 0;
+    while (count < size) {
+        const std::size_t n = embec::varint_decode(data + at, size - at, single[count]);
+        if (n == 0) {
+            break;
+        }
+        at += n;
+        ++count;
+    }
+    const embec::frame_result all = embec::varint_decode_array(data, size, bulk, count);
+    if (!all || all.length != at || std::memcmp(bulk, single, count * sizeof(T)) != 0) {
+        std::abort();
+    }
+    if (at < size &&
+        embec::varint_decode_array(data, size, single, count + 1).status == embec::frame_status::ok) {
+        std::abort();
+    }
+
+    // Decoded values re-encode canonically, no longer than the input, and
+    // decode to the same values.
+    const embec::frame_result e = embec::varint_encode_array(bulk, count, encoded, sizeof(encoded));
+    const embec::frame_result d = embec::varint_decode_array(encoded, e.length, single, count);
+    if (!e || e.length > at || !d || std::memcmp(bulk, single, count * sizeof(T)) != 0) {
+        std::abort();
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    if (size > 4096) {
+        return 0;
+    }
+    check<std::uint32_t>(data, size);
+    check<std::int32_t>(data, size);
+    check<std::uint64_t>(data, size);
+    check<std::uint16_t>(data, size);
+    return 0;
+}
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <map>
+#include <set>
+#include <string_view>
+
+#include "embec/hash_map.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+/// Counts live instances to check that the containers destroy elements.
+struct counted {
+    static int live;
+    counted() noexcept : value(0) { ++live; }
+    explicit counted(int v) noexcept : value(v) { ++live; }
+    counted(const counted& other) noexcept : value(other.value) { ++live; }
+    counted(counted&& other) noexcept : value(other.value) { ++live; }
+    counted& operator=(const counted&) = default;
+    counted& operator=(counted&&) = default;
+    ~counted() { --live; }
+    int value;
+};
+int counted::live = 0;
+
+/// A poor hash that puts many keys into the same home slot.
+struct clustered_hash {
+    std::size_t operator()(std::uint32_t key) const noexcept { return key % 5; }
+};
+
+template <typename Map>
+void check_map_model(embec::test::rng& r)
+{
+    Map map;
+    std::map<std::uint32_t, int> model;
+    const std::uint32_t key_space = 1 + static_cast<std::uint32_t>(r.below(200));
+    for (int step = 0; step < 600; ++step) {
+        const auto key = static_cast<std::uint32_t>(r.below(key_space));
+        const int value = static_cast<int>(r.next() & 0xffff);
+        switch (r.below(6)) {
+        case 0:
+        case 1: {
+            const auto [it, inserted] = map.try_emplace(key, value);
+            if (model.count(key)) {
+                EMBEC_REQUIRE(!inserted && it != map.end() && it->second.value == model[key]);
+            } else if (model.size() == Map::capacity()) {
+                EMBEC_REQUIRE(!inserted && it == map.end());
+            } else {
+                EMBEC_REQUIRE(inserted && it->first == key && it->second.value == value);
+                model[key] = value;
+            }
+            break;
+        }
+        case 2: {
+            if (model.count(key) || model.size() < Map::capacity()) {
+                map.insert_or_assign(key, counted(value));
+                model[key] = value;
+            }
+            break;
+        }
+        case 3:
+            EMBEC_REQUIRE(map.erase(key) == model.erase(key));
+            break;
+        case 4: {
+            const auto it = map.find(key);
+            EMBEC_REQUIRE((it != map.end()) == (model.count(key) != 0));
+            if (it != map.end()) {
+                EMBEC_REQUIRE(it->second.value == model[key]);
+                if (r.chance(30)) {
+                    map.erase(it);
+                    model.erase(key);
+                }
+            }
+            break;
+        }
+        default:
+            if (model.count(key) || model.size() < Map::capacity()) {
+                map[key].value = value;
+                model[key] = value;
+            }
+            break;
+        }
+        EMBEC_REQUIRE(map.size() == model.size());
+    }
+    // Iteration visits every element exactly once.
+    std::map<std::uint32_t, int> seen;
+    for (const auto& entry : map) {
+        EMBEC_REQUIRE(seen.emplace(entry.first, entry.second.value).second);
+    }
+    EMBEC_CHECK(seen == model);
+    map.clear();
+    EMBEC_CHECK(map.empty() && map.begin() == map.end());
+}
+
+EMBEC_TEST(map_model, "hash_map/map_model")
+{
+    embec::test::property(300, check_map_model<embec::hash_map<std::uint32_t, counted, 64>>);
+    embec::test::property(300, check_map_model<embec::hash_map<std::uint32_t, counted, 7>>);
+    embec::test::property(
+        300, check_map_model<embec::hash_map<std::uint32_t, counted, 48, clustered_hash>>);
+    EMBEC_CHECK(counted::live == 0);
+}
+
+EMBEC_TEST(set_model, "hash_map/set_model")
+{
+    embec::test::property(300, [](embec::test::rng& r) {
+        embec::hash_set<std::uint16_t, 100> set;
+        std::set<std::uint16_t> model;
+        for (int step = 0; step < 800; ++step) {
+            const auto key = static_cast<std::uint16_t>(r.below(300));
+            if (r.chance(55)) {
+                const bool fits = model.size() < 100 || model.count(key);
+                const auto [it, inserted] = set.insert(key);
+                EMBEC_REQUIRE(inserted == (fits && !model.count(key)));
+                EMBEC_REQUIRE((it != set.end()) == fits);
+                if (fits) {
+                    model.insert(key);
+                }
+            } else {
+                EMBEC_REQUIRE(set.erase(key) == model.erase(key));
+            }
+            EMBEC_REQUIRE(set.contains(key) == (model.count(key) != 0));
+        }
+        EMBEC_CHECK(std::set<std::uint16_t>(set.begin(), set.end()) == model);
+    });
+}
+
+EMBEC_TEST(string_keys, "hash_map/string_keys")
+{
+    embec::hash_map<std::string_view, int, 8> map{{"alpha", 1}, {"beta", 2}};
+    map["gamma"] = 3;
+    EMBEC_CHECK(map.size() == 3 && map.find("beta")->second == 2 && map.count("delta") == 0);
+    EMBEC_CHECK(!map.insert({"alpha", 9}).second && map["alpha"] == 1);
+}
+
+constexpr auto units = embec::make_perfect_hash_map<std::string_view, std::uint8_t>({
+    {"mV", 0}, {"mA", 1}, {"degC", 2}, {"rpm", 3}, {"Pa", 4}, {"Hz", 5},
+});
+static_assert(*units.find("rpm") == 3 && units.find("kg") == nullptr,
+              "perfect_hash_map is usable in constant expressions");
+// Duplicate keys are rejected during constant evaluation, with or without
+// NDEBUG: make_perfect_hash_map<int, int>({{1, 10}, {1, 30}}) in a constexpr
+// initialiser fails with a call to detail::perfect_hash_duplicate_key().
+
+constexpr auto make_squares()
+{
+    embec::map_entry<std::uint32_t, std::uint32_t> entries[300]{};
+    for (std::uint32_t i = 0; i < 300; ++i) {
+        entries[i] = {i * 7919u + 13u, i * i};
+    }
+    return embec::perfect_hash_map<std::uint32_t, std::uint32_t, 300>(entries);
+}
+
+EMBEC_TEST(perfect_hash, "hash_map/perfect_hash")
+{
+    for (const auto& entry : units) {
+        EMBEC_CHECK(units.find_entry(entry.first) == &entry);
+    }
+    static constexpr auto squares = make_squares();
+    for (std::uint32_t i = 0; i < 300; ++i) {
+        const std::uint32_t* v = squares.find(i * 7919u + 13u);
+        EMBEC_REQUIRE(v != nullptr && *v == i * i);
+        EMBEC_REQUIRE(!squares.contains(i * 7919u + 14u));
+    }
+}
+
+} // namespace
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "embec/histogram.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+template <typename Value, unsigned Precision>
+void check_layout(embec::test::rng& r)
+{
+    using layout = embec::histogram_layout<Value, Precision>;
+    // Buckets tile the value range in order.
+    EMBEC_REQUIRE(layout::lowest_in(0) == 0);
+    EMBEC_REQUIRE(layout::highest_in(layout::bucket_count - 1) == static_cast<Value>(~Value{0}));
+    for (std::size_t i = 1; i < layout::bucket_count; ++i) {
+        EMBEC_REQUIRE(layout::lowest_in(i) == layout::highest_in(i - 1) + 1);
+    }
+    // Every value lands in the bucket that covers it, and bucket widths
+    // stay within the precision.
+    for (int k = 0; k < 2000; ++k) {
+        const auto value = static_cast<Value>(r.next() >> r.below(8 * sizeof(Value)));
+        const std::size_t i = layout::index_of(value);
+        EMBEC_REQUIRE(i < layout::bucket_count);
+        EMBEC_REQUIRE(layout::lowest_in(i) <= value && value <= layout::highest_in(i));
+        const auto width = static_cast<double>(layout::highest_in(i) - layout::lowest_in(i));
+        EMBEC_REQUIRE(width <= static_cast<double>(layout::lowest_in(i)) / (1 << Precision));
+    }
+}
+
+EMBEC_TEST(layout, "histogram/layout")
+{
+    embec::test::property(20, [](embec::test::rng& r) {
+        check_layout<std::uint32_t, 4>(r);
+        check_layout<std::uint32_t, 1>(r);
+        check_layout<std::uint16_t, 7>(r);
+        check_layout<std::uint64_t, 5>(r);
+    });
+    EMBEC_CHECK(embec::histogram<>::bucket_count() == 464);
+    EMBEC_CHECK((embec::histogram<std::uint32_t, 3>::bucket_count() == 240));
+}
+
+EMBEC_TEST(percentiles, "histogram/percentiles")
+{
+    // Percentiles never underestimate the exact value and overestimate it
+    // by at most the bucket resolution; merged snapshots answer as if the
+    // values had been recorded together.
+    embec::test::property(100, [](embec::test::rng& r) {
+        embec::histogram<> first;
+        embec::histogram<> second;
+        embec::histogram<> both;
+        std::vector<std::uint32_t> values(1 + r.below(3000));
+        const unsigned spread = 1 + static_cast<unsigned>(r.below(31));
+        for (auto& v : values) {
+            // Latency-like: mostly small, with a long tail.
+            v = static_cast<std::uint32_t>(r.next() >> (32 - spread)) + 100;
+            (r.chance(50) ? first : second).record(v);
+            both.record(v);
+        }
+        auto merged = first.snapshot();
+        merged.merge(second.snapshot());
+        const auto direct = both.snapshot();
+        std::sort(values.begin(), values.end());
+        EMBEC_REQUIRE(merged.count() == values.size() && direct.count() == values.size());
+        EMBEC_REQUIRE(merged.min() == values.front() && merged.max() == values.back());
+        for (const double p : {0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+            const auto rank = static_cast<std::size_t>(
+                std::max(1.0, std::ceil(p / 100 * static_cast<double>(values.size()))));
+            const std::uint32_t exact = values[rank - 1];
+            const std::uint32_t estimate = merged.percentile(p);
+            EMBEC_REQUIRE(estimate == direct.percentile(p));
+            EMBEC_REQUIRE(estimate >= exact && estimate - exact <= exact / 16);
+        }
+        const double mean = static_cast<double>(std::accumulate(values.begin(), values.end(),
+                                                                std::uint64_t{0})) /
+                            static_cast<double>(values.size());
+        EMBEC_REQUIRE(std::fabs(merged.mean() - mean) <= mean / 16);
+    });
+}
+
+EMBEC_TEST(snapshots, "histogram/snapshots")
+{
+    embec::histogram<std::uint16_t, 2> h;
+    auto empty = h.snapshot();
+    EMBEC_CHECK(empty.empty() && empty.min() == 0 && empty.max() == 0 &&
+                empty.percentile(50) == 0 && empty.mean() == 0);
+
+    // Small values are exact.
+    for (std::uint16_t v : {3, 1, 4, 1, 5}) {
+        h.record(v);
+    }
+    h.record(65535);
+    auto s = h.snapshot();
+    EMBEC_CHECK(s.count() == 6 && s.min() == 1 && s.max() == 65535);
+    EMBEC_CHECK(s.percentile(50) == 3 && s.percentile(0) == 1 && s.percentile(100) == 65535);
+    EMBEC_CHECK(s.bucket(1) == 2 && s.bucket_lowest(7) == 7);
+    std::uint64_t exported = 0;
+    s.for_each_bucket([&](std::uint16_t lo, std::uint16_t hi, std::uint32_t n) {
+        EMBEC_CHECK(lo <= hi);
+        exported += n;
+    });
+    EMBEC_CHECK(exported == 6);
+
+    // Draining hands over the counts and starts over.
+    const auto drained = h.drain();
+    EMBEC_CHECK(drained.count() == 6 && drained.max() == 65535);
+    EMBEC_CHECK(h.snapshot().empty() && h.snapshot().max() == 0);
+    h.record(9);
+    s = h.snapshot();
+    EMBEC_CHECK(s.min() == 9 && s.max() == 9);
+    h.reset();
+    EMBEC_CHECK(h.snapshot().empty());
+}
+
+EMBEC_TEST(threads, "histogram/threads")
+{
+    // Concurrent recording and draining lose nothing. Run under TSan.
+    constexpr int threads = 4;
+    constexpr std::uint32_t per_thread = 20000;
+    embec::histogram<> h;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&h, t] {
+            for (std::uint32_t i = 0; i < per_thread; ++i) {
+                h.record(i * (t + 1));
+            }
+        });
+    }
+    embec::histogram_snapshot<> total;
+    for (int k = 0; k < 100; ++k) {
+        total.merge(h.drain());
+        std::this_thread::yield();
+    }
+    for (auto& w : writers) {
+        w.join();
+    }
+    total.merge(h.drain());
+    EMBEC_CHECK(total.count() == threads * per_thread);
+    EMBEC_CHECK(total.min() == 0 && total.max() == (per_thread - 1) * threads);
+}
+
+} // namespace
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <string>
+
+#include "embec/hsm.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+enum class st : std::uint8_t { top, a, a1, a2, b };
+enum class ev : std::uint8_t { to_b, to_a2, self, tick, post_tick, unknown };
+
+struct machine_def;
+
+/// Context logging every action into a string.
+struct recorder {
+    std::string log;
+    bool allow = true;
+    int ticks = 0;
+    embec::hsm<machine_def, 4>* machine = nullptr;
+
+    static void enter_a(recorder& r) { r.log += "+a"; }
+    static void exit_a(recorder& r) { r.log += "-a"; }
+    static void enter_a1(recorder& r) { r.log += "+a1"; }
+    static void exit_a1(recorder& r) { r.log += "-a1"; }
+    static void enter_a2(recorder& r) { r.log += "+a2"; }
+    static void exit_a2(recorder& r) { r.log += "-a2"; }
+    static void enter_b(recorder& r) { r.log += "+b"; }
+    static void exit_b(recorder& r) { r.log += "-b"; }
+    static void act(recorder& r) { r.log += "!"; }
+    static void tick(recorder& r) { ++r.ticks; }
+    static bool allowed(recorder& r) { return r.allow; }
+    static void post_ticks(recorder& r);
+};
+
+struct machine_def {
+    using context = recorder;
+    using event = ev;
+    static constexpr st initial = st::top;
+    using states = embec::hsm_states<embec::hsm_state<st::top, embec::hsm_none, st::a>,
+                                     embec::hsm_state<st::a, st::top, st::a1>,
+                                     embec::hsm_state<st::a1, st::a>,
+                                     embec::hsm_state<st::a2, st::a>,
+                                     embec::hsm_state<st::b, st::top>>;
+    using rules = embec::hsm_rules<
+        embec::hsm_entry<st::a, &recorder::enter_a>, embec::hsm_exit<st::a, &recorder::exit_a>,
+        embec::hsm_entry<st::a1, &recorder::enter_a1>,
+        embec::hsm_exit<st::a1, &recorder::exit_a1>,
+        embec::hsm_entry<st::a2, &recorder::enter_a2>,
+        embec::hsm_exit<st::a2, &recorder::exit_a2>,
+        embec::hsm_entry<st::b, &recorder::enter_b>, embec::hsm_exit<st::b, &recorder::exit_b>,
+        embec::hsm_transition<st::a, ev::to_b, st::b>,                           // rule 8
+        embec::hsm_transition<st::a1, ev::to_a2, st::a2, nullptr, &recorder::allowed>,
+        embec::hsm_transition<st::a, ev::to_a2, st::b, &recorder::act>,          // fallback
+        embec::hsm_transition<st::a2, ev::self, st::a2, &recorder::act>,
+        embec::hsm_internal<st::top, ev::tick, &recorder::tick>,
+        embec::hsm_transition<st::b, ev::post_tick, st::a, &recorder::post_ticks>>;
+};
+
+void recorder::post_ticks(recorder& r)
+{
+    // Run to completion: both ticks are handled after this transition.
+    r.machine->dispatch(ev::tick);
+    r.machine->post(ev::tick);
+    r.log += r.ticks == 0 && r.machine->pending() == 2 ? "q" : "?";
+}
+
+using machine = embec::hsm<machine_def, 4>;
+
+EMBEC_TEST(transitions, "hsm/transitions")
+{
+    recorder r;
+    machine m(r);
+    r.machine = &m;
+    EMBEC_CHECK(m.dispatch(ev::tick) && m.pending() == 1); // queued before start()
+    m.start();
+    EMBEC_CHECK(r.log == "+a+a1" && m.state() == st::a1 && r.ticks == 1);
+    EMBEC_CHECK(m.is_in(st::a) && m.is_in(st::top) && !m.is_in(st::b));
+
+    // Inner rule with a passing guard: exits only up to the common parent.
+    r.log.clear();
+    m.dispatch(ev::to_a2);
+    EMBEC_CHECK(r.log == "-a1+a2" && m.state() == st::a2);
+
+    // Self-transition exits and re-enters the state.
+    r.log.clear();
+    m.dispatch(ev::self);
+    EMBEC_CHECK(r.log == "-a2!+a2");
+
+    // Rule inherited from the parent.
+    r.log.clear();
+    m.dispatch(ev::to_b);
+    EMBEC_CHECK(r.log == "-a2-a+b" && m.state() == st::b);
+
+    // Internal transition on the root runs no exits or entries.
+    r.log.clear();
+    m.dispatch(ev::tick);
+    EMBEC_CHECK(r.log.empty() && r.ticks == 2 && m.state() == st::b);
+
+    // Unhandled events are dropped.
+    EMBEC_CHECK(m.process() == 0);
+    m.post(ev::to_a2);
+    m.post(ev::unknown);
+    EMBEC_CHECK(m.process() == 0 && m.state() == st::b);
+
+    // Events posted from an action are handled after it, in order.
+    r.log.clear();
+    r.ticks = 0;
+    m.dispatch(ev::post_tick);
+    EMBEC_CHECK(r.log == "-bq+a+a1" && r.ticks == 2 && m.state() == st::a1);
+}
+
+EMBEC_TEST(guard_fallback, "hsm/guard_fallback")
+{
+    recorder r;
+    machine m(r);
+    r.machine = &m;
+    m.start();
+    r.allow = false;
+    r.log.clear();
+    m.dispatch(ev::to_a2); // a1's rule is refused; a's rule applies
+    EMBEC_CHECK(r.log == "-a1-a!+b" && m.state() == st::b);
+}
+
+EMBEC_TEST(queue_full, "hsm/queue_full")
+{
+    recorder r;
+    machine m(r);
+    for (int i = 0; i < 4; ++i) {
+        EMBEC_CHECK(m.post(ev::tick));
+    }
+    EMBEC_CHECK(!m.post(ev::tick) && !m.dispatch(ev::tick) && m.pending() == 4);
+    m.start();
+    EMBEC_CHECK(r.ticks == 4 && m.pending() == 0);
+}
+
+EMBEC_TEST(timing_monitor, "hsm/timing_monitor")
+{
+    recorder r;
+    embec::hsm<machine_def, 4, embec::hsm_timing_monitor<machine_def>> m(r);
+    m.start();
+    m.dispatch(ev::to_b);
+    m.dispatch(ev::tick);
+    m.dispatch(ev::tick);
+    EMBEC_CHECK(m.monitor()[8].count == 1 && m.monitor()[12].count == 2);
+    EMBEC_CHECK(m.monitor()[12].max >= m.monitor()[12].last && m.monitor()[9].count == 0);
+    m.monitor().reset();
+    EMBEC_CHECK(m.monitor()[12].count == 0);
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "embec/inline_string.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+std::string random_text(embec::test::rng& r, std::size_t max_length)
+{
+    std::string s(r.below(max_length + 1), ' ');
+    for (char& c : s) {
+        c = static_cast<char>('a' + r.below(4)); // small alphabet so find() hits
+    }
+    return s;
+}
+
+EMBEC_TEST(model, "inline_string/model")
+{
+    // Random edits against std::string, including arguments that view the
+    // string itself.
+    embec::test::property(500, [](embec::test::rng& r) {
+        constexpr std::size_t N = 40;
+        embec::inline_string<N> s;
+        std::string model;
+        for (int step = 0; step < 200; ++step) {
+            const std::size_t room = N - model.size();
+            std::string text = random_text(r, 12);
+            switch (r.below(8)) {
+            case 0:
+                EMBEC_REQUIRE(s.try_append(text) == (text.size() <= room));
+                if (text.size() <= room) {
+                    model += text;
+                }
+                break;
+            case 1:
+                EMBEC_REQUIRE(s.append_truncated(text) == std::min(text.size(), room));
+                model += text.substr(0, room);
+                break;
+            case 2:
+                if (room) {
+                    s.push_back(text.empty() ? 'z' : text[0]);
+                    model.push_back(text.empty() ? 'z' : text[0]);
+                } else {
+                    EMBEC_REQUIRE(!s.try_push_back('z'));
+                }
+                break;
+            case 3: {
+                const std::size_t pos = r.below(model.size() + 1);
+                if (r.chance(50) && !model.empty()) {
+                    // Insert a piece of the string into itself.
+                    const std::size_t from = r.below(model.size());
+                    const std::size_t count =
+                        std::min<std::size_t>(r.below(model.size() - from + 1), room);
+                    text = model.substr(from, count);
+                    s.insert(pos, s.view().substr(from, count));
+                    model.insert(pos, text);
+                } else if (text.size() <= room) {
+                    s.insert(pos, text);
+                    model.insert(pos, text);
+                }
+                break;
+            }
+            case 4: {
+                const std::size_t pos = r.below(model.size() + 1);
+                const std::size_t count = r.below(10);
+                s.erase(pos, count);
+                model.erase(pos, count);
+                break;
+            }
+            case 5: {
+                const std::size_t count = r.below(N + 1);
+                s.resize(count, 'r');
+                model.resize(count, 'r');
+                break;
+            }
+            case 6:
+                if (!model.empty()) {
+                    // Assign a suffix of the string to itself.
+                    const std::size_t from = r.below(model.size());
+                    s = s.view().substr(from);
+                    model = model.substr(from);
+                }
+                break;
+            default:
+                EMBEC_REQUIRE(s.find(text) == model.find(text));
+                EMBEC_REQUIRE(s.starts_with(text) == (model.compare(0, text.size(), text) == 0));
+                EMBEC_REQUIRE(s.ends_with(text) ==
+                              (model.size() >= text.size() &&
+                               model.compare(model.size() - text.size(), text.size(), text) == 0));
+                EMBEC_REQUIRE((s.compare(text) < 0) == (model.compare(text) < 0));
+                break;
+            }
+            EMBEC_REQUIRE(s.view() == model);
+            EMBEC_REQUIRE(std::strlen(s.c_str()) == model.size());
+        }
+    });
+}
+
+EMBEC_TEST(basics, "inline_string/basics")
+{
+    constexpr embec::inline_string<8> fixed("abc");
+    static_assert(fixed.size() == 3 && fixed.view() == "abc", "constexpr construction");
+
+    embec::inline_string<5> s(3, 'x');
+    s += 'y';
+    s += "z";
+    EMBEC_CHECK(s == "xxxyz" && s.full() && !s.try_append("!") && s == "xxxyz");
+    s.pop_back();
+    EMBEC_CHECK(s.size() == 4 && s.c_str()[4] == '\0');
+
+    const embec::inline_string<16> other("xxxy");
+    EMBEC_CHECK(s == other && !(s != other) && other == "xxxy");
+    EMBEC_CHECK(embec::inline_string<4>("ab") < embec::inline_string<9>("b"));
+    const std::string_view view = other;
+    EMBEC_CHECK(view.size() == 4 && view.data() == other.data());
+}
+
+} // namespace
@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <list>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "embec/intrusive.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+struct in_tree;
+
+/// Element linked into a list, a tree and a heap at once.
+struct item : embec::list_hook<>, embec::rb_hook<in_tree> {
+    std::uint32_t key = 0;
+    std::uint32_t id = 0;
+    embec::heap_hook<> in_heap;
+
+    friend bool operator<(const item& a, const item& b) { return a.key < b.key; }
+    friend bool operator<(const item& a, std::uint32_t key) { return a.key < key; }
+    friend bool operator<(std::uint32_t key, const item& a) { return key < a.key; }
+};
+
+using item_list = embec::intrusive_list<item>;
+using item_tree = embec::rb_tree<item, std::less<>, embec::rb_hook<in_tree>>;
+using item_heap =
+    embec::pairing_heap<item, std::less<>,
+                        embec::member_hook<item, embec::heap_hook<>, &item::in_heap>>;
+
+/// Tree entries in the order rb_tree keeps them: by key, then by insertion.
+using tree_model = std::set<std::tuple<std::uint32_t, std::uint64_t, std::uint32_t>>;
+
+EMBEC_TEST(model, "intrusive/model")
+{
+    // The same elements move in and out of all three containers at random.
+    embec::test::property(300, [](embec::test::rng& r) {
+        std::vector<item> items(64);
+        std::vector<std::uint64_t> inserted_at(items.size());
+        for (std::uint32_t i = 0; i < items.size(); ++i) {
+            items[i].id = i;
+        }
+        item_list list;
+        item_tree tree;
+        item_heap heap;
+        std::list<std::uint32_t> list_model;
+        tree_model tree_ids;
+        std::multiset<std::pair<std::uint32_t, std::uint32_t>> heap_model;
+        const auto key_space = 1 + static_cast<std::uint32_t>(r.below(100));
+        std::uint64_t clock = 0;
+
+        for (int step = 0; step < 1000; ++step) {
+            item& it = items[r.below(items.size())];
+            switch (r.below(8)) {
+            case 0:
+                if (!it.list_hook<>::linked()) {
+                    if (r.chance(50)) {
+                        list.push_back(it);
+                        list_model.push_back(it.id);
+                    } else {
+                        list.push_front(it);
+                        list_model.push_front(it.id);
+                    }
+                }
+                break;
+            case 1:
+                if (it.list_hook<>::linked()) {
+                    it.list_hook<>::unlink(); // without knowing the list
+                    list_model.remove(it.id);
+                }
+                break;
+            case 2:
+                if (!it.rb_hook<in_tree>::linked() && !it.in_heap.linked()) {
+                    it.key = static_cast<std::uint32_t>(r.below(key_space));
+                    inserted_at[it.id] = clock++;
+                    tree.insert(it);
+                    tree_ids.emplace(it.key, inserted_at[it.id], it.id);
+                }
+                break;
+            case 3:
+                if (it.rb_hook<in_tree>::linked()) {
+                    tree.erase(it);
+                    tree_ids.erase({it.key, inserted_at[it.id], it.id});
+                } else if (!tree.empty()) {
+                    const item& first = tree.pop_front();
+                    EMBEC_REQUIRE(std::get<2>(*tree_ids.begin()) == first.id);
+                    tree_ids.erase(tree_ids.begin());
+                }
+                break;
+            case 4:
+                if (!it.in_heap.linked() && !it.rb_hook<in_tree>::linked()) {
+                    it.key = static_cast<std::uint32_t>(r.below(key_space));
+                    heap.push(it);
+                    heap_model.emplace(it.key, it.id);
+                }
+                break;
+            case 5:
+                if (!heap.empty()) {
+                    const item& top = heap.pop();
+                    EMBEC_REQUIRE(top.key == heap_model.begin()->first);
+                    EMBEC_REQUIRE(heap_model.erase({top.key, top.id}) == 1);
+                }
+                break;
+            case 6:
+                if (it.in_heap.linked()) {
+                    // Move the key either way, or drop the element.
+                    heap_model.erase({it.key, it.id});
+                    if (r.chance(30)) {
+                        heap.erase(it);
+                        break;
+                    }
+                    if (r.chance(50) && it.key > 0) {
+                        it.key = static_cast<std::uint32_t>(r.below(it.key));
+                        heap.decrease(it);
+                    } else {
+                        it.key = static_cast<std::uint32_t>(r.below(key_space));
+                        heap.update(it);
+                    }
+                    heap_model.emplace(it.key, it.id);
+                }
+                break;
+            default: {
+                // Searches.
+                const auto key = static_cast<std::uint32_t>(r.below(key_space + 1));
+                const auto lower = tree.lower_bound(key);
+                const auto model_lower = tree_ids.lower_bound({key, 0, 0});
+                EMBEC_REQUIRE((lower == tree.end()) == (model_lower == tree_ids.end()));
+                if (lower != tree.end()) {
+                    EMBEC_REQUIRE(lower->id == std::get<2>(*model_lower));
+                }
+                const auto upper = tree.upper_bound(key);
+                const auto model_upper = tree_ids.lower_bound({key + 1, 0, 0});
+                EMBEC_REQUIRE((upper == tree.end()) == (model_upper == tree_ids.end()));
+                EMBEC_REQUIRE(tree.contains(key) == (model_lower != model_upper));
+                break;
+            }
+            }
+            EMBEC_REQUIRE(tree.size() == tree_ids.size() && heap.size() == heap_model.size());
+            if (!heap.empty()) {
+                EMBEC_REQUIRE(heap.top().key == heap_model.begin()->first);
+            }
+        }
+
+        EMBEC_CHECK(list.size() == list_model.size());
+        EMBEC_CHECK(std::equal(list.begin(), list.end(), list_model.begin(), list_model.end(),
+                               [](const item& a, std::uint32_t id) { return a.id == id; }));
+        EMBEC_CHECK(std::equal(tree.begin(), tree.end(), tree_ids.begin(), tree_ids.end(),
+                               [](const item& a, const auto& entry) {
+                                   return a.id == std::get<2>(entry);
+                               }));
+        // Backwards from end() too.
+        auto back = tree.end();
+        for (auto model_it = tree_ids.rbegin(); model_it != tree_ids.rend(); ++model_it) {
+            EMBEC_REQUIRE((--back)->id == std::get<2>(*model_it));
+        }
+        tree.clear();
+        heap.clear();
+        for (const item& i : items) {
+            EMBEC_REQUIRE(!i.rb_hook<in_tree>::linked() && !i.in_heap.linked());
+        }
+        // items is destroyed before list: destruction unlinks from the list.
+        items.clear();
+        EMBEC_CHECK(list.empty());
+    });
+}
+
+EMBEC_TEST(list_operations, "intrusive/list_operations")
+{
+    item a, b, c, d;
+    a.id = 1;
+    b.id = 2;
+    c.id = 3;
+    d.id = 4;
+    item_list first;
+    item_list second;
+    first.push_back(a);
+    first.push_back(b);
+    second.push_back(c);
+    second.push_back(d);
+    first.splice(first.iterator_to(b), second);
+    std::vector<std::uint32_t> ids;
+    for (const item& i : first) {
+        ids.push_back(i.id);
+    }
+    EMBEC_CHECK((ids == std::vector<std::uint32_t>{1, 3, 4, 2}) && second.empty());
+    EMBEC_CHECK(first.erase(first.iterator_to(c))->id == 4);
+    EMBEC_CHECK(first.insert(first.begin(), c)->id == 3 && first.front().id == 3);
+
+    // A copy of a linked element is not linked.
+    const item copy = a;
+    EMBEC_CHECK(!copy.list_hook<>::linked() && a.list_hook<>::linked());
+    first.clear();
+    EMBEC_CHECK(!a.list_hook<>::linked() && first.size() == 0);
+}
+
+EMBEC_TEST(tree_insert_unique, "intrusive/tree_insert_unique")
+{
+    item a, b;
+    a.key = 5;
+    b.key = 5;
+    item_tree tree;
+    EMBEC_CHECK(tree.insert_unique(a).second);
+    const auto [pos, inserted] = tree.insert_unique(b);
+    EMBEC_CHECK(!inserted && &*pos == &a && tree.size() == 1 && tree.find(5u) != tree.end());
+}
+
+} // namespace
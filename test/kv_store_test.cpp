@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "embec/flash_sim.hpp"
+#include "embec/kv_store.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using flash_type = embec::flash_sim<1024, 6, 8>;
+using store_type = embec::kv_store<flash_type, 32>;
+using model_type = std::map<std::uint16_t, std::vector<std::uint8_t>>;
+
+std::vector<std::uint8_t> random_value(embec::test::rng& r)
+{
+    std::vector<std::uint8_t> value(r.below(41));
+    r.fill(value.data(), value.size());
+    return value;
+}
+
+/// True if @p store holds exactly the contents of @p model.
+bool matches(const store_type& store, const model_type& model)
+{
+    if (store.size() != model.size()) {
+        return false;
+    }
+    for (const auto& [key, value] : model) {
+        std::uint8_t out[store_type::max_value_size];
+        const embec::kv_result result = store.get(key, out, sizeof(out));
+        if (!result || result.length != value.size() ||
+            !std::equal(value.begin(), value.end(), out)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Applies a random put or erase to @p store and to @p model, where it
+/// counts as done if it succeeds or fails with a flash error (in which case
+/// it may or may not have happened).
+embec::kv_status random_write(embec::test::rng& r, store_type& store, model_type& model)
+{
+    const auto key = static_cast<std::uint16_t>(r.below(store_type::capacity()));
+    if (r.chance(20)) {
+        const embec::kv_status status = store.erase(key);
+        if (status == embec::kv_status::ok || status == embec::kv_status::flash_error) {
+            model.erase(key);
+        }
+        return status;
+    }
+    const std::vector<std::uint8_t> value = random_value(r);
+    const embec::kv_status status = store.put(key, value.data(), value.size());
+    if (status == embec::kv_status::ok || status == embec::kv_status::flash_error) {
+        model[key] = value;
+    }
+    return status;
+}
+
+EMBEC_TEST(model, "kv_store/model")
+{
+    embec::test::property(100, [](embec::test::rng& r) {
+        flash_type flash;
+        EMBEC_REQUIRE(flash.open());
+        auto store = std::make_unique<store_type>(flash);
+        // Blank flash mounts as an empty store.
+        EMBEC_REQUIRE(store->mount() == embec::kv_status::ok && store->size() == 0);
+        model_type model;
+        for (int step = 0; step < 600; ++step) {
+            const embec::kv_status status = random_write(r, *store, model);
+            EMBEC_REQUIRE(status == embec::kv_status::ok || status == embec::kv_status::not_found);
+            if (r.chance(5)) {
+                EMBEC_REQUIRE(store->collect_step() == embec::kv_status::ok);
+            }
+            if (r.chance(2)) {
+                // Reset: a new store object mounts the same flash.
+                store = std::make_unique<store_type>(flash);
+                EMBEC_REQUIRE(store->mount() == embec::kv_status::ok);
+            }
+            EMBEC_REQUIRE(store->size() == model.size());
+        }
+        EMBEC_CHECK(matches(*store, model));
+        EMBEC_CHECK(flash.stats().overwrites == 0);
+        // The ring wears all sectors alike.
+        std::uint32_t least = ~0u;
+        std::uint32_t most = 0;
+        for (std::size_t s = 0; s < flash_type::sector_count; ++s) {
+            least = std::min(least, flash.erase_count(s));
+            most = std::max(most, flash.erase_count(s));
+        }
+        EMBEC_CHECK(most - least <= 1);
+    });
+}
+
+EMBEC_TEST(power_cuts, "kv_store/power_cuts")
+{
+    // Power fails in the middle of a random operation; after mounting again
+    // only that operation may be lost.
+    embec::test::property(400, [](embec::test::rng& r) {
+        flash_type flash;
+        EMBEC_REQUIRE(flash.open());
+        model_type model;
+        {
+            store_type store(flash);
+            EMBEC_REQUIRE(store.format() == embec::kv_status::ok);
+            for (std::uint64_t i = r.below(300); i > 0; --i) {
+                random_write(r, store, model);
+            }
+        }
+        for (int cut = 0; cut < 5; ++cut) {
+            store_type store(flash);
+            EMBEC_REQUIRE(store.mount() == embec::kv_status::ok);
+            EMBEC_REQUIRE(matches(store, model));
+            flash.cut_power_after(r.below(12), static_cast<std::uint32_t>(r.next()));
+            model_type before;
+            embec::kv_status status = embec::kv_status::ok;
+            while (status != embec::kv_status::flash_error) {
+                before = model;
+                status = random_write(r, store, model);
+            }
+            EMBEC_REQUIRE(!store.mounted());
+            flash.power_on();
+            flash.cancel_power_cut();
+
+            store_type after(flash);
+            EMBEC_REQUIRE(after.mount() == embec::kv_status::ok);
+            if (!matches(after, model)) {
+                // The interrupted write was lost.
+                EMBEC_REQUIRE(matches(after, before));
+                model = before;
+            }
+        }
+    });
+}
+
+EMBEC_TEST(limits, "kv_store/limits")
+{
+    flash_type flash;
+    EMBEC_REQUIRE(flash.open());
+    store_type store(flash);
+    EMBEC_REQUIRE(store.format() == embec::kv_status::ok);
+    std::uint8_t big[store_type::max_value_size + 1] = {};
+    EMBEC_CHECK(store.put(1, big, sizeof(big)) == embec::kv_status::too_large);
+    EMBEC_CHECK(store.put(1, big, sizeof(big) - 1) == embec::kv_status::ok);
+    std::uint8_t small[4];
+    const embec::kv_result short_read = store.get(1, small, sizeof(small));
+    EMBEC_CHECK(short_read.status == embec::kv_status::too_large &&
+                short_read.length == store_type::max_value_size);
+    EMBEC_CHECK(store.get(2, small, sizeof(small)).status == embec::kv_status::not_found);
+    EMBEC_CHECK(store.erase(2) == embec::kv_status::not_found);
+
+    // The index holds MaxKeys keys.
+    for (std::uint16_t key = 0; key < store_type::capacity(); ++key) {
+        EMBEC_REQUIRE(store.put(key, &key, sizeof(key)) == embec::kv_status::ok);
+    }
+    const std::uint16_t extra = store_type::capacity();
+    EMBEC_CHECK(store.put(extra, &extra, sizeof(extra)) == embec::kv_status::no_space);
+    EMBEC_CHECK(store.erase(0) == embec::kv_status::ok && !store.contains(0));
+    EMBEC_CHECK(store.put(extra, &extra, sizeof(extra)) == embec::kv_status::ok);
+}
+
+EMBEC_TEST(corrupt_record, "kv_store/corrupt_record")
+{
+    // A flipped bit in the newest record loses that record only.
+    flash_type flash;
+    EMBEC_REQUIRE(flash.open());
+    {
+        store_type store(flash);
+        EMBEC_REQUIRE(store.format() == embec::kv_status::ok);
+        const std::uint32_t a = 1;
+        const std::uint32_t b = 2;
+        EMBEC_REQUIRE(store.put(7, &a, sizeof(a)) == embec::kv_status::ok);
+        EMBEC_REQUIRE(store.put(7, &b, sizeof(b)) == embec::kv_status::ok);
+    }
+    // Flip a value bit of the second record {key 7, length 4, CRC, value}.
+    const std::uint8_t header[] = {7, 0, 4, 0};
+    std::uint8_t* const end = flash.data() + flash_type::size;
+    std::uint8_t* record = std::search(flash.data(), end, header, header + 4);
+    record = std::search(record + 4, end, header, header + 4);
+    EMBEC_REQUIRE(record != end);
+    record[8] ^= 0x04;
+    store_type store(flash);
+    EMBEC_REQUIRE(store.mount() == embec::kv_status::ok);
+    std::uint32_t value = 0;
+    EMBEC_CHECK(store.get(7, &value, sizeof(value)) && value == 1);
+}
+
+} // namespace
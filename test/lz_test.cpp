@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "embec/lz.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+// Input with repeats at assorted distances and lengths, some beyond any
+// window, mixed with runs and random bytes.
+std::vector<std::uint8_t> compressible(embec::test::rng& r, std::size_t length)
+{
+    std::vector<std::uint8_t> data;
+    while (data.size() < length) {
+        const std::size_t n = 1 + r.below(40);
+        switch (r.below(4)) {
+        case 0:
+            for (std::size_t i = 0; i < n; ++i) {
+                data.push_back(static_cast<std::uint8_t>(r.next()));
+            }
+            break;
+        case 1:
+            data.insert(data.end(), n, static_cast<std::uint8_t>(r.below(3)));
+            break;
+        default:
+            if (!data.empty()) {
+                const std::size_t distance = 1 + r.below(std::min<std::size_t>(data.size(), 3000));
+                for (std::size_t i = 0; i < n; ++i) {
+                    data.push_back(data[data.size() - distance]);
+                }
+            }
+            break;
+        }
+    }
+    data.resize(length);
+    return data;
+}
+
+// Streams @p input through the encoder and decoder in random chunks with
+// random output space, and checks the result.
+template <typename Encoder, typename Decoder>
+bool round_trip(Encoder& encoder, Decoder& decoder, const std::vector<std::uint8_t>& input,
+                embec::test::rng& r, std::size_t* compressed_size = nullptr)
+{
+    std::vector<std::uint8_t> compressed;
+    std::uint8_t chunk[64];
+    encoder.reset();
+    embec::lz_status status = embec::lz_status::need_input;
+    std::size_t at = 0;
+    while (status != embec::lz_status::done) {
+        if (at < input.size()) {
+            at += encoder.sink(input.data() + at, std::min<std::size_t>(1 + r.below(100),
+                                                                          input.size() - at));
+        } else if (status == embec::lz_status::need_input) {
+            encoder.finish();
+        }
+        const std::size_t n = encoder.poll(chunk, 1 + r.below(sizeof(chunk)), status);
+        compressed.insert(compressed.end(), chunk, chunk + n);
+        if (status == embec::lz_status::invalid) {
+            return false;
+        }
+    }
+    if (compressed.size() > embec::lz_max_compressed_size(input.size())) {
+        return false;
+    }
+    if (compressed_size) {
+        *compressed_size = compressed.size();
+    }
+
+    std::vector<std::uint8_t> output;
+    decoder.reset();
+    status = embec::lz_status::need_input;
+    at = 0;
+    while (status != embec::lz_status::done) {
+        if (at < compressed.size()) {
+            at += decoder.sink(compressed.data() + at,
+                               std::min<std::size_t>(1 + r.below(20), compressed.size() - at));
+        } else if (status == embec::lz_status::need_input) {
+            decoder.finish();
+        }
+        const std::size_t n = decoder.poll(chunk, 1 + r.below(sizeof(chunk)), status);
+        output.insert(output.end(), chunk, chunk + n);
+        if (status == embec::lz_status::invalid) {
+            return false;
+        }
+    }
+    return output == input;
+}
+
+EMBEC_TEST(round_trip_test, "lz/round_trip")
+{
+    // Window sizes from the smallest to a few KiB, with and without hash
+    // chains, on inputs several windows long.
+    embec::test::property(40, [](embec::test::rng& r) {
+        const auto input = compressible(r, r.below(6000));
+        static embec::lz_encoder<4, 3> tiny_encoder;
+        static embec::lz_decoder<4, 3, 1> tiny_decoder;
+        static embec::lz_encoder<8, 4, 8, 1> small_encoder;
+        static embec::lz_decoder<8, 4> small_decoder;
+        static embec::lz_encoder<10, 5, 9, 4> medium_encoder;
+        static embec::lz_decoder<10, 5, 8> medium_decoder;
+        static embec::lz_encoder<12, 8> large_encoder;
+        static embec::lz_decoder<12, 8> large_decoder;
+        EMBEC_REQUIRE(round_trip(tiny_encoder, tiny_decoder, input, r));
+        EMBEC_REQUIRE(round_trip(small_encoder, small_decoder, input, r));
+        EMBEC_REQUIRE(round_trip(medium_encoder, medium_decoder, input, r));
+        EMBEC_REQUIRE(round_trip(large_encoder, large_decoder, input, r));
+    });
+}
+
+EMBEC_TEST(ratio, "lz/ratio")
+{
+    embec::test::rng r(7);
+    static embec::lz_encoder<8, 4> encoder;
+    static embec::lz_decoder<8, 4> decoder;
+
+    // Repetitive text shrinks a lot, random bytes grow by at most 1/8.
+    std::vector<std::uint8_t> text;
+    while (text.size() < 4000) {
+        const char line[] = "t=1234,temp=21.5,hum=40.2,ok\n";
+        text.insert(text.end(), line, line + sizeof(line) - 1);
+    }
+    std::size_t size = 0;
+    EMBEC_CHECK(round_trip(encoder, decoder, text, r, &size));
+    EMBEC_CHECK(size < text.size() / 8);
+
+    std::vector<std::uint8_t> noise(4000);
+    r.fill(noise.data(), noise.size());
+    EMBEC_CHECK(round_trip(encoder, decoder, noise, r, &size));
+    EMBEC_CHECK(size <= embec::lz_max_compressed_size(noise.size()));
+
+    std::vector<std::uint8_t> empty;
+    EMBEC_CHECK(round_trip(encoder, decoder, empty, r, &size) && size == 0);
+}
+
+EMBEC_TEST(one_shot, "lz/one_shot")
+{
+    static embec::lz_encoder<9, 4> encoder;
+    static embec::lz_decoder<9, 4> decoder;
+    std::uint8_t input[300];
+    for (std::size_t i = 0; i < sizeof(input); ++i) {
+        input[i] = static_cast<std::uint8_t>(i % 17);
+    }
+    std::uint8_t compressed[embec::lz_max_compressed_size(sizeof(input))];
+    std::uint8_t output[sizeof(input)];
+
+    const embec::frame_result c =
+        embec::lz_compress(encoder, input, sizeof(input), compressed, sizeof(compressed));
+    EMBEC_REQUIRE(c && c.length < 60);
+    const embec::frame_result d =
+        embec::lz_decompress(decoder, compressed, c.length, output, sizeof(output));
+    EMBEC_CHECK(d && d.length == sizeof(input) && std::memcmp(output, input, sizeof(input)) == 0);
+
+    // Too little room on either side.
+    EMBEC_CHECK(embec::lz_compress(encoder, input, sizeof(input), compressed, c.length - 1)
+                    .status == embec::frame_status::overflow);
+    EMBEC_CHECK(embec::lz_decompress(decoder, compressed, c.length, output, sizeof(output) - 1)
+                    .status == embec::frame_status::overflow);
+}
+
+EMBEC_TEST(invalid, "lz/invalid")
+{
+    static embec::lz_decoder<8, 4> decoder;
+    std::uint8_t output[64];
+
+    // A match before any output refers outside the window.
+    const std::uint8_t early_match[] = {0x00, 0x00, 0x00};
+    EMBEC_CHECK(embec::lz_decompress(decoder, early_match, sizeof(early_match), output,
+                                     sizeof(output))
+                    .status == embec::frame_status::invalid);
+
+    // Literal 'A' (1 01000001) then a match 2 bytes back while only one
+    // byte exists.
+    const std::uint8_t far_match[] = {0xa0, 0x80, 0x40};
+    EMBEC_CHECK(embec::lz_decompress(decoder, far_match, sizeof(far_match), output,
+                                     sizeof(output))
+                    .status == embec::frame_status::invalid);
+
+    // A whole byte of a token that never completes is truncation, not
+    // padding.
+    const std::uint8_t truncated[] = {0xff};
+    EMBEC_CHECK(embec::lz_decompress(decoder, truncated, sizeof(truncated), output,
+                                     sizeof(output))
+                    .status == embec::frame_status::invalid);
+
+    // The error sticks until reset.
+    decoder.reset();
+    decoder.sink(early_match, sizeof(early_match));
+    embec::lz_status status;
+    decoder.poll(output, sizeof(output), status);
+    EMBEC_CHECK(status == embec::lz_status::invalid);
+    const std::uint8_t literal[] = {0xa0, 0x80};
+    EMBEC_CHECK(decoder.sink(literal, 1) == 1);
+    EMBEC_CHECK(decoder.poll(output, sizeof(output), status) == 0 &&
+                status == embec::lz_status::invalid);
+    decoder.reset();
+    decoder.sink(literal, sizeof(literal));
+    decoder.finish();
+    EMBEC_CHECK(decoder.poll(output, sizeof(output), status) == 1 && output[0] == 'A' &&
+                status == embec::lz_status::done);
+}
+
+} // namespace
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Test runner.
+//
+// Usage: embec_tests [--output FILE] [--filter PREFIX] [--seed N] [--list]
+//
+// Runs every registered test whose name starts with the filter, in name
+// order, and writes one PASS/FAIL line per test plus a summary to stdout and
+// to the output file (test_output.txt by default). Failed checks are listed
+// under their test together with the property seed, if any; rerunning with
+// --seed reproduces the same generated inputs. Exits with status 1 if any
+// test failed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "test.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+void print(std::FILE* out, const char* format, const char* name, unsigned long long checks,
+           double ms)
+{
+    for (std::FILE* f : {stdout, out}) {
+        std::fprintf(f, format, name, checks, ms);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* output_path = "test_output.txt";
+    const char* filter = nullptr;
+    bool list = false;
+    embec::test::context& ctx = embec::test::current();
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--output") && has_value) {
+            output_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--filter") && has_value) {
+            filter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--seed") && has_value) {
+            ctx.base_seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (!std::strcmp(argv[i], "--list")) {
+            list = true;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--output FILE] [--filter PREFIX] [--seed N] [--list]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    auto tests = embec::test::registry();
+    std::sort(tests.begin(), tests.end(),
+              [](const auto& a, const auto& b) { return std::strcmp(a.name, b.name) < 0; });
+    const std::size_t filter_length = filter ? std::strlen(filter) : 0;
+    tests.erase(std::remove_if(tests.begin(), tests.end(),
+                               [&](const auto& t) {
+                                   return filter && std::strncmp(t.name, filter, filter_length);
+                               }),
+                tests.end());
+
+    if (list) {
+        for (const auto& t : tests) {
+            std::printf("%s\n", t.name);
+        }
+        return 0;
+    }
+
+    std::FILE* out = std::fopen(output_path, "w");
+    if (!out) {
+        std::perror(output_path);
+        return 1;
+    }
+    ctx.log = out;
+    std::fprintf(out, "seed %llu\n", static_cast<unsigned long long>(ctx.base_seed));
+
+    std::size_t failed = 0;
+    std::uint64_t checks = 0;
+    for (const auto& t : tests) {
+        ctx.test = t.name;
+        ctx.checks = 0;
+        ctx.failures = 0;
+        std::fflush(out);
+        const auto start = clock_type::now();
+        t.fn();
+        const double ms =
+            std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        checks += ctx.checks;
+        if (ctx.failures != 0) {
+            ++failed;
+            print(out, "FAIL %-48s %10llu checks %9.1f ms\n", t.name, ctx.checks, ms);
+        } else {
+            print(out, "PASS %-48s %10llu checks %9.1f ms\n", t.name, ctx.checks, ms);
+        }
+    }
+
+    for (std::FILE* f : {stdout, out}) {
+        std::fprintf(f, "%zu tests, %zu passed, %zu failed, %llu checks\n", tests.size(),
+                     tests.size() - failed, failed, static_cast<unsigned long long>(checks));
+    }
+    std::fclose(out);
+    return failed != 0 ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "embec/mpmc_queue.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+EMBEC_TEST(basic, "mpmc_queue/basic")
+{
+    embec::mpmc_queue<int, 4> queue;
+    int v = 0;
+    EMBEC_CHECK(queue.empty() && queue.capacity() == 4 && !queue.pop(v));
+    for (int i = 0; i < 4; ++i) {
+        EMBEC_CHECK(queue.push(i));
+    }
+    EMBEC_CHECK(!queue.push(4) && queue.size() == 4);
+    EMBEC_CHECK(queue.pop(v) && v == 0);
+    EMBEC_CHECK(queue.push(4));
+    for (int i = 1; i <= 4; ++i) {
+        EMBEC_CHECK(queue.pop(v) && v == i);
+    }
+    EMBEC_CHECK(queue.empty() && !queue.pop(v));
+
+    // Batches stop at the capacity and at the content.
+    const int in[6] = {1, 2, 3, 4, 5, 6};
+    int out[6] = {};
+    EMBEC_CHECK(queue.push(in, 6) == 4 && queue.push(in, 1) == 0);
+    EMBEC_CHECK(queue.pop(out, 3) == 3 && out[0] == 1 && out[2] == 3);
+    EMBEC_CHECK(queue.push(in + 4, 2) == 2);
+    EMBEC_CHECK(queue.pop(out, 6) == 3 && out[0] == 4 && out[1] == 5 && out[2] == 6);
+    EMBEC_CHECK(queue.pop(out, 6) == 0);
+    queue.push(9);
+    queue.reset();
+    EMBEC_CHECK(queue.empty() && !queue.pop(v) && queue.push(in, 6) == 4);
+}
+
+EMBEC_TEST(model, "mpmc_queue/model")
+{
+    // Single-context pushes and pops, single and batched, against a deque.
+    embec::test::property(200, [](embec::test::rng& r) {
+        embec::mpmc_queue<std::uint32_t, 16> queue;
+        std::deque<std::uint32_t> model;
+        std::uint32_t next = 0;
+        for (int step = 0; step < 500; ++step) {
+            std::uint32_t buf[24];
+            const std::size_t n = 1 + r.below(24);
+            switch (r.below(4)) {
+            case 0:
+                if (queue.push(next)) {
+                    EMBEC_REQUIRE(model.size() < 16);
+                    model.push_back(next++);
+                } else {
+                    EMBEC_REQUIRE(model.size() == 16);
+                }
+                break;
+            case 1: {
+                for (std::size_t i = 0; i < n; ++i) {
+                    buf[i] = next + static_cast<std::uint32_t>(i);
+                }
+                const std::size_t pushed = queue.push(buf, n);
+                EMBEC_REQUIRE(pushed == std::min(n, 16 - model.size()));
+                for (std::size_t i = 0; i < pushed; ++i) {
+                    model.push_back(next++);
+                }
+                break;
+            }
+            case 2: {
+                std::uint32_t v = 0;
+                const bool popped = queue.pop(v);
+                EMBEC_REQUIRE(popped == !model.empty());
+                if (popped) {
+                    EMBEC_REQUIRE(v == model.front());
+                    model.pop_front();
+                }
+                break;
+            }
+            default: {
+                const std::size_t popped = queue.pop(buf, n);
+                EMBEC_REQUIRE(popped == std::min(n, model.size()));
+                for (std::size_t i = 0; i < popped; ++i) {
+                    EMBEC_REQUIRE(buf[i] == model.front());
+                    model.pop_front();
+                }
+                break;
+            }
+            }
+            EMBEC_REQUIRE(queue.size() == model.size());
+        }
+    });
+}
+
+EMBEC_TEST(threads, "mpmc_queue/threads")
+{
+    // Several producers and consumers share a small queue, single and
+    // batched. Every element must arrive exactly once, and each consumer
+    // must see each producer's elements in order. Run under TSan to check
+    // the memory ordering.
+    constexpr std::uint32_t producers = 3;
+    constexpr std::uint32_t consumers = 3;
+    constexpr std::uint32_t per_producer = 30000;
+    embec::mpmc_queue<std::uint32_t, 32> queue;
+    std::atomic<std::uint32_t> remaining{producers * per_producer};
+    std::vector<std::uint32_t> seen(producers * per_producer, 0);
+    std::atomic<std::uint32_t> errors{0};
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            std::uint32_t next = 0;
+            while (next < per_producer) {
+                std::uint32_t buf[5];
+                const std::uint32_t n =
+                    p == 0 ? 1 : std::min<std::uint32_t>(5, per_producer - next);
+                for (std::uint32_t i = 0; i < n; ++i) {
+                    buf[i] = p * per_producer + next + i;
+                }
+                const std::size_t pushed = n == 1 ? queue.push(buf[0]) : queue.push(buf, n);
+                next += static_cast<std::uint32_t>(pushed);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<std::vector<std::uint32_t>> received(consumers);
+    for (std::uint32_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::vector<std::uint32_t> last(producers, 0);
+            while (remaining.load(std::memory_order_relaxed) != 0) {
+                std::uint32_t buf[7];
+                const std::size_t n = c == 0 ? queue.pop(buf[0]) : queue.pop(buf, 7);
+                if (n == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::size_t i = 0; i < n; ++i) {
+                    const std::uint32_t p = buf[i] / per_producer;
+                    const std::uint32_t k = buf[i] % per_producer + 1;
+                    errors.fetch_add(p >= producers || k <= last[p], std::memory_order_relaxed);
+                    last[p] = k;
+                    received[c].push_back(buf[i]);
+                }
+                remaining.fetch_sub(static_cast<std::uint32_t>(n), std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& values : received) {
+        for (std::uint32_t v : values) {
+            ++seen[v];
+        }
+    }
+    std::uint32_t wrong = 0;
+    for (std::uint32_t count : seen) {
+        wrong += count != 1;
+    }
+    EMBEC_CHECK(errors.load() == 0 && wrong == 0);
+    EMBEC_CHECK(queue.empty());
+}
+
+} // namespace
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+// Compiled with EMBEC_NO_PROFILE defined (see CMakeLists.txt).
+
+#include <cstring>
+
+#include "embec/profile.hpp"
+
+#include "test.hpp"
+
+#if !defined(EMBEC_NO_PROFILE)
+#error "this file must be compiled with EMBEC_NO_PROFILE"
+#endif
+
+namespace {
+
+EMBEC_PROFILE_COUNTER(disabled_events);
+EMBEC_PROFILE_EXTERN_COUNTER(disabled_elsewhere);
+EMBEC_PROFILE_HISTOGRAM(disabled_cycles);
+EMBEC_PROFILE_EXTERN_HISTOGRAM(disabled_cycles_elsewhere);
+
+EMBEC_TEST(disabled, "profile/disabled")
+{
+    // The macros expand to nothing: their arguments are never evaluated
+    // and the objects they name do not exist.
+    int evaluated = 0;
+    const auto touch = [&evaluated] { return static_cast<std::uint32_t>(++evaluated); };
+    EMBEC_PROFILE_COUNT(disabled_events);
+    EMBEC_PROFILE_ADD(disabled_events, touch());
+    EMBEC_PROFILE_RECORD(disabled_cycles, touch());
+    {
+        EMBEC_PROFILE_SCOPE(disabled_cycles);
+    }
+    EMBEC_CHECK(evaluated == 0 && touch() == 1);
+
+    for (auto* c = embec::profile_counter::first(); c != nullptr; c = c->next()) {
+        EMBEC_CHECK(std::strcmp(c->name(), "disabled_events") != 0);
+    }
+    for (auto* h = embec::profile_histogram::first(); h != nullptr; h = h->next()) {
+        EMBEC_CHECK(std::strcmp(h->name(), "disabled_cycles") != 0);
+    }
+}
+
+} // namespace
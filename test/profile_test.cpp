@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "embec/profile.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+EMBEC_PROFILE_COUNTER(test_events);
+EMBEC_PROFILE_HISTOGRAM(test_scope_cycles);
+EMBEC_PROFILE_HISTOGRAM(test_values);
+
+template <typename Node>
+const Node* find(const Node* first, const char* name)
+{
+    for (const Node* n = first; n != nullptr; n = n->next()) {
+        if (std::strcmp(n->name(), name) == 0) {
+            return n;
+        }
+    }
+    return nullptr;
+}
+
+EMBEC_TEST(registry, "profile/registry")
+{
+    // Objects defined with the macros are named after their variables and
+    // can be found by enumeration.
+    EMBEC_CHECK(find(embec::profile_counter::first(), "test_events") == &test_events);
+    EMBEC_CHECK(find(embec::profile_histogram::first(), "test_scope_cycles") ==
+                &test_scope_cycles);
+    EMBEC_CHECK(find(embec::profile_histogram::first(), "test_values") == &test_values);
+    EMBEC_CHECK(find(embec::profile_counter::first(), "missing") == nullptr);
+}
+
+EMBEC_TEST(counters, "profile/counters")
+{
+    test_events.drain();
+    EMBEC_PROFILE_COUNT(test_events);
+    EMBEC_PROFILE_ADD(test_events, 41);
+    EMBEC_CHECK(test_events.value() == 42);
+    EMBEC_CHECK(test_events.drain() == 42 && test_events.value() == 0);
+
+    // Concurrent increments are not lost. Run under TSan.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 10000; ++i) {
+                EMBEC_PROFILE_COUNT(test_events);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EMBEC_CHECK(test_events.drain() == 40000);
+}
+
+EMBEC_TEST(timers, "profile/timers")
+{
+    test_scope_cycles.reset();
+    for (int i = 0; i < 10; ++i) {
+        EMBEC_PROFILE_SCOPE(test_scope_cycles);
+        volatile int sink = 0;
+        for (int k = 0; k < 1000 * i; ++k) {
+            sink = sink + k;
+        }
+    }
+    const auto s = test_scope_cycles.drain();
+    EMBEC_CHECK(s.count() == 10 && s.max() >= s.min() && s.max() > 0);
+
+    // record_since() measures from an earlier reading.
+    test_values.reset();
+    test_values.record_since(static_cast<embec::cycles_t>(embec::cycle_counter::now() - 1000));
+    EMBEC_PROFILE_RECORD(test_values, 7u);
+    const auto v = test_values.drain();
+    EMBEC_CHECK(v.count() == 2 && v.min() == 7 && v.max() >= 1000);
+}
+
+} // namespace
@@ -0,0 +1,219 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <string>
+
+#include "embec/scheduler.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+/// Appends its name to a log, yielding in between, @p rounds times.
+struct yielder : embec::protothread<yielder> {
+    std::string* log = nullptr;
+    char name = '?';
+    int rounds = 0;
+    int i = 0;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        for (i = 0; i < rounds; ++i) {
+            *log += name;
+            EMBEC_PT_YIELD();
+        }
+        EMBEC_PT_END();
+    }
+};
+
+EMBEC_TEST(priorities, "scheduler/priorities")
+{
+    // The most urgent level runs first; equal priorities take turns.
+    std::string log;
+    embec::scheduler sched;
+    yielder a, b, c;
+    a.log = b.log = c.log = &log;
+    a.name = 'a';
+    b.name = 'b';
+    c.name = 'c';
+    a.rounds = b.rounds = 3;
+    c.rounds = 2;
+    sched.spawn(a, 5);
+    sched.spawn(b, 5);
+    sched.spawn(c, 1);
+    EMBEC_CHECK(a.state() == embec::task::status::ready);
+    sched.run_until_idle();
+    EMBEC_CHECK(log == "ccababab" && a.done() && b.done() && c.done() && sched.idle());
+
+    // A finished task can be spawned again.
+    log.clear();
+    sched.spawn(c, 0);
+    EMBEC_CHECK(sched.run_until_idle() == 3 && log == "cc");
+}
+
+struct sleeper : embec::protothread<sleeper> {
+    embec::timer_wheel<>* wheel = nullptr;
+    int wakeups = 0;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        for (;;) {
+            EMBEC_PT_SLEEP(*wheel, 5);
+            ++wakeups;
+        }
+        EMBEC_PT_END();
+    }
+};
+
+EMBEC_TEST(sleep, "scheduler/sleep")
+{
+    embec::timer_wheel<> wheel;
+    embec::scheduler sched;
+    sleeper s;
+    s.wheel = &wheel;
+    sched.spawn(s, 0);
+    sched.run_until_idle();
+    EMBEC_CHECK(s.state() == embec::task::status::waiting);
+    for (int t = 1; t <= 23; ++t) {
+        wheel.tick();
+        EMBEC_REQUIRE(sched.idle() == (t % 5 != 0));
+        sched.run_until_idle();
+    }
+    EMBEC_CHECK(s.wakeups == 4 && wheel.next_event() == 2);
+}
+
+using int_channel = embec::channel<int, 3>;
+
+struct producer : embec::protothread<producer> {
+    int_channel* ch = nullptr;
+    int next = 0;
+    int count = 0;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        while (next < count) {
+            EMBEC_PT_SEND(*ch, next);
+            ++next;
+        }
+        EMBEC_PT_END();
+    }
+};
+
+struct consumer : embec::protothread<consumer> {
+    int_channel* ch = nullptr;
+    embec::event* finished = nullptr;
+    int expected = 0;
+    int errors = 0;
+    int count = 0;
+    int value = 0;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        while (expected < count) {
+            EMBEC_PT_RECEIVE(*ch, value);
+            errors += value != expected;
+            ++expected;
+        }
+        finished->set();
+        EMBEC_PT_END();
+    }
+};
+
+struct waiter : embec::protothread<waiter> {
+    embec::event* ev = nullptr;
+    bool passed = false;
+
+    void run()
+    {
+        EMBEC_PT_BEGIN();
+        EMBEC_PT_WAIT(*ev);
+        passed = true;
+        EMBEC_PT_END();
+    }
+};
+
+EMBEC_TEST(channel, "scheduler/channel")
+{
+    // Producers and consumers at both priority orders block on the bounded
+    // channel alternately; items arrive in order and the event releases
+    // the waiters at the end.
+    for (unsigned producer_priority = 0; producer_priority < 2; ++producer_priority) {
+        embec::scheduler sched;
+        int_channel ch;
+        embec::event done;
+        producer p;
+        consumer c;
+        waiter w1, w2;
+        p.ch = c.ch = &ch;
+        p.count = c.count = 1000;
+        c.finished = &done;
+        w1.ev = w2.ev = &done;
+        sched.spawn(w1, 2);
+        sched.spawn(p, producer_priority);
+        sched.spawn(c, 1 - producer_priority);
+        sched.spawn(w2, 3);
+        sched.run_until_idle();
+        EMBEC_CHECK(p.done() && c.done() && c.errors == 0 && c.expected == 1000);
+        EMBEC_CHECK(w1.passed && w2.passed && done.is_set() && ch.empty());
+        done.reset();
+        EMBEC_CHECK(!done.is_set());
+    }
+}
+
+#if EMBEC_HAS_COROUTINES
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// GCC pairs the frame's usual operator delete with the promise's placement
+// operator new when the coroutine has parameters besides the storage, and
+// warns about a mismatch that the language rules require.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+embec::coroutine send_all(embec::coroutine_storage&, int_channel& ch, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        co_await ch.send(i);
+    }
+}
+
+embec::coroutine receive_all(embec::coroutine_storage&, int_channel& ch, int count,
+                             embec::timer_wheel<>& wheel, int& sum)
+{
+    for (int i = 0; i < count; ++i) {
+        sum += co_await ch.receive();
+        if (i % 100 == 0) {
+            co_await embec::sleep_for(wheel, 3);
+        }
+        co_await embec::yield();
+    }
+}
+
+EMBEC_TEST(coroutines, "scheduler/coroutines")
+{
+    embec::scheduler sched;
+    embec::timer_wheel<> wheel;
+    int_channel ch;
+    embec::task_storage<512> send_storage;
+    embec::task_storage<512> receive_storage;
+    int sum = 0;
+    EMBEC_REQUIRE(sched.spawn(send_all(send_storage, ch, 1000), 2));
+    EMBEC_REQUIRE(sched.spawn(receive_all(receive_storage, ch, 1000, wheel, sum), 1));
+    EMBEC_CHECK(send_storage.busy() && receive_storage.busy());
+    // A storage holds one frame at a time.
+    EMBEC_CHECK(!sched.spawn(send_all(send_storage, ch, 1), 0));
+    while (receive_storage.busy()) {
+        sched.run_until_idle();
+        wheel.tick();
+    }
+    EMBEC_CHECK(sum == 999 * 1000 / 2 && !send_storage.busy() && sched.idle());
+
+    embec::task_storage<16> tiny;
+    EMBEC_CHECK(!sched.spawn(send_all(tiny, ch, 1), 0) && tiny.required() > tiny.capacity());
+}
+
+#endif // EMBEC_HAS_COROUTINES
+
+} // namespace
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <vector>
+
+#include "embec/slip.hpp"
+#include "embec/spsc_ring.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+using bytes = std::vector<std::uint8_t>;
+
+/// Straightforward RFC 1055 encoder used as the reference.
+bytes reference_encode(const bytes& in)
+{
+    bytes out{embec::slip::end};
+    for (std::uint8_t b : in) {
+        if (b == embec::slip::end) {
+            out.push_back(embec::slip::esc);
+            out.push_back(embec::slip::esc_end);
+        } else if (b == embec::slip::esc) {
+            out.push_back(embec::slip::esc);
+            out.push_back(embec::slip::esc_esc);
+        } else {
+            out.push_back(b);
+        }
+    }
+    out.push_back(embec::slip::end);
+    return out;
+}
+
+bytes encode(const bytes& in)
+{
+    bytes out(embec::slip_max_encoded_size(in.size()));
+    const auto r = embec::slip_encode(in.data(), in.size(), out.data(), out.size());
+    out.resize(r ? r.length : 0);
+    return out;
+}
+
+EMBEC_TEST(known_vectors, "slip/known_vectors")
+{
+    EMBEC_CHECK(encode({}) == bytes({0xc0, 0xc0}));
+    EMBEC_CHECK(encode({0x01, 0xc0, 0x02, 0xdb, 0x03}) ==
+                bytes({0xc0, 0x01, 0xdb, 0xdc, 0x02, 0xdb, 0xdd, 0x03, 0xc0}));
+    EMBEC_CHECK(encode({0xdb, 0xdb}) == bytes({0xc0, 0xdb, 0xdd, 0xdb, 0xdd, 0xc0}));
+}
+
+EMBEC_TEST(decode_rejects_malformed, "slip/decode_rejects_malformed")
+{
+    std::uint8_t out[16];
+    const std::uint8_t dangling[] = {0x01, 0xdb};
+    EMBEC_CHECK(embec::slip_decode(dangling, 2, out, 16).status == embec::frame_status::invalid);
+    const std::uint8_t bad_escape[] = {0xdb, 0x01};
+    EMBEC_CHECK(embec::slip_decode(bad_escape, 2, out, 16).status ==
+                embec::frame_status::invalid);
+    const std::uint8_t embedded_end[] = {0x01, 0xc0};
+    EMBEC_CHECK(embec::slip_decode(embedded_end, 2, out, 16).status ==
+                embec::frame_status::invalid);
+    const std::uint8_t escaped[] = {0x01, 0xdb, 0xdc};
+    EMBEC_CHECK(embec::slip_decode(escaped, 3, out, 1).status == embec::frame_status::overflow);
+    const auto r = embec::slip_decode(escaped, 3, out, 2);
+    EMBEC_CHECK(r && r.length == 2 && out[0] == 0x01 && out[1] == 0xc0);
+}
+
+EMBEC_TEST(round_trip, "slip/round_trip")
+{
+    embec::test::property(2000, [](embec::test::rng& r) {
+        bytes in(r.below(600));
+        r.fill_biased(in.data(), in.size(), embec::slip::end, embec::slip::esc);
+        const bytes enc = encode(in);
+        EMBEC_REQUIRE(enc == reference_encode(in));
+
+        // Exactly enough space succeeds, one byte less overflows.
+        bytes tight(enc.size());
+        EMBEC_CHECK(embec::slip_encode(in.data(), in.size(), tight.data(), tight.size()).length ==
+                    enc.size());
+        EMBEC_CHECK(embec::slip_encode(in.data(), in.size(), tight.data(), tight.size() - 1)
+                        .status == embec::frame_status::overflow);
+
+        bytes body(enc.begin() + 1, enc.end() - 1);
+        const auto d = embec::slip_decode(body.data(), body.size(), body.data(), body.size());
+        EMBEC_CHECK(d && d.length == in.size() && std::equal(in.begin(), in.end(), body.begin()));
+
+        embec::slip_encoder encoder;
+        encoder.begin(in.data(), in.size());
+        bytes streamed;
+        std::uint8_t byte;
+        while (encoder.next(byte)) {
+            streamed.push_back(byte);
+        }
+        EMBEC_CHECK(streamed == enc);
+    });
+}
+
+EMBEC_TEST(streaming_decoder, "slip/streaming_decoder")
+{
+    embec::test::property(500, [](embec::test::rng& r) {
+        // Frames with random chunking; some carry an invalid escape and
+        // must be dropped without affecting their neighbours.
+        bytes stream;
+        std::vector<bytes> expected;
+        std::uint8_t buffer[200];
+        const std::size_t count = 1 + r.below(6);
+        for (std::size_t f = 0; f < count; ++f) {
+            bytes in(r.below(260));
+            r.fill_biased(in.data(), in.size(), embec::slip::end, embec::slip::esc);
+            bytes enc = reference_encode(in);
+            const bool corrupt = r.chance(15);
+            if (corrupt) {
+                enc.insert(enc.begin() + 1 + r.below(enc.size() - 1), {embec::slip::esc, 0x55});
+            }
+            stream.insert(stream.end(), enc.begin(), enc.end());
+            if (!corrupt && !in.empty() && in.size() <= sizeof(buffer)) {
+                expected.push_back(in);
+            }
+        }
+
+        embec::slip_decoder decoder(buffer, sizeof(buffer));
+        std::vector<bytes> got;
+        std::size_t pos = 0;
+        while (pos < stream.size()) {
+            const std::size_t chunk = 1 + r.below(40);
+            const std::size_t n = chunk < stream.size() - pos ? chunk : stream.size() - pos;
+            embec::frame_status status;
+            const std::size_t used = decoder.push(stream.data() + pos, n, status);
+            EMBEC_REQUIRE(used >= 1 && used <= n);
+            pos += used;
+            if (status == embec::frame_status::ok) {
+                got.emplace_back(decoder.data(), decoder.data() + decoder.size());
+            }
+        }
+        EMBEC_CHECK(got == expected);
+    });
+}
+
+EMBEC_TEST(ring_write_and_decode, "slip/ring_write_and_decode")
+{
+    embec::spsc_ring<std::uint8_t, 1024> ring;
+    std::uint8_t buffer[300];
+    embec::slip_decoder decoder(buffer, sizeof(buffer));
+    embec::test::property(300, [&](embec::test::rng& r) {
+        bytes in(r.below(300));
+        r.fill_biased(in.data(), in.size(), embec::slip::end, embec::slip::esc);
+        EMBEC_REQUIRE(embec::slip_write(ring, in.data(), in.size()));
+        embec::frame_status status;
+        do {
+            status = decoder.push(ring);
+        } while (status == embec::frame_status::incomplete && !ring.empty());
+        if (in.empty()) {
+            EMBEC_CHECK(status == embec::frame_status::incomplete);
+        } else {
+            EMBEC_CHECK(status == embec::frame_status::ok && decoder.size() == in.size() &&
+                        std::equal(in.begin(), in.end(), decoder.data()));
+        }
+        EMBEC_CHECK(ring.empty());
+    });
+    bytes big(600, 0xc0);
+    EMBEC_CHECK(!embec::slip_write(ring, big.data(), big.size()));
+    EMBEC_CHECK(ring.empty());
+}
+
+} // namespace
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "embec/snapshot.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+/// Payload whose fields are all written from one counter, so a torn read
+/// shows up as fields that disagree. 13 words to straddle several cache
+/// lines with an odd size.
+struct sample {
+    std::uint32_t fields[13];
+
+    static sample of(std::uint32_t k)
+    {
+        sample s;
+        for (std::uint32_t i = 0; i < 13; ++i) {
+            s.fields[i] = k * 13 + i;
+        }
+        return s;
+    }
+
+    bool consistent() const
+    {
+        for (std::uint32_t i = 0; i < 13; ++i) {
+            if (fields[i] != fields[0] + i) {
+                return false;
+            }
+        }
+        return fields[0] % 13 == 0;
+    }
+
+    std::uint32_t counter() const { return fields[0] / 13; }
+};
+
+EMBEC_TEST(seqlock_basic, "snapshot/seqlock_basic")
+{
+    embec::seqlock<sample> lock;
+    EMBEC_CHECK(lock.version() == 0 && lock.load().fields[5] == 0);
+    lock.store(sample::of(7));
+    sample s{};
+    EMBEC_CHECK(lock.try_load(s) && s.consistent() && s.counter() == 7);
+    EMBEC_CHECK(lock.version() == 1);
+
+    // Payloads that are not a whole number of words.
+    struct odd {
+        char text[5];
+    };
+    embec::seqlock<odd> small(odd{{'a', 'b', 'c', 'd', 0}});
+    EMBEC_CHECK(small.load().text[3] == 'd' && small.version() == 1);
+}
+
+EMBEC_TEST(triple_buffer_basic, "snapshot/triple_buffer_basic")
+{
+    embec::triple_buffer<sample> buffer(sample::of(1));
+    EMBEC_CHECK(!buffer.updated() && buffer.read().counter() == 1);
+    buffer.write(sample::of(2));
+    EMBEC_CHECK(buffer.updated());
+    const sample& a = buffer.read();
+    EMBEC_CHECK(!buffer.updated() && a.counter() == 2);
+
+    // Later writes do not disturb the reference held by the reader, and
+    // only the latest of several is seen.
+    for (std::uint32_t k = 3; k <= 6; ++k) {
+        buffer.back() = sample::of(k);
+        buffer.publish();
+    }
+    EMBEC_CHECK(a.counter() == 2);
+    EMBEC_CHECK(buffer.read().counter() == 6 && buffer.read().counter() == 6);
+}
+
+EMBEC_TEST(threads, "snapshot/threads")
+{
+    // A writer publishes an increasing counter as fast as it can while
+    // readers check that every value is whole and never goes backwards.
+    // Run under TSan to check the memory ordering.
+    constexpr std::uint32_t writes = 50000;
+    embec::seqlock<sample> lock(sample::of(0));
+    embec::triple_buffer<sample> buffer(sample::of(0));
+    std::atomic<bool> done{false};
+    std::atomic<std::uint32_t> errors{0};
+
+    std::thread writer([&] {
+        for (std::uint32_t k = 1; k <= writes; ++k) {
+            lock.store(sample::of(k));
+            buffer.back() = sample::of(k);
+            buffer.publish();
+        }
+        done.store(true, std::memory_order_release);
+    });
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            std::uint32_t last = 0;
+            bool finished = false;
+            while (!finished) {
+                finished = done.load(std::memory_order_acquire);
+                const sample s = lock.load();
+                errors.fetch_add(!s.consistent() || s.counter() < last, std::memory_order_relaxed);
+                last = s.counter();
+            }
+            errors.fetch_add(last != writes, std::memory_order_relaxed);
+        });
+    }
+    std::uint32_t last = 0;
+    bool finished = false;
+    while (!finished) {
+        finished = done.load(std::memory_order_acquire);
+        const sample& s = buffer.read();
+        errors.fetch_add(!s.consistent() || s.counter() < last, std::memory_order_relaxed);
+        last = s.counter();
+    }
+    writer.join();
+    for (auto& t : readers) {
+        t.join();
+    }
+    EMBEC_CHECK(errors.load() == 0 && last == writes);
+}
+
+} // namespace
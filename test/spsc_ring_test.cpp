@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <deque>
+#include <thread>
+
+#include "embec/spsc_ring.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+EMBEC_TEST(basic, "spsc_ring/basic")
+{
+    embec::spsc_ring<int, 4> ring;
+    int v = 0;
+    EMBEC_CHECK(ring.empty() && !ring.full() && ring.capacity() == 4);
+    EMBEC_CHECK(!ring.pop(v) && !ring.peek(v));
+    for (int i = 0; i < 4; ++i) {
+        EMBEC_CHECK(ring.push(i));
+    }
+    EMBEC_CHECK(ring.full() && !ring.push(4) && ring.size() == 4);
+    EMBEC_CHECK(ring.peek(v) && v == 0 && ring.size() == 4);
+    EMBEC_CHECK(ring.pop(v) && v == 0);
+    EMBEC_CHECK(ring.push(4));
+    for (int i = 1; i <= 4; ++i) {
+        EMBEC_CHECK(ring.pop(v) && v == i);
+    }
+    EMBEC_CHECK(ring.empty());
+    ring.push(9);
+    ring.reset();
+    EMBEC_CHECK(ring.empty() && !ring.pop(v));
+}
+
+EMBEC_TEST(regions_wrap, "spsc_ring/regions_wrap")
+{
+    embec::spsc_ring<std::uint8_t, 8> ring;
+    const std::uint8_t in[6] = {1, 2, 3, 4, 5, 6};
+    std::uint8_t out[8];
+    EMBEC_CHECK(ring.write(in, 6) == 6 && ring.read(out, 6) == 6);
+
+    // The write position is now 6: only two slots are contiguous.
+    auto w = ring.claim_write();
+    EMBEC_CHECK(w.size == 2);
+    w.data[0] = 10;
+    w.data[1] = 11;
+    ring.commit_write(2);
+    w = ring.claim_write();
+    EMBEC_CHECK(w.size == 6);
+    w.data[0] = 12;
+    ring.commit_write(1);
+
+    auto r = ring.claim_read();
+    EMBEC_CHECK(r.size == 2 && r.data[0] == 10 && r.data[1] == 11);
+    ring.commit_read(2);
+    r = ring.claim_read();
+    EMBEC_CHECK(r.size == 1 && r.data[0] == 12);
+    ring.commit_read(1);
+    EMBEC_CHECK(ring.claim_read().empty());
+}
+
+EMBEC_TEST(model, "spsc_ring/model")
+{
+    // Random mix of every producer and consumer operation against a deque.
+    embec::test::property(300, [](embec::test::rng& r) {
+        embec::spsc_ring<std::uint16_t, 16> ring;
+        std::deque<std::uint16_t> model;
+        std::uint16_t next = 0;
+        for (int step = 0; step < 400; ++step) {
+            std::uint16_t buf[20];
+            const std::size_t n = r.below(20);
+            const std::size_t space = 16 - model.size();
+            switch (r.below(6)) {
+            case 0: {
+                const bool ok = ring.push(next);
+                EMBEC_REQUIRE(ok == (space != 0));
+                if (ok) {
+                    model.push_back(next++);
+                }
+                break;
+            }
+            case 1: {
+                for (std::size_t i = 0; i < n; ++i) {
+                    buf[i] = static_cast<std::uint16_t>(next + i);
+                }
+                const std::size_t written = ring.write(buf, n);
+                EMBEC_REQUIRE(written == (n < space ? n : space));
+                for (std::size_t i = 0; i < written; ++i) {
+                    model.push_back(next++);
+                }
+                break;
+            }
+            case 2: {
+                const auto region = ring.claim_write();
+                EMBEC_REQUIRE(region.size <= space && (space == 0 || region.size != 0));
+                const std::size_t count = region.size ? r.below(region.size + 1) : 0;
+                for (std::size_t i = 0; i < count; ++i) {
+                    region.data[i] = next;
+                    model.push_back(next++);
+                }
+                ring.commit_write(count);
+                break;
+            }
+            case 3: {
+                std::uint16_t v;
+                const bool ok = ring.pop(v);
+                EMBEC_REQUIRE(ok == !model.empty());
+                if (ok) {
+                    EMBEC_REQUIRE(v == model.front());
+                    model.pop_front();
+                }
+                break;
+            }
+            case 4: {
+                const std::size_t got = ring.read(buf, n);
+                EMBEC_REQUIRE(got == (n < model.size() ? n : model.size()));
+                for (std::size_t i = 0; i < got; ++i) {
+                    EMBEC_REQUIRE(buf[i] == model.front());
+                    model.pop_front();
+                }
+                break;
+            }
+            default: {
+                const auto region = ring.claim_read();
+                EMBEC_REQUIRE(region.size <= model.size() &&
+                              (model.empty() || region.size != 0));
+                const std::size_t count = region.size ? r.below(region.size + 1) : 0;
+                for (std::size_t i = 0; i < count; ++i) {
+                    EMBEC_REQUIRE(region.data[i] == model.front());
+                    model.pop_front();
+                }
+                ring.commit_read(count);
+                break;
+            }
+            }
+            EMBEC_REQUIRE(ring.size() == model.size());
+        }
+    });
+}
+
+EMBEC_TEST(threads, "spsc_ring/threads")
+{
+    // A producer and a consumer thread move a counting sequence through a
+    // small ring using all three transfer styles; run under TSan to check
+    // the memory ordering.
+    constexpr std::uint32_t total = 100000;
+    embec::spsc_ring<std::uint32_t, 64> ring;
+    std::thread producer([&] {
+        std::uint32_t next = 0;
+        std::uint32_t style = 0;
+        while (next < total) {
+            if (ring.full()) {
+                std::this_thread::yield();
+            }
+            switch (style++ % 3) {
+            case 0:
+                if (ring.push(next)) {
+                    ++next;
+                }
+                break;
+            case 1: {
+                std::uint32_t buf[7];
+                const std::uint32_t n = total - next < 7 ? total - next : 7;
+                for (std::uint32_t i = 0; i < n; ++i) {
+                    buf[i] = next + i;
+                }
+                next += static_cast<std::uint32_t>(ring.write(buf, n));
+                break;
+            }
+            default: {
+                const auto region = ring.claim_write();
+                std::size_t n = 0;
+                while (n < region.size && next < total) {
+                    region.data[n++] = next++;
+                }
+                ring.commit_write(n);
+                break;
+            }
+            }
+        }
+    });
+
+    std::uint32_t expected = 0;
+    std::uint32_t errors = 0;
+    std::uint32_t style = 0;
+    while (expected < total) {
+        if (ring.empty()) {
+            std::this_thread::yield();
+        }
+        switch (style++ % 3) {
+        case 0: {
+            std::uint32_t v;
+            if (ring.pop(v)) {
+                errors += v != expected++;
+            }
+            break;
+        }
+        case 1: {
+            std::uint32_t buf[5];
+            const std::size_t n = ring.read(buf, 5);
+            for (std::size_t i = 0; i < n; ++i) {
+                errors += buf[i] != expected++;
+            }
+            break;
+        }
+        default: {
+            const auto region = ring.claim_read();
+            for (std::size_t i = 0; i < region.size; ++i) {
+                errors += region.data[i] != expected++;
+            }
+            ring.commit_read(region.size);
+            break;
+        }
+        }
+    }
+    producer.join();
+    EMBEC_CHECK(errors == 0);
+    EMBEC_CHECK(ring.empty());
+}
+
+} // namespace
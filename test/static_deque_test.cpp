@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <deque>
+#include <string>
+
+#include "embec/static_deque.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+template <typename T>
+T make(std::uint64_t n)
+{
+    if constexpr (std::is_same<T, std::string>::value) {
+        return std::string(20 + n % 7, static_cast<char>('a' + n % 26));
+    } else {
+        return static_cast<T>(n);
+    }
+}
+
+template <typename T>
+void check_model(embec::test::rng& r)
+{
+    // Random operations at both ends against std::deque, wrapping the
+    // circular buffer many times.
+    constexpr std::size_t N = 13;
+    embec::static_deque<T, N> d;
+    std::deque<T> model;
+    for (int step = 0; step < 400; ++step) {
+        const bool room = model.size() < N;
+        const T value = make<T>(r.next());
+        switch (r.below(7)) {
+        case 0:
+            EMBEC_REQUIRE(d.try_push_back(value) == room);
+            if (room) {
+                model.push_back(value);
+            }
+            break;
+        case 1:
+            EMBEC_REQUIRE(d.try_push_front(value) == room);
+            if (room) {
+                model.push_front(value);
+            }
+            break;
+        case 2:
+            if (room) {
+                EMBEC_REQUIRE(d.emplace_front(value) == value);
+                model.push_front(value);
+            }
+            break;
+        case 3:
+        case 4:
+            if (!model.empty()) {
+                d.pop_front();
+                model.pop_front();
+            }
+            break;
+        case 5:
+            if (!model.empty()) {
+                d.pop_back();
+                model.pop_back();
+            }
+            break;
+        default: {
+            embec::static_deque<T, N> copy(d);
+            embec::static_deque<T, N> moved(std::move(copy));
+            d = moved;
+            break;
+        }
+        }
+        EMBEC_REQUIRE(d.size() == model.size());
+        EMBEC_REQUIRE(std::equal(d.begin(), d.end(), model.begin(), model.end()));
+        EMBEC_REQUIRE(std::equal(d.rbegin(), d.rend(), model.rbegin(), model.rend()));
+        if (!model.empty()) {
+            const std::size_t i = r.below(model.size());
+            EMBEC_REQUIRE(d[i] == model[i] && d.front() == model.front() &&
+                          d.back() == model.back());
+        }
+    }
+}
+
+EMBEC_TEST(model_trivial, "static_deque/model_trivial")
+{
+    embec::test::property(300, check_model<int>);
+}
+
+EMBEC_TEST(model_non_trivial, "static_deque/model_non_trivial")
+{
+    embec::test::property(300, check_model<std::string>);
+}
+
+EMBEC_TEST(random_access_iterators, "static_deque/random_access_iterators")
+{
+    embec::static_deque<int, 8> d;
+    for (int i = 0; i < 6; ++i) {
+        d.push_back(i);
+    }
+    d.pop_front();
+    d.pop_front();
+    d.push_back(6);
+    d.push_back(7);
+    d.push_back(8); // wraps around the end of the storage
+    EMBEC_CHECK(d.end() - d.begin() == 7 && d.begin()[3] == 5);
+    EMBEC_CHECK(std::lower_bound(d.begin(), d.end(), 6) - d.begin() == 4);
+    std::reverse(d.begin(), d.end());
+    EMBEC_CHECK(d.front() == 8 && d.back() == 2 && d.begin() < d.end());
+}
+
+} // namespace
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <string>
+#include <vector>
+
+#include "embec/static_vector.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+static_assert([] {
+    embec::static_vector<int, 4> v{2, 3, 5};
+    v.push_back(7);
+    return v.back() == 7 && v.size() == 4;
+}(), "static_vector of a trivial type is usable in constant expressions");
+
+template <typename T>
+T make(std::uint64_t n)
+{
+    if constexpr (std::is_same<T, std::string>::value) {
+        // Long enough to live on the heap, so leaks and double frees show
+        // up under ASan.
+        return std::string(20 + n % 7, static_cast<char>('a' + n % 26));
+    } else {
+        return static_cast<T>(n);
+    }
+}
+
+template <typename T>
+void check_model(embec::test::rng& r)
+{
+    // Random operations against std::vector.
+    constexpr std::size_t N = 24;
+    embec::static_vector<T, N> v;
+    std::vector<T> model;
+    for (int step = 0; step < 300; ++step) {
+        const std::size_t room = N - model.size();
+        const T value = make<T>(r.next());
+        switch (r.below(9)) {
+        case 0:
+            EMBEC_REQUIRE(v.try_push_back(value) == (room != 0));
+            if (room) {
+                model.push_back(value);
+            }
+            break;
+        case 1:
+            if (room) {
+                v.emplace_back(value);
+                model.push_back(value);
+            }
+            break;
+        case 2:
+            if (!model.empty()) {
+                v.pop_back();
+                model.pop_back();
+            }
+            break;
+        case 3:
+            if (room) {
+                const std::size_t at = r.below(model.size() + 1);
+                EMBEC_REQUIRE(*v.insert(v.begin() + at, value) == value);
+                model.insert(model.begin() + static_cast<std::ptrdiff_t>(at), value);
+            }
+            break;
+        case 4: {
+            const std::size_t count = r.below(room + 1);
+            const std::size_t at = r.below(model.size() + 1);
+            v.insert(v.begin() + at, count, value);
+            model.insert(model.begin() + static_cast<std::ptrdiff_t>(at), count, value);
+            break;
+        }
+        case 5:
+            if (!model.empty()) {
+                const std::size_t first = r.below(model.size());
+                const std::size_t last = first + r.below(model.size() - first + 1);
+                v.erase(v.begin() + first, v.begin() + last);
+                model.erase(model.begin() + static_cast<std::ptrdiff_t>(first),
+                            model.begin() + static_cast<std::ptrdiff_t>(last));
+            }
+            break;
+        case 6: {
+            const std::size_t count = r.below(N + 1);
+            v.resize(count, value);
+            model.resize(count, value);
+            break;
+        }
+        case 7: {
+            // Copy, move and assignment keep the contents.
+            embec::static_vector<T, N> copy(v);
+            embec::static_vector<T, N> moved(std::move(copy));
+            embec::static_vector<T, N> assigned;
+            assigned.push_back(value);
+            assigned = moved;
+            EMBEC_REQUIRE(assigned == v && moved == v);
+            v = std::move(assigned);
+            break;
+        }
+        default:
+            if (r.chance(10)) {
+                v.clear();
+                model.clear();
+            }
+            break;
+        }
+        EMBEC_REQUIRE(v.size() == model.size());
+        EMBEC_REQUIRE(std::equal(v.begin(), v.end(), model.begin(), model.end()));
+    }
+}
+
+EMBEC_TEST(model_trivial, "static_vector/model_trivial")
+{
+    embec::test::property(300, check_model<int>);
+}
+
+EMBEC_TEST(model_non_trivial, "static_vector/model_non_trivial")
+{
+    embec::test::property(300, check_model<std::string>);
+}
+
+EMBEC_TEST(construction, "static_vector/construction")
+{
+    const int data[] = {4, 5, 6};
+    embec::static_vector<int, 5> from_range(data, data + 3);
+    embec::static_vector<int, 5> filled(2, 9);
+    embec::static_vector<int, 5> sized(4);
+    EMBEC_CHECK(from_range.size() == 3 && from_range[2] == 6);
+    EMBEC_CHECK(filled.size() == 2 && filled[1] == 9 && sized.size() == 4 && sized[3] == 0);
+    EMBEC_CHECK(from_range < filled && from_range != filled);
+    from_range.swap(filled);
+    EMBEC_CHECK(filled.size() == 3 && from_range.size() == 2);
+    EMBEC_CHECK(*from_range.rbegin() == 9);
+    EMBEC_CHECK(sized.try_emplace_back(1) != nullptr && sized.full() &&
+                sized.try_emplace_back(2) == nullptr);
+
+    // Pointers to other element types convert element by element.
+    const short narrow[] = {-1, 2, 300};
+    embec::static_vector<int, 5> widened(narrow, narrow + 3);
+    EMBEC_CHECK(widened.size() == 3 && widened[0] == -1 && widened[2] == 300);
+    widened.insert(widened.begin() + 1, narrow, narrow + 2);
+    EMBEC_CHECK(widened.size() == 5 && widened[1] == -1 && widened[2] == 2 && widened[3] == 2);
+}
+
+} // namespace
@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <vector>
+
+#include "embec/stats.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+template <typename T>
+double to_double(T x)
+{
+    return embec::detail::sample_traits<T>::template to_real<double>(x);
+}
+
+template <typename T>
+T random_sample(embec::test::rng& r, std::int64_t offset, std::int64_t spread);
+
+template <>
+std::int16_t random_sample<std::int16_t>(embec::test::rng& r, std::int64_t offset,
+                                         std::int64_t spread)
+{
+    return static_cast<std::int16_t>(
+        std::clamp<std::int64_t>(offset + r.range(-spread, spread), -32768, 32767));
+}
+
+template <>
+std::int32_t random_sample<std::int32_t>(embec::test::rng& r, std::int64_t offset,
+                                         std::int64_t spread)
+{
+    return static_cast<std::int32_t>(offset * 1000 + r.range(-spread, spread) * 1000);
+}
+
+template <>
+embec::q15 random_sample<embec::q15>(embec::test::rng& r, std::int64_t offset, std::int64_t spread)
+{
+    return embec::q15::from_raw(random_sample<std::int16_t>(r, offset, spread));
+}
+
+template <>
+float random_sample<float>(embec::test::rng& r, std::int64_t offset, std::int64_t spread)
+{
+    return static_cast<float>(offset) + static_cast<float>(r.range(-spread, spread)) / 64;
+}
+
+template <>
+double random_sample<double>(embec::test::rng& r, std::int64_t offset, std::int64_t spread)
+{
+    return static_cast<double>(offset) + static_cast<double>(r.range(-spread, spread)) / 1024;
+}
+
+/// Feeds random samples one at a time and in blocks of random length
+/// (which take the vector paths) and compares with a two-pass reference.
+template <typename T, typename Real>
+void check_running_stats(double tolerance)
+{
+    embec::test::property(200, [tolerance](embec::test::rng& r) {
+        // Offsets far from zero relative to the spread test cancellation.
+        const std::int64_t offset = r.chance(50) ? 0 : r.range(-30000, 30000);
+        const std::int64_t spread = 1 + static_cast<std::int64_t>(r.below(r.chance(20) ? 3 : 2000));
+        std::vector<T> samples(r.below(2000));
+        for (T& x : samples) {
+            x = random_sample<T>(r, offset, spread);
+        }
+
+        embec::running_stats<T, Real> whole;
+        embec::running_stats<T, Real> first;
+        embec::running_stats<T, Real> second;
+        const std::size_t split = samples.empty() ? 0 : r.below(samples.size());
+        for (std::size_t i = 0; i < samples.size();) {
+            const std::size_t n = std::min<std::size_t>(samples.size() - i, 1 + r.below(600));
+            if (r.chance(30)) {
+                for (std::size_t k = i; k < i + n; ++k) {
+                    whole.add(samples[k]);
+                }
+            } else {
+                whole.add(samples.data() + i, n);
+            }
+            i += n;
+        }
+        first.add(samples.data(), split);
+        for (std::size_t k = split; k < samples.size(); ++k) {
+            second.add(samples[k]);
+        }
+        first.merge(second);
+
+        double mean = 0;
+        for (const T& x : samples) {
+            mean += to_double(x);
+        }
+        mean = samples.empty() ? 0 : mean / static_cast<double>(samples.size());
+        double m2 = 0;
+        for (const T& x : samples) {
+            m2 += (to_double(x) - mean) * (to_double(x) - mean);
+        }
+        const double variance = samples.empty() ? 0 : m2 / static_cast<double>(samples.size());
+        // Rounding errors scale with the magnitude of the data, not of the
+        // results.
+        double magnitude = 0;
+        for (const T& x : samples) {
+            magnitude = std::max(magnitude, std::fabs(to_double(x)));
+        }
+        const double variance_tolerance = tolerance * (1 + magnitude * magnitude);
+
+        for (const auto* s : {&whole, &first}) {
+            EMBEC_REQUIRE(s->count() == samples.size());
+            EMBEC_REQUIRE(std::fabs(s->mean() - mean) <= tolerance * (1 + magnitude));
+            EMBEC_REQUIRE(std::fabs(s->variance() - variance) <= variance_tolerance);
+            EMBEC_REQUIRE(s->variance() >= 0);
+            if (!samples.empty()) {
+                EMBEC_REQUIRE(s->min() == *std::min_element(samples.begin(), samples.end()));
+                EMBEC_REQUIRE(s->max() == *std::max_element(samples.begin(), samples.end()));
+                const double n = static_cast<double>(samples.size());
+                EMBEC_REQUIRE(samples.size() < 2 ||
+                              std::fabs(s->sample_variance() - variance * n / (n - 1)) <=
+                                  2 * variance_tolerance);
+            }
+        }
+    });
+}
+
+EMBEC_TEST(running_stats_int16, "stats/running_stats_int16")
+{
+    check_running_stats<std::int16_t, float>(1e-5);
+    check_running_stats<std::int16_t, double>(1e-12);
+}
+
+EMBEC_TEST(running_stats_q15, "stats/running_stats_q15")
+{
+    check_running_stats<embec::q15, float>(1e-5);
+}
+
+EMBEC_TEST(running_stats_int32, "stats/running_stats_int32")
+{
+    check_running_stats<std::int32_t, double>(1e-11);
+}
+
+EMBEC_TEST(running_stats_float, "stats/running_stats_float")
+{
+    check_running_stats<float, float>(1e-5);
+    check_running_stats<double, double>(1e-12);
+}
+
+EMBEC_TEST(running_stats_basics, "stats/running_stats_basics")
+{
+    embec::running_stats<int> s;
+    EMBEC_CHECK(s.empty() && s.mean() == 0 && s.variance() == 0 && s.sample_variance() == 0);
+    for (int x : {2, 4, 4, 4, 5, 5, 7, 9}) {
+        s.add(x);
+    }
+    EMBEC_CHECK(s.count() == 8 && s.mean() == 5 && s.variance() == 4 && s.stddev() == 2);
+    EMBEC_CHECK(s.min() == 2 && s.max() == 9);
+    s.reset();
+    EMBEC_CHECK(s.empty());
+}
+
+template <typename T, std::size_t Window>
+void check_sliding_min_max()
+{
+    embec::test::property(100, [](embec::test::rng& r) {
+        embec::sliding_min_max<T, Window> window;
+        std::deque<T> model;
+        T min_out[64];
+        T max_out[64];
+        T in[64];
+        int trend = 0;
+        for (int step = 0; step < 300; ++step) {
+            // Runs of rising and falling samples stress the deques.
+            const std::size_t n = 1 + r.below(64);
+            for (std::size_t i = 0; i < n; ++i) {
+                trend = r.chance(5) ? static_cast<int>(r.range(-3, 3)) : trend;
+                in[i] = static_cast<T>(static_cast<int>(r.below(20)) + trend * step);
+            }
+            if (r.chance(10)) {
+                window.reset();
+                model.clear();
+            }
+            if (r.chance(50)) {
+                window.process(in, min_out, max_out, n);
+            } else {
+                window.push(in, n);
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                model.push_back(in[i]);
+                if (model.size() > Window) {
+                    model.pop_front();
+                }
+            }
+            EMBEC_REQUIRE(window.size() == model.size() && window.full() == (model.size() == Window));
+            EMBEC_REQUIRE(window.min() == *std::min_element(model.begin(), model.end()));
+            EMBEC_REQUIRE(window.max() == *std::max_element(model.begin(), model.end()));
+        }
+    });
+}
+
+EMBEC_TEST(sliding_min_max, "stats/sliding_min_max")
+{
+    check_sliding_min_max<int, 1>();
+    check_sliding_min_max<int, 7>();
+    check_sliding_min_max<float, 100>();
+
+    embec::sliding_min_max<int, 3> w;
+    EMBEC_CHECK(w.empty() && w.window() == 3);
+    const int in[] = {5, 1, 3, 4, 6, 2};
+    int lo[6];
+    int hi[6];
+    w.process(in, lo, hi, 6);
+    EMBEC_CHECK(lo[0] == 5 && lo[1] == 1 && lo[3] == 1 && lo[4] == 3 && lo[5] == 2);
+    EMBEC_CHECK(hi[1] == 5 && hi[2] == 5 && hi[3] == 4 && hi[4] == 6 && hi[5] == 6);
+}
+
+EMBEC_TEST(p2_quantile, "stats/p2_quantile")
+{
+    // Exact below five samples.
+    embec::p2_quantile<int> median(0.5f);
+    EMBEC_CHECK(median.value() == 0 && median.quantile() == 0.5f);
+    for (int x : {9, 1, 5}) {
+        median.add(x);
+    }
+    EMBEC_CHECK(median.value() == 5 && median.count() == 3);
+    median.add(2);
+    EMBEC_CHECK(median.value() == 5); // rank round(1.5) of {1, 2, 5, 9}
+
+    // Close to the quantile of uniform and bell-shaped streams, in any
+    // order. P-square converges only slowly from an unrepresentative start,
+    // which bounds the accuracy away from the median.
+    embec::test::property(20, [](embec::test::rng& r) {
+        for (const double p : {0.5, 0.9, 0.99}) {
+            embec::p2_quantile<std::int32_t, double> uniform(p);
+            embec::p2_quantile<float> bell(static_cast<float>(p));
+            std::vector<std::int32_t> ramp(20000);
+            std::vector<float> bells(ramp.size());
+            for (std::size_t i = 0; i < ramp.size(); ++i) {
+                ramp[i] = static_cast<std::int32_t>(r.below(100000));
+                uniform.add(ramp[i]);
+                float sum = 0;
+                for (int k = 0; k < 12; ++k) {
+                    sum += static_cast<float>(r.below(1000)) / 1000;
+                }
+                bells[i] = sum - 6; // roughly N(0, 1)
+                bell.add(bells[i]);
+            }
+            const auto rank = static_cast<std::size_t>(p * static_cast<double>(ramp.size() - 1));
+            std::sort(ramp.begin(), ramp.end());
+            std::sort(bells.begin(), bells.end());
+            EMBEC_REQUIRE(std::fabs(uniform.value() - ramp[rank]) < 1000);
+            EMBEC_REQUIRE(std::fabs(bell.value() - bells[rank]) < (p == 0.5 ? 0.02 : 0.5));
+
+            // Sorted input is the worst case for the marker adjustments.
+            embec::p2_quantile<std::int32_t, double> sorted(p);
+            sorted.add(ramp.data(), ramp.size());
+            EMBEC_REQUIRE(std::fabs(sorted.value() - ramp[rank]) < 2000);
+        }
+    });
+}
+
+} // namespace
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/// @file test.hpp
+/// @brief Minimal host unit and property test framework for embec.
+///
+/// A test is a function registered under a "component/case" name. Checks
+/// record failures and let the test continue; EMBEC_REQUIRE additionally
+/// returns from the test. property() runs a check against many generated
+/// inputs, each from its own seed, and stops at the first failing case,
+/// whose seed is reported; the runner's --seed selects a different set of
+/// cases and the same --seed reproduces them. The runner in main.cpp
+/// writes one line per test to test_output.txt. Each component has its own
+/// <component>_test.cpp.
+
+#ifndef EMBEC_TEST_TEST_HPP
+#define EMBEC_TEST_TEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace embec {
+namespace test {
+
+using test_fn = void (*)();
+
+struct test_case {
+    const char* name;
+    test_fn fn;
+};
+
+inline std::vector<test_case>& registry()
+{
+    static std::vector<test_case> tests;
+    return tests;
+}
+
+/// Registers a test from a static initialiser.
+struct registrar {
+    registrar(const char* name, test_fn fn) { registry().push_back({name, fn}); }
+};
+
+/// State of the running test.
+struct context {
+    std::FILE* log = nullptr;
+    const char* test = nullptr;
+    std::uint64_t checks = 0;
+    std::uint64_t failures = 0;
+    std::uint64_t base_seed = 1;
+    std::uint64_t seed = 0; ///< Seed of the running property case, 0 if none.
+};
+
+inline context& current()
+{
+    static context ctx;
+    return ctx;
+}
+
+/// Records a failed check; only the first few per test are printed.
+inline bool fail(const char* file, int line, const char* expression)
+{
+    context& ctx = current();
+    if (++ctx.failures <= 5) {
+        for (std::FILE* f : {ctx.log, stderr}) {
+            if (f == nullptr) {
+                continue;
+            }
+            std::fprintf(f, "  %s: %s:%d: check failed: %s", ctx.test, file, line, expression);
+            if (ctx.seed != 0) {
+                std::fprintf(f, " (seed %llu)", static_cast<unsigned long long>(ctx.seed));
+            }
+            std::fprintf(f, "\n");
+        }
+    }
+    return false;
+}
+
+inline bool check(bool ok, const char* file, int line, const char* expression)
+{
+    ++current().checks;
+    return ok || fail(file, line, expression);
+}
+
+/// xorshift64* generator for property tests.
+class rng {
+public:
+    explicit rng(std::uint64_t seed) noexcept : state_(seed != 0 ? seed : 0x9e3779b97f4a7c15ull) {}
+
+    std::uint64_t next() noexcept
+    {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 0x2545f4914f6cdd1dull;
+    }
+
+    /// Uniform in [0, bound); bound must be non-zero.
+    std::uint64_t below(std::uint64_t bound) noexcept { return next() % bound; }
+
+    /// Uniform in [low, high].
+    std::int64_t range(std::int64_t low, std::int64_t high) noexcept
+    {
+        return low + static_cast<std::int64_t>(
+                         below(static_cast<std::uint64_t>(high - low) + 1));
+    }
+
+    /// True with probability @p percent / 100.
+    bool chance(unsigned percent) noexcept { return below(100) < percent; }
+
+    void fill(void* data, std::size_t length) noexcept
+    {
+        auto* p = static_cast<std::uint8_t*>(data);
+        for (std::size_t i = 0; i < length; ++i) {
+            p[i] = static_cast<std::uint8_t>(next() >> 56);
+        }
+    }
+
+    /// Bytes biased towards @p special values, which makes the special
+    /// cases of codecs (delimiters, escapes) frequent.
+    void fill_biased(std::uint8_t* data, std::size_t length, std::uint8_t special_a,
+                     std::uint8_t special_b) noexcept
+    {
+        for (std::size_t i = 0; i < length; ++i) {
+            const auto r = next();
+            data[i] = (r & 7) == 0 ? special_a
+                      : (r & 7) == 1 ? special_b
+                                     : static_cast<std::uint8_t>(r >> 56);
+        }
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+/// Runs @p body for @p cases generated inputs, seeding each case
+/// differently, and stops at the first failing case.
+template <typename Body>
+void property(std::size_t cases, Body body)
+{
+    context& ctx = current();
+    const std::uint64_t failures = ctx.failures;
+    for (std::size_t i = 0; i < cases; ++i) {
+        ctx.seed = ctx.base_seed * 0x100000001b3ull + i + 1;
+        rng r(ctx.seed);
+        body(r);
+        if (ctx.failures != failures) {
+            break;
+        }
+    }
+    ctx.seed = 0;
+}
+
+} // namespace test
+} // namespace embec
+
+/// Defines and registers a test function.
+#define EMBEC_TEST(func, name)                                                       \
+    static void func();                                                             \
+    static const ::embec::test::registrar func##_registrar{name, func};             \
+    static void func()
+
+/// Records a failure if @p expr is false and continues.
+#define EMBEC_CHECK(expr) ::embec::test::check(static_cast<bool>(expr), __FILE__, __LINE__, #expr)
+
+/// Records a failure and returns from the enclosing function if @p expr is
+/// false.
+#define EMBEC_REQUIRE(expr)                                                          \
+    do {                                                                            \
+        if (!EMBEC_CHECK(expr)) {                                                   \
+            return;                                                                 \
+        }                                                                           \
+    } while (0)
+
+#endif // EMBEC_TEST_TEST_HPP
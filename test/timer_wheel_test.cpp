@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <vector>
+
+#include "embec/timer_wheel.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+/// A small wheel (64 ticks in range) so that long delays take the parked
+/// path and cascade through every level.
+using wheel_type = embec::timer_wheel<2, 3>;
+
+struct tracked_timer {
+    embec::timer t;
+    wheel_type* wheel = nullptr;
+    embec::tick_t due = 0;  ///< Expected expiry while armed.
+    embec::tick_t period = 0;
+    bool armed = false;
+    int late_or_early = 0;
+    int* order_errors = nullptr;
+    embec::tick_t* last_fire = nullptr;
+
+    static void expired(embec::timer& t)
+    {
+        auto& self = *static_cast<tracked_timer*>(t.context());
+        self.late_or_early += self.wheel->now() != self.due || !self.armed;
+        // Callbacks run in time order.
+        *self.order_errors += static_cast<std::int32_t>(self.wheel->now() - *self.last_fire) < 0;
+        *self.last_fire = self.wheel->now();
+        if (self.period) {
+            self.due += self.period;
+        } else {
+            self.armed = false;
+        }
+        self.late_or_early += t.active() != (self.period != 0);
+    }
+};
+
+EMBEC_TEST(model, "timer_wheel/model")
+{
+    // Every timer fires exactly at its expiry, through tick() and advance(),
+    // with timers started, restarted and stopped at random.
+    embec::test::property(300, [](embec::test::rng& r) {
+        wheel_type wheel;
+        std::vector<tracked_timer> timers(24);
+        int order_errors = 0;
+        embec::tick_t last_fire = 0;
+        // Start at a random time so that counters wrap.
+        wheel.advance(static_cast<embec::tick_t>(r.next()));
+        last_fire = wheel.now();
+        for (tracked_timer& t : timers) {
+            t.t.set_callback(&tracked_timer::expired, &t);
+            t.wheel = &wheel;
+            t.order_errors = &order_errors;
+            t.last_fire = &last_fire;
+        }
+        for (int step = 0; step < 400; ++step) {
+            tracked_timer& t = timers[r.below(timers.size())];
+            switch (r.below(4)) {
+            case 0: {
+                const auto delay = static_cast<embec::tick_t>(r.below(r.chance(20) ? 300 : 40));
+                const auto period =
+                    r.chance(30) ? 1 + static_cast<embec::tick_t>(r.below(90)) : 0;
+                wheel.start(t.t, delay, period);
+                t.due = wheel.now() + (delay ? delay : 1);
+                t.period = period;
+                t.armed = true;
+                break;
+            }
+            case 1:
+                EMBEC_REQUIRE(wheel.stop(t.t) == t.armed);
+                t.armed = false;
+                break;
+            case 2:
+                wheel.tick();
+                break;
+            default: {
+                // The earliest expiry is never before next_event().
+                const embec::tick_t next = wheel.next_event();
+                for (const tracked_timer& other : timers) {
+                    if (other.armed) {
+                        EMBEC_REQUIRE(other.due - wheel.now() >= next);
+                    }
+                }
+                wheel.advance(static_cast<embec::tick_t>(r.below(100)));
+                break;
+            }
+            }
+            std::size_t armed = 0;
+            for (const tracked_timer& other : timers) {
+                armed += other.armed;
+                EMBEC_REQUIRE(other.t.active() == other.armed);
+            }
+            EMBEC_REQUIRE(wheel.size() == armed);
+        }
+        for (const tracked_timer& t : timers) {
+            EMBEC_REQUIRE(t.late_or_early == 0);
+        }
+        EMBEC_CHECK(order_errors == 0);
+        EMBEC_CHECK(wheel.empty() || wheel.next_event() != wheel_type::no_event);
+    });
+}
+
+EMBEC_TEST(periodic, "timer_wheel/periodic")
+{
+    embec::timer_wheel<> wheel;
+    int count = 0;
+    embec::timer t([](embec::timer& self) { ++*static_cast<int*>(self.context()); }, &count);
+    wheel.start(t, 0, 10); // a zero delay means one tick
+    EMBEC_CHECK(wheel.tick() == 1 && count == 1);
+    EMBEC_CHECK(wheel.next_event() == 10 && t.expiry() == 11 && t.period() == 10);
+    EMBEC_CHECK(wheel.advance(1000) == 100 && count == 101);
+    EMBEC_CHECK(wheel.stop(t) && !wheel.stop(t) && wheel.next_event() == wheel.no_event);
+}
+
+} // namespace
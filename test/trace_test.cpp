@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "embec/trace.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+enum class channel : std::int8_t { left = -1, right = 1 };
+
+/// A drained record, with its format entry looked up the way the host
+/// decoder does: the ID is the entry's offset from the anchor.
+struct record {
+    std::uint32_t id;
+    std::uint32_t timestamp;
+    std::string signature;
+    std::string format;
+    std::vector<std::uint32_t> args;
+};
+
+std::vector<record> parse(const std::uint8_t* data, std::size_t size)
+{
+    std::vector<record> records;
+    for (std::size_t at = 0; at + 4 <= size;) {
+        std::uint32_t words[0x80];
+        std::memcpy(words, data + at, 4);
+        const std::uint32_t length = words[0] & 0x7f;
+        const bool valid = (words[0] & ~0x7fu) == 0x80 && length >= 3 && at + 4 * length <= size;
+        EMBEC_CHECK(valid);
+        if (!valid) {
+            break;
+        }
+        std::memcpy(words, data + at, 4 * length);
+        record r{words[1], words[2], {}, {}, {words + 3, words + length}};
+        if (r.id != embec::trace_buffer<8>::dropped_id) {
+            // The 32-bit offset wraps for entries placed before the anchor.
+            // Integer arithmetic, as in the encoder: the entry lies outside
+            // the anchor array, so pointer arithmetic on it is undefined.
+            const auto offset = static_cast<std::intptr_t>(static_cast<std::int32_t>(r.id));
+            const char* entry = reinterpret_cast<const char*>(
+                reinterpret_cast<std::uintptr_t>(embec::detail::trace_anchor) +
+                static_cast<std::uintptr_t>(offset));
+            r.signature = entry;
+            r.format = entry + r.signature.size() + 1;
+        }
+        records.push_back(r);
+        at += 4 * length;
+    }
+    return records;
+}
+
+EMBEC_TEST(record_layout, "trace/record_layout")
+{
+    embec::trace_buffer<64> trace;
+    const std::int16_t millivolts = -1234;
+    const double ratio = 0.25;
+    const int* pointer = reinterpret_cast<const int*>(0x1000);
+    EMBEC_CHECK(EMBEC_TRACE(trace, "adc ch%u = %d mV", 3u, millivolts));
+    EMBEC_CHECK(EMBEC_TRACE(trace, "ratio %f of %llu, %d%%", ratio, 1ull << 40, channel::left));
+    EMBEC_CHECK(EMBEC_TRACE(trace, "p=%p f=%f", pointer, 1.5f));
+    EMBEC_CHECK(EMBEC_TRACE(trace, "no arguments"));
+
+    std::uint8_t out[256];
+    const std::size_t n = trace.drain(out, sizeof(out));
+    const std::vector<record> records = parse(out, n);
+    EMBEC_REQUIRE(records.size() == 4);
+
+    EMBEC_CHECK(records[0].signature == "ui" && records[0].format == "adc ch%u = %d mV");
+    EMBEC_CHECK(records[0].args == (std::vector<std::uint32_t>{3, 0xfffffb2eu}));
+
+    EMBEC_CHECK(records[1].signature == "dQi" && records[1].args.size() == 5);
+    std::uint64_t bits;
+    std::memcpy(&bits, &ratio, sizeof(bits));
+    EMBEC_CHECK(records[1].args[0] == static_cast<std::uint32_t>(bits) &&
+                records[1].args[1] == bits >> 32);
+    EMBEC_CHECK(records[1].args[2] == 0 && records[1].args[3] == 0x100 &&
+                records[1].args[4] == 0xffffffffu);
+
+    EMBEC_CHECK(records[2].signature == (sizeof(void*) == 8 ? "Pf" : "pf"));
+    EMBEC_CHECK(records[2].args[0] == 0x1000 && records[2].args.back() == 0x3fc00000u);
+    EMBEC_CHECK(records[3].signature.empty() && records[3].format == "no arguments");
+
+    // Each call site has its own ID; the same site keeps it.
+    EMBEC_CHECK(records[0].id != records[1].id && records[1].id != records[2].id);
+    for (int i = 0; i < 2; ++i) {
+        EMBEC_TRACE(trace, "loop %d", i);
+    }
+    const std::vector<record> loop = parse(out, trace.drain(out, sizeof(out)));
+    EMBEC_CHECK(loop.size() == 2 && loop[0].id == loop[1].id && loop[1].args[0] == 1);
+}
+
+EMBEC_TEST(full_buffer, "trace/full_buffer")
+{
+    embec::trace_buffer<16> trace; // room for three 5-word records
+    int logged = 0;
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        logged += EMBEC_TRACE(trace, "%u %u", i, i);
+    }
+    EMBEC_CHECK(logged == 3 && trace.dropped() == 2);
+
+    // A short buffer takes whole records only.
+    std::uint8_t out[64];
+    std::size_t n = trace.drain(out, 24);
+    EMBEC_CHECK(n == 20 && parse(out, n)[0].args[0] == 0 && trace.dropped() == 2);
+    n = trace.drain(out, sizeof(out));
+    const std::vector<record> rest = parse(out, n);
+    EMBEC_REQUIRE(rest.size() == 3);
+    EMBEC_CHECK(rest[1].args[0] == 2 && rest[2].id == trace.dropped_id && rest[2].args[0] == 2);
+    EMBEC_CHECK(trace.dropped() == 0 && trace.drain(out, sizeof(out)) == 0);
+}
+
+EMBEC_TEST(threads, "trace/threads")
+{
+    // Producers log concurrently while one consumer drains; every record
+    // arrives intact and in per-thread order, or is counted as dropped.
+    constexpr std::uint32_t producers = 4;
+    constexpr std::uint32_t per_thread = 20000;
+    embec::trace_buffer<1024> trace;
+    std::atomic<std::uint32_t> finished{0};
+    std::vector<std::thread> threads;
+    for (std::uint32_t t = 0; t < producers; ++t) {
+        threads.emplace_back([&trace, &finished, t] {
+            for (std::uint32_t i = 0; i < per_thread; ++i) {
+                const std::uint64_t check = (std::uint64_t{t} << 32 | i) * 0x9e3779b97f4a7c15u;
+                if (!EMBEC_TRACE(trace, "%u %u %llu", t, i, check)) {
+                    std::this_thread::yield();
+                }
+            }
+            finished.fetch_add(1);
+        });
+    }
+
+    std::uint32_t received = 0;
+    std::uint32_t dropped = 0;
+    std::uint32_t corrupt = 0;
+    std::int64_t last[producers];
+    std::fill(last, last + producers, -1);
+    std::vector<std::uint8_t> out(2048);
+    for (;;) {
+        const bool all_finished = finished.load() == producers;
+        const std::size_t n = trace.drain(out.data(), out.size());
+        if (n == 0) {
+            if (all_finished) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+        const std::vector<record> records = parse(out.data(), n);
+        for (const record& r : records) {
+            if (r.id == trace.dropped_id) {
+                dropped += r.args[0];
+                continue;
+            }
+            const std::uint32_t t = r.args[0];
+            const std::uint32_t i = r.args[1];
+            const std::uint64_t check = (std::uint64_t{t} << 32 | i) * 0x9e3779b97f4a7c15u;
+            corrupt += t >= producers || r.args.size() != 4 ||
+                       r.args[2] != static_cast<std::uint32_t>(check) ||
+                       r.args[3] != check >> 32 ||
+                       static_cast<std::int64_t>(i) <= last[t % producers];
+            last[t % producers] = i;
+            ++received;
+        }
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    EMBEC_CHECK(corrupt == 0);
+    EMBEC_CHECK(received + dropped == producers * per_thread && received > 0);
+}
+
+} // namespace
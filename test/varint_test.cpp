@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "embec/varint.hpp"
+
+#include "test.hpp"
+
+namespace {
+
+EMBEC_TEST(zigzag, "varint/zigzag")
+{
+    static_assert(embec::zigzag_encode(std::int32_t{0}) == 0u, "");
+    static_assert(embec::zigzag_encode(std::int32_t{-1}) == 1u, "");
+    static_assert(embec::zigzag_encode(std::int32_t{1}) == 2u, "");
+    static_assert(embec::zigzag_encode(std::numeric_limits<std::int32_t>::min()) == 0xffffffffu,
+                  "");
+    static_assert(embec::zigzag_decode(std::uint8_t{255}) == -128, "");
+    embec::test::property(100, [](embec::test::rng& r) {
+        const auto v64 = static_cast<std::int64_t>(r.next() << 32 | r.next());
+        const auto v16 = static_cast<std::int16_t>(r.next());
+        EMBEC_REQUIRE(embec::zigzag_decode(embec::zigzag_encode(v64)) == v64);
+        EMBEC_REQUIRE(embec::zigzag_decode(embec::zigzag_encode(v16)) == v16);
+        // Magnitude order: |v| and -|v| - 1 map next to each other.
+        const auto small = static_cast<std::int32_t>(r.below(1000));
+        EMBEC_REQUIRE(embec::zigzag_encode(small) == 2u * static_cast<std::uint32_t>(small));
+        EMBEC_REQUIRE(embec::zigzag_encode(-small - 1) ==
+                      2u * static_cast<std::uint32_t>(small) + 1);
+    });
+}
+
+EMBEC_TEST(single, "varint/single")
+{
+    std::uint8_t buf[16];
+    EMBEC_CHECK(embec::varint_encode(std::uint32_t{300}, buf, sizeof(buf)) == 2);
+    EMBEC_CHECK(buf[0] == 0xac && buf[1] == 0x02);
+    EMBEC_CHECK(embec::varint_encode(std::uint32_t{300}, buf, 1) == 0);
+    EMBEC_CHECK(embec::varint_encode(std::int32_t{-1}, buf, sizeof(buf)) == 1 && buf[0] == 0x01);
+    EMBEC_CHECK(embec::varint_encode(~std::uint64_t{0}, buf, sizeof(buf)) == 10 &&
+                buf[9] == 0x01);
+    EMBEC_CHECK(embec::varint_size(0) == 1 && embec::varint_size(127) == 1 &&
+                embec::varint_size(128) == 2 && embec::varint_size(~std::uint64_t{0}) == 10);
+    static_assert(embec::varint_max_size<std::uint32_t> == 5, "");
+
+    std::uint32_t v = 0;
+    const std::uint8_t canonical[] = {0xac, 0x02};
+    EMBEC_CHECK(embec::varint_decode(canonical, 2, v) == 2 && v == 300);
+    EMBEC_CHECK(embec::varint_decode(canonical, 1, v) == 0); // truncated
+    const std::uint8_t padded[] = {0x80, 0x80, 0x00};
+    EMBEC_CHECK(embec::varint_decode(padded, 3, v) == 3 && v == 0);
+    const std::uint8_t largest[] = {0xff, 0xff, 0xff, 0xff, 0x0f};
+    EMBEC_CHECK(embec::varint_decode(largest, 5, v) == 5 && v == 0xffffffffu);
+    const std::uint8_t too_large[] = {0xff, 0xff, 0xff, 0xff, 0x1f};
+    EMBEC_CHECK(embec::varint_decode(too_large, 5, v) == 0);
+    const std::uint8_t too_long[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+    EMBEC_CHECK(embec::varint_decode(too_long, 6, v) == 0);
+    std::uint8_t small = 0;
+    const std::uint8_t byte_max[] = {0xff, 0x01};
+    const std::uint8_t byte_over[] = {0x80, 0x02};
+    EMBEC_CHECK(embec::varint_decode(byte_max, 2, small) == 2 && small == 255);
+    EMBEC_CHECK(embec::varint_decode(byte_over, 2, small) == 0);
+}
+
+// Values with a mix of encoded lengths, biased towards short ones.
+template <typename T>
+T random_value(embec::test::rng& r)
+{
+    const std::uint64_t raw = r.next() << 32 | r.next();
+    const unsigned bits = static_cast<unsigned>(r.below(8 * sizeof(T) + 1));
+    const std::uint64_t v = bits == 0 ? 0 : raw >> (64 - bits);
+    return r.chance(60) ? static_cast<T>(v & 0x7f) : static_cast<T>(v);
+}
+
+template <typename T>
+bool array_round_trip(embec::test::rng& r)
+{
+    const std::size_t count = r.below(300);
+    std::vector<T> values(count);
+    for (auto& v : values) {
+        v = random_value<T>(r);
+    }
+    std::vector<std::uint8_t> buf(count * embec::varint_max_size<T> + 1);
+    const embec::frame_result e =
+        embec::varint_encode_array(values.data(), count, buf.data(), buf.size());
+    if (!e) {
+        return false;
+    }
+    // The array encoding is the concatenation of single encodings.
+    std::size_t at = 0;
+    for (const T v : values) {
+        std::uint8_t one[16];
+        const std::size_t n = embec::varint_encode(v, one, sizeof(one));
+        if (std::memcmp(one, buf.data() + at, n) != 0) {
+            return false;
+        }
+        at += n;
+    }
+    std::vector<T> decoded(count + 1);
+    const embec::frame_result d =
+        embec::varint_decode_array(buf.data(), e.length, decoded.data(), count);
+    if (!d || d.length != e.length || at != e.length ||
+        !std::equal(values.begin(), values.end(), decoded.begin())) {
+        return false;
+    }
+    // Too little room or input.
+    return count == 0 ||
+           (embec::varint_encode_array(values.data(), count, buf.data(), e.length - 1).status ==
+                embec::frame_status::overflow &&
+            embec::varint_decode_array(buf.data(), e.length - 1, decoded.data(), count).status ==
+                embec::frame_status::incomplete);
+}
+
+EMBEC_TEST(arrays, "varint/arrays")
+{
+    embec::test::property(100, [](embec::test::rng& r) {
+        EMBEC_REQUIRE(array_round_trip<std::uint32_t>(r));
+        EMBEC_REQUIRE(array_round_trip<std::int32_t>(r));
+        EMBEC_REQUIRE(array_round_trip<std::uint64_t>(r));
+        EMBEC_REQUIRE(array_round_trip<std::int64_t>(r));
+        EMBEC_REQUIRE(array_round_trip<std::uint16_t>(r));
+        EMBEC_REQUIRE(array_round_trip<std::int8_t>(r));
+    });
+}
+
+EMBEC_TEST(bulk_matches_single, "varint/bulk_matches_single")
+{
+    // Arbitrary bytes, including runs of one-byte values and broken
+    // encodings, decode in bulk exactly as value by value: same values, same
+    // stopping point, same error. This covers the SSE2 path on hosts.
+    embec::test::property(300, [](embec::test::rng& r) {
+        std::uint8_t bytes[200];
+        for (auto& b : bytes) {
+            const unsigned kind = static_cast<unsigned>(r.below(10));
+            b = static_cast<std::uint8_t>(kind < 5   ? r.below(0x80)
+                                          : kind < 9 ? 0x80 | r.below(0x80)
+                                                     : r.next());
+        }
+        if (r.chance(30)) {
+            std::memset(bytes + r.below(100), 0x01, 40);
+        }
+        const std::size_t length = r.below(sizeof(bytes) + 1);
+        const std::size_t count = r.below(100);
+        std::uint32_t bulk[100];
+        const embec::frame_result result =
+            embec::varint_decode_array(bytes, length, bulk, count);
+
+        std::size_t at = 0;
+        embec::frame_status expected = embec::frame_status::ok;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t v = 0;
+            const std::size_t n = embec::varint_decode(bytes + at, length - at, v);
+            if (n == 0) {
+                // Truncated if no byte in reach ends the value.
+                bool ends = false;
+                for (std::size_t k = at; k < length && k < at + 5; ++k) {
+                    ends = ends || bytes[k] < 0x80;
+                }
+                expected = ends || length - at >= 5 ? embec::frame_status::invalid
+                                                    : embec::frame_status::incomplete;
+                break;
+            }
+            EMBEC_REQUIRE(!result || bulk[i] == v);
+            at += n;
+        }
+        EMBEC_REQUIRE(result.status == expected);
+        EMBEC_REQUIRE(!result || result.length == at);
+    });
+}
+
+template <unsigned Order, typename T>
+bool delta_round_trip(const std::vector<T>& values, std::size_t* size = nullptr)
+{
+    std::vector<std::uint8_t> buf(values.size() * embec::varint_max_size<T>);
+    const embec::frame_result e =
+        embec::varint_delta_encode<Order>(values.data(), values.size(), buf.data(), buf.size());
+    std::vector<T> decoded(values.size());
+    const embec::frame_result d =
+        embec::varint_delta_decode<Order>(buf.data(), e.length, decoded.data(), values.size());
+    if (size) {
+        *size = e.length;
+    }
+    return e && d && d.length == e.length && decoded == values;
+}
+
+EMBEC_TEST(delta, "varint/delta")
+{
+    // Timestamps with a fixed period and jitter: delta-of-delta needs about
+    // one byte per value, plain deltas two, the raw values five.
+    std::vector<std::uint32_t> stamps;
+    embec::test::rng r(3);
+    std::uint32_t t = 4000000000u;
+    for (int i = 0; i < 1000; ++i) {
+        t += 1000 + static_cast<std::uint32_t>(r.below(3)) - 1;
+        stamps.push_back(t);
+    }
+    std::size_t order1 = 0;
+    std::size_t order2 = 0;
+    EMBEC_CHECK(delta_round_trip<1>(stamps, &order1));
+    EMBEC_CHECK(delta_round_trip<2>(stamps, &order2));
+    EMBEC_CHECK(order1 < 2 * 1000 + 10 && order2 < 1000 + 10);
+
+    // Arbitrary sequences round-trip, including wrapping differences.
+    embec::test::property(100, [](embec::test::rng& r) {
+        std::vector<std::int64_t> wide(r.below(200));
+        std::vector<std::int16_t> narrow(wide.size());
+        std::vector<std::uint32_t> mixed(wide.size());
+        for (std::size_t i = 0; i < wide.size(); ++i) {
+            wide[i] = static_cast<std::int64_t>(r.next() << 32 | r.next());
+            narrow[i] = random_value<std::int16_t>(r);
+            mixed[i] = random_value<std::uint32_t>(r);
+        }
+        EMBEC_REQUIRE(delta_round_trip<1>(wide) && delta_round_trip<2>(wide));
+        EMBEC_REQUIRE(delta_round_trip<1>(narrow) && delta_round_trip<2>(narrow));
+        EMBEC_REQUIRE(delta_round_trip<1>(mixed) && delta_round_trip<2>(mixed));
+    });
+}
+
+} // namespace
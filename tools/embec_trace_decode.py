@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-3-Clause
+"""Decode embec trace records (see include/embec/trace.hpp).
+
+The format strings are read from the symbol table of the firmware ELF
+file, which must not be stripped: every EMBEC_TRACE call site owns one
+`embec_trace_entry` object holding the argument signature and the format
+string, and record IDs are offsets from `embec::detail::trace_anchor`.
+
+    embec_trace_decode.py firmware.elf trace.bin [--hz 168e6]
+"""
+
+import argparse
+import struct
+import sys
+
+ANCHOR = "_ZN5embec6detail12trace_anchorE"
+ENTRY = "embec_trace_entry"
+DROPPED_ID = 0xFFFFFFFF
+
+# Signature code -> (words, struct format of the little-endian words).
+CODES = {
+    "i": (1, "i"),
+    "u": (1, "I"),
+    "q": (2, "q"),
+    "Q": (2, "Q"),
+    "f": (1, "f"),
+    "d": (2, "d"),
+    "p": (1, "I"),
+    "P": (2, "Q"),
+}
+
+
+class Elf:
+    def __init__(self, data):
+        if data[:4] != b"\x7fELF":
+            raise ValueError("not an ELF file")
+        self.data = data
+        self.is64 = data[4] == 2
+        self.end = "<" if data[5] == 1 else ">"
+        if self.is64:
+            shoff, = struct.unpack_from(self.end + "Q", data, 0x28)
+            shentsize, shnum = struct.unpack_from(self.end + "HH", data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(self.end + "I", data, 0x20)
+            shentsize, shnum = struct.unpack_from(self.end + "HH", data, 0x2E)
+        self.sections = [self._section(shoff + i * shentsize) for i in range(shnum)]
+
+    def _section(self, at):
+        if self.is64:
+            (_, kind, _, addr, offset, size, link, _, _,
+             entsize) = struct.unpack_from(self.end + "IIQQQQIIQQ", self.data, at)
+        else:
+            (_, kind, _, addr, offset, size, link, _, _,
+             entsize) = struct.unpack_from(self.end + "IIIIIIIIII", self.data, at)
+        return {"type": kind, "addr": addr, "offset": offset, "size": size,
+                "link": link, "entsize": entsize}
+
+    def symbols(self):
+        """Yields (name, value, size, section index) of .symtab."""
+        for table in self.sections:
+            if table["type"] != 2:  # SHT_SYMTAB
+                continue
+            strings = self.sections[table["link"]]
+            for at in range(table["offset"], table["offset"] + table["size"],
+                            table["entsize"]):
+                if self.is64:
+                    name, _, _, shndx, value, size = struct.unpack_from(
+                        self.end + "IBBHQQ", self.data, at)
+                else:
+                    name, value, size, _, _, shndx = struct.unpack_from(
+                        self.end + "IIIBBH", self.data, at)
+                start = strings["offset"] + name
+                stop = self.data.index(b"\0", start)
+                yield self.data[start:stop].decode(), value, size, shndx
+
+    def read(self, shndx, value, size):
+        section = self.sections[shndx]
+        if section["type"] == 8:  # SHT_NOBITS
+            return None
+        at = section["offset"] + value - section["addr"]
+        return self.data[at:at + size]
+
+
+def load_formats(path):
+    """Returns {id: (signature, format)}."""
+    with open(path, "rb") as f:
+        elf = Elf(f.read())
+    anchor = None
+    entries = []
+    for name, value, size, shndx in elf.symbols():
+        if name == ANCHOR:
+            anchor = value
+        elif ENTRY in name and 0 < shndx < len(elf.sections):
+            entries.append((value, elf.read(shndx, value, size)))
+    if anchor is None:
+        raise ValueError("%s: no %s symbol (stripped, or no trace calls?)" % (path, ANCHOR))
+    formats = {}
+    for value, text in entries:
+        if text is None:
+            continue
+        signature, fmt = text.split(b"\0")[:2]
+        formats[(value - anchor) & 0xFFFFFFFF] = (signature.decode(), fmt.decode())
+    return formats
+
+
+def python_format(fmt):
+    """Rewrites C conversions into ones Python's % operator accepts."""
+    out = []
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        out.append(c)
+        i += 1
+        if c != "%":
+            continue
+        while i < len(fmt) and fmt[i] in "-+ #0123456789.*":
+            out.append(fmt[i])
+            i += 1
+        while i < len(fmt) and fmt[i] in "hljztL":
+            i += 1
+        if i < len(fmt):
+            conv = fmt[i]
+            out.append({"p": "#x", "u": "d"}.get(conv, conv))
+            i += 1
+    return "".join(out)
+
+
+def decode(formats, stream, end, hz):
+    words = struct.unpack(end + "%dI" % (len(stream) // 4), stream[:len(stream) // 4 * 4])
+    i = 0
+    while i + 3 <= len(words):
+        header, ident, stamp = words[i:i + 3]
+        length = header & 0x7F
+        if header & ~0x7F != 0x80 or length < 3 or i + length > len(words):
+            yield "<corrupt record at word %d>" % i
+            i += 1
+            continue
+        args = words[i + 3:i + length]
+        i += length
+        if ident == DROPPED_ID:
+            yield "<%d records dropped>" % args[0]
+            continue
+        if ident not in formats:
+            yield "%10d <unknown format id %#x>" % (stamp, ident)
+            continue
+        signature, fmt = formats[ident]
+        values = []
+        at = 0
+        for code in signature:
+            count, kind = CODES[code]
+            raw = struct.pack("<%dI" % count, *args[at:at + count])
+            values.append(struct.unpack("<" + kind, raw)[0])
+            at += count
+        text = python_format(fmt) % tuple(values)
+        when = "%12.6f" % (stamp / hz) if hz else "%10d" % stamp
+        yield "%s %s" % (when, text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="unstripped firmware image")
+    parser.add_argument("trace", help="drained trace bytes ('-' for stdin)")
+    parser.add_argument("--big-endian", action="store_true",
+                        help="the target is big-endian")
+    parser.add_argument("--hz", type=float, default=0,
+                        help="cycle counter rate; print seconds instead of ticks")
+    args = parser.parse_args()
+
+    formats = load_formats(args.elf)
+    if args.trace == "-":
+        stream = sys.stdin.buffer.read()
+    else:
+        with open(args.trace, "rb") as f:
+            stream = f.read()
+    for line in decode(formats, stream, ">" if args.big_endian else "<", args.hz):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()